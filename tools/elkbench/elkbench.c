@@ -0,0 +1,551 @@
+// Host-side benchmarks of how scripts run in Elk (websocket/elk.c), with the
+// same arena size the firmware uses by default.
+//
+//   cc -O2 -I../../websocket -o elkbench elkbench.c ../../websocket/elk.c ../../websocket/js_minify.c
+//   ./elkbench minify [-n reps] [-m arena_kb] [-f frame_fn] [script.js]
+//   ./elkbench gc [-n frames] [-m arena_kb] [-l live_kb] [-f frame_fn script.js]
+//   ./elkbench lookup [-n frames] [-m arena_kb] [lvgl_elk.h]
+//
+// minify   runs a script as written and as js_minify() turns it into (what
+//          the firmware runs from /script.min.js): loads it `reps` times,
+//          then calls `frame_fn(n);` `reps` times, each call its own
+//          js_eval() as when js_timers.cpp fires a frame callback. Reports
+//          size, time per load and per frame, and arena use. Without a
+//          file, a sample dashboard script is used, with a per-frame update
+//          function full of comments, long local names and LV_* constants.
+//          Natives the script calls (print, lv_*, ns.member(), ...) are
+//          stubbed as functions returning 0; LV_* constants become globals
+//          for the unminified run, since Elk has none. Frame time is
+//          mostly Elk's GC, which runs whenever the arena passes the
+//          threshold, so it moves less than load time does.
+//          Exits 1 if either version fails to run or they return different
+//          results.
+// gc       runs the same frames with the GC threshold (gc_threshold_pct in
+//          webscreen.json) at 10..100% of the arena and reports time per
+//          frame against the lowest free arena. Elk's GC walks the whole
+//          arena for every dead entity it removes, so a low threshold that
+//          finds little garbage each time is cheapest, until the data the
+//          script keeps alive (`live_kb` adds a string of that size) nears
+//          the threshold and the GC runs after nearly every statement. A
+//          high one leaves the least headroom. Exits 1 if the default
+//          threshold fails.
+// lookup   reads the binding table (g_js_bindings) from lvgl_elk.h and
+//          times calls to 8 bindings spread over it, registered three
+//          ways: every flat global (what a NULL script registers), only
+//          the flat names called, and the namespaced members called
+//          (`lv.obj_align(...)`). Reports globals, arena taken by the
+//          bindings and time per call. Exits 1 if a call fails.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <time.h>
+#include "elk.h"
+#include "js_minify.h"
+
+#define ARENA_KB_DEFAULT 16  // ELK_HEAP_DEFAULT in lvgl_elk.h
+#define GC_PCT_DEFAULT 50    // ELK_GC_PCT_DEFAULT
+
+static const char g_sample[] =
+  "// Sample dashboard: a smoothed sensor value shown on a gauge, a bar and\n"
+  "// a label, refreshed once per frame.\n"
+  "let smoothedTemperature = 0;\n"
+  "let frameCounter = 0;\n"
+  "\n"
+  "// Exponential moving average with a weight of 1/8\n"
+  "let computeSmoothedValue = function(previousValue, newSample) {\n"
+  "  let smoothingWeight = 8;   // larger is smoother\n"
+  "  return previousValue + (newSample - previousValue) / smoothingWeight;\n"
+  "};\n"
+  "\n"
+  "/* Called once per frame from requestAnimationFrame(). Every comment and\n"
+  "   every long name in here is scanned again on each call. */\n"
+  "let updateDashboardFrame = function(currentFrameNumber) {\n"
+  "  // Fake sensor: a sawtooth with a little wobble\n"
+  "  let rawSensorReading = (currentFrameNumber * 37) % 100;\n"
+  "  smoothedTemperature = computeSmoothedValue(smoothedTemperature, rawSensorReading);\n"
+  "\n"
+  "  // Position and colour depend on the value\n"
+  "  let labelAlignment = LV_ALIGN_CENTER;\n"
+  "  if (smoothedTemperature > 50) {\n"
+  "    labelAlignment = LV_ALIGN_TOP_MID;\n"
+  "    lv_obj_set_style_bg_color(3, 16711680, LV_PART_MAIN);\n"
+  "  } else {\n"
+  "    lv_obj_set_style_bg_color(3, 255, LV_PART_MAIN);\n"
+  "  }\n"
+  "  lv_obj_align(1, labelAlignment, 0, 0);\n"
+  "  lv_bar_set_value(2, smoothedTemperature, LV_ANIM_OFF);\n"
+  "  lv_label_set_text(4, 'temperature');\n"
+  "  countFrame();\n"
+  "  return smoothedTemperature;\n"
+  "};\n"
+  "\n"
+  "// Frames are counted here so ++ gets minified too\n"
+  "let countFrame = function() {\n"
+  "  frameCounter++;\n"
+  "  return frameCounter;\n"
+  "};\n";
+#define SAMPLE_FRAME "updateDashboardFrame"
+
+static size_t g_arena_size = ARENA_KB_DEFAULT * 1024;
+static char *g_arena;
+static int g_gc_pct = GC_PCT_DEFAULT;  // js_setgct() as elk_task() sets it
+static size_t g_live;                   // bytes of a global string kept alive
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static char *read_file(const char *path, size_t *len) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *buf = (char *) malloc((size_t) n + 1);
+  if (buf && fread(buf, 1, (size_t) n, f) != (size_t) n) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  if (buf) buf[n] = '\0', *len = (size_t) n;
+  return buf;
+}
+
+/******************************************************************************
+ * Stubs for the natives a script calls
+ ******************************************************************************/
+static jsval_t js_stub(struct js *js, jsval_t *args, int nargs) {
+  (void) js, (void) args, (void) nargs;
+  return js_mknum(0);
+}
+
+static int is_word(char c) {
+  return isalnum((unsigned char) c) || c == '_' || c == '$';
+}
+
+static int is_keyword(const char *s, size_t n) {
+  static const char *const kw[] = { "if", "for", "while", "return", "function", "let", "typeof",
+                                    "else", "break", "continue", "new", "delete" };
+  for (size_t i = 0; i < sizeof(kw) / sizeof(kw[0]); i++) {
+    if (strlen(kw[i]) == n && memcmp(kw[i], s, n) == 0) return 1;
+  }
+  return 0;
+}
+
+// True if `let name` appears anywhere in the script
+static int is_declared(const char *src, size_t len, const char *name, size_t n) {
+  for (const char *p = src; (p = strstr(p, "let ")) != NULL && p < src + len; p += 4) {
+    const char *q = p + 4;
+    while (*q == ' ') q++;
+    if (!strncmp(q, name, n) && !is_word(q[n])) return 1;
+  }
+  return 0;
+}
+
+// Skip over string literals and comments, so only code is scanned
+static size_t skip_noncode(const char *s, size_t len, size_t i) {
+  if (s[i] == '"' || s[i] == '\'') {
+    char q = s[i++];
+    while (i < len && s[i] != q) i += s[i] == '\\' ? 2 : 1;
+    return i + 1;
+  }
+  if (s[i] == '/' && i + 1 < len && s[i + 1] == '/') {
+    while (i < len && s[i] != '\n') i++;
+    return i;
+  }
+  if (s[i] == '/' && i + 1 < len && s[i + 1] == '*') {
+    const char *e = strstr(s + i + 2, "*/");
+    return e ? (size_t) (e - s) + 2 : len;
+  }
+  return i;
+}
+
+// Give every name the script calls but never declares a stub: `name(` as a
+// global, `ns.member(` as a member of a stub object `ns`. LV_* constants
+// become globals too when `constants` is set.
+static void add_stubs(struct js *js, const char *src, size_t len, int constants) {
+  jsval_t glob = js_glob(js);
+  char name[64], member[64];
+  for (size_t i = 0; i < len;) {
+    size_t k = skip_noncode(src, len, i);
+    if (k != i) {
+      i = k;
+      continue;
+    }
+    if (!is_word(src[i]) || isdigit((unsigned char) src[i]) || (i > 0 && src[i - 1] == '.')) {
+      i++;
+      continue;
+    }
+    size_t st = i;
+    while (i < len && is_word(src[i])) i++;
+    size_t n = i - st;
+    if (n >= sizeof(name) || is_keyword(src + st, n) || is_declared(src, len, src + st, n)) continue;
+    memcpy(name, src + st, n);
+    name[n] = '\0';
+
+    long value;
+    if (constants && n > 3 && !memcmp(name, "LV_", 3) && js_minify_constant(name, n, &value)) {
+      js_set(js, glob, name, js_mknum((double) value));
+    } else if (i < len && src[i] == '(') {
+      js_set(js, glob, name, js_mkfun(js_stub));
+    } else if (i < len && src[i] == '.') {
+      size_t ms = i + 1, me = ms;
+      while (me < len && is_word(src[me])) me++;
+      if (me == ms || me - ms >= sizeof(member) || me >= len || src[me] != '(') continue;
+      memcpy(member, src + ms, me - ms);
+      member[me - ms] = '\0';
+      jsval_t ns = js_mkobj(js);
+      // Keep members added for earlier calls through the same namespace
+      jsval_t old = js_eval(js, name, n);
+      if (js_type(old) == JS_PRIV) ns = old;
+      js_set(js, ns, member, js_mkfun(js_stub));
+      js_set(js, glob, name, ns);
+    }
+  }
+}
+
+/******************************************************************************
+ * minify
+ ******************************************************************************/
+typedef struct {
+  double load_us;   // eval of the whole script
+  double frame_us;  // per `frame(n);` call, 0 without one
+  size_t used;      // arena bytes in use afterwards
+  size_t min_free;  // lowest free arena seen
+  char result[64];
+  int failed;
+} run_t;
+
+// Loads the script `reps` times into a fresh instance; on the last one,
+// calls `frame(n);` `reps` times the way js_timers.cpp fires a frame
+// callback, each call a js_eval() of its own.
+static run_t run_script(const char *code, size_t len, const char *stub_src, size_t stub_len, int constants,
+                        const char *frame, int reps) {
+  run_t r;
+  memset(&r, 0, sizeof(r));
+  if (!g_arena) g_arena = (char *) malloc(g_arena_size);
+  struct js *js = NULL;
+  jsval_t v = js_mkundef();
+  double total = 0;
+  for (int i = 0; i < reps && !r.failed; i++) {
+    js = js_create(g_arena, g_arena_size);
+    js_setgct(js, g_arena_size * g_gc_pct / 100);
+    add_stubs(js, stub_src, stub_len, constants);
+    if (g_live) {
+      char *fill = (char *) malloc(g_live);
+      memset(fill, 'x', g_live);
+      js_set(js, js_glob(js), "liveData", js_mkstr(js, fill, g_live));
+      free(fill);
+    }
+    double t0 = now_s();
+    v = js_eval(js, code, len);
+    total += now_s() - t0;
+    r.failed = js_type(v) == JS_ERR;
+  }
+  r.load_us = total * 1e6 / reps;
+
+  if (frame && !r.failed) {
+    char call[96];
+    total = 0;
+    for (int i = 0; i < reps && !r.failed; i++) {
+      int n = snprintf(call, sizeof(call), "%s(%d);", frame, i);
+      double t0 = now_s();
+      v = js_eval(js, call, (size_t) n);
+      total += now_s() - t0;
+      r.failed = js_type(v) == JS_ERR;
+    }
+    r.frame_us = total * 1e6 / reps;
+  }
+  snprintf(r.result, sizeof(r.result), "%s", js_str(js, v));
+  size_t size, lwm;
+  js_stats(js, &size, &lwm, NULL);
+  r.used = js_usage(js);
+  r.min_free = lwm;
+  return r;
+}
+
+static int cmd_minify(int argc, char *argv[]) {
+  int reps = 200;
+  const char *path = NULL, *frame = NULL;
+  for (int a = 0; a < argc; a++) {
+    if (!strcmp(argv[a], "-n") && a + 1 < argc) {
+      reps = atoi(argv[++a]);
+    } else if (!strcmp(argv[a], "-m") && a + 1 < argc) {
+      g_arena_size = (size_t) atoi(argv[++a]) * 1024;
+    } else if (!strcmp(argv[a], "-f") && a + 1 < argc) {
+      frame = argv[++a];
+    } else if (argv[a][0] != '-' && !path) {
+      path = argv[a];
+    } else {
+      return 2;
+    }
+  }
+  if (reps <= 0) reps = 1;
+  if (frame && strlen(frame) > 64) return 2;
+
+  size_t len = sizeof(g_sample) - 1;
+  const char *src = g_sample;
+  char *file = NULL;
+  if (path) {
+    file = read_file(path, &len);
+    if (!file) {
+      fprintf(stderr, "elkbench: cannot read %s\n", path);
+      return 1;
+    }
+    src = file;
+  } else if (!frame) {
+    frame = SAMPLE_FRAME;
+  }
+  char *min = (char *) malloc(len + 1);
+  js_minify_stats_t st;
+  size_t min_len = js_minify(src, len, min, len + 1, &st);
+  if (!min_len && len) {
+    fprintf(stderr, "elkbench: %s: unterminated string/comment or unbalanced braces\n", path ? path : "sample");
+    free(min);
+    free(file);
+    return 1;
+  }
+
+  run_t a = run_script(src, len, src, len, 1, frame, reps);
+  run_t b = run_script(min, min_len, src, len, 0, frame, reps);
+  printf("%s, %d runs each, %u KB arena%s%s\n", path ? path : "sample script", reps,
+         (unsigned) (g_arena_size / 1024), frame ? ", frame callback " : "", frame ? frame : "");
+  printf("%-9s %8s %10s %10s %10s %10s  %s\n", "", "bytes", "load us", "frame us", "arena", "min free", "result");
+  printf("%-9s %8u %10.1f %10.2f %10u %10u  %s\n", "source", (unsigned) len, a.load_us, a.frame_us,
+         (unsigned) a.used, (unsigned) a.min_free, a.result);
+  printf("%-9s %8u %10.1f %10.2f %10u %10u  %s\n", "minified", (unsigned) min_len, b.load_us, b.frame_us,
+         (unsigned) b.used, (unsigned) b.min_free, b.result);
+  fprintf(stderr, "%u locals renamed, %u constants inlined; source/minified time: load %.2fx", (unsigned) st.renamed,
+          (unsigned) st.inlined, b.load_us > 0 ? a.load_us / b.load_us : 0);
+  if (frame) fprintf(stderr, ", frame %.2fx", b.frame_us > 0 ? a.frame_us / b.frame_us : 0);
+  fprintf(stderr, "\n");
+  int bad = a.failed || b.failed || strcmp(a.result, b.result) != 0;
+  free(min);
+  free(file);
+  return bad ? 1 : 0;
+}
+
+/******************************************************************************
+ * gc
+ ******************************************************************************/
+static int cmd_gc(int argc, char *argv[]) {
+  int reps = 2000;
+  const char *path = NULL, *frame = NULL;
+  for (int a = 0; a < argc; a++) {
+    if (!strcmp(argv[a], "-n") && a + 1 < argc) {
+      reps = atoi(argv[++a]);
+    } else if (!strcmp(argv[a], "-m") && a + 1 < argc) {
+      g_arena_size = (size_t) atoi(argv[++a]) * 1024;
+    } else if (!strcmp(argv[a], "-f") && a + 1 < argc) {
+      frame = argv[++a];
+    } else if (!strcmp(argv[a], "-l") && a + 1 < argc) {
+      g_live = (size_t) atoi(argv[++a]) * 1024;
+    } else if (argv[a][0] != '-' && !path) {
+      path = argv[a];
+    } else {
+      return 2;
+    }
+  }
+  if (reps <= 0) reps = 1;
+  if (!frame && path) return 2;
+  if (!frame) frame = SAMPLE_FRAME;
+  if (strlen(frame) > 64) return 2;
+
+  size_t len = sizeof(g_sample) - 1;
+  const char *src = g_sample;
+  char *file = NULL;
+  if (path) {
+    file = read_file(path, &len);
+    if (!file) {
+      fprintf(stderr, "elkbench: cannot read %s\n", path);
+      return 1;
+    }
+    src = file;
+  }
+
+  printf("%s, %d frames of %s, %u KB arena, %u KB more kept live\n", path ? path : "sample script", reps,
+         frame, (unsigned) (g_arena_size / 1024), (unsigned) (g_live / 1024));
+  printf("%-6s %10s %10s %10s  %s\n", "gc %", "frame us", "arena", "min free", "result");
+  int bad = 0;
+  double best = 0;
+  int best_pct = 0;
+  for (int pct = 10; pct <= 100; pct += 10) {
+    g_gc_pct = pct;
+    run_t r = run_script(src, len, src, len, 1, frame, reps);
+    printf("%-6d %10.2f %10u %10u  %s%s\n", pct, r.frame_us, (unsigned) r.used, (unsigned) r.min_free, r.result,
+           pct == GC_PCT_DEFAULT ? "  (default)" : "");
+    if (r.failed && pct == GC_PCT_DEFAULT) bad = 1;
+    if (!r.failed && (!best_pct || r.frame_us < best)) best = r.frame_us, best_pct = pct;
+  }
+  if (best_pct) fprintf(stderr, "fastest without errors: %d%%, %.2f us/frame\n", best_pct, best);
+  free(file);
+  return bad;
+}
+
+/******************************************************************************
+ * lookup
+ ******************************************************************************/
+#define LOOKUP_CALLS 8  // bindings called per frame, spread over the table
+
+typedef struct {
+  char ns[8];  // "" for a plain global
+  char member[48];
+  char flat[48];
+} binding_t;
+
+static const char *const g_timer_names[] = { "setTimeout", "setInterval", "requestAnimationFrame",
+                                             "clearTimeout", "clearInterval", "cancelAnimationFrame" };
+
+// Rows of g_js_bindings: { JS_NS_LV, "member", "flat", fn },
+static int read_bindings(const char *path, binding_t **out) {
+  size_t len;
+  char *text = read_file(path, &len);
+  if (!text) return -1;
+  int n = 0, cap = 0;
+  binding_t *b = NULL;
+  for (char *p = text; (p = strstr(p, "{ JS_NS_")) != NULL; p++) {
+    binding_t row;
+    char ns[16];
+    if (sscanf(p, "{ JS_NS_%15[A-Z] , \"%47[^\"]\" , \"%47[^\"]\"", ns, row.member, row.flat) != 3) continue;
+    if (strlen(ns) >= sizeof(row.ns)) continue;
+    for (size_t i = 0; i <= strlen(ns); i++) row.ns[i] = (char) tolower((unsigned char) ns[i]);
+    if (!strcmp(row.ns, "none")) row.ns[0] = '\0';
+    if (n == cap) {
+      cap = cap ? cap * 2 : 64;
+      b = (binding_t *) realloc(b, (size_t) cap * sizeof(*b));
+    }
+    b[n++] = row;
+  }
+  free(text);
+  *out = b;
+  return n;
+}
+
+enum { REG_FLAT_ALL, REG_FLAT_USED, REG_NAMESPACED };
+
+// What register_js_functions() sets up: the timers first, then every row
+// in table order (Elk puts each new property first in the list), then the
+// namespace objects. Returns the number of globals.
+static unsigned register_bindings(struct js *js, const binding_t *b, int n, const int *used, int how) {
+  jsval_t glob = js_glob(js);
+  unsigned globals = 0;
+  for (size_t i = 0; i < sizeof(g_timer_names) / sizeof(g_timer_names[0]); i++, globals++) {
+    js_set(js, glob, g_timer_names[i], js_mkfun(js_stub));
+  }
+  static const char *const ns_names[] = { "lv", "style", "sd", "net", "ble", "data" };
+  jsval_t ns_obj[sizeof(ns_names) / sizeof(ns_names[0])];
+  for (size_t k = 0; k < sizeof(ns_names) / sizeof(ns_names[0]); k++) ns_obj[k] = js_mkundef();
+  for (int i = 0; i < n; i++) {
+    jsval_t fn = js_mkfun(js_stub);
+    int is_used = 0;
+    for (int k = 0; k < LOOKUP_CALLS; k++) is_used |= used[k] == i;
+    if (how == REG_NAMESPACED && b[i].ns[0] && is_used) {
+      for (size_t k = 0; k < sizeof(ns_names) / sizeof(ns_names[0]); k++) {
+        if (strcmp(ns_names[k], b[i].ns) != 0) continue;
+        if (js_type(ns_obj[k]) == JS_UNDEF) ns_obj[k] = js_mkobj(js);
+        js_set(js, ns_obj[k], b[i].member, fn);
+      }
+    }
+    if (!b[i].ns[0] || how == REG_FLAT_ALL || (how == REG_FLAT_USED && is_used)) {
+      js_set(js, glob, b[i].flat, fn);
+      globals++;
+    }
+  }
+  for (size_t k = 0; k < sizeof(ns_names) / sizeof(ns_names[0]); k++) {
+    if (js_type(ns_obj[k]) == JS_UNDEF) continue;
+    js_set(js, glob, ns_names[k], ns_obj[k]);
+    globals++;
+  }
+  return globals;
+}
+
+static int cmd_lookup(int argc, char *argv[]) {
+  int reps = 20000;
+  const char *path = "../../websocket/lvgl_elk.h";
+  for (int a = 0; a < argc; a++) {
+    if (!strcmp(argv[a], "-n") && a + 1 < argc) {
+      reps = atoi(argv[++a]);
+    } else if (!strcmp(argv[a], "-m") && a + 1 < argc) {
+      g_arena_size = (size_t) atoi(argv[++a]) * 1024;
+    } else if (argv[a][0] != '-') {
+      path = argv[a];
+    } else {
+      return 2;
+    }
+  }
+  if (reps <= 0) reps = 1;
+
+  binding_t *b = NULL;
+  int n = read_bindings(path, &b);
+  if (n < 0) {
+    fprintf(stderr, "elkbench: cannot read %s\n", path);
+    return 1;
+  }
+  // Bindings with a namespace, evenly spread from the first to the last row
+  int with_ns = 0, used[LOOKUP_CALLS];
+  for (int i = 0; i < n; i++) with_ns += b[i].ns[0] != '\0';
+  if (with_ns < LOOKUP_CALLS) {
+    fprintf(stderr, "elkbench: %s: %d namespaced bindings found, need %d\n", path, with_ns, LOOKUP_CALLS);
+    free(b);
+    return 1;
+  }
+  for (int k = 0, seen = 0, i = 0; i < n && k < LOOKUP_CALLS; i++) {
+    if (!b[i].ns[0]) continue;
+    if (seen++ == (with_ns - 1) * k / (LOOKUP_CALLS - 1)) used[k++] = i;
+  }
+
+  static const char *const names[] = { "flat, all", "flat, used", "namespaced" };
+  if (!g_arena) g_arena = (char *) malloc(g_arena_size);
+  printf("%s: %d bindings, %d calls per frame, %d frames, %u KB arena\n", path, n, LOOKUP_CALLS, reps,
+         (unsigned) (g_arena_size / 1024));
+  printf("%-11s %8s %10s %10s\n", "", "globals", "arena", "us/call");
+  int bad = 0;
+  for (int how = REG_FLAT_ALL; how <= REG_NAMESPACED; how++) {
+    char code[LOOKUP_CALLS * 112];
+    size_t o = 0;
+    for (int k = 0; k < LOOKUP_CALLS; k++) {
+      const binding_t *u = &b[used[k]];
+      if (how == REG_NAMESPACED) o += (size_t) snprintf(code + o, sizeof(code) - o, "%s.%s(1, 2);", u->ns, u->member);
+      else o += (size_t) snprintf(code + o, sizeof(code) - o, "%s(1, 2);", u->flat);
+    }
+    struct js *js = js_create(g_arena, g_arena_size);
+    js_setgct(js, g_arena_size * g_gc_pct / 100);
+    unsigned globals = register_bindings(js, b, n, used, how);
+    size_t arena = js_usage(js);
+    jsval_t v = js_mkundef();
+    double t0 = now_s();
+    for (int i = 0; i < reps && js_type(v) != JS_ERR; i++) v = js_eval(js, code, o);
+    double t = now_s() - t0;
+    if (js_type(v) == JS_ERR) {
+      fprintf(stderr, "%s: %s\n", names[how], js_str(js, v));
+      bad = 1;
+    }
+    printf("%-11s %8u %10u %10.3f\n", names[how], globals, (unsigned) arena, t * 1e6 / reps / LOOKUP_CALLS);
+  }
+  free(b);
+  return bad;
+}
+
+static void usage(const char *argv0) {
+  fprintf(stderr, "usage: %s minify [-n reps] [-m arena_kb] [-f frame_fn] [script.js]\n", argv0);
+  fprintf(stderr, "       %s gc [-n frames] [-m arena_kb] [-l live_kb] [-f frame_fn script.js]\n", argv0);
+  fprintf(stderr, "       %s lookup [-n frames] [-m arena_kb] [lvgl_elk.h]\n", argv0);
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    usage(argv[0]);
+    return 2;
+  }
+  int rc = 2;
+  if (!strcmp(argv[1], "minify")) rc = cmd_minify(argc - 2, argv + 2);
+  if (!strcmp(argv[1], "gc")) rc = cmd_gc(argc - 2, argv + 2);
+  if (!strcmp(argv[1], "lookup")) rc = cmd_lookup(argc - 2, argv + 2);
+  if (rc == 2) usage(argv[0]);
+  free(g_arena);
+  return rc;
+}
@@ -0,0 +1,370 @@
+// Host-side converter from GIF to the pre-decoded .wsa animation format
+// played by anim_create(); the frame coder is the one the firmware decodes
+// with (websocket/anim_codec.c).
+//
+//   cc -O2 -I../../websocket -o gif2wsa gif2wsa.c ../../websocket/anim_codec.c
+//   ./gif2wsa [-k interval] [-b rrggbb] anim.gif anim.wsa
+//
+// -k forces a key frame every `interval` frames (default: only where it is
+// smaller than the delta), which lets a lagging player catch up without
+// applying every delta. -b is the colour transparent pixels end up as
+// (default black). Frames shorter than 20 ms play at 100 ms, as browsers do.
+//
+// Besides converting, it times decoding every frame both ways on this
+// machine: the GIF path (LZW, palette, disposal, RGB565 conversion: the
+// work lv_gif does per frame) against applying the .wsa records.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "anim_codec.h"
+
+static uint8_t *read_file(const char *path, size_t *len) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t *buf = (uint8_t *) malloc((size_t) n + 1);
+  if (buf && fread(buf, 1, (size_t) n, f) != (size_t) n) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  if (buf) *len = (size_t) n;
+  return buf;
+}
+
+/******************************************************************************
+ * GIF decoding
+ ******************************************************************************/
+typedef struct {
+  uint16_t w, h;
+  uint16_t loops;         // 0 = forever, also when there is no NETSCAPE block
+  uint32_t bg;            // 0xRRGGBB for transparent pixels
+  uint32_t *canvas;       // composited screen, 0xRRGGBB
+  uint32_t *saved;        // for "restore to previous" disposal
+  uint16_t *frame;        // canvas as RGB565
+  uint8_t *idx;           // one decoded image
+} gif_t;
+
+typedef void (*gif_frame_cb)(gif_t *g, uint16_t delay_ms, void *ctx);
+
+// Decodes `len` bytes of LZW data into at most `npx` colour indices
+static int lzw_decode(const uint8_t *data, size_t len, int min_size, uint8_t *out, size_t npx) {
+  static uint16_t prefix[4096];
+  static uint8_t suffix[4096], stack[4097];
+  if (min_size < 2 || min_size > 8) return 0;
+  const int clear = 1 << min_size, eoi = clear + 1;
+  int size = min_size + 1, next = eoi + 1, prev = -1, first = 0;
+  size_t bitpos = 0, o = 0;
+  for (int i = 0; i < clear; i++) suffix[i] = (uint8_t) i;
+
+  while (o < npx) {
+    if (bitpos + size > len * 8) break;
+    const uint8_t *q = data + (bitpos >> 3);  // gif_blocks() pads two bytes
+    int code = (int) (((q[0] | q[1] << 8 | (uint32_t) q[2] << 16) >> (bitpos & 7)) & ((1u << size) - 1));
+    bitpos += size;
+    if (code == clear) {
+      size = min_size + 1;
+      next = eoi + 1;
+      prev = -1;
+      continue;
+    }
+    if (code == eoi) break;
+    if (prev < 0) {
+      if (code >= clear) return 0;
+      out[o++] = (uint8_t) code;
+      prev = first = code;
+      continue;
+    }
+    if (code > next) return 0;
+    int c = code, sp = 0;
+    if (code == next) {
+      stack[sp++] = (uint8_t) first;
+      c = prev;
+    }
+    while (c >= clear) {
+      stack[sp++] = suffix[c];
+      c = prefix[c];
+    }
+    stack[sp++] = (uint8_t) c;
+    first = c;
+    while (sp && o < npx) out[o++] = stack[--sp];
+    if (next < 4096) {
+      prefix[next] = (uint16_t) prev;
+      suffix[next] = (uint8_t) first;
+      if (++next == (1 << size) && size < 12) size++;
+    }
+    prev = code;
+  }
+  return 1;
+}
+
+// Concatenated data sub-blocks starting at *p, plus two zero bytes of
+// padding; advances *p past them
+static uint8_t *gif_blocks(const uint8_t **p, const uint8_t *end, size_t *len) {
+  size_t n = 0;
+  for (const uint8_t *q = *p; q < end && *q; q += *q + 1) n += *q;
+  uint8_t *buf = (uint8_t *) calloc(n + 2, 1);
+  n = 0;
+  while (*p < end && **p) {
+    size_t b = **p;
+    if (*p + 1 + b > end) {  // truncated file: keep what is there
+      *p = end;
+      break;
+    }
+    memcpy(buf + n, *p + 1, b);
+    n += b;
+    *p += b + 1;
+  }
+  if (*p < end) (*p)++;
+  *len = n;
+  return buf;
+}
+
+static uint32_t rgb(const uint8_t *c) {
+  return ((uint32_t) c[0] << 16) | ((uint32_t) c[1] << 8) | c[2];
+}
+
+static uint16_t rgb565(uint32_t c) {
+  return (uint16_t) (((c >> 8) & 0xF800) | ((c >> 5) & 0x07E0) | ((c >> 3) & 0x001F));
+}
+
+// Calls `cb` once per frame with the composited canvas in g->frame.
+// Returns the number of frames, or -1 if the file is not a valid GIF.
+static int gif_decode(gif_t *g, const uint8_t *buf, size_t len, gif_frame_cb cb, void *ctx) {
+  const uint8_t *p = buf, *end = buf + len;
+  if (len < 13 || (memcmp(p, "GIF87a", 6) && memcmp(p, "GIF89a", 6))) return -1;
+  uint16_t sw = (uint16_t) (p[6] | p[7] << 8), sh = (uint16_t) (p[8] | p[9] << 8);
+  if (!sw || !sh) return -1;
+  if (!g->canvas) {
+    g->w = sw;
+    g->h = sh;
+    g->canvas = (uint32_t *) malloc((size_t) sw * sh * 4);
+    g->saved = (uint32_t *) malloc((size_t) sw * sh * 4);
+    g->frame = (uint16_t *) malloc((size_t) sw * sh * 2);
+    g->idx = (uint8_t *) malloc((size_t) sw * sh);
+  }
+  const size_t npx = (size_t) sw * sh;
+  for (size_t i = 0; i < npx; i++) g->canvas[i] = g->bg;
+
+  const uint8_t *gct = NULL;
+  int gct_n = 0;
+  if (p[10] & 0x80) {
+    gct = p + 13;
+    gct_n = 2 << (p[10] & 7);
+  }
+  p += 13 + 3 * gct_n;
+
+  int frames = 0, disposal = 0, transp = -1;
+  uint16_t delay = 0;
+  g->loops = 0;
+  while (p < end) {
+    uint8_t tag = *p++;
+    if (tag == 0x3B) break;  // trailer
+    if (tag == 0x21) {       // extension
+      if (p >= end) return -1;
+      uint8_t label = *p++;
+      size_t n;
+      uint8_t *d = gif_blocks(&p, end, &n);
+      if (label == 0xF9 && n >= 4) {  // graphic control
+        disposal = (d[0] >> 2) & 7;
+        transp = (d[0] & 1) ? d[3] : -1;
+        delay = (uint16_t) (d[1] | d[2] << 8);
+      } else if (label == 0xFF && n >= 14 && !memcmp(d, "NETSCAPE2.0", 11) && d[11] == 1) {
+        g->loops = (uint16_t) (d[12] | d[13] << 8);
+      }
+      free(d);
+      continue;
+    }
+    if (tag != 0x2C || p + 9 > end) return -1;
+
+    // Image descriptor
+    int x0 = p[0] | p[1] << 8, y0 = p[2] | p[3] << 8;
+    int w = p[4] | p[5] << 8, h = p[6] | p[7] << 8;
+    uint8_t flags = p[8];
+    p += 9;
+    const uint8_t *ct = gct;
+    int ct_n = gct_n;
+    if (flags & 0x80) {
+      ct = p;
+      ct_n = 2 << (flags & 7);
+      p += 3 * ct_n;
+    }
+    if (p >= end || !ct) return -1;
+    int min_size = *p++;
+    size_t n;
+    uint8_t *d = gif_blocks(&p, end, &n);
+    if ((size_t) w * h > npx) {
+      free(d);
+      return -1;
+    }
+    memset(g->idx, 0, (size_t) w * h);
+    if (!lzw_decode(d, n, min_size, g->idx, (size_t) w * h)) {
+      free(d);
+      return -1;
+    }
+    free(d);
+
+    if (disposal == 3) memcpy(g->saved, g->canvas, npx * 4);
+    static const int pass_start[] = { 0, 4, 2, 1 }, pass_step[] = { 8, 8, 4, 2 };
+    int row = 0;
+    for (int pass = 0; pass < ((flags & 0x40) ? 4 : 1); pass++) {
+      int start = (flags & 0x40) ? pass_start[pass] : 0, step = (flags & 0x40) ? pass_step[pass] : 1;
+      for (int y = start; y < h; y += step, row++) {
+        if (y0 + y >= sh) continue;
+        const uint8_t *src = g->idx + (size_t) row * w;
+        uint32_t *dst = g->canvas + (size_t) (y0 + y) * sw + x0;
+        for (int x = 0; x < w && x0 + x < sw; x++) {
+          if (src[x] != transp && src[x] < ct_n) dst[x] = rgb(ct + 3 * src[x]);
+        }
+      }
+    }
+
+    for (size_t i = 0; i < npx; i++) g->frame[i] = rgb565(g->canvas[i]);
+    if (cb) cb(g, delay < 2 ? 100 : (uint16_t) (delay * 10), ctx);
+    frames++;
+
+    if (disposal == 2) {
+      for (int y = y0; y < y0 + h && y < sh; y++) {
+        for (int x = x0; x < x0 + w && x < sw; x++) g->canvas[(size_t) y * sw + x] = g->bg;
+      }
+    } else if (disposal == 3) {
+      memcpy(g->canvas, g->saved, npx * 4);
+    }
+    disposal = 0;
+    transp = -1;
+    delay = 0;
+  }
+  return frames;
+}
+
+/******************************************************************************
+ * Encoding
+ ******************************************************************************/
+typedef struct {
+  int key_every;
+  uint16_t *prev;
+  uint8_t *key, *delta;   // scratch records
+  uint8_t *out;           // all records
+  size_t out_len, out_cap;
+  anim_frame_t *index;
+  int frames, keys;
+  uint32_t max_frame;
+} enc_t;
+
+static void encode_frame(gif_t *g, uint16_t delay_ms, void *ctx) {
+  enc_t *e = (enc_t *) ctx;
+  uint32_t npx = (uint32_t) g->w * g->h;
+  if (!e->prev) {
+    e->prev = (uint16_t *) malloc(npx * 2);
+    e->key = (uint8_t *) malloc(ANIM_FRAME_BOUND(npx));
+    e->delta = (uint8_t *) malloc(ANIM_FRAME_BOUND(npx));
+  }
+
+  size_t kn = anim_encode_frame(g->frame, NULL, npx, e->key), dn = kn;
+  int keyed = e->frames == 0 || (e->key_every > 0 && e->frames % e->key_every == 0);
+  if (!keyed) {
+    dn = anim_encode_frame(g->frame, e->prev, npx, e->delta);
+    keyed = kn <= dn;
+  }
+  const uint8_t *rec = keyed ? e->key : e->delta;
+  size_t n = keyed ? kn : dn;
+
+  if (e->out_len + n > e->out_cap) {
+    e->out_cap = (e->out_len + n) * 2;
+    e->out = (uint8_t *) realloc(e->out, e->out_cap);
+  }
+  e->index = (anim_frame_t *) realloc(e->index, (size_t) (e->frames + 1) * sizeof(anim_frame_t));
+  anim_frame_t *f = &e->index[e->frames++];
+  f->offset = (uint32_t) e->out_len;  // relative until written
+  f->size = (uint32_t) n;
+  f->delay_ms = delay_ms;
+  f->flags = keyed ? ANIM_FRAME_KEY : 0;
+  memcpy(e->out + e->out_len, rec, n);
+  e->out_len += n;
+  e->keys += keyed;
+  if (n > e->max_frame) e->max_frame = (uint32_t) n;
+  memcpy(e->prev, g->frame, npx * 2);
+}
+
+static double now_ms(void) {
+  return (double) clock() * 1000.0 / CLOCKS_PER_SEC;
+}
+
+int main(int argc, char *argv[]) {
+  int key_every = 0, a = 1;
+  uint32_t bg = 0;
+  for (; a + 1 < argc && argv[a][0] == '-'; a += 2) {
+    if (!strcmp(argv[a], "-k")) key_every = atoi(argv[a + 1]);
+    else if (!strcmp(argv[a], "-b")) bg = (uint32_t) strtoul(argv[a + 1], NULL, 16) & 0xFFFFFF;
+    else break;
+  }
+  if (argc - a != 2) {
+    fprintf(stderr, "usage: %s [-k interval] [-b rrggbb] anim.gif anim.wsa\n", argv[0]);
+    return 2;
+  }
+  size_t len;
+  uint8_t *src = read_file(argv[a], &len);
+  if (!src) {
+    fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[a]);
+    return 1;
+  }
+
+  gif_t g;
+  memset(&g, 0, sizeof(g));
+  g.bg = bg;
+  enc_t e;
+  memset(&e, 0, sizeof(e));
+  e.key_every = key_every;
+  int frames = gif_decode(&g, src, len, encode_frame, &e);
+  if (frames <= 0 || frames > 0xFFFF) {
+    fprintf(stderr, "%s: %s is not a GIF this tool can read\n", argv[0], argv[a]);
+    return 1;
+  }
+
+  anim_header_t h;
+  h.w = g.w;
+  h.h = g.h;
+  h.frames = (uint16_t) frames;
+  h.loops = g.loops;
+  h.max_frame = e.max_frame;
+  size_t base = ANIM_HEADER_SIZE + (size_t) frames * ANIM_FRAME_SIZE;
+  uint8_t *head = (uint8_t *) malloc(base);
+  anim_write_header(head, &h);
+  for (int i = 0; i < frames; i++) {
+    e.index[i].offset += (uint32_t) base;
+    anim_write_frame(head + ANIM_HEADER_SIZE + (size_t) i * ANIM_FRAME_SIZE, &e.index[i]);
+  }
+  FILE *f = fopen(argv[a + 1], "wb");
+  if (!f || fwrite(head, 1, base, f) != base || fwrite(e.out, 1, e.out_len, f) != e.out_len) {
+    fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[a + 1]);
+    return 1;
+  }
+  fclose(f);
+
+  // Per-frame decode cost, each path repeated for at least 200 ms
+  const uint32_t npx = (uint32_t) g.w * g.h;
+  int gif_frames = 0, wsa_frames = 0;
+  double t0 = now_ms(), gif_ms, wsa_ms;
+  do gif_frames += gif_decode(&g, src, len, NULL, NULL);
+  while ((gif_ms = now_ms() - t0) < 200);
+  t0 = now_ms();
+  do {
+    for (int i = 0; i < frames; i++) {
+      if (!anim_decode_frame(e.out + e.index[i].offset - base, e.index[i].size, e.prev, npx, 0)) {
+        fprintf(stderr, "%s: frame %d does not decode\n", argv[0], i);
+        return 1;
+      }
+    }
+    wsa_frames += frames;
+  } while ((wsa_ms = now_ms() - t0) < 200);
+
+  fprintf(stderr, "%s: %dx%d, %d frames (%d key), %lu -> %lu bytes, largest frame %lu; "
+          "decode per frame: gif %.3f ms, wsa %.3f ms\n", argv[a], g.w, g.h, frames, e.keys,
+          (unsigned long) len, (unsigned long) (base + e.out_len), (unsigned long) e.max_frame,
+          gif_ms / gif_frames, wsa_ms / wsa_frames);
+  return 0;
+}
@@ -0,0 +1,495 @@
+// Host-side test of the image loader (websocket/img_loader.cpp): decoded
+// output compared pixel for pixel with reference bitmaps, built against
+// tools/mock.
+//
+//   c++ -O2 -I../mock -I../../websocket -o imgload imgload.cpp ../mock/mock.cpp ../../websocket/img_loader.cpp
+//   ./imgload [-v]
+//
+// Every image is generated from one pattern (a gradient, with holes of
+// transparency where a test wants them) and the reference is that pattern
+// in the layout LVGL draws: RGB565 per pixel, plus an alpha byte for
+// LV_IMG_CF_TRUE_COLOR_ALPHA. The card and the app bundle are in memory.
+// In place of the PNG/JPEG decoders there is one that hands out the
+// pattern as a PNG decoder does (the whole frame, always with alpha) or as
+// a JPEG one does (line by line, no alpha).
+// .bin tests check the header and the pixel data, from SD and from the
+// bundle (which shadows SD), and that damaged or truncated files are
+// refused. Decoder tests check the alpha byte is dropped exactly when every
+// pixel is opaque, line-by-line reads, which drive ("S:" or "B:") a file
+// is opened through, and errors. Sharing checks one decode per path until
+// the file changes. Exits 1 if any test fails.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <map>
+#include "Arduino.h"
+#include "SD_MMC.h"
+#include "img_loader.h"
+#include "bundle.h"
+
+static int g_verbose = 0;
+static int g_failed = 0;
+
+/******************************************************************************
+ * Pattern and reference bitmaps
+ ******************************************************************************/
+typedef struct {
+  uint8_t r, g, b, a;
+} argb_t;
+
+// Pixel x,y of a w x h image; `holes` makes every 7th pixel see-through
+static argb_t pattern(uint32_t x, uint32_t y, uint32_t w, uint32_t h, bool holes) {
+  argb_t p;
+  p.r = (uint8_t)(x * 255 / (w > 1 ? w - 1 : 1));
+  p.g = (uint8_t)(y * 255 / (h > 1 ? h - 1 : 1));
+  p.b = (uint8_t)((x * 13 + y * 7) & 0xff);
+  p.a = holes && (x + y * w) % 7 == 3 ? (uint8_t)((x * 37) & 0x7f) : LV_OPA_COVER;
+  return p;
+}
+
+// The pattern as LVGL draws it: `px` bytes a pixel, alpha last if px is 3
+static uint8_t *reference(uint32_t w, uint32_t h, bool holes, size_t px, size_t *size) {
+  *size = (size_t)w * h * px;
+  uint8_t *buf = (uint8_t *)malloc(*size);
+  for (uint32_t y = 0; y < h; y++) {
+    for (uint32_t x = 0; x < w; x++) {
+      argb_t p = pattern(x, y, w, h, holes);
+      lv_color_t c = lv_color_make(p.r, p.g, p.b);
+      uint8_t *d = buf + ((size_t)y * w + x) * px;
+      memcpy(d, &c, sizeof(c));
+      if (px == LV_IMG_PX_SIZE_ALPHA_BYTE) d[2] = p.a;
+    }
+  }
+  return buf;
+}
+
+// Any other colour format: bytes that only depend on their position
+static void fill_bytes(uint8_t *buf, size_t n, uint8_t seed) {
+  for (size_t i = 0; i < n; i++) buf[i] = (uint8_t)(i * 31 + seed);
+}
+
+// An LVGL .bin: header, then `size` bytes of pixel data
+static std::string bin_file(lv_img_cf_t cf, uint32_t w, uint32_t h, const uint8_t *data, size_t size) {
+  lv_img_header_t hd;
+  memset(&hd, 0, sizeof(hd));
+  hd.cf = cf;
+  hd.w = w;
+  hd.h = h;
+  std::string f((const char *)&hd, sizeof(hd));
+  f.append((const char *)data, size);
+  return f;
+}
+
+static bool same(const lv_img_dsc_t *d, lv_img_cf_t cf, uint32_t w, uint32_t h, const uint8_t *ref, size_t size) {
+  bool ok = d->header.cf == cf && d->header.w == w && d->header.h == h && d->data_size == size && d->data &&
+            memcmp(d->data, ref, size) == 0;
+  if (!ok && g_verbose) {
+    printf("  got cf %u %ux%u, %u bytes; reference cf %u %ux%u, %u bytes\n", (unsigned)d->header.cf,
+           (unsigned)d->header.w, (unsigned)d->header.h, (unsigned)d->data_size, (unsigned)cf, (unsigned)w,
+           (unsigned)h, (unsigned)size);
+    for (size_t i = 0; d->data && d->data_size == size && i < size; i++) {
+      if (d->data[i] == ref[i]) continue;
+      printf("  first difference at byte %u: %02x, reference %02x\n", (unsigned)i, d->data[i], ref[i]);
+      break;
+    }
+  }
+  return ok;
+}
+
+static bool printed(const char *msg) {
+  bool ok = strstr(mock_serial_text(), msg) != NULL;
+  if (!ok && g_verbose) printf("  printed \"%s\", wanted \"%s\"\n", mock_serial_text(), msg);
+  return ok;
+}
+
+/******************************************************************************
+ * App bundle
+ ******************************************************************************/
+typedef struct {
+  bundle_entry_t entry;
+  std::string data;
+} fake_bundle_file_t;
+
+static std::map<std::string, fake_bundle_file_t> g_bundle;
+
+static void bundle_put(const char *path, const std::string &data, uint32_t crc) {
+  fake_bundle_file_t &f = g_bundle[path];
+  memset(&f.entry, 0, sizeof(f.entry));
+  f.entry.size = f.entry.raw_size = (uint32_t)data.size();
+  f.entry.crc = crc;
+  f.data = data;
+}
+
+const bundle_entry_t *bundle_find(const char *path) {
+  std::map<std::string, fake_bundle_file_t>::iterator it = g_bundle.find(path);
+  return it == g_bundle.end() ? NULL : &it->second.entry;
+}
+
+uint8_t *bundle_load(const bundle_entry_t *e) {
+  for (std::map<std::string, fake_bundle_file_t>::iterator it = g_bundle.begin(); it != g_bundle.end(); ++it) {
+    if (&it->second.entry != e) continue;
+    uint8_t *buf = (uint8_t *)malloc(e->raw_size + 1);
+    memcpy(buf, it->second.data.data(), e->raw_size);
+    buf[e->raw_size] = 0;
+    return buf;
+  }
+  return NULL;
+}
+
+/******************************************************************************
+ * Decoder
+ ******************************************************************************/
+typedef struct {
+  uint32_t w, h;
+  bool holes;
+  bool lines;         // JPEG-like: read_line, no alpha; else PNG-like
+  lv_img_cf_t cf;     // what it claims to produce, 0 = the usual
+  int fail_row;       // read_line fails here, -1 = never
+  uint8_t *frame;
+} fake_image_t;
+
+static std::map<std::string, fake_image_t> g_images;  // by SD path
+static std::string g_last_src;
+static int g_opens, g_closes, g_lines;
+
+static void image_put(const char *path, uint32_t w, uint32_t h, bool holes, bool lines) {
+  fake_image_t &im = g_images[path];
+  memset(&im, 0, sizeof(im));
+  im.w = w, im.h = h, im.holes = holes, im.lines = lines, im.fail_row = -1;
+  mock_sd_put(path, "img", 3, 1000);  // the loader checks the file's version
+}
+
+lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t *dsc, const void *src, lv_color_t color, int32_t frame_id) {
+  (void)color;
+  (void)frame_id;
+  g_last_src = (const char *)src;
+  if (g_last_src.size() < 3) return LV_RES_INV;
+  std::map<std::string, fake_image_t>::iterator it = g_images.find(g_last_src.substr(2));
+  if (it == g_images.end()) return LV_RES_INV;
+  fake_image_t &im = it->second;
+  g_opens++;
+  memset(dsc, 0, sizeof(*dsc));
+  dsc->header.cf = im.cf ? im.cf : im.lines ? LV_IMG_CF_TRUE_COLOR : LV_IMG_CF_TRUE_COLOR_ALPHA;
+  dsc->header.w = im.w;
+  dsc->header.h = im.h;
+  dsc->user_data = &im;
+  if (!im.lines) {
+    size_t size;
+    im.frame = reference(im.w, im.h, im.holes, LV_IMG_PX_SIZE_ALPHA_BYTE, &size);
+    dsc->img_data = im.frame;
+  }
+  return LV_RES_OK;
+}
+
+lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t *dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                                  uint8_t *buf) {
+  fake_image_t *im = (fake_image_t *)dsc->user_data;
+  if (y == im->fail_row || x != 0 || (uint32_t)len != im->w) return LV_RES_INV;
+  g_lines++;
+  for (lv_coord_t i = 0; i < len; i++) {
+    argb_t p = pattern((uint32_t)i, (uint32_t)y, im->w, im->h, false);
+    lv_color_t c = lv_color_make(p.r, p.g, p.b);
+    memcpy(buf + i * sizeof(c), &c, sizeof(c));
+  }
+  return LV_RES_OK;
+}
+
+void lv_img_decoder_close(lv_img_decoder_dsc_t *dsc) {
+  fake_image_t *im = (fake_image_t *)dsc->user_data;
+  free(im->frame);
+  im->frame = NULL;
+  g_closes++;
+}
+
+/******************************************************************************
+ * The rest of LVGL the loader calls
+ ******************************************************************************/
+void lv_img_cache_invalidate_src(const void *src) {
+  (void)src;
+}
+
+lv_img_src_t lv_img_src_get_type(const void *src) {
+  (void)src;
+  return LV_IMG_SRC_VARIABLE;
+}
+
+const void *lv_img_get_src(lv_obj_t *obj) {
+  (void)obj;
+  return NULL;
+}
+
+void lv_img_set_src(lv_obj_t *obj, const void *src) {
+  (void)obj;
+  (void)src;
+}
+
+bool lv_obj_remove_event_cb_with_user_data(lv_obj_t *obj, lv_event_cb_t cb, const void *user_data) {
+  (void)obj;
+  (void)cb;
+  (void)user_data;
+  return false;
+}
+
+void lv_obj_add_event_cb(lv_obj_t *obj, lv_event_cb_t cb, lv_event_code_t code, void *user_data) {
+  (void)obj;
+  (void)cb;
+  (void)code;
+  (void)user_data;
+}
+
+void *lv_event_get_user_data(lv_event_t *e) {
+  (void)e;
+  return NULL;
+}
+
+/******************************************************************************
+ * .bin tests
+ ******************************************************************************/
+static bool test_bin_color(void) {
+  // Odd width: rows are not padded
+  const uint32_t w = 37, h = 5;
+  size_t size;
+  uint8_t *ref = reference(w, h, false, sizeof(lv_color_t), &size);
+  std::string f = bin_file(LV_IMG_CF_TRUE_COLOR, w, h, ref, size);
+  mock_sd_put("/grad.bin", f.data(), f.size(), 1);
+  lv_img_dsc_t d;
+  bool ok = img_decode("/grad.bin", &d) && same(&d, LV_IMG_CF_TRUE_COLOR, w, h, ref, size);
+  if (ok) free((void *)d.data);
+  free(ref);
+  return ok;
+}
+
+static bool test_bin_formats(void) {
+  // Each format is loaded as is, with the size lv_img_buf.c gives it
+  static const lv_img_cf_t cfs[] = { LV_IMG_CF_TRUE_COLOR_ALPHA, LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED,
+                                     LV_IMG_CF_INDEXED_1BIT, LV_IMG_CF_INDEXED_4BIT, LV_IMG_CF_INDEXED_8BIT,
+                                     LV_IMG_CF_ALPHA_2BIT, LV_IMG_CF_ALPHA_8BIT };
+  bool ok = true;
+  for (size_t i = 0; i < sizeof(cfs) / sizeof(cfs[0]); i++) {
+    const uint32_t w = 21, h = 9;
+    size_t size = lv_img_buf_get_img_size(w, h, cfs[i]);
+    uint8_t *ref = (uint8_t *)malloc(size);
+    fill_bytes(ref, size, (uint8_t)i);
+    // Trailing bytes past the image are ignored
+    std::string f = bin_file(cfs[i], w, h, ref, size) + "junk";
+    mock_sd_put("/fmt.bin", f.data(), f.size(), 1);
+    lv_img_dsc_t d;
+    bool one = img_decode("/fmt.bin", &d) && same(&d, cfs[i], w, h, ref, size);
+    if (!one && g_verbose) printf("  colour format %u\n", (unsigned)cfs[i]);
+    if (one) free((void *)d.data);
+    ok = ok && one;
+    free(ref);
+  }
+  return ok;
+}
+
+static bool test_bin_bundle(void) {
+  const uint32_t w = 16, h = 16;
+  size_t size;
+  uint8_t *ref = reference(w, h, true, LV_IMG_PX_SIZE_ALPHA_BYTE, &size);
+  // A different image of the same name on SD: the bundle's wins, and SD is
+  // not touched
+  uint8_t *other = reference(w, h, false, LV_IMG_PX_SIZE_ALPHA_BYTE, &size);
+  std::string sd = bin_file(LV_IMG_CF_TRUE_COLOR_ALPHA, w, h, other, size);
+  mock_sd_put("/logo.bin", sd.data(), sd.size(), 1);
+  bundle_put("/logo.bin", bin_file(LV_IMG_CF_TRUE_COLOR_ALPHA, w, h, ref, size), 0x1234);
+  int opens = mock_sd_opens;
+  lv_img_dsc_t d;
+  bool ok = img_decode("/logo.bin", &d) && same(&d, LV_IMG_CF_TRUE_COLOR_ALPHA, w, h, ref, size);
+  ok = ok && mock_sd_opens == opens;
+  if (ok) free((void *)d.data);
+  g_bundle.erase("/logo.bin");
+  free(ref);
+  free(other);
+  return ok;
+}
+
+static bool test_bin_refused(void) {
+  const uint32_t w = 8, h = 4;
+  size_t size;
+  uint8_t *ref = reference(w, h, false, sizeof(lv_color_t), &size);
+  lv_img_dsc_t d;
+  bool ok = true;
+
+  std::string f = bin_file(LV_IMG_CF_TRUE_COLOR, w, h, ref, size - 1);
+  mock_sd_put("/bad.bin", f.data(), f.size(), 1);
+  mock_serial_clear();
+  ok = ok && !img_decode("/bad.bin", &d) && printed("is truncated (63 of 64 data bytes)");
+
+  f = bin_file(LV_IMG_CF_RAW, w, h, ref, size);  // not a format .bin files have
+  mock_sd_put("/bad.bin", f.data(), f.size(), 1);
+  mock_serial_clear();
+  ok = ok && !img_decode("/bad.bin", &d) && printed("is not an LVGL image file");
+
+  f = bin_file(LV_IMG_CF_TRUE_COLOR, 0, h, ref, size);
+  mock_sd_put("/bad.bin", f.data(), f.size(), 1);
+  ok = ok && !img_decode("/bad.bin", &d);
+
+  f = bin_file(LV_IMG_CF_TRUE_COLOR, w, h, ref, size);
+  f[0] = (char)(f[0] | 0xe0);  // always_zero set: a PNG or some other file renamed
+  mock_sd_put("/bad.bin", f.data(), f.size(), 1);
+  ok = ok && !img_decode("/bad.bin", &d);
+
+  mock_sd_put("/bad.bin", "ab", 2, 1);
+  ok = ok && !img_decode("/bad.bin", &d);
+
+  mock_serial_clear();
+  ok = ok && !img_decode("/missing.bin", &d) && printed("cannot open /missing.bin");
+
+  bundle_put("/bad.bin", bin_file(LV_IMG_CF_TRUE_COLOR, w, h, ref, size - 2), 1);
+  mock_serial_clear();
+  ok = ok && !img_decode("/bad.bin", &d) && printed("is not a complete LVGL image file");
+  g_bundle.erase("/bad.bin");
+
+  free(ref);
+  return ok;
+}
+
+/******************************************************************************
+ * Decoder tests
+ ******************************************************************************/
+static bool test_png_opaque(void) {
+  // Every pixel opaque: the alpha byte is dropped
+  const uint32_t w = 33, h = 7;
+  image_put("/photo.png", w, h, false, false);
+  size_t size;
+  uint8_t *ref = reference(w, h, false, sizeof(lv_color_t), &size);
+  lv_img_dsc_t d;
+  bool ok = img_decode("/photo.png", &d) && same(&d, LV_IMG_CF_TRUE_COLOR, w, h, ref, size);
+  if (ok) free((void *)d.data);
+  free(ref);
+  return ok && g_opens == g_closes;
+}
+
+static bool test_png_alpha(void) {
+  const uint32_t w = 33, h = 7;
+  image_put("/icon.png", w, h, true, false);
+  size_t size;
+  uint8_t *ref = reference(w, h, true, LV_IMG_PX_SIZE_ALPHA_BYTE, &size);
+  lv_img_dsc_t d;
+  bool ok = img_decode("/icon.png", &d) && same(&d, LV_IMG_CF_TRUE_COLOR_ALPHA, w, h, ref, size);
+  if (ok) free((void *)d.data);
+  free(ref);
+  return ok && g_opens == g_closes;
+}
+
+static bool test_jpeg_lines(void) {
+  const uint32_t w = 50, h = 11;
+  image_put("/view.jpg", w, h, false, true);
+  size_t size;
+  uint8_t *ref = reference(w, h, false, sizeof(lv_color_t), &size);
+  int lines = g_lines;
+  lv_img_dsc_t d;
+  bool ok = img_decode("/view.jpg", &d) && same(&d, LV_IMG_CF_TRUE_COLOR, w, h, ref, size);
+  ok = ok && g_lines - lines == (int)h;
+  if (ok) free((void *)d.data);
+  free(ref);
+  return ok && g_opens == g_closes;
+}
+
+static bool test_drives(void) {
+  image_put("/a.png", 4, 4, false, false);
+  lv_img_dsc_t d;
+  bool ok = img_decode("/a.png", &d) && g_last_src == "S:/a.png";
+  if (ok) free((void *)d.data);
+  // A bundle entry of the same name goes through the bundle's drive
+  bundle_put("/a.png", "png", 7);
+  ok = ok && img_decode("/a.png", &d) && g_last_src == "B:/a.png";
+  if (ok) free((void *)d.data);
+  g_bundle.erase("/a.png");
+  return ok;
+}
+
+static bool test_decoder_errors(void) {
+  lv_img_dsc_t d;
+  mock_serial_clear();
+  bool ok = !img_decode("/nothing.png", &d) && printed("no decoder could open /nothing.png");
+
+  image_put("/mask.png", 8, 8, false, false);
+  g_images["/mask.png"].cf = LV_IMG_CF_ALPHA_8BIT;
+  mock_serial_clear();
+  ok = ok && !img_decode("/mask.png", &d) && printed("decodes to unsupported format 14");
+
+  image_put("/cut.jpg", 8, 8, false, true);
+  g_images["/cut.jpg"].fail_row = 5;
+  mock_serial_clear();
+  ok = ok && !img_decode("/cut.jpg", &d) && printed("cannot decode /cut.jpg (8x8)");
+  return ok && g_opens == g_closes;
+}
+
+/******************************************************************************
+ * Sharing
+ ******************************************************************************/
+static bool test_shared(void) {
+  img_cache_stats_t s0, s;
+  img_cache_get_stats(&s0);
+  image_put("/bg.png", 20, 10, true, false);
+  int opens = g_opens;
+  const lv_img_dsc_t *a = img_acquire("/bg.png");
+  const lv_img_dsc_t *b = img_acquire("/bg.png");
+  bool ok = a && a == b && g_opens - opens == 1;
+  size_t size;
+  uint8_t *ref = reference(20, 10, true, LV_IMG_PX_SIZE_ALPHA_BYTE, &size);
+  ok = ok && same(a, LV_IMG_CF_TRUE_COLOR_ALPHA, 20, 10, ref, size);
+  free(ref);
+
+  // Replaced on the card while shown: the next caller gets a fresh decode
+  mock_sd_put("/bg.png", "img2", 4, 2000);
+  g_images["/bg.png"].holes = false;
+  const lv_img_dsc_t *c = img_acquire("/bg.png");
+  ref = reference(20, 10, false, sizeof(lv_color_t), &size);
+  ok = ok && c && c != a && g_opens - opens == 2 && same(c, LV_IMG_CF_TRUE_COLOR, 20, 10, ref, size);
+  free(ref);
+
+  img_cache_get_stats(&s);
+  ok = ok && s.misses - s0.misses == 2 && s.hits - s0.hits == 1 && s.entries - s0.entries == 2;
+  img_release(a);
+  img_release(b);  // the old version goes with its last user
+  img_release(c);  // the new one stays cached
+  img_cache_get_stats(&s);
+  ok = ok && s.entries - s0.entries == 1 && s.in_use == s0.in_use;
+  return ok;
+}
+
+typedef struct {
+  const char *name;
+  bool (*run)(void);
+} test_t;
+
+static const test_t g_tests[] = {
+  { "bin color", test_bin_color },
+  { "bin formats", test_bin_formats },
+  { "bin bundle", test_bin_bundle },
+  { "bin refused", test_bin_refused },
+  { "png opaque", test_png_opaque },
+  { "png alpha", test_png_alpha },
+  { "jpeg lines", test_jpeg_lines },
+  { "drives", test_drives },
+  { "decoder errors", test_decoder_errors },
+  { "shared", test_shared },
+};
+
+int main(int argc, char *argv[]) {
+  for (int a = 1; a < argc; a++) {
+    if (!strcmp(argv[a], "-v")) {
+      g_verbose = 1;
+    } else {
+      fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+      return 2;
+    }
+  }
+  mock_serial_quiet = !g_verbose;
+
+  for (size_t i = 0; i < sizeof(g_tests) / sizeof(g_tests[0]); i++) {
+    bool ok = g_tests[i].run();
+    printf("%-18s %s\n", g_tests[i].name, ok ? "ok" : "FAIL");
+    if (!ok) g_failed++;
+  }
+  img_cache_stats_t s;
+  img_cache_get_stats(&s);
+  fprintf(stderr, "%d decoder opens, %d closes, %lu cached bytes, %d failed\n", g_opens, g_closes,
+          (unsigned long)s.bytes, g_failed);
+  return g_failed ? 1 : 0;
+}
@@ -0,0 +1,271 @@
+// Host-side test of the typed bridges (websocket/js_bind.h): arguments as
+// scripts pass them, converted to C++ parameters, built against tools/mock
+// and the real Elk.
+//
+//   c++ -O2 -I../mock -I../../websocket -o jsbind jsbind.cpp ../mock/mock.cpp -x c ../../websocket/elk.c
+//   ./jsbind [-v]
+//
+// Each test registers a few JS_BIND bridges and evaluates calls to them:
+// numbers and enums, booleans given as numbers, strings read in place from
+// the Elk arena, return values (Strings copied into the arena), too few or mistyped arguments (the
+// function must not run, and the message must name the argument), and a
+// handle type added by specialising js_arg the way lvgl_elk.h adds
+// lv_obj_t *. Exits 1 if any test fails.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arduino.h"
+#include "js_bind.h"
+
+static int g_verbose = 0;
+static int g_failed = 0;
+
+/******************************************************************************
+ * Bridges
+ ******************************************************************************/
+enum fake_align_t { FAKE_ALIGN_LEFT = 1, FAKE_ALIGN_RIGHT = 3 };
+
+static int g_calls = 0;
+static double g_got[4];
+static const char *g_got_str;
+
+JS_BIND_FN(void, set_num, int a, double b, uint8_t c, int16_t d) {
+  g_calls++;
+  g_got[0] = a, g_got[1] = b, g_got[2] = c, g_got[3] = d;
+}
+
+JS_BIND_FN(void, set_align, fake_align_t align) {
+  g_calls++;
+  g_got[0] = align;
+}
+
+JS_BIND_FN(void, set_flag, bool on) {
+  g_calls++;
+  g_got[0] = on;
+}
+
+JS_BIND_FN(void, set_text, int id, const char *text) {
+  g_calls++;
+  g_got[0] = id;
+  g_got_str = text;
+}
+
+JS_BIND_FN(int, add, int a, int b) {
+  g_calls++;
+  return a + b;
+}
+
+JS_BIND_FN(bool, is_even, int a) {
+  g_calls++;
+  return a % 2 == 0;
+}
+
+JS_BIND_FN(const char *, name_of, int id) {
+  g_calls++;
+  return id == 1 ? "one" : NULL;
+}
+
+// Built on the fly, as the HTTP bridges build their payloads
+JS_BIND_FN(String, greet, const char *who) {
+  g_calls++;
+  return String("hello ") + who;
+}
+
+// A handle type, converted the way lvgl_elk.h converts lv_obj_t *
+typedef struct {
+  int x;
+} fake_obj_t;
+
+static fake_obj_t g_objs[2] = { { 10 }, { 20 } };
+static int g_handle_lookups = 0;
+
+template<>
+struct js_arg<fake_obj_t *> {
+  static const char *what() { return "object handle"; }
+  static bool get(struct js *js, jsval_t v, fake_obj_t *&out) {
+    g_handle_lookups++;
+    if (js_type(v) != JS_NUM) return false;
+    int id = (int)js_getnum(v);
+    out = id >= 0 && id < 2 ? &g_objs[id] : NULL;
+    return out != NULL;
+  }
+};
+
+JS_BIND_FN(int, obj_move, fake_obj_t *obj, fake_obj_t *to, int dx) {
+  g_calls++;
+  obj->x = to->x + dx;
+  return obj->x;
+}
+
+/******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static char g_mem[8192];
+static struct js *g_js;
+
+static void reset_js(void) {
+  g_js = js_create(g_mem, sizeof(g_mem));
+  jsval_t glob = js_glob(g_js);
+  js_set(g_js, glob, "set_num", js_mkfun(JS_BIND(set_num)));
+  js_set(g_js, glob, "set_align", js_mkfun(JS_BIND(set_align)));
+  js_set(g_js, glob, "set_flag", js_mkfun(JS_BIND(set_flag)));
+  js_set(g_js, glob, "set_text", js_mkfun(JS_BIND(set_text)));
+  js_set(g_js, glob, "add", js_mkfun(JS_BIND(add)));
+  js_set(g_js, glob, "is_even", js_mkfun(JS_BIND(is_even)));
+  js_set(g_js, glob, "name_of", js_mkfun(JS_BIND(name_of)));
+  js_set(g_js, glob, "greet", js_mkfun(JS_BIND(greet)));
+  js_set(g_js, glob, "obj_move", js_mkfun(JS_BIND(obj_move)));
+  g_calls = 0;
+  mock_serial_clear();
+}
+
+static jsval_t eval(const char *code) {
+  jsval_t v = js_eval(g_js, code, strlen(code));
+  if (js_type(v) == JS_ERR && g_verbose) printf("  %s: %s\n", code, js_str(g_js, v));
+  return v;
+}
+
+// The call was turned down: null, the function not run, `msg` printed
+static bool rejected(const char *code, const char *msg) {
+  int calls = g_calls;
+  mock_serial_clear();
+  bool ok = js_type(eval(code)) == JS_NULL && g_calls == calls && strstr(mock_serial_text(), msg) != NULL;
+  if (!ok && g_verbose) printf("  %s: printed \"%s\", wanted \"%s\"\n", code, mock_serial_text(), msg);
+  return ok;
+}
+
+/******************************************************************************
+ * Tests
+ ******************************************************************************/
+static bool test_numbers(void) {
+  reset_js();
+  bool ok = js_type(eval("set_num(-7, 2.5, 200, -300);")) == JS_NULL && g_calls == 1;
+  ok = ok && g_got[0] == -7 && g_got[1] == 2.5 && g_got[2] == 200 && g_got[3] == -300;
+  // Fractions are cut towards zero, as the hand-written casts did
+  eval("set_num(3.9, 0, 0, -2.7);");
+  ok = ok && g_calls == 2 && g_got[0] == 3 && g_got[3] == -2;
+  eval("set_align(3);");
+  ok = ok && g_calls == 3 && g_got[0] == FAKE_ALIGN_RIGHT;
+  return ok;
+}
+
+static bool test_bools(void) {
+  reset_js();
+  bool ok = true;
+  eval("set_flag(true);");
+  ok = ok && g_got[0] == 1;
+  eval("set_flag(false);");
+  ok = ok && g_got[0] == 0;
+  eval("set_flag(1);");
+  ok = ok && g_got[0] == 1;
+  eval("set_flag(0);");
+  ok = ok && g_got[0] == 0;
+  eval("set_flag(-1);");
+  ok = ok && g_got[0] == 1 && g_calls == 5;
+  ok = ok && rejected("set_flag('yes');", "set_flag: argument 1: expected boolean");
+  return ok;
+}
+
+static bool test_strings(void) {
+  reset_js();
+  eval("let label = 'hello world';");
+  bool ok = js_type(eval("set_text(4, label);")) == JS_NULL && g_calls == 1 && g_got[0] == 4;
+  // Read in place: the pointer is into the arena, NUL-terminated there
+  ok = ok && g_got_str && g_got_str > g_mem && g_got_str < g_mem + sizeof(g_mem);
+  ok = ok && !strcmp(g_got_str, "hello world");
+  eval("set_text(5, '');");
+  ok = ok && g_calls == 2 && g_got_str && g_got_str[0] == '\0';
+  ok = ok && rejected("set_text(4, 12);", "set_text: argument 2: expected string");
+  ok = ok && rejected("set_text(null, 'x');", "set_text: argument 1: expected number");
+  return ok;
+}
+
+static bool test_returns(void) {
+  reset_js();
+  jsval_t v = eval("add(2, 40);");
+  bool ok = js_type(v) == JS_NUM && js_getnum(v) == 42;
+  ok = ok && js_type(eval("is_even(4);")) == JS_TRUE && js_type(eval("is_even(3);")) == JS_FALSE;
+  v = eval("name_of(1);");
+  ok = ok && js_type(v) == JS_STR && !strcmp(js_str(g_js, v), "\"one\"");
+  ok = ok && js_type(eval("name_of(2);")) == JS_NULL;
+  // The String is gone once the bridge returns; the script keeps the copy
+  v = eval("let g = greet('elk'); g + '!';");
+  ok = ok && js_type(v) == JS_STR && !strcmp(js_getstr(g_js, v, NULL), "hello elk!");
+  // Results can be used in expressions
+  v = eval("add(add(1, 2), 3) * 2;");
+  ok = ok && js_type(v) == JS_NUM && js_getnum(v) == 12;
+  return ok && g_calls == 8;
+}
+
+static bool test_arity(void) {
+  reset_js();
+  bool ok = rejected("set_num(1, 2, 3);", "set_num: expects 4 arguments, got 3");
+  ok = ok && rejected("add();", "add: expects 2 arguments, got 0");
+  // Extra arguments are ignored
+  jsval_t v = eval("add(1, 2, 'x', 4);");
+  ok = ok && js_type(v) == JS_NUM && js_getnum(v) == 3;
+  return ok;
+}
+
+static bool test_mistyped(void) {
+  reset_js();
+  bool ok = rejected("set_num(1, 'two', 3, 4);", "set_num: argument 2: expected number");
+  ok = ok && rejected("set_num(1, 2, 3, true);", "set_num: argument 4: expected number");
+  ok = ok && rejected("add(1, undefined);", "add: argument 2: expected number");
+  // Only the first bad argument is reported
+  mock_serial_clear();
+  eval("add('a', 'b');");
+  ok = ok && strstr(mock_serial_text(), "argument 1") && !strstr(mock_serial_text(), "argument 2");
+  return ok;
+}
+
+static bool test_handles(void) {
+  reset_js();
+  g_objs[0].x = 10, g_objs[1].x = 20;
+  g_handle_lookups = 0;
+  jsval_t v = eval("obj_move(0, 1, 5);");
+  bool ok = js_type(v) == JS_NUM && js_getnum(v) == 25 && g_objs[0].x == 25 && g_handle_lookups == 2;
+  ok = ok && rejected("obj_move(0, 7, 5);", "obj_move: argument 2: expected object handle");
+  // Conversion stops at the first failure: the second handle is not looked up
+  g_handle_lookups = 0;
+  ok = ok && rejected("obj_move(9, 1, 5);", "obj_move: argument 1: expected object handle");
+  ok = ok && g_handle_lookups == 1 && g_objs[0].x == 25;
+  return ok;
+}
+
+typedef struct {
+  const char *name;
+  bool (*run)(void);
+} test_t;
+
+static const test_t g_tests[] = {
+  { "numbers", test_numbers },
+  { "bools", test_bools },
+  { "strings", test_strings },
+  { "returns", test_returns },
+  { "arity", test_arity },
+  { "mistyped", test_mistyped },
+  { "handles", test_handles },
+};
+
+int main(int argc, char *argv[]) {
+  for (int a = 1; a < argc; a++) {
+    if (!strcmp(argv[a], "-v")) {
+      g_verbose = 1;
+    } else {
+      fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+      return 2;
+    }
+  }
+  mock_serial_quiet = !g_verbose;
+
+  for (size_t i = 0; i < sizeof(g_tests) / sizeof(g_tests[0]); i++) {
+    bool ok = g_tests[i].run();
+    printf("%-18s %s\n", g_tests[i].name, ok ? "ok" : "FAIL");
+    if (!ok) g_failed++;
+  }
+  fprintf(stderr, "%d tests, %d failed\n", (int)(sizeof(g_tests) / sizeof(g_tests[0])), g_failed);
+  return g_failed ? 1 : 0;
+}
@@ -0,0 +1,69 @@
+// Host-side minifier for WebScreen scripts; same code the firmware runs at
+// boot (websocket/js_minify.c), so the result is byte-identical.
+//
+//   cc -O2 -I../../websocket -o jsmin jsmin.c ../../websocket/js_minify.c
+//   ./jsmin script.js script.min.js
+//
+// Copy both files to the SD card root. The firmware runs /script.min.js as
+// long as its header matches /script.js and regenerates it otherwise.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "js_minify.h"
+
+static char *read_file(const char *path, size_t *len) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  char *buf = (char *) malloc((size_t) n + 1);
+  if (buf && fread(buf, 1, (size_t) n, f) != (size_t) n) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  if (buf) buf[n] = '\0', *len = (size_t) n;
+  return buf;
+}
+
+int main(int argc, char *argv[]) {
+  if (argc < 2) {
+    fprintf(stderr, "usage: %s script.js [script.min.js]\n", argv[0]);
+    return 2;
+  }
+  size_t len;
+  char *src = read_file(argv[1], &len);
+  if (!src) {
+    fprintf(stderr, "%s: cannot read %s\n", argv[0], argv[1]);
+    return 1;
+  }
+
+  char *out = (char *) malloc(len + JS_MINIFY_HEADER_MAX + 1);
+  size_t hl = js_minify_header(src, len, out, JS_MINIFY_HEADER_MAX);
+  js_minify_stats_t st;
+  clock_t t0 = clock();
+  size_t n = js_minify(src, len, out + hl, len + 1, &st);
+  double ms = (double) (clock() - t0) * 1000.0 / CLOCKS_PER_SEC;
+  if (n == 0 && len > 0) {
+    fprintf(stderr, "%s: %s: unterminated string/comment or unbalanced braces\n", argv[0], argv[1]);
+    return 1;
+  }
+
+  FILE *f = argc > 2 ? fopen(argv[2], "wb") : stdout;
+  if (!f || fwrite(out, 1, hl + n, f) != hl + n) {
+    fprintf(stderr, "%s: cannot write %s\n", argv[0], argc > 2 ? argv[2] : "stdout");
+    return 1;
+  }
+  if (f != stdout) fclose(f);
+
+  fprintf(stderr, "%s: %lu -> %lu bytes (%.0f%%), %lu tokens, %lu locals renamed, "
+          "%lu constants inlined, %.2f ms\n", argv[1], (unsigned long) st.in_len,
+          (unsigned long) (hl + n), len ? 100.0 * (double) (hl + n) / (double) len : 0.0,
+          (unsigned long) st.tokens, (unsigned long) st.renamed, (unsigned long) st.inlined, ms);
+  free(out);
+  free(src);
+  return 0;
+}
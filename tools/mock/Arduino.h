@@ -0,0 +1,72 @@
+#pragma once
+
+// Host stand-in for <Arduino.h>, see mock.h
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdarg.h>
+#include <string>
+#include "mock.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define INPUT_PULLUP 0x05
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+#define LOW 0
+#define HIGH 1
+
+void pinMode(int pin, int mode);
+void digitalWrite(int pin, int level);
+int digitalRead(int pin);
+void attachInterrupt(int pin, void (*isr)(void), int mode);
+void detachInterrupt(int pin);
+void delay(uint32_t ms);
+uint32_t millis(void);
+uint32_t micros(void);
+
+#define constrain(v, lo, hi) ((v) < (lo) ? (lo) : ((v) > (hi) ? (hi) : (v)))
+
+// Only concatenation, as the firmware sources build paths
+class String {
+public:
+  String(const char *s = "") : s_(s) {}
+  String operator+(const char *s) const {
+    String r(*this);
+    r.s_ += s;
+    return r;
+  }
+  const char *c_str() const { return s_.c_str(); }
+  unsigned int length() const { return (unsigned int)s_.size(); }
+
+private:
+  std::string s_;
+};
+
+class HardwareSerial {
+public:
+  int printf(const char *fmt, ...) __attribute__((format(printf, 2, 3)));
+  void print(const char *s);
+  void println(const char *s = "");
+  void println(int v);
+};
+extern HardwareSerial Serial;
+
+// Set to silence Serial output
+extern int mock_serial_quiet;
+// Everything printed since the last mock_serial_clear(), for assertions
+const char *mock_serial_text(void);
+void mock_serial_clear(void);
+
+static inline void *ps_malloc(size_t n) {
+  return malloc(n);
+}
+static inline bool psramFound(void) {
+  return true;
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Host stand-in for the Arduino SD_MMC card: files live in memory and are
+// put there by the test. Only reading is supported.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+#define FILE_READ "r"
+
+// Create or replace `path` with a copy of `data`, last written at `mtime`
+void mock_sd_put(const char *path, const void *data, size_t len, time_t mtime);
+void mock_sd_remove(const char *path);
+// Files opened so far, to check what was read from the card
+extern int mock_sd_opens;
+
+struct mock_sd_file;
+
+class File {
+public:
+  File(const mock_sd_file *f = NULL) : f_(f), pos_(0) {}
+  operator bool() const { return f_ != NULL; }
+  size_t read(uint8_t *buf, size_t n);
+  size_t size() const;
+  time_t getLastWrite() const;
+  void close() { f_ = NULL; }
+
+private:
+  const mock_sd_file *f_;
+  size_t pos_;
+};
+
+class SDMMCFS {
+public:
+  File open(const char *path, const char *mode = FILE_READ);
+};
+
+extern SDMMCFS SD_MMC;
@@ -0,0 +1,47 @@
+#pragma once
+
+// Host stand-in for the Arduino SPI class. Only the plain SPI build of the
+// panel driver talks through it; the calls are accepted and dropped.
+
+#include <stdint.h>
+#include <stddef.h>
+
+#define SPI_MODE0 0
+#define MSBFIRST 1
+
+struct SPISettings {
+  SPISettings(uint32_t clock, uint8_t order, uint8_t mode) {
+    (void)clock;
+    (void)order;
+    (void)mode;
+  }
+};
+
+class SPIClass {
+public:
+  void begin(int sck, int miso, int mosi, int ss) {
+    (void)sck;
+    (void)miso;
+    (void)mosi;
+    (void)ss;
+  }
+  void setFrequency(uint32_t f) {
+    (void)f;
+  }
+  void beginTransaction(SPISettings s) {
+    (void)s;
+  }
+  void endTransaction() {}
+  void write(uint8_t v) {
+    (void)v;
+  }
+  void write16(uint16_t v) {
+    (void)v;
+  }
+  void writeBytes(const uint8_t *p, size_t n) {
+    (void)p;
+    (void)n;
+  }
+};
+
+extern SPIClass SPI;
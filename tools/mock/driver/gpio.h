@@ -0,0 +1,10 @@
+#pragma once
+
+#include "mock.h"
+
+typedef int gpio_num_t;
+
+static inline int gpio_set_level(gpio_num_t pin, uint32_t level) {
+  if (mock_gpio_hook) mock_gpio_hook(pin, (int)level);
+  return 0;
+}
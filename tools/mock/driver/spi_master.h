@@ -0,0 +1,108 @@
+#pragma once
+
+// Host stand-in for the ESP-IDF SPI master driver. The bus behind it lives
+// in mock.cpp: queued transactions wait in a FIFO and only go out when the
+// driver blocks for a result (or a test calls mock_spi_run()), so a host
+// test sees exactly which descriptors are in flight at any time.
+
+#include <stdint.h>
+#include <stddef.h>
+#include "esp_err.h"
+
+typedef enum { SPI1_HOST = 0, SPI2_HOST = 1, SPI3_HOST = 2 } spi_host_device_t;
+
+#define SPI_DMA_CH_AUTO 3
+
+#define SPICOMMON_BUSFLAG_MASTER (1 << 0)
+#define SPICOMMON_BUSFLAG_GPIO_PINS (1 << 2)
+#define SPICOMMON_BUSFLAG_QUAD (1 << 7)
+
+#define SPI_DEVICE_HALFDUPLEX (1 << 4)
+
+#define SPI_TRANS_MODE_DIO (1 << 0)
+#define SPI_TRANS_MODE_QIO (1 << 1)
+#define SPI_TRANS_USE_RXDATA (1 << 2)
+#define SPI_TRANS_USE_TXDATA (1 << 3)
+#define SPI_TRANS_MODE_DIOQIO_ADDR (1 << 4)
+#define SPI_TRANS_VARIABLE_CMD (1 << 5)
+#define SPI_TRANS_VARIABLE_ADDR (1 << 6)
+#define SPI_TRANS_VARIABLE_DUMMY (1 << 7)
+#define SPI_TRANS_MULTILINE_CMD (1 << 9)
+#define SPI_TRANS_MULTILINE_ADDR (1 << 11)
+
+typedef struct spi_transaction_t {
+  uint32_t flags;
+  uint16_t cmd;
+  uint64_t addr;
+  size_t length;    // bits
+  size_t rxlength;  // bits
+  void *user;
+  union {
+    const void *tx_buffer;
+    uint8_t tx_data[4];
+  };
+  union {
+    void *rx_buffer;
+    uint8_t rx_data[4];
+  };
+} spi_transaction_t;
+
+typedef struct {
+  spi_transaction_t base;
+  uint8_t command_bits;
+  uint8_t address_bits;
+  uint8_t dummy_bits;
+} spi_transaction_ext_t;
+
+typedef void (*transaction_cb_t)(spi_transaction_t *trans);
+
+typedef struct {
+  int data0_io_num;
+  int data1_io_num;
+  int sclk_io_num;
+  int data2_io_num;
+  int data3_io_num;
+  int max_transfer_sz;
+  uint32_t flags;
+} spi_bus_config_t;
+
+typedef struct {
+  uint8_t command_bits;
+  uint8_t address_bits;
+  uint8_t dummy_bits;
+  uint8_t mode;
+  int clock_speed_hz;
+  int spics_io_num;
+  uint32_t flags;
+  int queue_size;
+  transaction_cb_t pre_cb;
+  transaction_cb_t post_cb;
+} spi_device_interface_config_t;
+
+typedef struct mock_spi_dev *spi_device_handle_t;
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *cfg, int dma);
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *cfg,
+                             spi_device_handle_t *out);
+esp_err_t spi_device_queue_trans(spi_device_handle_t dev, spi_transaction_t *t, uint32_t ticks);
+esp_err_t spi_device_get_trans_result(spi_device_handle_t dev, spi_transaction_t **out, uint32_t ticks);
+esp_err_t spi_device_polling_transmit(spi_device_handle_t dev, spi_transaction_t *t);
+
+// The wire side: called for every transaction as it goes out, between the
+// device's pre_cb and post_cb. `queued` is false for polling transactions.
+typedef void (*mock_spi_wire_fn)(spi_transaction_t *t, bool queued);
+extern mock_spi_wire_fn mock_spi_wire_hook;
+
+typedef struct {
+  uint32_t queued;        // spi_device_queue_trans() calls
+  uint32_t polled;        // spi_device_polling_transmit() calls
+  uint32_t collected;     // results handed back
+  uint32_t max_inflight;  // most queued-but-uncollected at once
+  uint32_t errors;        // contract violations, also printed
+} mock_spi_stats_t;
+extern mock_spi_stats_t mock_spi_stats;
+
+// Send up to `n` waiting queued transactions; returns how many went out
+uint32_t mock_spi_run(uint32_t n);
+// Queued transactions not yet handed back
+uint32_t mock_spi_inflight(void);
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <stdlib.h>
+#include <stdint.h>
+
+#define MALLOC_CAP_8BIT (1 << 2)
+#define MALLOC_CAP_DMA (1 << 3)
+#define MALLOC_CAP_SPIRAM (1 << 10)
+#define MALLOC_CAP_INTERNAL (1 << 11)
+
+static inline void *heap_caps_malloc(size_t n, uint32_t caps) {
+  (void)caps;
+  return malloc(n);
+}
+static inline void *heap_caps_calloc(size_t n, size_t size, uint32_t caps) {
+  (void)caps;
+  return calloc(n, size);
+}
+static inline void *heap_caps_realloc(void *p, size_t n, uint32_t caps) {
+  (void)caps;
+  return realloc(p, n);
+}
+static inline void heap_caps_free(void *p) {
+  free(p);
+}
+static inline size_t heap_caps_get_free_size(uint32_t caps) {
+  return (caps & MALLOC_CAP_SPIRAM) ? 8u << 20 : 256u << 10;
+}
+static inline size_t heap_caps_get_largest_free_block(uint32_t caps) {
+  return heap_caps_get_free_size(caps) / 2;
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+#include <stdint.h>
+
+static inline void esp_rom_gpio_connect_in_signal(uint32_t gpio, uint32_t signal, bool inv) {
+  (void)gpio;
+  (void)signal;
+  (void)inv;
+}
@@ -0,0 +1,7 @@
+#pragma once
+
+#include "mock.h"
+
+static inline int64_t esp_timer_get_time(void) {
+  return mock_now_us;
+}
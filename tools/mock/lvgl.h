@@ -0,0 +1,319 @@
+#pragma once
+
+// Host stand-in for the parts of LVGL v8.3 that the host tests compile
+// against. Colours are RGB565 (LV_COLOR_DEPTH 16); the colour macros and
+// mixing functions follow lv_color.h so results match the library bit for
+// bit, in both byte orders (build with -DLV_COLOR_16_SWAP=1 for the
+// swapped one). Everything else is only declared as far as the firmware
+// sources need it to compile.
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#ifndef LV_COLOR_16_SWAP
+#define LV_COLOR_16_SWAP 0
+#endif
+#define LV_COLOR_DEPTH 16
+#define LV_COLOR_MIX_ROUND_OFS 128
+
+#define LV_ATTRIBUTE_FAST_MEM
+#define LV_UDIV255(x) (((x) * 0x8081U) >> 0x17)
+
+typedef uint8_t lv_opa_t;
+enum {
+  LV_OPA_TRANSP = 0,
+  LV_OPA_0 = 0,
+  LV_OPA_50 = 127,
+  LV_OPA_100 = 255,
+  LV_OPA_COVER = 255,
+};
+#define LV_OPA_MIN 2
+#define LV_OPA_MAX 253
+
+typedef union {
+  struct {
+#if LV_COLOR_16_SWAP == 0
+    uint16_t blue : 5;
+    uint16_t green : 6;
+    uint16_t red : 5;
+#else
+    uint16_t green_h : 3;
+    uint16_t red : 5;
+    uint16_t blue : 5;
+    uint16_t green_l : 3;
+#endif
+  } ch;
+  uint16_t full;
+} lv_color_t;
+
+#define LV_COLOR_SET_R(c, v) (c).ch.red = (uint8_t)((v)&0x1F)
+#define LV_COLOR_SET_B(c, v) (c).ch.blue = (uint8_t)((v)&0x1F)
+#define LV_COLOR_SET_A(c, v) \
+  do { \
+  } while (0)
+#define LV_COLOR_GET_R(c) (c).ch.red
+#define LV_COLOR_GET_B(c) (c).ch.blue
+#if LV_COLOR_16_SWAP == 0
+#define LV_COLOR_SET_G(c, v) (c).ch.green = (uint8_t)((v)&0x3F)
+#define LV_COLOR_GET_G(c) (c).ch.green
+#else
+#define LV_COLOR_SET_G(c, v) \
+  { \
+    (c).ch.green_h = (uint8_t)(((v) >> 3) & 0x7); \
+    (c).ch.green_l = (uint8_t)((v)&0x7); \
+  }
+#define LV_COLOR_GET_G(c) (((c).ch.green_h << 3) + (c).ch.green_l)
+#endif
+
+static inline lv_color_t lv_color_make(uint8_t r8, uint8_t g8, uint8_t b8) {
+  lv_color_t c;
+  c.full = 0;
+  LV_COLOR_SET_R(c, r8 >> 3);
+  LV_COLOR_SET_G(c, g8 >> 2);
+  LV_COLOR_SET_B(c, b8 >> 3);
+  return c;
+}
+
+static inline lv_color_t lv_color_hex(uint32_t c) {
+  return lv_color_make((uint8_t)(c >> 16), (uint8_t)(c >> 8), (uint8_t)c);
+}
+
+static inline lv_color_t lv_color_black(void) {
+  return lv_color_make(0, 0, 0);
+}
+
+static inline lv_color_t lv_color_white(void) {
+  return lv_color_make(0xff, 0xff, 0xff);
+}
+
+static inline lv_color_t lv_color_mix(lv_color_t c1, lv_color_t c2, uint8_t mix) {
+  lv_color_t ret;
+  ret.full = 0;
+  LV_COLOR_SET_R(ret, LV_UDIV255((uint16_t)LV_COLOR_GET_R(c1) * mix + LV_COLOR_GET_R(c2) * (255 - mix) +
+                                 LV_COLOR_MIX_ROUND_OFS));
+  LV_COLOR_SET_G(ret, LV_UDIV255((uint16_t)LV_COLOR_GET_G(c1) * mix + LV_COLOR_GET_G(c2) * (255 - mix) +
+                                 LV_COLOR_MIX_ROUND_OFS));
+  LV_COLOR_SET_B(ret, LV_UDIV255((uint16_t)LV_COLOR_GET_B(c1) * mix + LV_COLOR_GET_B(c2) * (255 - mix) +
+                                 LV_COLOR_MIX_ROUND_OFS));
+  return ret;
+}
+
+static inline void lv_color_premult(lv_color_t c, uint8_t mix, uint16_t *out) {
+  out[0] = (uint16_t)LV_COLOR_GET_R(c) * mix;
+  out[1] = (uint16_t)LV_COLOR_GET_G(c) * mix;
+  out[2] = (uint16_t)LV_COLOR_GET_B(c) * mix;
+}
+
+static inline lv_color_t lv_color_mix_premult(uint16_t *premult_c1, lv_color_t c2, uint8_t mix) {
+  lv_color_t ret;
+  ret.full = 0;
+  LV_COLOR_SET_R(ret, LV_UDIV255(premult_c1[0] + LV_COLOR_GET_R(c2) * mix + LV_COLOR_MIX_ROUND_OFS));
+  LV_COLOR_SET_G(ret, LV_UDIV255(premult_c1[1] + LV_COLOR_GET_G(c2) * mix + LV_COLOR_MIX_ROUND_OFS));
+  LV_COLOR_SET_B(ret, LV_UDIV255(premult_c1[2] + LV_COLOR_GET_B(c2) * mix + LV_COLOR_MIX_ROUND_OFS));
+  LV_COLOR_SET_A(ret, 0xFF);
+  return ret;
+}
+
+/* ---- Areas ---- */
+
+typedef int16_t lv_coord_t;
+#define LV_COORD_MIN (-((1 << 13) - 1))
+#define LV_COORD_MAX ((1 << 13) - 1)
+
+typedef struct {
+  lv_coord_t x1, y1, x2, y2;
+} lv_area_t;
+
+typedef struct {
+  lv_coord_t x, y;
+} lv_point_t;
+
+static inline lv_coord_t lv_area_get_width(const lv_area_t *a) {
+  return (lv_coord_t)(a->x2 - a->x1 + 1);
+}
+
+static inline lv_coord_t lv_area_get_height(const lv_area_t *a) {
+  return (lv_coord_t)(a->y2 - a->y1 + 1);
+}
+
+static inline uint32_t lv_area_get_size(const lv_area_t *a) {
+  return (uint32_t)lv_area_get_width(a) * lv_area_get_height(a);
+}
+
+static inline bool _lv_area_intersect(lv_area_t *res, const lv_area_t *a1, const lv_area_t *a2) {
+  res->x1 = a1->x1 > a2->x1 ? a1->x1 : a2->x1;
+  res->y1 = a1->y1 > a2->y1 ? a1->y1 : a2->y1;
+  res->x2 = a1->x2 < a2->x2 ? a1->x2 : a2->x2;
+  res->y2 = a1->y2 < a2->y2 ? a1->y2 : a2->y2;
+  return res->x1 <= res->x2 && res->y1 <= res->y2;
+}
+
+/* ---- Software renderer hook points ---- */
+
+#define LV_DRAW_COMPLEX 1
+#define LV_IMG_ZOOM_NONE 256
+
+typedef uint8_t lv_draw_mask_res_t;
+enum { LV_DRAW_MASK_RES_TRANSP, LV_DRAW_MASK_RES_FULL_COVER, LV_DRAW_MASK_RES_CHANGED, LV_DRAW_MASK_RES_UNKNOWN };
+
+typedef uint8_t lv_blend_mode_t;
+enum { LV_BLEND_MODE_NORMAL, LV_BLEND_MODE_ADDITIVE, LV_BLEND_MODE_SUBTRACTIVE, LV_BLEND_MODE_MULTIPLY };
+
+typedef uint8_t lv_img_cf_t;
+
+typedef struct {
+  int16_t angle;
+  uint16_t zoom;
+  lv_color_t recolor;
+  lv_opa_t recolor_opa;
+  lv_opa_t opa;
+  lv_blend_mode_t blend_mode;
+} lv_draw_img_dsc_t;
+
+typedef struct _lv_draw_ctx_t {
+  void *buf;
+  lv_area_t *buf_area;
+  const lv_area_t *clip_area;
+  void (*draw_img_decoded)(struct _lv_draw_ctx_t *draw_ctx, const lv_draw_img_dsc_t *dsc, const lv_area_t *coords,
+                           const uint8_t *map_p, lv_img_cf_t color_format);
+} lv_draw_ctx_t;
+
+typedef struct {
+  const lv_area_t *blend_area;
+  const lv_color_t *src_buf;
+  lv_color_t color;
+  lv_opa_t *mask_buf;
+  lv_draw_mask_res_t mask_res;
+  const lv_area_t *mask_area;
+  lv_opa_t opa;
+  lv_blend_mode_t blend_mode;
+} lv_draw_sw_blend_dsc_t;
+
+typedef struct {
+  lv_draw_ctx_t base_draw;
+  void (*blend)(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc);
+} lv_draw_sw_ctx_t;
+
+typedef struct _lv_disp_drv_t {
+  lv_coord_t hor_res;
+  lv_coord_t ver_res;
+  void (*set_px_cb)(struct _lv_disp_drv_t *, uint8_t *, lv_coord_t, lv_coord_t, lv_coord_t, lv_color_t,
+                    lv_opa_t);
+  uint32_t screen_transp : 1;
+} lv_disp_drv_t;
+
+typedef struct _lv_disp_t {
+  lv_disp_drv_t *driver;
+} lv_disp_t;
+
+/* ---- Objects ---- */
+
+typedef struct _lv_obj_class_t {
+  const char *name;
+} lv_obj_class_t;
+
+typedef struct _lv_obj_t lv_obj_t;
+typedef struct _lv_event_t lv_event_t;
+typedef void (*lv_event_cb_t)(lv_event_t *e);
+typedef uint8_t lv_event_code_t;
+enum { LV_EVENT_DELETE = 34 };
+#define LV_CHART_POINT_NONE (LV_COORD_MAX)
+
+/* ---- Images ---- */
+
+typedef uint8_t lv_res_t;
+enum { LV_RES_INV = 0, LV_RES_OK };
+
+enum {
+  LV_IMG_CF_UNKNOWN = 0,
+  LV_IMG_CF_RAW,
+  LV_IMG_CF_RAW_ALPHA,
+  LV_IMG_CF_RAW_CHROMA_KEYED,
+  LV_IMG_CF_TRUE_COLOR,
+  LV_IMG_CF_TRUE_COLOR_ALPHA,
+  LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED,
+  LV_IMG_CF_INDEXED_1BIT,
+  LV_IMG_CF_INDEXED_2BIT,
+  LV_IMG_CF_INDEXED_4BIT,
+  LV_IMG_CF_INDEXED_8BIT,
+  LV_IMG_CF_ALPHA_1BIT,
+  LV_IMG_CF_ALPHA_2BIT,
+  LV_IMG_CF_ALPHA_4BIT,
+  LV_IMG_CF_ALPHA_8BIT,
+};
+#define LV_IMG_PX_SIZE_ALPHA_BYTE 3
+
+typedef uint8_t lv_img_src_t;
+enum { LV_IMG_SRC_VARIABLE, LV_IMG_SRC_FILE, LV_IMG_SRC_SYMBOL, LV_IMG_SRC_UNKNOWN };
+
+typedef struct {
+  uint32_t cf : 5;
+  uint32_t always_zero : 3;
+  uint32_t reserved : 2;
+  uint32_t w : 11;
+  uint32_t h : 11;
+} lv_img_header_t;
+
+typedef struct {
+  lv_img_header_t header;
+  uint32_t data_size;
+  const uint8_t *data;
+} lv_img_dsc_t;
+
+typedef struct {
+  lv_img_header_t header;
+  const uint8_t *img_data;
+  void *user_data;  // the test's decoder state
+} lv_img_decoder_dsc_t;
+
+// As lv_img_buf.c computes it
+static inline uint32_t lv_img_buf_get_img_size(lv_coord_t w, lv_coord_t h, lv_img_cf_t cf) {
+  switch (cf) {
+    case LV_IMG_CF_TRUE_COLOR: case LV_IMG_CF_TRUE_COLOR_CHROMA_KEYED:
+      return (uint32_t)w * h * sizeof(lv_color_t);
+    case LV_IMG_CF_TRUE_COLOR_ALPHA: return (uint32_t)w * h * LV_IMG_PX_SIZE_ALPHA_BYTE;
+    case LV_IMG_CF_ALPHA_1BIT: return (uint32_t)(w / 8 + 1) * h;
+    case LV_IMG_CF_ALPHA_2BIT: return (uint32_t)(w / 4 + 1) * h;
+    case LV_IMG_CF_ALPHA_4BIT: return (uint32_t)(w / 2 + 1) * h;
+    case LV_IMG_CF_ALPHA_8BIT: return (uint32_t)w * h;
+    case LV_IMG_CF_INDEXED_1BIT: return (uint32_t)(w / 8 + 1) * h + 4 * 2;
+    case LV_IMG_CF_INDEXED_2BIT: return (uint32_t)(w / 4 + 1) * h + 4 * 4;
+    case LV_IMG_CF_INDEXED_4BIT: return (uint32_t)(w / 2 + 1) * h + 4 * 16;
+    case LV_IMG_CF_INDEXED_8BIT: return (uint32_t)w * h + 4 * 256;
+    default: return 0;
+  }
+}
+
+// Defined by the test that needs them
+uint32_t lv_timer_handler(void);
+extern const lv_obj_class_t lv_canvas_class;
+lv_obj_t *lv_scr_act(void);
+lv_obj_t *lv_canvas_create(lv_obj_t *parent);
+void lv_canvas_set_buffer(lv_obj_t *obj, void *buf, lv_coord_t w, lv_coord_t h, lv_img_cf_t cf);
+bool lv_obj_check_type(const lv_obj_t *obj, const lv_obj_class_t *cls);
+void lv_obj_set_user_data(lv_obj_t *obj, void *data);
+void *lv_obj_get_user_data(lv_obj_t *obj);
+void lv_obj_add_event_cb(lv_obj_t *obj, lv_event_cb_t cb, lv_event_code_t code, void *user_data);
+void *lv_event_get_user_data(lv_event_t *e);
+void lv_obj_invalidate(const lv_obj_t *obj);
+lv_disp_t *_lv_refr_get_disp_refreshing(void);
+void lv_draw_sw_blend_basic(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc);
+void lv_draw_sw_init_ctx(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx);
+void lv_draw_sw_blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc);
+void lv_draw_sw_img_decoded(lv_draw_ctx_t *draw_ctx, const lv_draw_img_dsc_t *draw_dsc, const lv_area_t *coords,
+                            const uint8_t *src_buf, lv_img_cf_t cf);
+bool lv_draw_mask_is_any(const lv_area_t *a);
+lv_draw_mask_res_t lv_draw_mask_apply(lv_opa_t *mask_buf, lv_coord_t abs_x, lv_coord_t abs_y, lv_coord_t len);
+void *lv_mem_buf_get(uint32_t size);
+void lv_mem_buf_release(void *p);
+lv_coord_t lv_disp_get_hor_res(lv_disp_t *disp);
+lv_res_t lv_img_decoder_open(lv_img_decoder_dsc_t *dsc, const void *src, lv_color_t color, int32_t frame_id);
+lv_res_t lv_img_decoder_read_line(lv_img_decoder_dsc_t *dsc, lv_coord_t x, lv_coord_t y, lv_coord_t len,
+                                  uint8_t *buf);
+void lv_img_decoder_close(lv_img_decoder_dsc_t *dsc);
+void lv_img_cache_invalidate_src(const void *src);
+lv_img_src_t lv_img_src_get_type(const void *src);
+const void *lv_img_get_src(lv_obj_t *obj);
+void lv_img_set_src(lv_obj_t *obj, const void *src);
+bool lv_obj_remove_event_cb_with_user_data(lv_obj_t *obj, lv_event_cb_t cb, const void *user_data);
@@ -0,0 +1,377 @@
+// Host stand-ins for Arduino-ESP32 / ESP-IDF, see mock.h
+
+#include "Arduino.h"
+#include "SD_MMC.h"
+#include "SPI.h"
+#include "driver/spi_master.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/timers.h"
+
+#include <deque>
+#include <map>
+#include <string>
+
+int64_t mock_now_us = 0;
+mock_gpio_fn mock_gpio_hook = NULL;
+int mock_in_isr = 0;
+int mock_tasks_created = 0;
+
+static void mock_default_block(uint32_t ms) {
+  mock_advance_us((int64_t)ms * 1000);
+}
+mock_block_fn mock_block_hook = mock_default_block;
+
+void mock_advance_us(int64_t us) {
+  mock_now_us += us;
+}
+
+// Wait for `*count` to become non-zero, for up to `ticks` ms of simulated time
+static bool mock_wait(volatile int *count, TickType_t ticks) {
+  if (*count > 0) return true;
+  if (ticks == 0) return false;
+  int64_t deadline = ticks == portMAX_DELAY ? INT64_MAX : mock_now_us + (int64_t)ticks * 1000;
+  while (*count == 0 && mock_now_us < deadline) {
+    int64_t before = mock_now_us;
+    int64_t left = deadline - mock_now_us;
+    mock_block_hook(left > 1000000 ? 1000 : (uint32_t)((left + 999) / 1000));
+    if (mock_now_us == before && *count == 0) break;  // nothing will ever change
+  }
+  return *count > 0;
+}
+
+/* ---- Arduino ---- */
+
+HardwareSerial Serial;
+SPIClass SPI;
+int mock_serial_quiet = 0;
+static std::string mock_serial_buf;
+
+int HardwareSerial::printf(const char *fmt, ...) {
+  char line[512];
+  va_list ap;
+  va_start(ap, fmt);
+  int n = vsnprintf(line, sizeof(line), fmt, ap);
+  va_end(ap);
+  mock_serial_buf += line;
+  if (!mock_serial_quiet) fputs(line, stdout);
+  return n;
+}
+
+void HardwareSerial::print(const char *s) {
+  printf("%s", s);
+}
+
+void HardwareSerial::println(const char *s) {
+  printf("%s\n", s);
+}
+
+void HardwareSerial::println(int v) {
+  printf("%d\n", v);
+}
+
+const char *mock_serial_text(void) {
+  return mock_serial_buf.c_str();
+}
+
+void mock_serial_clear(void) {
+  mock_serial_buf.clear();
+}
+
+/* ---- SD card ---- */
+
+struct mock_sd_file {
+  std::string data;
+  time_t mtime;
+};
+
+SDMMCFS SD_MMC;
+int mock_sd_opens = 0;
+static std::map<std::string, mock_sd_file> mock_sd_files;
+
+void mock_sd_put(const char *path, const void *data, size_t len, time_t mtime) {
+  mock_sd_file &f = mock_sd_files[path];
+  f.data.assign((const char *)data, len);
+  f.mtime = mtime;
+}
+
+void mock_sd_remove(const char *path) {
+  mock_sd_files.erase(path);
+}
+
+File SDMMCFS::open(const char *path, const char *mode) {
+  (void)mode;
+  std::map<std::string, mock_sd_file>::const_iterator it = mock_sd_files.find(path);
+  if (it == mock_sd_files.end()) return File();
+  mock_sd_opens++;
+  return File(&it->second);
+}
+
+size_t File::read(uint8_t *buf, size_t n) {
+  if (!f_ || pos_ >= f_->data.size()) return 0;
+  if (n > f_->data.size() - pos_) n = f_->data.size() - pos_;
+  memcpy(buf, f_->data.data() + pos_, n);
+  pos_ += n;
+  return n;
+}
+
+size_t File::size() const {
+  return f_ ? f_->data.size() : 0;
+}
+
+time_t File::getLastWrite() const {
+  return f_ ? f_->mtime : 0;
+}
+
+#define MOCK_PINS 64
+static mock_isr_fn mock_isrs[MOCK_PINS];
+static int mock_levels[MOCK_PINS];
+
+void pinMode(int pin, int mode) {
+  (void)pin;
+  (void)mode;
+}
+
+void digitalWrite(int pin, int level) {
+  if (pin >= 0 && pin < MOCK_PINS) mock_levels[pin] = level;
+  if (mock_gpio_hook) mock_gpio_hook(pin, level);
+}
+
+int digitalRead(int pin) {
+  return pin >= 0 && pin < MOCK_PINS ? mock_levels[pin] : 0;
+}
+
+void attachInterrupt(int pin, void (*isr)(void), int mode) {
+  (void)mode;
+  if (pin >= 0 && pin < MOCK_PINS) mock_isrs[pin] = isr;
+}
+
+void detachInterrupt(int pin) {
+  if (pin >= 0 && pin < MOCK_PINS) mock_isrs[pin] = NULL;
+}
+
+mock_isr_fn mock_isr(int pin) {
+  return pin >= 0 && pin < MOCK_PINS ? mock_isrs[pin] : NULL;
+}
+
+void mock_fire_isr(int pin) {
+  mock_isr_fn fn = mock_isr(pin);
+  if (!fn) return;
+  mock_in_isr = 1;
+  fn();
+  mock_in_isr = 0;
+}
+
+void delay(uint32_t ms) {
+  int64_t until = mock_now_us + (int64_t)ms * 1000;
+  while (mock_now_us < until) {
+    int64_t before = mock_now_us;
+    mock_block_hook((uint32_t)((until - mock_now_us + 999) / 1000));
+    if (mock_now_us == before) mock_now_us = until;
+  }
+}
+
+uint32_t millis(void) {
+  return (uint32_t)(mock_now_us / 1000);
+}
+
+uint32_t micros(void) {
+  return (uint32_t)mock_now_us;
+}
+
+/* ---- FreeRTOS ---- */
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return xSemaphoreCreateCounting(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(int max, int initial) {
+  SemaphoreHandle_t s = new mock_sem;
+  s->count = initial;
+  s->max = max;
+  return s;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t s, TickType_t ticks) {
+  if (!mock_wait(&s->count, ticks)) return pdFALSE;
+  s->count--;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t s) {
+  if (s->count >= s->max) return pdFALSE;
+  s->count++;
+  return pdTRUE;
+}
+
+BaseType_t xSemaphoreGiveFromISR(SemaphoreHandle_t s, BaseType_t *woken) {
+  if (woken) *woken = pdFALSE;
+  return xSemaphoreGive(s);
+}
+
+static struct mock_task {
+  int notify;
+} mock_task_self;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t fn, const char *name, uint32_t stack, void *arg,
+                                   UBaseType_t prio, TaskHandle_t *out, BaseType_t core) {
+  (void)core;
+  return xTaskCreate(fn, name, stack, arg, prio, out);
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack, void *arg, UBaseType_t prio,
+                       TaskHandle_t *out) {
+  (void)fn;
+  (void)name;
+  (void)stack;
+  (void)arg;
+  (void)prio;
+  mock_tasks_created++;
+  if (out) *out = &mock_task_self;
+  return pdPASS;
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  return &mock_task_self;
+}
+
+void vTaskDelay(TickType_t ticks) {
+  delay(ticks);
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return millis();
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t t) {
+  (void)t;
+  return 4096;
+}
+
+uint32_t ulTaskNotifyTake(BaseType_t clear, TickType_t ticks) {
+  if (!mock_wait(&mock_task_self.notify, ticks)) return 0;
+  uint32_t n = mock_task_self.notify;
+  mock_task_self.notify = clear ? 0 : n - 1;
+  return n;
+}
+
+BaseType_t xTaskNotifyGive(TaskHandle_t t) {
+  t->notify++;
+  return pdPASS;
+}
+
+TimerHandle_t xTimerCreate(const char *name, TickType_t period, UBaseType_t reload, void *id,
+                           TimerCallbackFunction_t cb) {
+  (void)name;
+  (void)period;
+  (void)reload;
+  (void)id;
+  (void)cb;
+  return NULL;
+}
+
+BaseType_t xTimerStart(TimerHandle_t t, TickType_t wait) {
+  (void)t;
+  (void)wait;
+  return pdPASS;
+}
+
+/* ---- SPI master ---- */
+
+struct mock_spi_dev {
+  spi_device_interface_config_t cfg;
+  std::deque<spi_transaction_t *> waiting;  // queued, not on the wire yet
+  std::deque<spi_transaction_t *> done;     // sent, not handed back yet
+};
+
+mock_spi_wire_fn mock_spi_wire_hook = NULL;
+mock_spi_stats_t mock_spi_stats;
+static mock_spi_dev *mock_spi_device = NULL;
+
+static void mock_spi_error(const char *what) {
+  fprintf(stderr, "mock spi: %s\n", what);
+  mock_spi_stats.errors++;
+}
+
+static void mock_spi_send(mock_spi_dev *d, spi_transaction_t *t, bool queued) {
+  if (d->cfg.pre_cb) d->cfg.pre_cb(t);
+  if (mock_spi_wire_hook) mock_spi_wire_hook(t, queued);
+  if (d->cfg.post_cb) d->cfg.post_cb(t);
+}
+
+esp_err_t spi_bus_initialize(spi_host_device_t host, const spi_bus_config_t *cfg, int dma) {
+  (void)host;
+  (void)cfg;
+  (void)dma;
+  return ESP_OK;
+}
+
+esp_err_t spi_bus_add_device(spi_host_device_t host, const spi_device_interface_config_t *cfg,
+                             spi_device_handle_t *out) {
+  (void)host;
+  mock_spi_device = new mock_spi_dev;
+  mock_spi_device->cfg = *cfg;
+  *out = mock_spi_device;
+  return ESP_OK;
+}
+
+uint32_t mock_spi_inflight(void) {
+  mock_spi_dev *d = mock_spi_device;
+  return d ? (uint32_t)(d->waiting.size() + d->done.size()) : 0;
+}
+
+uint32_t mock_spi_run(uint32_t n) {
+  mock_spi_dev *d = mock_spi_device;
+  uint32_t sent = 0;
+  while (d && sent < n && !d->waiting.empty()) {
+    spi_transaction_t *t = d->waiting.front();
+    d->waiting.pop_front();
+    mock_in_isr = 1;  // the callbacks run in the SPI interrupt
+    mock_spi_send(d, t, true);
+    mock_in_isr = 0;
+    d->done.push_back(t);
+    sent++;
+  }
+  return sent;
+}
+
+esp_err_t spi_device_queue_trans(spi_device_handle_t dev, spi_transaction_t *t, uint32_t ticks) {
+  (void)ticks;
+  if (mock_spi_inflight() >= (uint32_t)dev->cfg.queue_size) {
+    // The real call would block forever: nobody else collects results
+    mock_spi_error("queue_trans on a full queue");
+    return ESP_ERR_INVALID_STATE;
+  }
+  for (spi_transaction_t *q : dev->waiting)
+    if (q == t) mock_spi_error("descriptor queued twice");
+  for (spi_transaction_t *q : dev->done)
+    if (q == t) mock_spi_error("descriptor reused before its result was collected");
+  dev->waiting.push_back(t);
+  mock_spi_stats.queued++;
+  if (mock_spi_inflight() > mock_spi_stats.max_inflight) mock_spi_stats.max_inflight = mock_spi_inflight();
+  return ESP_OK;
+}
+
+esp_err_t spi_device_get_trans_result(spi_device_handle_t dev, spi_transaction_t **out, uint32_t ticks) {
+  (void)ticks;
+  if (dev->done.empty()) mock_spi_run(1);
+  if (dev->done.empty()) {
+    mock_spi_error("get_trans_result with nothing queued");
+    return ESP_ERR_INVALID_STATE;
+  }
+  *out = dev->done.front();
+  dev->done.pop_front();
+  mock_spi_stats.collected++;
+  return ESP_OK;
+}
+
+esp_err_t spi_device_polling_transmit(spi_device_handle_t dev, spi_transaction_t *t) {
+  if (mock_spi_inflight()) mock_spi_error("polling transmit with queued transactions outstanding");
+  mock_spi_stats.polled++;
+  mock_spi_send(dev, t, false);
+  return ESP_OK;
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+// Host stand-ins for the Arduino-ESP32 / ESP-IDF pieces the firmware
+// sources use, so the real files build into the host tests under tools/.
+// Single-threaded: "tasks" are whatever the test calls, time only moves
+// when something waits (delay, a semaphore or notification timeout) or the
+// test advances it. Tests hook in where the firmware would block or touch
+// a pin.
+
+#include <stdint.h>
+
+// Simulated clock, microseconds since start
+extern int64_t mock_now_us;
+void mock_advance_us(int64_t us);
+
+// Called when a wait would block for up to `ms` (semaphore, notification,
+// delay). The default advances the clock by `ms`; a test can instead run
+// whatever would have happened meanwhile (bus transfers, TE pulses, ...).
+typedef void (*mock_block_fn)(uint32_t ms);
+extern mock_block_fn mock_block_hook;
+
+// Pin writes (digitalWrite and gpio_set_level)
+typedef void (*mock_gpio_fn)(int pin, int level);
+extern mock_gpio_fn mock_gpio_hook;
+
+// attachInterrupt() bookkeeping: handler per pin, NULL when detached
+typedef void (*mock_isr_fn)(void);
+mock_isr_fn mock_isr(int pin);
+// Run a pin's handler in "interrupt context" (xPortInIsrContext() is true)
+void mock_fire_isr(int pin);
+extern int mock_in_isr;
+
+// Tasks created with xTaskCreate*: recorded, never run
+extern int mock_tasks_created;
@@ -0,0 +1,7 @@
+#pragma once
+
+typedef struct {
+  int spiq_in;
+} spi_signal_conn_t;
+
+static const spi_signal_conn_t spi_periph_signal[3] = { { 0 }, { 0 }, { 0 } };
@@ -0,0 +1,538 @@
+// Host-side test of the RM67162 panel driver (websocket/rm67162.cpp), built
+// against the mock SPI bus in tools/mock and a model of the panel behind it.
+//
+//   c++ -O2 -I../mock -I../../websocket -o panelsim panelsim.cpp ../mock/mock.cpp ../../websocket/rm67162.cpp
+//   ./panelsim [-v]
+//
+// The mock bus only moves queued transactions when the driver blocks for a
+// result, so everything the driver queues stays in flight as long as it
+// possibly can; it flags descriptors reused before they were handed back,
+// a queue deeper than the device allows and polling transfers started
+// while queued ones are outstanding. The panel decodes what reaches the
+// wire: register writes (CASET, RASET, scroll area and start, ...), RAMWR
+// pixel streams whose continuation chunks must arrive inside the same CS
+// frame, and the power mode read-back of rm67162_init(). Pixels are read
+// from the caller's buffer at the moment they go out, so a buffer or tile
+// rewritten too early shows up as wrong pixels in frame memory.
+// The panel shows frame memory through its scroll start address, as the
+// RM67162 does once a scroll area is set.
+// TE pulses come from the pin interrupt whenever the driver waits, every
+// 16.7 ms of simulated time, so frame gating can be timed exactly.
+// Every test draws into a reference image as well and compares it with
+// what the panel shows. Exits 1 if any test fails.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arduino.h"
+#include "driver/spi_master.h"
+#include "rm67162.h"
+
+#define W EXAMPLE_LCD_H_RES  // landscape, rotation 1
+#define H EXAMPLE_LCD_V_RES
+
+static int g_verbose = 0;
+
+/******************************************************************************
+ * Panel model
+ ******************************************************************************/
+typedef struct {
+  int cs;                  // pin level
+  bool fresh;              // CS fell and nothing was sent in this frame yet
+  bool streaming;          // inside a RAMWR pixel stream
+  uint16_t x1, x2, y1, y2; // window
+  uint16_t wx, wy;         // write pointer
+  uint16_t scroll;         // vertical scroll start address, native rows
+  bool scroll_area;        // 0x33 seen since the last normal mode (0x13)
+  uint32_t errors;
+  uint32_t overflow;       // pixels past the end of the window
+  uint16_t mem[H][W];      // frame memory, landscape
+} panel_t;
+
+static panel_t g_panel;
+
+static void panel_error(const char *what) {
+  if (g_panel.errors++ < 10) fprintf(stderr, "panel: %s\n", what);
+}
+
+static void panel_gpio(int pin, int level) {
+  if (pin != TFT_CS || level == g_panel.cs) return;
+  g_panel.cs = level;
+  if (level) {
+    g_panel.streaming = false;
+  } else {
+    g_panel.fresh = true;
+  }
+}
+
+static void panel_pixels(const uint16_t *p, size_t n) {
+  for (size_t i = 0; i < n; i++) {
+    if (g_panel.wy > g_panel.y2 || g_panel.wy >= H || g_panel.wx >= W) {
+      g_panel.overflow++;
+      continue;
+    }
+    g_panel.mem[g_panel.wy][g_panel.wx] = p[i];
+    if (++g_panel.wx > g_panel.x2) {
+      g_panel.wx = g_panel.x1;
+      g_panel.wy++;
+    }
+  }
+}
+
+static void panel_register(uint8_t reg, const uint8_t *d, size_t len) {
+  switch (reg) {
+    case 0x2a:
+      if (len != 4) break;
+      g_panel.x1 = d[0] << 8 | d[1];
+      g_panel.x2 = d[2] << 8 | d[3];
+      break;
+    case 0x2b:
+      if (len != 4) break;
+      g_panel.y1 = d[0] << 8 | d[1];
+      g_panel.y2 = d[2] << 8 | d[3];
+      break;
+    case 0x2c:
+      g_panel.wx = g_panel.x1;
+      g_panel.wy = g_panel.y1;
+      break;
+    case 0x33:
+      if (len == 6) g_panel.scroll_area = true;
+      break;
+    case 0x37:
+      if (len == 2) g_panel.scroll = (d[0] << 8 | d[1]) % W;
+      break;
+    case 0x13:
+      g_panel.scroll_area = false;
+      g_panel.scroll = 0;
+      break;
+  }
+}
+
+static void panel_wire(spi_transaction_t *t, bool queued) {
+  (void)queued;
+  spi_transaction_ext_t *e = (spi_transaction_ext_t *)t;
+  if (g_panel.cs) {
+    panel_error("transaction with CS high");
+    return;
+  }
+  if ((t->flags & SPI_TRANS_VARIABLE_CMD) && e->command_bits == 0) {
+    if (!g_panel.streaming) panel_error("pixel chunk outside a RAMWR stream");
+    else panel_pixels((const uint16_t *)t->tx_buffer, t->length / 16);
+    g_panel.fresh = false;
+    return;
+  }
+  if (!g_panel.fresh) panel_error("command inside an open CS frame");
+  g_panel.fresh = false;
+  uint8_t reg = (uint8_t)(t->addr >> 8);
+  switch (t->cmd) {
+    case 0x02: {
+      const uint8_t *d = (t->flags & SPI_TRANS_USE_TXDATA) ? t->tx_data : (const uint8_t *)t->tx_buffer;
+      panel_register(reg, d, t->length / 8);
+      break;
+    }
+    case 0x32:
+      if (reg != 0x2c) {
+        panel_error("quad write to a register other than RAMWR");
+        break;
+      }
+      g_panel.wx = g_panel.x1;
+      g_panel.wy = g_panel.y1;
+      g_panel.streaming = true;
+      panel_pixels((const uint16_t *)t->tx_buffer, t->length / 16);
+      break;
+    case 0x03:
+      // RDDPM: booster, sleep out, display on; RDID1
+      t->rx_data[0] = reg == 0x0A ? 0x9C : reg == 0xDA ? 0x01 : 0x00;
+      break;
+    default:
+      panel_error("unknown command");
+  }
+}
+
+// What the viewer sees at landscape column x, row y
+static uint16_t panel_visible(int x, int y) {
+  return g_panel.mem[y][(x + g_panel.scroll) % W];
+}
+
+/******************************************************************************
+ * TE pin
+ ******************************************************************************/
+#define TE_PERIOD_US 16667
+
+static bool g_te_running = false;
+static int64_t g_te_next_us = TE_PERIOD_US;
+
+// Waiting in the driver: time passes, and the panel keeps pulsing TE
+static void te_block(uint32_t ms) {
+  int64_t until = mock_now_us + (int64_t)ms * 1000;
+  if (g_te_running && g_te_next_us <= until) {
+    mock_now_us = g_te_next_us;
+    g_te_next_us += TE_PERIOD_US;
+    mock_fire_isr(TFT_TE);
+  } else {
+    mock_now_us = until;
+  }
+}
+
+/******************************************************************************
+ * Reference image and checks
+ ******************************************************************************/
+static uint16_t g_ref[H][W];
+static int g_failed = 0;
+
+static void ref_rect(int x, int y, int w, int h, const uint16_t *src, int stride, uint16_t solid) {
+  for (int r = 0; r < h; r++)
+    for (int c = 0; c < w; c++) g_ref[y + r][x + c] = src ? src[r * stride + c] : solid;
+}
+
+// Fill a buffer with pixels unique to this (seed, position)
+static void pattern_fill(uint16_t *buf, int w, int h, uint32_t seed) {
+  for (int i = 0; i < w * h; i++) buf[i] = (uint16_t)((seed * 2654435761u + i * 40503u) >> 7);
+}
+
+static bool check_screen(const char *test) {
+  uint32_t bad = 0;
+  int fx = -1, fy = -1;
+  for (int y = 0; y < H; y++)
+    for (int x = 0; x < W; x++)
+      if (panel_visible(x, y) != g_ref[y][x]) {
+        if (!bad++) {
+          fx = x;
+          fy = y;
+        }
+      }
+  if (bad) printf("  %s: %lu pixels differ, first at %d,%d\n", test, (unsigned long)bad, fx, fy);
+  return bad == 0;
+}
+
+typedef struct {
+  const char *name;
+  bool (*run)(void);
+} test_t;
+
+static void report(const test_t *t, bool ok, uint32_t spi_errors0, uint32_t panel_errors0) {
+  if (mock_spi_stats.errors != spi_errors0 || g_panel.errors != panel_errors0 || g_panel.overflow) ok = false;
+  printf("%-18s %s\n", t->name, ok ? "ok" : "FAIL");
+  g_panel.overflow = 0;
+  if (!ok) g_failed++;
+}
+
+/******************************************************************************
+ * Tests
+ ******************************************************************************/
+#define MAX_DONE 256
+static void *g_done[MAX_DONE];
+static uint32_t g_ndone = 0;
+
+static void on_done(void *user) {
+  if (!mock_in_isr) panel_error("flush-done callback outside the SPI interrupt");
+  if (g_ndone < MAX_DONE) g_done[g_ndone] = user;
+  g_ndone++;
+}
+
+static bool test_init(void) {
+  if (!rm67162_init()) return false;
+  lcd_setRotation(1);
+  lcd_set_flush_done_cb(on_done);
+  lcd_clear_rect(0, 0, W, H);
+  lcd_wait_idle();
+  memset(g_ref, 0, sizeof(g_ref));
+  return check_screen("init");
+}
+
+// Bands pushed back to back without waiting: the driver has to keep the
+// queue full, hand each descriptor back before reusing it, and report the
+// bands done in order.
+static bool test_pipeline(void) {
+  enum { BANDS = 30, BH = 8 };
+  static uint16_t bufs[BANDS][W * BH];
+  g_ndone = 0;
+  lcd_push_stats_t before;
+  lcd_get_push_stats(&before);
+  mock_spi_stats.max_inflight = 0;
+  uint32_t queued0 = mock_spi_stats.queued;
+  for (int b = 0; b < BANDS; b++) {
+    int y = (b * BH) % H;
+    pattern_fill(bufs[b], W, BH, b + 1);
+    ref_rect(0, y, W, BH, bufs[b], W, 0);
+    lcd_PushColorsAsync(0, y, W, BH, bufs[b], bufs[b]);
+  }
+  bool deep = mock_spi_stats.max_inflight == LCD_QUEUE_SIZE;
+  lcd_wait_idle();
+  bool ok = deep && mock_spi_inflight() == 0 && g_ndone == BANDS;
+  for (int b = 0; b < BANDS && b < (int)g_ndone; b++) ok &= g_done[b] == bufs[b];
+  lcd_push_stats_t after;
+  lcd_get_push_stats(&after);
+  ok &= after.transactions - before.transactions == mock_spi_stats.queued - queued0;
+  if (!deep) printf("  pipeline: at most %lu in flight\n", (unsigned long)mock_spi_stats.max_inflight);
+  return check_screen("pipeline") && ok;
+}
+
+// A full screen in one push: SEND_BUF_SIZE chunks inside one CS frame
+static bool test_chunks(void) {
+  static uint16_t buf[W * H];
+  pattern_fill(buf, W, H, 77);
+  ref_rect(0, 0, W, H, buf, W, 0);
+  g_ndone = 0;
+  lcd_PushColorsAsync(0, 0, W, H, buf, buf);
+  lcd_wait_idle();
+  return check_screen("chunks") && g_ndone == 1 && g_done[0] == buf;
+}
+
+// Two buffers handed back and forth as the flush of LVGL does: a buffer is
+// drawn again only once its done callback has fired.
+static bool test_double_buffer(void) {
+  enum { BH = LVGL_DMA_BUF_LINES };
+  static uint16_t bufs[2][W * BH];
+  g_ndone = 0;
+  int drawn = 0;
+  for (int y = 0; y < H; y += BH) {
+    int b = drawn & 1;
+    while (drawn >= 2 && (int)g_ndone < drawn - 1) mock_spi_run(1);  // wait for buffer b
+    int h = H - y < BH ? H - y : BH;
+    pattern_fill(bufs[b], W, h, 1000 + y);
+    ref_rect(0, y, W, h, bufs[b], W, 0);
+    lcd_PushColorsAsync(0, y, W, h, bufs[b], bufs[b]);
+    drawn++;
+  }
+  lcd_wait_idle();
+  return check_screen("double buffer") && (int)g_ndone == drawn;
+}
+
+// Fills and pattern blits share one tile: it must not be rewritten while a
+// previous fill is still streaming it.
+static bool test_fills(void) {
+  static const uint16_t pat[3 * 2] = { 0x1111, 0x2222, 0x3333, 0x4444, 0x5555, 0x6666 };
+  lcd_fill_rect(10, 10, 200, 100, 0xF800);
+  ref_rect(10, 10, 200, 100, NULL, 0, 0xF800);
+  lcd_fill_rect(300, 20, 236, 200, 0x07E0);
+  ref_rect(300, 20, 236, 200, NULL, 0, 0x07E0);
+  lcd_blit_pattern(0, 120, 300, 120, pat, 3, 2);
+  for (int r = 0; r < 120; r++)
+    for (int c = 0; c < 300; c++) g_ref[120 + r][c] = pat[(r % 2) * 3 + c % 3];
+  lcd_fill_rect(50, 50, 50, 50, 0x001F);
+  ref_rect(50, 50, 50, 50, NULL, 0, 0x001F);
+  lcd_wait_idle();
+  return check_screen("fills");
+}
+
+// Polling commands between queued pushes must first drain the queue
+static bool test_mixed(void) {
+  static uint16_t a[W * 16], b[W * 16];
+  pattern_fill(a, W, 16, 5);
+  pattern_fill(b, W, 16, 6);
+  lcd_PushColorsAsync(0, 0, W, 16, a, a);
+  ref_rect(0, 0, W, 16, a, W, 0);
+  lcd_setRotation(1);
+  lcd_PushColorsAsync(0, 16, W, 16, b, b);
+  ref_rect(0, 16, W, 16, b, W, 0);
+  uint16_t px = 0xABCD;
+  lcd_DrawPoint(7, 100, px);
+  g_ref[100][7] = px;
+  lcd_wait_idle();
+  return check_screen("mixed");
+}
+
+// Gating off (the default): nothing listens to the TE pin, nothing waits
+static bool test_te_off(void) {
+  static uint16_t buf[W * 8];
+  if (mock_isr(TFT_TE)) return false;
+  g_te_running = true;
+  int64_t t0 = mock_now_us;
+  pattern_fill(buf, W, 8, 9);
+  ref_rect(0, 0, W, 8, buf, W, 0);
+  lcd_PushColorsAsync(0, 0, W, 8, buf, buf);
+  lcd_te_frame_done();
+  lcd_wait_idle();
+  g_te_running = false;
+  return mock_now_us == t0 && check_screen("te off");
+}
+
+// Divider 2: each frame starts on a pulse two pulses after the previous
+// frame's; pushes later in the same frame do not wait again
+static bool test_te_gate(void) {
+  static uint16_t buf[W * 8];
+  lcd_te_set_divider(2, false);
+  if (!mock_isr(TFT_TE)) return false;
+  g_te_running = true;
+  g_te_next_us = mock_now_us + TE_PERIOD_US;
+  lcd_te_stats_t st0, st;
+  lcd_te_get_stats(&st0);
+  bool ok = true;
+  int64_t start[4];
+  for (int f = 0; f < 4; f++) {
+    pattern_fill(buf, W, 8, 20 + f);
+    lcd_PushColorsAsync(0, 0, W, 8, buf, buf);
+    start[f] = mock_now_us;
+    lcd_PushColorsAsync(0, 8, W, 8, buf, buf);
+    ok &= mock_now_us == start[f];
+    lcd_wait_idle();
+    lcd_te_frame_done();
+  }
+  ref_rect(0, 0, W, 8, buf, W, 0);
+  ref_rect(0, 8, W, 8, buf, W, 0);
+  for (int f = 1; f < 4; f++) {
+    if (start[f] - start[f - 1] != 2 * TE_PERIOD_US) {
+      printf("  te gate: frame %d started %lld us after the previous one\n", f,
+             (long long)(start[f] - start[f - 1]));
+      ok = false;
+    }
+  }
+  lcd_te_get_stats(&st);
+  ok &= st.frames - st0.frames == 4 && st.timeouts == st0.timeouts && st.period_us == TE_PERIOD_US;
+  g_te_running = false;
+  return check_screen("te gate") && ok;
+}
+
+// Fills drawn by scripts between frames must not use up the wait of the
+// next frame
+static bool test_te_fills(void) {
+  static uint16_t buf[W * 8];
+  lcd_te_set_divider(1, false);
+  g_te_running = true;
+  g_te_next_us = mock_now_us + TE_PERIOD_US;
+  lcd_te_frame_done();
+  int64_t t0 = mock_now_us;
+  lcd_fill_rect(0, 100, 40, 40, 0x1234);
+  ref_rect(0, 100, 40, 40, NULL, 0, 0x1234);
+  bool ok = mock_now_us == t0;
+  pattern_fill(buf, W, 8, 31);
+  ref_rect(0, 0, W, 8, buf, W, 0);
+  lcd_PushColorsAsync(0, 0, W, 8, buf, buf);
+  ok &= mock_now_us > t0;
+  if (!ok) printf("  te fills: the fill waited for TE, the frame did not\n");
+  lcd_wait_idle();
+  g_te_running = false;
+  return check_screen("te fills") && ok;
+}
+
+// TE not coming: the frame goes out after LCD_TE_TIMEOUT_MS anyway, and
+// turning gating off releases the pin
+static bool test_te_timeout(void) {
+  static uint16_t buf[W * 8];
+  lcd_te_stats_t st0, st;
+  lcd_te_get_stats(&st0);
+  lcd_te_frame_done();
+  int64_t t0 = mock_now_us;
+  pattern_fill(buf, W, 8, 41);
+  ref_rect(0, 0, W, 8, buf, W, 0);
+  lcd_PushColorsAsync(0, 0, W, 8, buf, buf);
+  lcd_wait_idle();
+  lcd_te_get_stats(&st);
+  bool ok = st.timeouts == st0.timeouts + 1 && mock_now_us - t0 == 50000;
+  lcd_te_set_divider(0, false);
+  ok &= mock_isr(TFT_TE) == NULL;
+  return check_screen("te timeout") && ok;
+}
+
+// Content of a ticker scrolled `p` columns to the left, at logical column x
+static uint16_t ticker_px(int x, int y, int p) {
+  return (uint16_t)((x + p) * 131 + y * 7);
+}
+
+static void ticker_strip(uint16_t *buf, int x, int w, int p) {
+  for (int y = 0; y < H; y++)
+    for (int c = 0; c < w; c++) buf[y * w + c] = ticker_px(x + c, y, p);
+}
+
+// The fallback ticker in hardware scroll mode: each step draws the newly
+// exposed columns, which must not disturb what is on screen, then moves the
+// scroll window over them. Steps of every size wrap the frame memory many
+// times; strips crossing the wrap point are split by the driver.
+static bool test_scroll_ticker(void) {
+  static uint16_t buf[W * H];
+  lcd_scroll_enable(true);
+  if (!g_panel.scroll_area || lcd_scroll_offset() != 0) return false;
+  ticker_strip(buf, 0, W, 0);
+  lcd_PushColors(0, 0, W, H, buf);
+  lcd_wait_idle();
+  int p = 0;
+  bool ok = true;
+  for (int k = 0; k < 60 && ok; k++) {
+    int step = 1 + (k * 37) % 97;
+    uint16_t next = lcd_scroll_offset() + step;
+    lcd_scroll_prepare(next);
+    ticker_strip(buf, W - step, step, p + step);
+    if (k & 1) lcd_PushColors(W - step, 0, step, H, buf);
+    else lcd_PushColorsAsync(W - step, 0, step, H, buf, buf);
+    lcd_wait_idle();
+    // Not in view yet: only the columns about to scroll out were written
+    for (int y = 0; y < H && ok; y++)
+      for (int x = step; x < W && ok; x++) ok = panel_visible(x, y) == ticker_px(x, y, p);
+    if (!ok) printf("  scroll ticker: step %d drew over visible columns\n", k);
+    lcd_scroll_to(next);
+    p += step;
+    if (g_panel.scroll != p % W) {
+      printf("  scroll ticker: panel at %d, expected %d\n", g_panel.scroll, p % W);
+      ok = false;
+    }
+    for (int y = 0; y < H; y++)
+      for (int x = 0; x < W; x++) g_ref[y][x] = ticker_px(x, y, p);
+    ok &= check_screen("scroll ticker");
+  }
+  return ok;
+}
+
+// Under a scroll offset, fills, blits and points take logical coordinates
+// too, wrapping like pushes do; leaving scroll mode restores normal display
+static bool test_scroll_draw(void) {
+  static const uint16_t pat[4] = { 0xAAAA, 0xBBBB, 0xCCCC, 0xDDDD };
+  lcd_scroll_to(W - 100);
+  for (int y = 0; y < H; y++)
+    for (int x = 0; x < W; x++) g_ref[y][x] = panel_visible(x, y);
+  lcd_fill_rect(60, 10, 80, 50, 0x0F0F);  // crosses the wrap point at x = 100
+  ref_rect(60, 10, 80, 50, NULL, 0, 0x0F0F);
+  lcd_blit_pattern(90, 100, 21, 30, pat, 2, 2);
+  for (int r = 0; r < 30; r++)
+    for (int c = 0; c < 21; c++) g_ref[100 + r][90 + c] = pat[(r % 2) * 2 + c % 2];
+  lcd_DrawPoint(99, 200, 0x5A5A);
+  g_ref[200][99] = 0x5A5A;
+  lcd_DrawPoint(100, 200, 0xA5A5);
+  g_ref[200][100] = 0xA5A5;
+  lcd_wait_idle();
+  bool ok = check_screen("scroll draw");
+  lcd_scroll_enable(false);
+  ok &= !g_panel.scroll_area && g_panel.scroll == 0 && !lcd_scroll_active() && lcd_scroll_offset() == 0;
+  return ok;
+}
+
+static const test_t g_tests[] = {
+  { "init", test_init },
+  { "pipeline", test_pipeline },
+  { "chunks", test_chunks },
+  { "double buffer", test_double_buffer },
+  { "fills", test_fills },
+  { "mixed", test_mixed },
+  { "te off", test_te_off },
+  { "te gate", test_te_gate },
+  { "te fills", test_te_fills },
+  { "te timeout", test_te_timeout },
+  { "scroll ticker", test_scroll_ticker },
+  { "scroll draw", test_scroll_draw },
+};
+
+int main(int argc, char *argv[]) {
+  for (int a = 1; a < argc; a++) {
+    if (!strcmp(argv[a], "-v")) {
+      g_verbose = 1;
+    } else {
+      fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+      return 2;
+    }
+  }
+  mock_serial_quiet = !g_verbose;
+  g_panel.cs = 1;
+  mock_gpio_hook = panel_gpio;
+  mock_spi_wire_hook = panel_wire;
+  mock_block_hook = te_block;
+
+  for (size_t i = 0; i < sizeof(g_tests) / sizeof(g_tests[0]); i++) {
+    uint32_t spi0 = mock_spi_stats.errors, panel0 = g_panel.errors;
+    bool ok = g_tests[i].run();
+    report(&g_tests[i], ok, spi0, panel0);
+  }
+  fprintf(stderr, "%lu queued, %lu polled, %lu spi errors, %lu panel errors, %d failed\n",
+          (unsigned long)mock_spi_stats.queued, (unsigned long)mock_spi_stats.polled,
+          (unsigned long)mock_spi_stats.errors, (unsigned long)g_panel.errors, g_failed);
+  return g_failed ? 1 : 0;
+}
@@ -0,0 +1,592 @@
+// Host-side check and benchmark of the pixel kernels (websocket/pixel_kernels.cpp)
+// against the scalar loops LVGL runs for the same work.
+//
+//   c++ -O2 -I../mock -I../../websocket -o pxbench pxbench.cpp ../mock/mock.cpp
+//   ./pxbench [-n reps]
+//
+// Add -DLV_COLOR_16_SWAP=1 for the swapped byte order. Three versions run
+// side by side:
+//   lvgl      the reference: LVGL's per-pixel loops (fill_normal() and
+//             map_normal(), lv_color_mix() and lv_color_mix_premult())
+//   portable  the kernels as built for any target
+//   vector    the kernels as built for the ESP32-S3, with each PIE
+//             instruction replaced by the same lane arithmetic in C, and
+//             loads/stores dropping the low address bits like the
+//             instructions do
+// First every kernel is compared with the reference bit for bit: fills,
+// copies and alpha blends for every length up to 80 pixels at every 16-byte
+// alignment of source and destination, with guard pixels around the
+// destination; blends and recolors for all 65536 source pixels at every
+// opacity for a set of colours. The LVGL hooks are then run on random
+// masked, translucent and recoloured draws against LVGL's own steps, and
+// must not fall back to it. Then each version processes a 536 x 24 flush
+// band `reps` times. The vector timings here only show the cost of the
+// emulation; run the same kernels on the S3 for real figures. Exits 1 on
+// any mismatch.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Arduino.h"
+#include "lvgl.h"
+
+// Both builds of the kernels in one program
+namespace port {
+#define PX_USE_PIE 0
+#include "pixel_kernels.h"
+#include "pixel_kernels.cpp"
+}  // namespace port
+
+namespace vec {
+using port::px_stats_t;
+#undef PX_USE_PIE
+#define PX_USE_PIE 1
+#define PX_PIE_EMULATE 1
+#include "pixel_kernels.cpp"
+}  // namespace vec
+using port::px_stats_t;
+
+/******************************************************************************
+ * Reference: what LVGL does without the kernels
+ ******************************************************************************/
+static void ref_fill(lv_color_t *dst, lv_color_t color, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) dst[i] = color;
+}
+
+static void ref_copy(lv_color_t *dst, const lv_color_t *src, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) dst[i] = src[i];
+}
+
+static void ref_recolor(lv_color_t *dst, const lv_color_t *src, uint32_t n, lv_color_t color, lv_opa_t opa) {
+  uint16_t premult[3];
+  lv_color_premult(color, opa, premult);
+  for (uint32_t i = 0; i < n; i++) dst[i] = lv_color_mix_premult(premult, src[i], 255 - opa);
+}
+
+// MAP_NORMAL_MASK_PX
+static void ref_blend(lv_color_t *dst, const lv_color_t *src, const lv_opa_t *alpha, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    if (alpha[i] == LV_OPA_COVER) dst[i] = src[i];
+    else if (alpha[i]) dst[i] = lv_color_mix(src[i], dst[i], alpha[i]);
+  }
+}
+
+// FILL_NORMAL_MASK_PX
+static void ref_blend_color(lv_color_t *dst, lv_color_t color, const lv_opa_t *alpha, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++) {
+    if (alpha[i] == LV_OPA_COVER) dst[i] = color;
+    else if (alpha[i]) dst[i] = lv_color_mix(color, dst[i], alpha[i]);
+  }
+}
+
+// fill_normal(), uniform opacity, no mask
+static void ref_blend_fill(lv_color_t *dest, int32_t stride, int32_t w, int32_t h, lv_color_t color,
+                           lv_opa_t opa) {
+  lv_color_t last_dest = lv_color_black();
+  lv_color_t last_res = lv_color_mix(color, last_dest, opa);
+  uint16_t premult[3];
+  lv_color_premult(color, opa, premult);
+  for (int32_t y = 0; y < h; y++) {
+    for (int32_t x = 0; x < w; x++) {
+      if (last_dest.full != dest[x].full) {
+        last_dest = dest[x];
+        last_res = lv_color_mix_premult(premult, dest[x], 255 - opa);
+      }
+      dest[x] = last_res;
+    }
+    dest += stride;
+  }
+}
+
+// fill_normal(), masked
+static void ref_fill_masked(lv_color_t *dest, int32_t stride, int32_t w, int32_t h, lv_color_t color, lv_opa_t opa,
+                            const lv_opa_t *mask, int32_t mask_stride) {
+  for (int32_t y = 0; y < h; y++, dest += stride, mask += mask_stride) {
+    if (opa >= LV_OPA_MAX) {
+      ref_blend_color(dest, color, mask, w);
+      continue;
+    }
+    for (int32_t x = 0; x < w; x++) {
+      if (!mask[x]) continue;
+      lv_opa_t opa_tmp = mask[x] == LV_OPA_COVER ? opa : (lv_opa_t)((mask[x] * opa) >> 8);
+      dest[x] = opa_tmp == LV_OPA_COVER ? color : lv_color_mix(color, dest[x], opa_tmp);
+    }
+  }
+}
+
+// map_normal()
+static void ref_map(lv_color_t *dest, int32_t stride, int32_t w, int32_t h, const lv_color_t *src, int32_t src_stride,
+                    lv_opa_t opa, const lv_opa_t *mask, int32_t mask_stride) {
+  for (int32_t y = 0; y < h; y++, dest += stride, src += src_stride, mask += mask ? mask_stride : 0) {
+    for (int32_t x = 0; x < w; x++) {
+      if (!mask) {
+        dest[x] = opa >= LV_OPA_MAX ? src[x] : lv_color_mix(src[x], dest[x], opa);
+      } else if (opa > LV_OPA_MAX) {
+        ref_blend(dest + x, src + x, mask + x, 1);
+      } else if (mask[x]) {
+        lv_opa_t opa_tmp = mask[x] >= LV_OPA_MAX ? opa : (lv_opa_t)((opa * mask[x]) >> 8);
+        dest[x] = lv_color_mix(src[x], dest[x], opa_tmp);
+      }
+    }
+  }
+}
+
+/******************************************************************************
+ * LVGL around the hooks
+ ******************************************************************************/
+static lv_disp_drv_t g_drv = { 100, 64, NULL, 0 };
+static lv_disp_t g_disp = { &g_drv };
+
+lv_disp_t *_lv_refr_get_disp_refreshing(void) {
+  return &g_disp;
+}
+lv_coord_t lv_disp_get_hor_res(lv_disp_t *disp) {
+  return disp->driver->hor_res;
+}
+void lv_draw_sw_init_ctx(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx) {
+  (void)drv;
+  (void)draw_ctx;
+}
+void *lv_mem_buf_get(uint32_t size) {
+  return malloc(size);
+}
+void lv_mem_buf_release(void *p) {
+  free(p);
+}
+bool lv_draw_mask_is_any(const lv_area_t *a) {
+  (void)a;
+  return false;
+}
+lv_draw_mask_res_t lv_draw_mask_apply(lv_opa_t *mask_buf, lv_coord_t abs_x, lv_coord_t abs_y, lv_coord_t len) {
+  (void)mask_buf, (void)abs_x, (void)abs_y, (void)len;
+  return LV_DRAW_MASK_RES_FULL_COVER;
+}
+void lv_draw_sw_blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc) {
+  ((lv_draw_sw_ctx_t *)draw_ctx)->blend(draw_ctx, dsc);
+}
+
+// The normal blend mode of lv_draw_sw_blend_basic()
+void lv_draw_sw_blend_basic(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc) {
+  if (dsc->opa <= LV_OPA_MIN) return;
+  if (dsc->mask_buf && dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) return;
+  const lv_opa_t *mask = dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER ? NULL : dsc->mask_buf;
+  lv_area_t area;
+  if (!_lv_area_intersect(&area, dsc->blend_area, draw_ctx->clip_area)) return;
+  int32_t stride = lv_area_get_width(draw_ctx->buf_area);
+  lv_color_t *dest = (lv_color_t *)draw_ctx->buf + stride * (area.y1 - draw_ctx->buf_area->y1) +
+                     (area.x1 - draw_ctx->buf_area->x1);
+  int32_t mask_stride = 0;
+  if (mask) {
+    mask_stride = lv_area_get_width(dsc->mask_area);
+    mask += mask_stride * (area.y1 - dsc->mask_area->y1) + (area.x1 - dsc->mask_area->x1);
+  }
+  int32_t w = lv_area_get_width(&area), h = lv_area_get_height(&area);
+  if (dsc->src_buf) {
+    int32_t src_stride = lv_area_get_width(dsc->blend_area);
+    const lv_color_t *src = dsc->src_buf + src_stride * (area.y1 - dsc->blend_area->y1) +
+                            (area.x1 - dsc->blend_area->x1);
+    ref_map(dest, stride, w, h, src, src_stride, dsc->opa, mask, mask_stride);
+  } else if (mask) {
+    ref_fill_masked(dest, stride, w, h, dsc->color, dsc->opa, mask, mask_stride);
+  } else if (dsc->opa >= LV_OPA_MAX) {
+    for (int32_t y = 0; y < h; y++) ref_fill(dest + y * stride, dsc->color, w);
+  } else {
+    ref_blend_fill(dest, stride, w, h, dsc->color, dsc->opa);
+  }
+}
+
+// lv_draw_sw_img_decoded() for untransformed true-colour images
+void lv_draw_sw_img_decoded(lv_draw_ctx_t *draw_ctx, const lv_draw_img_dsc_t *draw_dsc, const lv_area_t *coords,
+                            const uint8_t *src_buf, lv_img_cf_t cf) {
+  lv_area_t blend_area = *draw_ctx->clip_area;
+  int32_t src_w = lv_area_get_width(coords);
+  int32_t blend_w = lv_area_get_width(&blend_area);
+  uint32_t max_buf_size = lv_disp_get_hor_res(_lv_refr_get_disp_refreshing());
+  uint32_t buf_h = lv_area_get_size(&blend_area) <= max_buf_size ? lv_area_get_height(&blend_area)
+                                                                   : max_buf_size / blend_w;
+  uint32_t buf_size = blend_w * buf_h;
+  lv_color_t *rgb_buf = (lv_color_t *)malloc(buf_size * sizeof(lv_color_t));
+  lv_opa_t *mask_buf = (lv_opa_t *)malloc(buf_size);
+  lv_draw_sw_blend_dsc_t dsc;
+  memset(&dsc, 0, sizeof(dsc));
+  dsc.opa = draw_dsc->opa;
+  dsc.blend_area = &blend_area;
+  dsc.src_buf = rgb_buf;
+  dsc.mask_buf = mask_buf;
+  dsc.mask_area = &blend_area;
+  dsc.mask_res = cf == LV_IMG_CF_TRUE_COLOR ? LV_DRAW_MASK_RES_FULL_COVER : LV_DRAW_MASK_RES_CHANGED;
+  lv_coord_t y_last = blend_area.y2;
+  blend_area.y2 = blend_area.y1 + buf_h - 1;
+  while (blend_area.y1 <= y_last) {
+    for (lv_coord_t y = blend_area.y1; y <= blend_area.y2; y++) {
+      for (lv_coord_t x = blend_area.x1; x <= blend_area.x2; x++) {
+        uint32_t i = (y - blend_area.y1) * blend_w + (x - blend_area.x1);
+        uint32_t px = (y - coords->y1) * src_w + (x - coords->x1);
+        if (cf == LV_IMG_CF_TRUE_COLOR) {
+          rgb_buf[i] = ((const lv_color_t *)src_buf)[px];
+          mask_buf[i] = LV_OPA_COVER;
+        } else {
+          rgb_buf[i].full = src_buf[px * 3] + (src_buf[px * 3 + 1] << 8);
+          mask_buf[i] = src_buf[px * 3 + 2];
+        }
+      }
+    }
+    ref_recolor(rgb_buf, rgb_buf, buf_size, draw_dsc->recolor, draw_dsc->recolor_opa);
+    lv_draw_sw_blend(draw_ctx, &dsc);
+    blend_area.y1 = blend_area.y2 + 1;
+    blend_area.y2 = blend_area.y1 + buf_h - 1;
+    if (blend_area.y2 > y_last) blend_area.y2 = y_last;
+  }
+  free(mask_buf);
+  free(rgb_buf);
+}
+
+/******************************************************************************
+ * Bit-exactness
+ ******************************************************************************/
+typedef struct {
+  const char *name;
+  void (*fill)(lv_color_t *, lv_color_t, uint32_t);
+  void (*copy)(lv_color_t *, const lv_color_t *, uint32_t);
+  void (*recolor)(lv_color_t *, const lv_color_t *, uint32_t, lv_color_t, lv_opa_t);
+  void (*blend)(lv_color_t *, const lv_color_t *, const lv_opa_t *, uint32_t);
+  void (*blend_color)(lv_color_t *, lv_color_t, const lv_opa_t *, uint32_t);
+  void (*draw_blend)(lv_draw_ctx_t *, const lv_draw_sw_blend_dsc_t *);
+  void (*draw_img_decoded)(lv_draw_ctx_t *, const lv_draw_img_dsc_t *, const lv_area_t *, const uint8_t *,
+                           lv_img_cf_t);
+  void (*get_stats)(px_stats_t *);
+} kernels_t;
+
+static const kernels_t g_ref = { "lvgl", ref_fill, ref_copy, ref_recolor, ref_blend, ref_blend_color,
+                                 lv_draw_sw_blend_basic, lv_draw_sw_img_decoded, NULL };
+static const kernels_t g_versions[] = {
+  { "portable", port::px_fill, port::px_copy, port::px_recolor, port::px_blend, port::px_blend_color,
+    port::px_draw_blend, port::px_draw_img_decoded, port::px_get_stats },
+  { "vector", vec::px_fill, vec::px_copy, vec::px_recolor, vec::px_blend, vec::px_blend_color,
+    vec::px_draw_blend, vec::px_draw_img_decoded, vec::px_get_stats },
+};
+
+#define GUARD 8
+#define MAXLEN 80
+
+static uint32_t g_rand = 12345;
+static uint16_t rnd16(void) {
+  g_rand = g_rand * 1103515245u + 12345u;
+  return (uint16_t)(g_rand >> 12);
+}
+
+// An alpha mask as text and anti-aliased edges have it: runs of clear and
+// covered pixels with partial ones in between
+static void make_mask(lv_opa_t *mask, uint32_t n) {
+  for (uint32_t i = 0; i < n;) {
+    uint32_t len = 1 + rnd16() % 12;
+    uint16_t kind = rnd16() % 3;
+    for (; len-- && i < n; i++) mask[i] = kind == 0 ? 0 : kind == 1 ? 255 : (lv_opa_t)rnd16();
+  }
+}
+
+// Fill, copy and alpha blends of every length at every alignment; returns
+// mismatches
+static uint32_t check_runs(const kernels_t *k) {
+  alignas(16) static lv_color_t src[MAXLEN + 16], a[MAXLEN + 2 * GUARD + 16], b[MAXLEN + 2 * GUARD + 16];
+  static lv_opa_t mask[MAXLEN];
+  static const char *const ops[] = { "fill", "copy", "blend", "blend color" };
+  uint32_t bad = 0;
+  for (uint32_t i = 0; i < MAXLEN + 16; i++) src[i].full = rnd16();
+  for (uint32_t len = 0; len <= MAXLEN; len++) {
+    for (uint32_t doff = 0; doff < 8; doff++) {
+      for (uint32_t soff = 0; soff < 8; soff++) {
+        lv_color_t c;
+        c.full = rnd16();
+        make_mask(mask, len);
+        for (int op = 0; op < 4; op++) {
+          for (uint32_t i = 0; i < sizeof(a) / sizeof(a[0]); i++) a[i].full = b[i].full = (uint16_t)(0xA5A5 ^ i);
+          lv_color_t *da = a + GUARD + doff, *db = b + GUARD + doff;
+          if (op == 0) {
+            g_ref.fill(da, c, len);
+            k->fill(db, c, len);
+          } else if (op == 1) {
+            g_ref.copy(da, src + soff, len);
+            k->copy(db, src + soff, len);
+          } else if (op == 2) {
+            g_ref.blend(da, src + soff, mask, len);
+            k->blend(db, src + soff, mask, len);
+          } else {
+            g_ref.blend_color(da, c, mask, len);
+            k->blend_color(db, c, mask, len);
+          }
+          if (memcmp(a, b, sizeof(a)) != 0 && bad++ < 5)
+            printf("  %s: %s of %u px, dst +%u, src +%u differs\n", k->name, ops[op], (unsigned)len, (unsigned)doff,
+                   (unsigned)soff);
+        }
+      }
+    }
+  }
+  return bad;
+}
+
+// Recolor of all 65536 source pixels at every opacity, for a few colours,
+// (the kernels in place, as px_blend_fill() calls them)
+static uint32_t check_recolor(const kernels_t *k) {
+  static lv_color_t all[65536], a[65536], b[65536];
+  static const uint32_t colours[] = { 0x000000, 0xFFFFFF, 0xFF0000, 0x00FF00, 0x0000FF, 0x336699, 0xC0FFEE };
+  uint32_t bad = 0;
+  for (uint32_t i = 0; i < 65536; i++) all[i].full = (uint16_t)i;
+  for (size_t ci = 0; ci < sizeof(colours) / sizeof(colours[0]); ci++) {
+    lv_color_t c = lv_color_hex(colours[ci]);
+    for (uint32_t opa = 1; opa < 256; opa++) {
+      g_ref.recolor(a, all, 65536, c, (lv_opa_t)opa);
+      memcpy(b, all, sizeof(b));
+      k->recolor(b, b, 65536, c, (lv_opa_t)opa);
+      if (memcmp(a, b, sizeof(a)) != 0 && bad++ < 5)
+        printf("  %s: recolor with #%06X at opa %u differs\n", k->name, (unsigned)colours[ci], (unsigned)opa);
+    }
+  }
+  return bad;
+}
+
+// Alpha blend of all 65536 source pixels over a scrambled destination at
+// every alpha, and of the colours above over all 65536 destination pixels
+static uint32_t check_blend(const kernels_t *k) {
+  alignas(16) static lv_color_t all[65536], dst[65536], a[65536], b[65536];
+  static lv_opa_t alpha[65536];
+  static const uint32_t colours[] = { 0x000000, 0xFFFFFF, 0xFF0000, 0x00FF00, 0x0000FF, 0x336699, 0xC0FFEE };
+  uint32_t bad = 0;
+  for (uint32_t i = 0; i < 65536; i++) {
+    all[i].full = (uint16_t)i;
+    dst[i].full = (uint16_t)(i * 40503u + 7);
+  }
+  for (uint32_t opa = 0; opa < 256; opa++) {
+    memset(alpha, (int)opa, sizeof(alpha));
+    memcpy(a, dst, sizeof(a));
+    memcpy(b, dst, sizeof(b));
+    g_ref.blend(a, all, alpha, 65536);
+    k->blend(b, all, alpha, 65536);
+    if (memcmp(a, b, sizeof(a)) != 0 && bad++ < 5)
+      printf("  %s: blend at alpha %u differs\n", k->name, (unsigned)opa);
+    for (size_t ci = 0; ci < sizeof(colours) / sizeof(colours[0]); ci++) {
+      lv_color_t c = lv_color_hex(colours[ci]);
+      memcpy(a, all, sizeof(a));
+      memcpy(b, all, sizeof(b));
+      g_ref.blend_color(a, c, alpha, 65536);
+      k->blend_color(b, c, alpha, 65536);
+      if (memcmp(a, b, sizeof(a)) != 0 && bad++ < 5)
+        printf("  %s: blend of #%06X at alpha %u differs\n", k->name, (unsigned)colours[ci], (unsigned)opa);
+    }
+  }
+  return bad;
+}
+
+// The uniform-opacity fill of the LVGL hook over a band with runs of
+// repeated pixels, as a dashboard background under an overlay has
+static uint32_t check_blend_fill(void (*blend)(lv_color_t *, lv_coord_t, int32_t, int32_t, lv_color_t, lv_opa_t),
+                                 const char *name) {
+  enum { BW = 64, BH = 16, STRIDE = 80 };
+  static lv_color_t a[STRIDE * BH], b[STRIDE * BH];
+  uint32_t bad = 0;
+  for (uint32_t round = 0; round < 2000; round++) {
+    for (uint32_t i = 0; i < STRIDE * BH; i++) a[i].full = (i % 7 == 0 || round & 1) ? rnd16() : a[i ? i - 1 : 0].full;
+    memcpy(b, a, sizeof(a));
+    lv_color_t c;
+    c.full = rnd16();
+    lv_opa_t opa = (lv_opa_t)(LV_OPA_MIN + rnd16() % (LV_OPA_MAX - LV_OPA_MIN));
+    ref_blend_fill(a, STRIDE, BW, BH, c, opa);
+    blend(b, STRIDE, BW, BH, c, opa);
+    if (memcmp(a, b, sizeof(a)) != 0 && bad++ < 5) printf("  %s: blend fill, round %u differs\n", name, (unsigned)round);
+  }
+  return bad;
+}
+
+// A draw buffer of 80 x 24 at (20, 10), clipped to a random area in it
+enum { BUF_W = 80, BUF_H = 24, BUF_X = 20, BUF_Y = 10 };
+
+typedef struct {
+  lv_draw_sw_ctx_t ctx;
+  lv_area_t buf_area, clip;
+  lv_color_t buf[BUF_W * BUF_H];
+} draw_t;
+
+static void rnd_area(lv_area_t *a, int32_t x, int32_t y, int32_t w, int32_t h) {
+  a->x1 = (lv_coord_t)(x + rnd16() % w);
+  a->y1 = (lv_coord_t)(y + rnd16() % h);
+  a->x2 = (lv_coord_t)(a->x1 + rnd16() % w);
+  a->y2 = (lv_coord_t)(a->y1 + rnd16() % h);
+}
+
+static void draw_init(draw_t *d, const kernels_t *k, const draw_t *from) {
+  memset(&d->ctx, 0, sizeof(d->ctx));
+  d->buf_area = { BUF_X, BUF_Y, BUF_X + BUF_W - 1, BUF_Y + BUF_H - 1 };
+  d->ctx.base_draw.buf = d->buf;
+  d->ctx.base_draw.buf_area = &d->buf_area;
+  d->ctx.base_draw.clip_area = &d->clip;
+  d->ctx.blend = k->draw_blend;
+  if (from) {
+    d->clip = from->clip;
+    memcpy(d->buf, from->buf, sizeof(d->buf));
+  } else {
+    rnd_area(&d->clip, BUF_X, BUF_Y, BUF_W / 2, BUF_H / 2);
+    for (uint32_t i = 0; i < BUF_W * BUF_H; i++) d->buf[i].full = i % 5 ? d->buf[i - 1].full : rnd16();
+  }
+}
+
+static uint32_t fallbacks(const kernels_t *k) {
+  px_stats_t st;
+  k->get_stats(&st);
+  return st.fallbacks;
+}
+
+// px_draw_blend() on masked fills and masked or translucent images, each
+// compared with lv_draw_sw_blend_basic() on the same buffer
+static uint32_t check_hook_blend(const kernels_t *k) {
+  static const lv_opa_t opas[] = { 255, 254, 253, 252, 200, 128, 40, 3 };
+  static draw_t ref, got;
+  static lv_color_t src[BUF_W * BUF_H];
+  static lv_opa_t mask[BUF_W * BUF_H];
+  uint32_t bad = 0, fb = fallbacks(k);
+  for (uint32_t round = 0; round < 20000; round++) {
+    draw_init(&ref, &g_ref, NULL);
+    draw_init(&got, k, &ref);
+    lv_area_t area;
+    rnd_area(&area, BUF_X - 8, BUF_Y - 4, BUF_W, BUF_H);
+    uint32_t n = lv_area_get_size(&area);
+    for (uint32_t i = 0; i < n; i++) src[i].full = rnd16();
+    make_mask(mask, n);
+    lv_draw_sw_blend_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.blend_area = &area;
+    dsc.mask_area = &area;
+    dsc.color.full = rnd16();
+    dsc.opa = opas[round % (sizeof(opas) / sizeof(opas[0]))];
+    dsc.src_buf = round & 8 ? src : NULL;
+    bool masked = !dsc.src_buf || round & 16;
+    dsc.mask_buf = masked ? mask : NULL;
+    dsc.mask_res = masked ? LV_DRAW_MASK_RES_CHANGED : LV_DRAW_MASK_RES_FULL_COVER;
+    ref.ctx.blend(&ref.ctx.base_draw, &dsc);
+    got.ctx.blend(&got.ctx.base_draw, &dsc);
+    if (memcmp(ref.buf, got.buf, sizeof(ref.buf)) != 0 && bad++ < 5)
+      printf("  %s: %s%s at opa %u differs\n", k->name, masked ? "masked " : "translucent ",
+             dsc.src_buf ? "image" : "fill", (unsigned)dsc.opa);
+  }
+  if (fallbacks(k) != fb) {
+    printf("  %s: %u blends fell back to LVGL\n", k->name, (unsigned)(fallbacks(k) - fb));
+    bad++;
+  }
+  return bad;
+}
+
+// px_draw_img_decoded() on recoloured images, against
+// lv_draw_sw_img_decoded(); the display is 100 pixels wide, so larger clip
+// areas are converted in several chunks
+static uint32_t check_hook_img(const kernels_t *k) {
+  static draw_t ref, got;
+  static uint8_t img[BUF_W * BUF_H * LV_IMG_PX_SIZE_ALPHA_BYTE];
+  uint32_t bad = 0, fb = fallbacks(k);
+  for (uint32_t round = 0; round < 4000; round++) {
+    draw_init(&ref, &g_ref, NULL);
+    draw_init(&got, k, &ref);
+    lv_area_t coords;
+    rnd_area(&coords, BUF_X - 8, BUF_Y - 4, BUF_W, BUF_H);
+    // LVGL clips the draw to the image first
+    _lv_area_intersect(&ref.clip, &ref.clip, &coords);
+    if (!_lv_area_intersect(&got.clip, &got.clip, &coords)) continue;
+    for (uint32_t i = 0; i < sizeof(img); i++) img[i] = (uint8_t)rnd16();
+    lv_img_cf_t cf = round & 1 ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+    lv_draw_img_dsc_t dsc;
+    memset(&dsc, 0, sizeof(dsc));
+    dsc.zoom = LV_IMG_ZOOM_NONE;
+    dsc.recolor.full = rnd16();
+    dsc.recolor_opa = (lv_opa_t)(LV_OPA_MIN + 1 + rnd16() % (256 - LV_OPA_MIN - 1));
+    dsc.opa = round & 2 ? LV_OPA_COVER : (lv_opa_t)(LV_OPA_MIN + 1 + rnd16() % 250);
+    g_ref.draw_img_decoded(&ref.ctx.base_draw, &dsc, &coords, img, cf);
+    k->draw_img_decoded(&got.ctx.base_draw, &dsc, &coords, img, cf);
+    if (memcmp(ref.buf, got.buf, sizeof(ref.buf)) != 0 && bad++ < 5)
+      printf("  %s: %s image recoloured at %u differs\n", k->name, round & 1 ? "alpha" : "opaque",
+             (unsigned)dsc.recolor_opa);
+  }
+  if (fallbacks(k) != fb) {
+    printf("  %s: %u image blends fell back to LVGL\n", k->name, (unsigned)(fallbacks(k) - fb));
+    bad++;
+  }
+  return bad;
+}
+
+/******************************************************************************
+ * Timing
+ ******************************************************************************/
+#define BAND_W 536
+#define BAND_H 24
+#define BAND_PX (BAND_W * BAND_H)
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static volatile uint16_t g_sink;
+
+// Mpx/s of one operation on the flush band: "blend" is a translucent
+// image, "mask" text in one colour
+static double bench(const kernels_t *k, int op, int reps) {
+  alignas(16) static lv_color_t src[BAND_PX], dst[BAND_PX];
+  static lv_opa_t opa[BAND_PX], text[BAND_PX];
+  for (uint32_t i = 0; i < BAND_PX; i++) {
+    src[i].full = (uint16_t)(i * 2654435761u >> 16);
+    opa[i] = (lv_opa_t)(i * 7 % 251 + 3);
+  }
+  make_mask(text, BAND_PX);
+  lv_color_t c = lv_color_hex(0x3080C0);
+  double t0 = now_s();
+  for (int r = 0; r < reps; r++) {
+    switch (op) {
+      case 0: k->fill(dst, c, BAND_PX); break;
+      case 1: k->copy(dst, src, BAND_PX); break;
+      case 2: k->recolor(dst, src, BAND_PX, c, (lv_opa_t)(64 + (r & 127))); break;
+      case 3: k->blend(dst, src, opa, BAND_PX); break;
+      case 4: k->blend_color(dst, c, text, BAND_PX); break;
+    }
+    g_sink = dst[r % BAND_PX].full;
+  }
+  double dt = now_s() - t0;
+  return dt > 0 ? (double)BAND_PX * reps / dt / 1e6 : 0;
+}
+
+int main(int argc, char *argv[]) {
+  int reps = 2000;
+  for (int a = 1; a < argc; a++) {
+    if (!strcmp(argv[a], "-n") && a + 1 < argc) {
+      reps = atoi(argv[++a]);
+    } else {
+      fprintf(stderr, "usage: %s [-n reps]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (reps <= 0) reps = 1;
+
+  uint32_t bad = 0;
+  for (size_t v = 0; v < sizeof(g_versions) / sizeof(g_versions[0]); v++) {
+    const kernels_t *k = &g_versions[v];
+    uint32_t b = check_runs(k) + check_recolor(k) + check_blend(k);
+    printf("%-9s bit-exact with lvgl: %s\n", k->name, b ? "NO" : "yes");
+    uint32_t h = check_hook_blend(k) + check_hook_img(k);
+    printf("%-9s hooks match lvgl:    %s\n", k->name, h ? "NO" : "yes");
+    bad += b + h;
+  }
+  // px_blend_fill() is the same code in both builds
+  bad += check_blend_fill(vec::px_blend_fill, "blend fill");
+
+  static const char *const ops[] = { "fill", "copy", "recolor", "blend", "mask" };
+  enum { NOPS = sizeof(ops) / sizeof(ops[0]) };
+  printf("\n%-9s", "");
+  for (int op = 0; op < NOPS; op++) printf(" %10s", ops[op]);
+  printf("   Mpx/s, %d x %d band, %d reps\n", BAND_W, BAND_H, reps);
+  const kernels_t *all[] = { &g_ref, &g_versions[0], &g_versions[1] };
+  for (size_t v = 0; v < 3; v++) {
+    printf("%-9s", all[v]->name);
+    for (int op = 0; op < NOPS; op++) printf(" %10.0f", bench(all[v], op, reps));
+    printf("\n");
+  }
+  fprintf(stderr, "%u mismatches (LV_COLOR_16_SWAP %d)\n", (unsigned)bad, LV_COLOR_16_SWAP);
+  return bad ? 1 : 0;
+}
@@ -0,0 +1,234 @@
+// Host-side test of the 'S' driver's read cache (websocket/sd_cache.c)
+// against a directory standing in for the SD card.
+//
+//   cc -O2 -I../../websocket -o sdcache sdcache.c ../../websocket/sd_cache.c
+//   ./sdcache [-c cache_kb] [-r readahead_kb] [-t] dir
+//
+// Every regular file in `dir` is put through access patterns like those of
+// LVGL's decoders, each read checked against the file's content:
+//   header    open, read the 12-byte header, close; twice (info, then open)
+//   rows      an image decoded line by line: 480-byte reads in sequence
+//   areas     partial redraws: seek to each row of a rectangle, read a slice
+//   glyphs    a font: scattered small reads into a table, then the data
+//   whole     one read of the full file (lodepng, the bundle loader)
+// The mock card counts transactions; -t traces each one. The uncached
+// figure is one transaction per read call, which is what the driver did.
+// Exits 1 if any read returned wrong data.
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "sd_cache.h"
+
+/******************************************************************************
+ * Mock card
+ ******************************************************************************/
+typedef struct {
+  FILE *f;
+  const char *name;
+} mock_file_t;
+
+static int g_trace = 0;
+static uint32_t g_transactions = 0;
+
+static uint32_t mock_read(void *handle, uint32_t off, void *buf, uint32_t n) {
+  mock_file_t *m = (mock_file_t *) handle;
+  g_transactions++;
+  if (g_trace) printf("  sd %-24s off %8lu len %6lu\n", m->name, (unsigned long) off, (unsigned long) n);
+  if (fseek(m->f, (long) off, SEEK_SET) != 0) return 0;
+  return (uint32_t) fread(buf, 1, n, m->f);
+}
+
+static uint8_t *read_file(const char *path, size_t *len) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t *buf = (uint8_t *) malloc((size_t) n + 1);
+  if (buf && fread(buf, 1, (size_t) n, f) != (size_t) n) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  if (buf) *len = (size_t) n;
+  return buf;
+}
+
+/******************************************************************************
+ * Driver model: what my_open_cb / my_read_cb / my_seek_cb do
+ ******************************************************************************/
+static sdc_cache_t g_cache;
+static uint8_t *g_ra;
+static uint32_t g_ra_cap;
+
+typedef struct {
+  mock_file_t m;
+  sdc_file_t sf;
+  const uint8_t *ref;    // expected content
+  size_t len;
+} test_file_t;
+
+static int g_errors = 0;
+static uint32_t g_calls = 0;  // read calls, the uncached transaction count
+
+static void t_open(test_file_t *t, const char *path, const char *name, const uint8_t *ref, size_t len) {
+  t->m.f = fopen(path, "rb");
+  t->m.name = name;
+  t->ref = ref;
+  t->len = len;
+  sdc_open(&t->sf, &g_cache, sdc_path_hash(name), (uint32_t) len, (uint32_t) len, g_ra, g_ra_cap,
+           mock_read, &t->m);
+}
+
+static void t_close(test_file_t *t) {
+  fclose(t->m.f);
+}
+
+static void t_read_at(test_file_t *t, uint32_t pos, uint32_t n) {
+  static uint8_t buf[1 << 20];
+  if (n > sizeof(buf)) n = sizeof(buf);
+  sdc_seek(&t->sf, pos);
+  uint32_t got;
+  g_calls++;
+  uint32_t want = pos < t->len ? (uint32_t) (t->len - pos) : 0;
+  if (want > n) want = n;
+  if (!sdc_read(&t->sf, buf, n, &got) || got != want || memcmp(buf, t->ref + pos, got) != 0) {
+    if (g_errors++ < 10) fprintf(stderr, "%s: wrong data for %lu bytes at %lu\n", t->m.name,
+                                 (unsigned long) n, (unsigned long) pos);
+  }
+}
+
+static uint32_t g_rand = 12345;
+static uint32_t rnd(uint32_t n) {
+  g_rand = g_rand * 1103515245u + 12345u;
+  return n ? (g_rand >> 8) % n : 0;
+}
+
+/******************************************************************************
+ * Patterns
+ ******************************************************************************/
+#define ROW 480   // a 240-pixel RGB565 line
+
+static void p_header(test_file_t *t) {
+  t_read_at(t, 0, 12);
+}
+
+static void p_rows(test_file_t *t) {
+  for (uint32_t p = 12; p < t->len; p += ROW) t_read_at(t, p, ROW);
+}
+
+static void p_areas(test_file_t *t) {
+  uint32_t rows = (uint32_t) (t->len / ROW);
+  for (int a = 0; a < 8 && rows; a++) {
+    uint32_t y = rnd(rows), h = 1 + rnd(24), x = rnd(ROW / 2) & ~1u, w = 2 + (rnd(ROW / 2) & ~1u);
+    for (uint32_t r = y; r < y + h && r < rows; r++) t_read_at(t, 12 + r * ROW + x, w);
+  }
+}
+
+static void p_glyphs(test_file_t *t) {
+  uint32_t table = t->len < 2048 ? (uint32_t) t->len : 2048;
+  for (int g = 0; g < 200; g++) {
+    t_read_at(t, rnd(table / 8) * 8, 8);                    // glyph descriptor
+    t_read_at(t, table + rnd((uint32_t) t->len), 16 + rnd(48));  // its bitmap
+  }
+}
+
+static void p_whole(test_file_t *t) {
+  t_read_at(t, 0, (uint32_t) t->len);
+}
+
+typedef struct {
+  const char *name;
+  void (*run)(test_file_t *t);
+  int header_first;  // decoder info open before the real one
+} pattern_t;
+
+static const pattern_t g_patterns[] = {
+  { "header", p_header, 1 },
+  { "rows",   p_rows,   1 },
+  { "areas",  p_areas,  1 },
+  { "glyphs", p_glyphs, 0 },
+  { "whole",  p_whole,  0 },
+};
+
+int main(int argc, char *argv[]) {
+  uint32_t cache_kb = SDC_CACHE_DEFAULT / 1024, ra_kb = SDC_READAHEAD_DEFAULT / 1024;
+  int a = 1;
+  for (; a < argc && argv[a][0] == '-'; a++) {
+    if (!strcmp(argv[a], "-t")) g_trace = 1;
+    else if (!strcmp(argv[a], "-c") && a + 1 < argc) cache_kb = (uint32_t) atoi(argv[++a]);
+    else if (!strcmp(argv[a], "-r") && a + 1 < argc) ra_kb = (uint32_t) atoi(argv[++a]);
+    else break;
+  }
+  if (argc - a != 1 || ra_kb == 0) {
+    fprintf(stderr, "usage: %s [-c cache_kb] [-r readahead_kb] [-t] dir\n", argv[0]);
+    return 2;
+  }
+  DIR *d = opendir(argv[a]);
+  if (!d) {
+    fprintf(stderr, "%s: cannot open %s\n", argv[0], argv[a]);
+    return 1;
+  }
+  size_t cache_size = (size_t) cache_kb * 1024;
+  void *mem = malloc(cache_size + 1);
+  uint32_t blocks = sdc_cache_init(&g_cache, mem, cache_size);
+  g_ra_cap = ra_kb * 1024;
+  g_ra = (uint8_t *) malloc(g_ra_cap);
+
+  printf("%-8s %8s %8s %8s %7s %10s\n", "pattern", "reads", "uncached", "cached", "hit %", "saved");
+  struct dirent *de;
+  int files = 0;
+  sdc_stats_t total_before = g_cache.stats;
+  uint32_t total_calls = 0, total_sd = 0;
+  for (size_t p = 0; p < sizeof(g_patterns) / sizeof(g_patterns[0]); p++) {
+    const pattern_t *pat = &g_patterns[p];
+    sdc_stats_t before = g_cache.stats;
+    uint32_t calls0 = g_calls, sd0 = g_transactions;
+    rewinddir(d);
+    files = 0;
+    while ((de = readdir(d)) != NULL) {
+      char path[1024];
+      snprintf(path, sizeof(path), "%s/%s", argv[a], de->d_name);
+      struct stat st;
+      if (de->d_name[0] == '.' || stat(path, &st) != 0 || !S_ISREG(st.st_mode) || st.st_size == 0) continue;
+      size_t len;
+      uint8_t *ref = read_file(path, &len);
+      if (!ref) continue;
+      files++;
+      if (g_trace) printf("%s %s\n", pat->name, de->d_name);
+      test_file_t t;
+      if (pat->header_first) {
+        t_open(&t, path, de->d_name, ref, len);
+        p_header(&t);
+        t_close(&t);
+      }
+      t_open(&t, path, de->d_name, ref, len);
+      pat->run(&t);
+      t_close(&t);
+      free(ref);
+    }
+    uint32_t reads = g_cache.stats.reads - before.reads, hits = g_cache.stats.hits - before.hits;
+    printf("%-8s %8lu %8lu %8lu %6.1f%% %10llu\n", pat->name, (unsigned long) reads,
+           (unsigned long) (g_calls - calls0), (unsigned long) (g_transactions - sd0),
+           reads ? 100.0 * hits / reads : 0.0,
+           (unsigned long long) (g_cache.stats.saved - before.saved));
+    total_calls += g_calls - calls0;
+    total_sd += g_transactions - sd0;
+  }
+  closedir(d);
+
+  const sdc_stats_t *s = &g_cache.stats;
+  printf("%d files, %lu cache blocks, %lu KB read-ahead: %lu -> %lu transactions, "
+         "%llu bytes read for %llu requested, %lu block hits\n", files, (unsigned long) blocks,
+         (unsigned long) ra_kb, (unsigned long) total_calls, (unsigned long) total_sd,
+         (unsigned long long) (s->sd_bytes - total_before.sd_bytes),
+         (unsigned long long) (s->bytes - total_before.bytes), (unsigned long) s->block_hits);
+  if (g_errors) {
+    fprintf(stderr, "%s: %d reads returned wrong data\n", argv[0], g_errors);
+    return 1;
+  }
+  return 0;
+}
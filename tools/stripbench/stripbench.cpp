@@ -0,0 +1,289 @@
+// Host-side check and benchmark of the strip chart (websocket/strip_chart.cpp)
+// against the full redraw lv_chart does in shift mode.
+//
+//   c++ -O2 -I../mock -I../../websocket -o stripbench stripbench.cpp ../mock/mock.cpp
+//       ../../websocket/strip_chart.cpp
+//   ./stripbench [-n samples] [-w width] [-h height] [-s step]
+//
+// Two ways to show the same stream of samples:
+//   shift   what lv_chart has to do at the least for every new value in
+//           LV_CHART_UPDATE_MODE_SHIFT: the chart is invalidated as a whole,
+//           so background, grid and every series line across all visible
+//           points are rasterized again. Drawn with the same fills and
+//           one-pixel spans as the strip chart; LVGL's anti-aliased lines,
+//           masks and tick labels cost a good deal more than this.
+//   strip   strip_chart_push(): shift the bitmap by one step and rasterize
+//           only the new columns.
+// Both end up invalidating the whole object, so the flush to the panel costs
+// the same and is left out. First the strip chart is compared with the full
+// redraw after every sample (4 series, gaps, missing values, vertical grid
+// lines every 10 samples); then both process `samples` values. Exits 1 on
+// any mismatch.
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Arduino.h"
+#include "lvgl.h"
+#include "strip_chart.h"
+
+/******************************************************************************
+ * Minimal LVGL objects
+ ******************************************************************************/
+struct _lv_obj_t {
+  const lv_obj_class_t *cls;
+  void *user_data;
+  lv_color_t *buf;
+  lv_coord_t w, h;
+  lv_event_cb_t delete_cb;
+  void *delete_data;
+  uint32_t invalidated;
+};
+
+struct _lv_event_t {
+  void *user_data;
+};
+
+const lv_obj_class_t lv_canvas_class = { "canvas" };
+
+lv_obj_t *lv_scr_act(void) {
+  return NULL;
+}
+
+lv_obj_t *lv_canvas_create(lv_obj_t *parent) {
+  (void)parent;
+  lv_obj_t *o = (lv_obj_t *)calloc(1, sizeof(lv_obj_t));
+  o->cls = &lv_canvas_class;
+  return o;
+}
+
+void lv_canvas_set_buffer(lv_obj_t *obj, void *buf, lv_coord_t w, lv_coord_t h, lv_img_cf_t cf) {
+  (void)cf;
+  obj->buf = (lv_color_t *)buf;
+  obj->w = w;
+  obj->h = h;
+}
+
+bool lv_obj_check_type(const lv_obj_t *obj, const lv_obj_class_t *cls) {
+  return obj && obj->cls == cls;
+}
+
+void lv_obj_set_user_data(lv_obj_t *obj, void *data) {
+  obj->user_data = data;
+}
+
+void *lv_obj_get_user_data(lv_obj_t *obj) {
+  return obj->user_data;
+}
+
+void lv_obj_add_event_cb(lv_obj_t *obj, lv_event_cb_t cb, lv_event_code_t code, void *user_data) {
+  if (code != LV_EVENT_DELETE) return;
+  obj->delete_cb = cb;
+  obj->delete_data = user_data;
+}
+
+void *lv_event_get_user_data(lv_event_t *e) {
+  return e->user_data;
+}
+
+void lv_obj_invalidate(const lv_obj_t *obj) {
+  ((lv_obj_t *)obj)->invalidated++;
+}
+
+static void obj_delete(lv_obj_t *obj) {
+  lv_event_t e = { obj->delete_data };
+  if (obj->delete_cb) obj->delete_cb(&e);
+  free(obj);
+}
+
+/******************************************************************************
+ * Full redraw (lv_chart shift mode)
+ ******************************************************************************/
+#define NSER 4
+
+static const lv_color_t g_colors[NSER] = {
+  lv_color_hex(0xff4040), lv_color_hex(0x40ff40), lv_color_hex(0x4080ff), lv_color_hex(0xffff00),
+};
+static const lv_color_t g_bg = lv_color_hex(0x101018);
+static const lv_color_t g_grid = lv_color_hex(0x404040);
+#define H_DIV 4
+#define V_EVERY 10
+#define V_MIN (-50)
+#define V_MAX 150
+
+typedef struct {
+  lv_coord_t w, h, step;
+  lv_color_t *buf;
+  lv_color_t *bg_col;
+  int32_t *values;  // every sample so far, NSER per sample
+  uint32_t n;
+} shift_chart_t;
+
+static lv_coord_t shift_map(const shift_chart_t *c, int32_t v) {
+  int32_t y = (int32_t)((int64_t)(V_MAX - v) * (c->h - 1) / (V_MAX - V_MIN));
+  return y < 0 ? 0 : (y >= c->h ? c->h - 1 : y);
+}
+
+static void shift_init(shift_chart_t *c, lv_coord_t w, lv_coord_t h, lv_coord_t step, uint32_t max_samples) {
+  c->w = w;
+  c->h = h;
+  c->step = step;
+  c->n = 0;
+  c->buf = (lv_color_t *)malloc((size_t)w * h * sizeof(lv_color_t));
+  c->bg_col = (lv_color_t *)malloc(h * sizeof(lv_color_t));
+  c->values = (int32_t *)malloc((size_t)max_samples * NSER * sizeof(int32_t));
+  for (lv_coord_t y = 0; y < h; y++) c->bg_col[y] = g_bg;
+  for (int k = 0; k <= H_DIV; k++) c->bg_col[(h - 1) * k / H_DIV] = g_grid;
+}
+
+static void shift_redraw(shift_chart_t *c) {
+  const lv_coord_t w = c->w, h = c->h, st = c->step;
+  // Background and horizontal grid
+  for (lv_coord_t y = 0; y < h; y++) {
+    lv_color_t *row = c->buf + (size_t)y * w;
+    for (lv_coord_t x = 0; x < w; x++) row[x] = c->bg_col[y];
+  }
+  // Every visible point: vertical grid line, then each series' segment
+  // from the previous point
+  uint32_t visible = (uint32_t)(w + st - 1) / st;
+  uint32_t first = c->n > visible ? c->n - visible : 0;
+  for (uint32_t j = first; j < c->n; j++) {
+    int col = w - 1 - st * (int)(c->n - 1 - j);  // last column of sample j
+    if (j % V_EVERY == 0 && col >= 0) {
+      for (lv_coord_t y = 0; y < h; y++) c->buf[(size_t)y * w + col] = g_grid;
+    }
+    for (int i = 0; i < NSER; i++) {
+      int32_t v = c->values[j * NSER + i];
+      if (v == LV_CHART_POINT_NONE) continue;
+      lv_coord_t y1 = shift_map(c, v);
+      int32_t pv = j > 0 ? c->values[(j - 1) * NSER + i] : LV_CHART_POINT_NONE;
+      lv_coord_t y0 = pv != LV_CHART_POINT_NONE ? shift_map(c, pv) : y1;
+      lv_coord_t prev = y0;
+      for (lv_coord_t k = 1; k <= st; k++) {
+        lv_coord_t yk = y0 + (y1 - y0) * k / st;
+        int x = col - st + k;
+        lv_coord_t lo = prev < yk ? prev : yk, hi = prev < yk ? yk : prev;
+        if (x >= 0) {
+          for (lv_coord_t y = lo; y <= hi; y++) c->buf[(size_t)y * w + x] = g_colors[i];
+        }
+        prev = yk;
+      }
+    }
+  }
+}
+
+static void shift_push(shift_chart_t *c, const int32_t *v, int n) {
+  for (int i = 0; i < NSER; i++) c->values[c->n * NSER + i] = i < n ? v[i] : LV_CHART_POINT_NONE;
+  c->n++;
+  shift_redraw(c);
+}
+
+/******************************************************************************
+ * Test data
+ ******************************************************************************/
+// Sample j: four wandering series, with gaps and short calls now and then
+static int sample(uint32_t j, int32_t *v) {
+  static uint32_t rng = 12345;
+  for (int i = 0; i < NSER; i++) {
+    rng = rng * 1664525u + 1013904223u;
+    int32_t wave = (int32_t)((j * (i + 3) * 7) % 200) - 50;
+    v[i] = wave + (int32_t)(rng >> 27) - 16;  // overshoots the range at both ends
+    if ((rng >> 8) % 37 == 0) v[i] = LV_CHART_POINT_NONE;
+  }
+  return j % 53 == 52 ? 2 : NSER;  // series 2 and 3 missing from some calls
+}
+
+static lv_obj_t *strip_new(lv_coord_t w, lv_coord_t h, lv_coord_t step) {
+  lv_obj_t *obj = strip_chart_create(lv_scr_act(), w, h);
+  if (!obj) return NULL;
+  for (int i = 0; i < NSER; i++) strip_chart_add_series(obj, g_colors[i]);
+  strip_chart_set_range(obj, V_MIN, V_MAX);
+  strip_chart_set_step(obj, (uint8_t)step);
+  strip_chart_set_grid(obj, g_bg, g_grid, H_DIV, V_EVERY);
+  return obj;
+}
+
+static uint32_t compare(const lv_obj_t *obj, const shift_chart_t *c, uint32_t j) {
+  uint32_t bad = 0;
+  for (size_t p = 0; p < (size_t)c->w * c->h; p++) {
+    if (obj->buf[p].full == c->buf[p].full) continue;
+    if (bad++ < 5) {
+      fprintf(stderr, "sample %u: pixel %d,%d is %04x, full redraw has %04x\n", (unsigned)j,
+              (int)(p % c->w), (int)(p / c->w), obj->buf[p].full, c->buf[p].full);
+    }
+  }
+  return bad;
+}
+
+static double now_s(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+int main(int argc, char *argv[]) {
+  int samples = 5000, w = 400, h = 160, step = 2;
+  for (int a = 1; a < argc; a++) {
+    int *opt = NULL;
+    if (!strcmp(argv[a], "-n")) opt = &samples;
+    else if (!strcmp(argv[a], "-w")) opt = &w;
+    else if (!strcmp(argv[a], "-h")) opt = &h;
+    else if (!strcmp(argv[a], "-s")) opt = &step;
+    if (!opt || a + 1 >= argc) {
+      fprintf(stderr, "usage: %s [-n samples] [-w width] [-h height] [-s step]\n", argv[0]);
+      return 2;
+    }
+    *opt = atoi(argv[++a]);
+  }
+  if (samples <= 0 || w < 2 || h < 2 || step < 1 || step >= w || step > 255) {
+    fprintf(stderr, "stripbench: bad size\n");
+    return 2;
+  }
+
+  // Check: the strip chart after every sample equals a full redraw
+  uint32_t check_n = (uint32_t)(3 * w / step + 2 * V_EVERY);
+  uint32_t bad = 0;
+  {
+    lv_obj_t *obj = strip_new(w, h, step);
+    shift_chart_t ref;
+    shift_init(&ref, w, h, step, check_n);
+    shift_redraw(&ref);
+    bad += compare(obj, &ref, 0);
+    for (uint32_t j = 0; j < check_n && bad < 5; j++) {
+      int32_t v[NSER];
+      int n = sample(j, v);
+      strip_chart_push(obj, v, n);
+      shift_push(&ref, v, n);
+      bad += compare(obj, &ref, j);
+    }
+    printf("strip chart matches the full redraw over %u samples: %s\n", (unsigned)check_n, bad ? "NO" : "yes");
+    obj_delete(obj);
+  }
+
+  // Benchmark
+  static int32_t vals[NSER];
+  lv_obj_t *obj = strip_new(w, h, step);
+  shift_chart_t ref;
+  shift_init(&ref, w, h, step, (uint32_t)samples);
+  double t0 = now_s();
+  for (int j = 0; j < samples; j++) {
+    int n = sample(j, vals);
+    shift_push(&ref, vals, n);
+  }
+  double t_shift = now_s() - t0;
+  t0 = now_s();
+  for (int j = 0; j < samples; j++) {
+    int n = sample(j, vals);
+    strip_chart_push(obj, vals, n);
+  }
+  double t_strip = now_s() - t0;
+
+  printf("\n%-6s %12s %10s   %d x %d, %d series, step %d, %d samples\n", "", "us/sample", "speedup", w, h,
+         NSER, step, samples);
+  printf("%-6s %12.2f %10s\n", "shift", t_shift * 1e6 / samples, "1.0");
+  printf("%-6s %12.2f %10.1f\n", "strip", t_strip * 1e6 / samples, t_shift / t_strip);
+  fprintf(stderr, "%u mismatches, %u invalidations\n", (unsigned)bad, (unsigned)obj->invalidated);
+  obj_delete(obj);
+  return bad ? 1 : 0;
+}
@@ -0,0 +1,350 @@
+// Host-side test of the UI command queue and its object handle table
+// (websocket/ui_queue.cpp), built against tools/mock and the real Elk.
+//
+//   c++ -O2 -I../mock -I../../websocket -o uiqueue uiqueue.cpp ../mock/mock.cpp
+//       ../../websocket/ui_queue.cpp -x c ../../websocket/elk.c
+//   ./uiqueue [-v]
+//
+// There is only one thread on the host: whenever the Elk side would block
+// (ring full, waiting for a UI_SYNC result) the mock scheduler runs a render
+// pass instead, so commands are applied exactly where the render task could
+// have picked them up. Bridges stand in for LVGL objects with plain structs
+// and record what they were called with.
+// Handle tests check reuse and generations: a handle kept after its object
+// was released must never resolve again, not even once the slot is reused,
+// and every such lookup is counted as stale. Queue tests check argument
+// copies, long argument lists, rejected calls and handle reservation.
+// Exits 1 if any test fails.
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Arduino.h"
+#include "ui_queue.h"
+
+static int g_verbose = 0;
+static int g_failed = 0;
+
+// The render task's LVGL pass: nothing is ever due
+uint32_t lv_timer_handler(void) {
+  return 0;
+}
+
+// Blocking on the Elk side lets the render task run
+static void render_block(uint32_t ms) {
+  (void)ms;
+  ui_run_once(0);
+  mock_advance_us(1000);
+}
+
+/******************************************************************************
+ * Bridges
+ ******************************************************************************/
+typedef struct {
+  int x;
+  char text[32];
+} fake_obj_t;
+
+static fake_obj_t g_objs[8];
+static int g_nobjs = 0;
+static int g_calls = 0;
+static int g_last_nargs = 0;
+static double g_sum = 0;
+static char g_last_str[64];
+
+// create(x) => handle, -1 for x < 0
+static jsval_t js_fake_create(struct js *js, jsval_t *args, int nargs) {
+  (void)js;
+  g_calls++;
+  if (nargs < 1 || js_getnum(args[0]) < 0 || g_nobjs == 8) return js_mknum(-1);
+  fake_obj_t *o = &g_objs[g_nobjs++];
+  o->x = (int)js_getnum(args[0]);
+  int id = ui_handle_claim();
+  if (id < 0) return js_mknum(-1);
+  ui_handle_set(id, o);
+  return js_mknum(id);
+}
+
+// set_text(handle, "text")
+static jsval_t js_fake_set_text(struct js *js, jsval_t *args, int nargs) {
+  g_calls++;
+  if (nargs < 2 || js_type(args[1]) != JS_STR) return js_mknull();
+  fake_obj_t *o = (fake_obj_t *)ui_handle_get((int)js_getnum(args[0]));
+  if (!o) return js_mknull();
+  size_t len;
+  const char *s = js_getstr(js, args[1], &len);
+  snprintf(o->text, sizeof(o->text), "%.*s", (int)len, s);
+  return js_mknull();
+}
+
+// get_x(handle) => x, null for a stale handle
+static jsval_t js_fake_get_x(struct js *js, jsval_t *args, int nargs) {
+  (void)js;
+  g_calls++;
+  fake_obj_t *o = nargs > 0 ? (fake_obj_t *)ui_handle_get((int)js_getnum(args[0])) : NULL;
+  return o ? js_mknum(o->x) : js_mknull();
+}
+
+// sum(...) => number of arguments, summed into g_sum
+static jsval_t js_fake_sum(struct js *js, jsval_t *args, int nargs) {
+  g_calls++;
+  g_last_nargs = nargs;
+  g_sum = 0;
+  g_last_str[0] = 0;
+  for (int i = 0; i < nargs; i++) {
+    if (js_type(args[i]) == JS_NUM) {
+      g_sum += js_getnum(args[i]);
+    } else if (js_type(args[i]) == JS_STR) {
+      size_t len;
+      const char *s = js_getstr(js, args[i], &len);
+      snprintf(g_last_str, sizeof(g_last_str), "%.*s", (int)len, s);
+    }
+  }
+  return js_mknum(nargs);
+}
+
+/******************************************************************************
+ * Helpers
+ ******************************************************************************/
+static char g_mem[16384];
+static struct js *g_js;
+
+static void reset_js(void) {
+  g_js = js_create(g_mem, sizeof(g_mem));
+  jsval_t glob = js_glob(g_js);
+  js_set(g_js, glob, "create", js_mkfun(UI_CREATE(js_fake_create)));
+  js_set(g_js, glob, "set_text", js_mkfun(UI_ASYNC(js_fake_set_text)));
+  js_set(g_js, glob, "get_x", js_mkfun(UI_SYNC(js_fake_get_x)));
+  js_set(g_js, glob, "sum", js_mkfun(UI_ASYNC(js_fake_sum)));
+  js_set(g_js, glob, "sum_sync", js_mkfun(UI_SYNC(js_fake_sum)));
+}
+
+// Evaluate and return the result as a number, NAN if it is not one
+static double eval_num(const char *code) {
+  jsval_t v = js_eval(g_js, code, strlen(code));
+  if (js_type(v) == JS_ERR && g_verbose) printf("  %s: %s\n", code, js_str(g_js, v));
+  return js_type(v) == JS_NUM ? js_getnum(v) : NAN;
+}
+
+static bool eval_null(const char *code) {
+  return js_type(js_eval(g_js, code, strlen(code))) == JS_NULL;
+}
+
+static ui_handle_stats_t hstats(void) {
+  ui_handle_stats_t s;
+  ui_handle_get_stats(&s);
+  return s;
+}
+
+/******************************************************************************
+ * Handle tests
+ ******************************************************************************/
+static bool test_handle_reuse(void) {
+  bool ok = true;
+  static int a, b;
+  int h1 = ui_handle_claim();
+  ui_handle_set(h1, &a);
+  ok &= h1 > 0 && ui_handle_get(h1) == &a;
+  ui_handle_release(h1);
+  ok &= ui_handle_get(h1) == NULL;
+
+  // LIFO free list: the next claim takes the same slot, new generation
+  int h2 = ui_handle_claim();
+  ui_handle_set(h2, &b);
+  ok &= h2 > 0 && h2 != h1;
+  ok &= (h2 & ((1 << UI_HANDLE_INDEX_BITS) - 1)) == (h1 & ((1 << UI_HANDLE_INDEX_BITS) - 1));
+  ok &= ui_handle_get(h2) == &b && ui_handle_get(h1) == NULL;
+
+  // Releasing the stale handle must not free the live object
+  ui_handle_release(h1);
+  ok &= ui_handle_get(h2) == &b;
+  ui_handle_release(h2);
+  ok &= hstats().used == 0;
+  return ok;
+}
+
+static bool test_handle_stale(void) {
+  bool ok = true;
+  static int a;
+  uint32_t stale0 = hstats().stale;
+  int h = ui_handle_claim();
+  ui_handle_set(h, &a);
+  ui_handle_release(h);
+  ok &= ui_handle_get(h) == NULL;
+  ui_handle_set(h, &a);  // a late bind must not revive it
+  ok &= ui_handle_get(h) == NULL;
+  ok &= hstats().stale == stale0 + 3;
+
+  // Never-valid ids are rejected without counting as stale
+  ok &= ui_handle_get(0) == NULL && ui_handle_get(-1) == NULL;
+  ok &= ui_handle_get(UI_HANDLE_MAX - 1) == NULL;
+  ok &= hstats().stale == stale0 + 3;
+
+  // A reserved handle resolves to nothing until it is bound
+  int r = ui_handle_claim();
+  ok &= ui_handle_get(r) == NULL && hstats().stale == stale0 + 3;
+  ui_handle_release(r);
+  return ok;
+}
+
+// Generations wrap around without ever producing 0 or -1 or a handle seen
+// recently in the same slot
+static bool test_handle_wrap(void) {
+  bool ok = true;
+  int first = ui_handle_claim();
+  int prev = first;
+  ui_handle_release(first);
+  for (int i = 0; i < 0x1FFFF; i++) {
+    int h = ui_handle_claim();
+    if (h <= 0 || h == prev) ok = false;
+    prev = h;
+    ui_handle_release(h);
+  }
+  return ok && hstats().used == 0;
+}
+
+static bool test_handle_grow(void) {
+  bool ok = true;
+  static int objs[UI_HANDLE_MAX];
+  static int ids[UI_HANDLE_MAX];
+  for (int i = 0; i < UI_HANDLE_MAX; i++) {
+    ids[i] = ui_handle_claim();
+    if (ids[i] <= 0) return false;
+    ui_handle_set(ids[i], &objs[i]);
+  }
+  ok &= ui_handle_claim() == -1;
+  ui_handle_stats_t s = hstats();
+  ok &= s.used == UI_HANDLE_MAX && s.peak == UI_HANDLE_MAX && s.capacity == UI_HANDLE_MAX;
+  for (int i = 0; i < UI_HANDLE_MAX; i++) ok &= ui_handle_get(ids[i]) == &objs[i];
+
+  // Free every other one; the rest keep their objects
+  for (int i = 0; i < UI_HANDLE_MAX; i += 2) ui_handle_release(ids[i]);
+  for (int i = 0; i < UI_HANDLE_MAX; i++) ok &= ui_handle_get(ids[i]) == (i % 2 ? &objs[i] : NULL);
+  for (int i = 1; i < UI_HANDLE_MAX; i += 2) ui_handle_release(ids[i]);
+  ok &= hstats().used == 0;
+  return ok;
+}
+
+/******************************************************************************
+ * Queue tests
+ ******************************************************************************/
+static bool test_queue_create(void) {
+  bool ok = true;
+  reset_js();
+  g_nobjs = 0;
+  // The handle comes back before the bridge ran and works in later commands
+  double h = eval_num("let h = create(42); set_text(h, 'hello'); h;");
+  ok &= h > 0 && g_calls == 0;
+  ok &= eval_num("get_x(h);") == 42;  // sync: everything before it is applied
+  ok &= !strcmp(g_objs[0].text, "hello");
+
+  // A bridge that fails gives the reserved handle back
+  uint32_t used = hstats().used;
+  double bad = eval_num("let b = create(-1); b;");
+  ok &= bad > 0;
+  ok &= eval_null("get_x(b);") && hstats().used == used;
+  return ok;
+}
+
+static bool test_queue_args(void) {
+  bool ok = true;
+  reset_js();
+  ok &= eval_num("sum_sync(1, 2.5, true, null, 'abc');") == 5;
+  ok &= g_sum == 3.5 && !strcmp(g_last_str, "abc");
+
+  // Long calls take a heap block: a 16 point polyline is 33 arguments
+  ok &= eval_num("sum_sync(0, 1,2,3,4,5,6,7,8,9,10,11,12,13,14,15,16, "
+                 "17,18,19,20,21,22,23,24,25,26,27,28,29,30,31,'end');") == 33;
+  ok &= g_sum == 31 * 32 / 2 && !strcmp(g_last_str, "end");
+
+  // Queued strings outlive the script's own copy
+  ok &= eval_null("let s = 'x' + 'yz'; sum(s); s = 0; get_x(0);");
+  ok &= g_last_nargs == 1 && !strcmp(g_last_str, "xyz");
+  return ok;
+}
+
+static bool test_queue_reject(void) {
+  bool ok = true;
+  reset_js();
+  mock_serial_clear();
+  int calls = g_calls;
+  uint32_t used = hstats().used;
+
+  // Objects and functions cannot be copied to the render task
+  ok &= eval_null("sum({a: 1});");
+  ok &= eval_null("sum_sync(1, function() {});");
+  ok &= eval_num("create({});") == -1;
+
+  // More than UI_MAX_ARGS
+  char code[UI_MAX_ARGS * 4 + 32] = "sum(";
+  for (int i = 0; i <= UI_MAX_ARGS; i++) strcat(code, i ? ",1" : "1");
+  strcat(code, ");");
+  ok &= eval_null(code);
+  code[strlen(code) - 4] = 0;  // exactly UI_MAX_ARGS
+  strcat(code, ");");
+  ok &= eval_null(code);
+  eval_num("sum_sync();");
+
+  ok &= g_calls == calls + 2;  // only the call within the limit and the sync
+  ok &= hstats().used == used;
+  const char *log = mock_serial_text();
+  ok &= strstr(log, "object or function") && strstr(log, "arguments rejected");
+  if (g_verbose) printf("%s", log);
+  return ok;
+}
+
+// More commands than the ring holds: the producer waits for render passes
+static bool test_queue_full(void) {
+  reset_js();
+  g_calls = 0;
+  ui_stats_t s0;
+  ui_get_stats(&s0);
+  for (int i = 0; i < UI_QUEUE_LEN * 3; i++) eval_null("sum(1, 'x');");
+  eval_num("sum_sync();");
+  ui_stats_t s;
+  ui_get_stats(&s);
+  return g_calls == UI_QUEUE_LEN * 3 + 1 && s.full > s0.full && s.max_batch == UI_QUEUE_LEN;
+}
+
+typedef struct {
+  const char *name;
+  bool (*run)(void);
+} test_t;
+
+static const test_t g_tests[] = {
+  { "handle reuse", test_handle_reuse },
+  { "handle stale", test_handle_stale },
+  { "handle wrap", test_handle_wrap },
+  { "handle grow", test_handle_grow },
+  { "queue create", test_queue_create },
+  { "queue args", test_queue_args },
+  { "queue reject", test_queue_reject },
+  { "queue full", test_queue_full },
+};
+
+int main(int argc, char *argv[]) {
+  for (int a = 1; a < argc; a++) {
+    if (!strcmp(argv[a], "-v")) {
+      g_verbose = 1;
+    } else {
+      fprintf(stderr, "usage: %s [-v]\n", argv[0]);
+      return 2;
+    }
+  }
+  mock_serial_quiet = !g_verbose;
+  mock_block_hook = render_block;
+  ui_start();
+
+  for (size_t i = 0; i < sizeof(g_tests) / sizeof(g_tests[0]); i++) {
+    g_calls = 0;
+    bool ok = g_tests[i].run();
+    printf("%-18s %s\n", g_tests[i].name, ok ? "ok" : "FAIL");
+    if (!ok) g_failed++;
+  }
+  ui_handle_stats_t s = hstats();
+  fprintf(stderr, "%lu allocs, %lu frees, %lu stale lookups, peak %lu, %d failed\n",
+          (unsigned long)s.allocs, (unsigned long)s.frees, (unsigned long)s.stale,
+          (unsigned long)s.peak, g_failed);
+  return g_failed ? 1 : 0;
+}
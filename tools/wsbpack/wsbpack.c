@@ -0,0 +1,222 @@
+// Host-side packer for .wsb app bundles (websocket/bundle_fmt.h): every file
+// under an app directory, script.js included, in one file the firmware
+// mounts as /app.wsb.
+//
+//   cc -O2 -I../../websocket -o wsbpack wsbpack.c ../../websocket/bundle_fmt.c ../../websocket/js_minify.c
+//   ./wsbpack [-s] [-k] app_dir app.wsb
+//
+// script.js is minified the way the firmware would at boot (-k keeps it as
+// written). Entries are compressed where that saves at least an eighth of
+// their size, which leaves already-compressed PNG, JPEG and GIF files
+// stored; -s stores everything. Paths inside the bundle are relative to
+// app_dir, so app_dir/img/logo.png is "/img/logo.png" to the script.
+//
+// The written bundle is read back and every entry checked before exiting.
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include "bundle_fmt.h"
+#include "js_minify.h"
+
+static uint8_t *read_file(const char *path, size_t *len) {
+  FILE *f = fopen(path, "rb");
+  if (!f) return NULL;
+  fseek(f, 0, SEEK_END);
+  long n = ftell(f);
+  fseek(f, 0, SEEK_SET);
+  uint8_t *buf = (uint8_t *) malloc((size_t) n + 1);
+  if (buf && fread(buf, 1, (size_t) n, f) != (size_t) n) {
+    free(buf);
+    buf = NULL;
+  }
+  fclose(f);
+  if (buf) buf[n] = 0, *len = (size_t) n;
+  return buf;
+}
+
+/******************************************************************************
+ * Collecting files
+ ******************************************************************************/
+typedef struct {
+  char *name;          // relative to app_dir, no leading '/'
+  char *path;          // on the host
+  uint8_t *data;       // as stored
+  bundle_entry_t e;
+} item_t;
+
+static item_t *g_items = NULL;
+static size_t g_count = 0, g_cap = 0;
+
+static int collect(const char *dir, const char *prefix) {
+  DIR *d = opendir(dir);
+  if (!d) return 0;
+  struct dirent *de;
+  while ((de = readdir(d)) != NULL) {
+    if (de->d_name[0] == '.') continue;
+    char path[1024], name[1024];
+    snprintf(path, sizeof(path), "%s/%s", dir, de->d_name);
+    snprintf(name, sizeof(name), "%s%s", prefix, de->d_name);
+    struct stat st;
+    if (stat(path, &st) != 0) continue;
+    if (S_ISDIR(st.st_mode)) {
+      strncat(name, "/", sizeof(name) - strlen(name) - 1);
+      if (!collect(path, name)) {
+        closedir(d);
+        return 0;
+      }
+      continue;
+    }
+    if (!S_ISREG(st.st_mode)) continue;
+    if (g_count == g_cap) {
+      g_cap = g_cap ? g_cap * 2 : 64;
+      g_items = (item_t *) realloc(g_items, g_cap * sizeof(item_t));
+    }
+    item_t *it = &g_items[g_count++];
+    memset(it, 0, sizeof(*it));
+    it->name = strdup(name);
+    it->path = strdup(path);
+  }
+  closedir(d);
+  return 1;
+}
+
+static int by_name(const void *a, const void *b) {
+  return strcmp(((const item_t *) a)->name, ((const item_t *) b)->name);
+}
+
+/******************************************************************************
+ * Verification: what bundle_mount() and bundle_load() check
+ ******************************************************************************/
+static int verify(const uint8_t *b, size_t len) {
+  bundle_header_t h;
+  if (len < BUNDLE_HEADER_SIZE || !bundle_read_header(b, &h) || h.file_size != len) return 0;
+  size_t meta = (size_t) h.count * BUNDLE_ENTRY_SIZE + h.names_size;
+  if (BUNDLE_HEADER_SIZE + meta > h.data_offset ||
+      bundle_crc32(0, b + BUNDLE_HEADER_SIZE, meta) != h.index_crc) return 0;
+  const char *names = (const char *) b + BUNDLE_HEADER_SIZE + (size_t) h.count * BUNDLE_ENTRY_SIZE;
+  const char *prev = NULL;
+  for (uint32_t i = 0; i < h.count; i++) {
+    bundle_entry_t e;
+    bundle_read_entry(b + BUNDLE_HEADER_SIZE + (size_t) i * BUNDLE_ENTRY_SIZE, &e);
+    if (e.name >= h.names_size || e.offset % BUNDLE_ALIGN || e.offset > len || e.size > len - e.offset) return 0;
+    if (prev && strcmp(prev, names + e.name) >= 0) return 0;
+    prev = names + e.name;
+    uint8_t *raw = (uint8_t *) malloc(e.raw_size + 1);
+    int ok = (e.flags & BUNDLE_LZ) ? bundle_lz_decompress(b + e.offset, e.size, raw, e.raw_size)
+                                   : (memcpy(raw, b + e.offset, e.size), e.size == e.raw_size);
+    ok = ok && bundle_crc32(0, raw, e.raw_size) == e.crc;
+    free(raw);
+    if (!ok) return 0;
+  }
+  return 1;
+}
+
+int main(int argc, char *argv[]) {
+  int store = 0, keep_script = 0, a = 1;
+  for (; a < argc && argv[a][0] == '-'; a++) {
+    if (!strcmp(argv[a], "-s")) store = 1;
+    else if (!strcmp(argv[a], "-k")) keep_script = 1;
+    else break;
+  }
+  if (argc - a != 2) {
+    fprintf(stderr, "usage: %s [-s] [-k] app_dir app.wsb\n", argv[0]);
+    return 2;
+  }
+  if (!collect(argv[a], "") || g_count == 0) {
+    fprintf(stderr, "%s: no files under %s\n", argv[0], argv[a]);
+    return 1;
+  }
+  qsort(g_items, g_count, sizeof(item_t), by_name);
+
+  // Content, minified and compressed where asked; names laid out in index order
+  size_t names_size = 0, raw_total = 0, packed = 0;
+  int have_script = 0;
+  for (size_t i = 0; i < g_count; i++) {
+    item_t *it = &g_items[i];
+    size_t len;
+    uint8_t *raw = read_file(it->path, &len);
+    if (!raw) {
+      fprintf(stderr, "%s: cannot read %s\n", argv[0], it->path);
+      return 1;
+    }
+    raw_total += len;
+    if (!strcmp(it->name, "script.js")) {
+      have_script = 1;
+      uint8_t *min = keep_script ? NULL : (uint8_t *) malloc(len + 1);
+      size_t n = min ? js_minify((const char *) raw, len, (char *) min, len + 1, NULL) : 0;
+      if (min && n == 0 && len > 0) {
+        fprintf(stderr, "%s: %s: unterminated string/comment or unbalanced braces\n", argv[0], it->path);
+        return 1;
+      }
+      if (min) {
+        free(raw);
+        raw = min;
+        len = n;
+      }
+    }
+    it->e.name = (uint32_t) names_size;
+    it->e.raw_size = (uint32_t) len;
+    it->e.crc = bundle_crc32(0, raw, len);
+    names_size += strlen(it->name) + 1;
+
+    uint8_t *z = store || len == 0 ? NULL : (uint8_t *) malloc(len);
+    size_t zn = z ? bundle_lz_compress(raw, len, z, len - len / 8) : 0;
+    if (zn) {
+      it->data = z;
+      it->e.size = (uint32_t) zn;
+      it->e.flags = BUNDLE_LZ;
+      free(raw);
+    } else {
+      free(z);
+      it->data = raw;
+      it->e.size = (uint32_t) len;
+    }
+  }
+  if (!have_script) fprintf(stderr, "%s: warning: %s has no script.js\n", argv[0], argv[a]);
+
+  // Header, index, names, then each entry at the next BUNDLE_ALIGN boundary
+  size_t meta = g_count * BUNDLE_ENTRY_SIZE + names_size;
+  size_t off = (BUNDLE_HEADER_SIZE + meta + BUNDLE_ALIGN - 1) / BUNDLE_ALIGN * BUNDLE_ALIGN;
+  bundle_header_t h;
+  h.count = (uint32_t) g_count;
+  h.names_size = (uint32_t) names_size;
+  h.data_offset = (uint32_t) off;
+  for (size_t i = 0; i < g_count; i++) {
+    off = (off + BUNDLE_ALIGN - 1) / BUNDLE_ALIGN * BUNDLE_ALIGN;
+    g_items[i].e.offset = (uint32_t) off;
+    off += g_items[i].e.size;
+    packed += g_items[i].e.size;
+  }
+  h.file_size = (uint32_t) off;
+
+  uint8_t *out = (uint8_t *) calloc(1, off);
+  uint8_t *p = out + BUNDLE_HEADER_SIZE;
+  for (size_t i = 0; i < g_count; i++, p += BUNDLE_ENTRY_SIZE) bundle_write_entry(p, &g_items[i].e);
+  for (size_t i = 0; i < g_count; i++) {
+    size_t n = strlen(g_items[i].name) + 1;
+    memcpy(p, g_items[i].name, n);
+    p += n;
+    memcpy(out + g_items[i].e.offset, g_items[i].data, g_items[i].e.size);
+  }
+  h.index_crc = bundle_crc32(0, out + BUNDLE_HEADER_SIZE, meta);
+  bundle_write_header(out, &h);
+
+  if (!verify(out, off)) {
+    fprintf(stderr, "%s: internal error, the bundle does not verify\n", argv[0]);
+    return 1;
+  }
+  FILE *f = fopen(argv[a + 1], "wb");
+  if (!f || fwrite(out, 1, off, f) != off) {
+    fprintf(stderr, "%s: cannot write %s\n", argv[0], argv[a + 1]);
+    return 1;
+  }
+  fclose(f);
+
+  fprintf(stderr, "%s: %lu files, %lu -> %lu bytes of content, %lu bytes with index and padding\n",
+          argv[a + 1], (unsigned long) g_count, (unsigned long) raw_total, (unsigned long) packed,
+          (unsigned long) off);
+  return 0;
+}
@@ -0,0 +1,145 @@
+#include "anim_codec.h"
+#include <string.h>
+
+static void put16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p) {
+  return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+/******************************************************************************
+ * Header and index
+ ******************************************************************************/
+void anim_write_header(uint8_t *buf, const anim_header_t *h) {
+  memcpy(buf, ANIM_MAGIC, 4);
+  put16(buf + 4, h->w);
+  put16(buf + 6, h->h);
+  put16(buf + 8, h->frames);
+  put16(buf + 10, h->loops);
+  put32(buf + 12, h->max_frame);
+}
+
+void anim_write_frame(uint8_t *buf, const anim_frame_t *f) {
+  put32(buf, f->offset);
+  put32(buf + 4, f->size);
+  put16(buf + 8, f->delay_ms);
+  put16(buf + 10, f->flags);
+}
+
+int anim_read_header(const uint8_t *buf, anim_header_t *h) {
+  if (memcmp(buf, ANIM_MAGIC, 4) != 0) return 0;
+  h->w = get16(buf + 4);
+  h->h = get16(buf + 6);
+  h->frames = get16(buf + 8);
+  h->loops = get16(buf + 10);
+  h->max_frame = get32(buf + 12);
+  return h->w && h->h && h->frames && h->max_frame;
+}
+
+void anim_read_frame(const uint8_t *buf, anim_frame_t *f) {
+  f->offset = get32(buf);
+  f->size = get32(buf + 4);
+  f->delay_ms = get16(buf + 8);
+  f->flags = get16(buf + 10);
+}
+
+/******************************************************************************
+ * Frame records
+ ******************************************************************************/
+static uint8_t *put_op(uint8_t *out, int op, uint32_t n) {
+  put16(out, (uint16_t)((op << 14) | n));
+  return out + 2;
+}
+
+// Pixels from i on that equal the previous frame / the pixel at i
+static uint32_t same_run(const uint16_t *cur, const uint16_t *prev, uint32_t i, uint32_t npx) {
+  uint32_t j = i;
+  while (j < npx && j - i < ANIM_OP_MAX && cur[j] == prev[j]) j++;
+  return j - i;
+}
+
+static uint32_t fill_run(const uint16_t *cur, uint32_t i, uint32_t npx) {
+  uint32_t j = i + 1;
+  while (j < npx && j - i < ANIM_OP_MAX && cur[j] == cur[i]) j++;
+  return j - i;
+}
+
+// A SKIP of 2 pixels or a FILL of 3 is no bigger than the literals it
+// replaces and ends the literal run; shorter ones are cheaper inline
+#define SKIP_MIN 2
+#define FILL_MIN 3
+
+size_t anim_encode_frame(const uint16_t *cur, const uint16_t *prev, uint32_t npx, uint8_t *out) {
+  uint8_t *o = out;
+  uint32_t i = 0;
+  while (i < npx) {
+    uint32_t n;
+    if (prev && (n = same_run(cur, prev, i, npx)) >= SKIP_MIN) {
+      o = put_op(o, ANIM_OP_SKIP, n);
+      i += n;
+      continue;
+    }
+    if ((n = fill_run(cur, i, npx)) >= FILL_MIN) {
+      o = put_op(o, ANIM_OP_FILL, n);
+      put16(o, cur[i]);
+      o += 2;
+      i += n;
+      continue;
+    }
+    uint32_t j = i + 1;
+    while (j < npx && j - i < ANIM_OP_MAX &&
+           !(prev && same_run(cur, prev, j, npx) >= SKIP_MIN) && fill_run(cur, j, npx) < FILL_MIN) {
+      j++;
+    }
+    o = put_op(o, ANIM_OP_COPY, j - i);
+    for (; i < j; i++, o += 2) put16(o, cur[i]);
+  }
+  return (size_t)(o - out);
+}
+
+int anim_decode_frame(const uint8_t *src, size_t len, uint16_t *px, uint32_t npx, int swap) {
+  const uint8_t *end = src + len;
+  uint32_t i = 0;
+  while (src + 2 <= end) {
+    uint16_t w = get16(src);
+    uint32_t n = w & ANIM_OP_MAX;
+    src += 2;
+    if (n == 0 || n > npx - i) return 0;
+    switch (w >> 14) {
+      case ANIM_OP_SKIP:
+        break;
+      case ANIM_OP_COPY:
+        if ((size_t)(end - src) < 2 * n) return 0;
+        memcpy(px + i, src, 2 * n);  // little endian in the file and on both targets
+        if (swap) {
+          for (uint32_t k = i; k < i + n; k++) px[k] = (uint16_t)((px[k] << 8) | (px[k] >> 8));
+        }
+        src += 2 * n;
+        break;
+      case ANIM_OP_FILL: {
+        if (end - src < 2) return 0;
+        uint16_t v = get16(src);
+        if (swap) v = (uint16_t)((v << 8) | (v >> 8));
+        src += 2;
+        for (uint32_t k = i; k < i + n; k++) px[k] = v;
+        break;
+      }
+      default:
+        return 0;
+    }
+    i += n;
+  }
+  return src == end && i == npx;
+}
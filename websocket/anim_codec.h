@@ -0,0 +1,77 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Pre-decoded animation container (.wsa). GIFs are converted on the host
+// (tools/gif2wsa) into RGB565 frames, so playing one costs a copy per
+// changed pixel instead of LZW decoding and palette lookups per frame:
+//
+//   anim_header_t                 16 bytes
+//   anim_frame_t[frames]          12 bytes each
+//   frame records                 at the offsets given in the index
+//
+// All fields are little endian. A frame record is a stream of 16-bit ops
+// covering the w*h pixels in row order; the top two bits are the op, the
+// low 14 bits a count of 1..16383 pixels:
+//   SKIP n   keep n pixels of the previous frame
+//   COPY n   n literal pixels follow
+//   FILL n   one pixel follows, repeated n times
+// Key frames use no SKIP, so playback can start (or catch up) at any of
+// them; the first frame is always one. Pixels are RGB565 in native byte
+// order; the player swaps them for LV_COLOR_16_SWAP builds.
+// Plain C and no allocation, so the same file builds into the firmware and
+// into the host tool.
+
+#define ANIM_MAGIC "WSA1"
+#define ANIM_HEADER_SIZE 16
+#define ANIM_FRAME_SIZE 12
+#define ANIM_FRAME_KEY 0x0001
+
+#define ANIM_OP_SKIP 0
+#define ANIM_OP_COPY 1
+#define ANIM_OP_FILL 2
+#define ANIM_OP_MAX 0x3FFF
+
+// Largest record anim_encode_frame() can produce for npx pixels
+#define ANIM_FRAME_BOUND(npx) (2 * (size_t)(npx) + 2 * (((size_t)(npx) + ANIM_OP_MAX - 1) / ANIM_OP_MAX))
+
+typedef struct {
+  uint16_t w, h;
+  uint16_t frames;
+  uint16_t loops;       // 0 = forever
+  uint32_t max_frame;   // largest frame record, sizes the player's read buffer
+} anim_header_t;
+
+typedef struct {
+  uint32_t offset;      // from the start of the file
+  uint32_t size;
+  uint16_t delay_ms;
+  uint16_t flags;       // ANIM_FRAME_KEY
+} anim_frame_t;
+
+// Serialized forms; `buf` holds ANIM_HEADER_SIZE / ANIM_FRAME_SIZE bytes
+void anim_write_header(uint8_t *buf, const anim_header_t *h);
+void anim_write_frame(uint8_t *buf, const anim_frame_t *f);
+// False if `buf` is not a .wsa header or the sizes are zero
+int anim_read_header(const uint8_t *buf, anim_header_t *h);
+void anim_read_frame(const uint8_t *buf, anim_frame_t *f);
+
+// Encode `cur` (npx pixels) into `out`, which must hold
+// ANIM_FRAME_BOUND(npx) bytes. With `prev` the record may skip pixels that
+// did not change (a delta frame); without it the record is a key frame.
+// Returns the record size.
+size_t anim_encode_frame(const uint16_t *cur, const uint16_t *prev, uint32_t npx, uint8_t *out);
+
+// Apply a record to `px`, which holds the previous frame for delta records.
+// `swap` byte-swaps the written pixels. False if the record is malformed
+// (px may be partly written).
+int anim_decode_frame(const uint8_t *src, size_t len, uint16_t *px, uint32_t npx, int swap);
+
+#ifdef __cplusplus
+}
+#endif
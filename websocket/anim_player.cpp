@@ -0,0 +1,245 @@
+#include <Arduino.h>
+#include <SD_MMC.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "anim_codec.h"
+#include "anim_player.h"
+
+#define ANIM_PLAYER_MAGIC 0x414E494D  // "ANIM"
+#define ANIM_TICK_MS 10                // how often due frames are looked for
+
+typedef struct {
+  uint32_t magic;
+  lv_obj_t *obj;
+  anim_header_t hdr;
+  anim_frame_t *index;
+  File file;              // record source unless preloaded
+  uint8_t *data;          // the whole file when preloaded
+  uint8_t *rbuf;          // one record when streaming
+  lv_color_t *buf;        // canvas bitmap, always holds frame `cur`
+  lv_timer_t *timer;
+  uint16_t cur;
+  uint32_t due;           // lv_tick at which the frame after `cur` is due
+  uint16_t loops;         // 0 = forever
+  uint16_t loops_done;
+  bool finished;
+  anim_player_stats_t stats;
+} anim_player_t;
+
+static anim_player_t *anim_get(lv_obj_t *obj) {
+  if (!obj || !lv_obj_check_type(obj, &lv_canvas_class)) return NULL;
+  anim_player_t *p = (anim_player_t *)lv_obj_get_user_data(obj);
+  return (p && p->magic == ANIM_PLAYER_MAGIC) ? p : NULL;
+}
+
+bool anim_player_check(lv_obj_t *obj) {
+  return anim_get(obj) != NULL;
+}
+
+static uint32_t anim_delay(const anim_player_t *p, uint16_t i) {
+  return p->index[i].delay_ms ? p->index[i].delay_ms : 1;
+}
+
+static void anim_free(anim_player_t *p) {
+  p->magic = 0;
+  if (p->timer) lv_timer_del(p->timer);
+  if (p->file) p->file.close();
+  free(p->index);
+  free(p->data);
+  free(p->rbuf);
+  free(p->buf);
+  delete p;
+}
+
+/******************************************************************************
+ * Loading
+ ******************************************************************************/
+static bool anim_load(anim_player_t *p, const char *path, bool preload) {
+  p->file = SD_MMC.open(path, FILE_READ);
+  if (!p->file) {
+    Serial.printf("anim: cannot open %s\n", path);
+    return false;
+  }
+  size_t fsize = p->file.size();
+  uint8_t hb[ANIM_HEADER_SIZE];
+  if (p->file.read(hb, sizeof(hb)) != sizeof(hb) || !anim_read_header(hb, &p->hdr)) {
+    Serial.printf("anim: %s is not a .wsa animation\n", path);
+    return false;
+  }
+
+  // Index: every record must lie inside the file and fit the read buffer
+  const anim_header_t &h = p->hdr;
+  size_t isize = (size_t)h.frames * ANIM_FRAME_SIZE;
+  uint8_t *ib = (uint8_t *)malloc(isize);
+  p->index = (anim_frame_t *)malloc(h.frames * sizeof(anim_frame_t));
+  bool ok = ib && p->index && p->file.read(ib, isize) == isize;
+  for (uint16_t i = 0; ok && i < h.frames; i++) {
+    anim_frame_t &f = p->index[i];
+    anim_read_frame(ib + (size_t)i * ANIM_FRAME_SIZE, &f);
+    ok = f.size >= 2 && f.size <= h.max_frame && f.offset >= ANIM_HEADER_SIZE + isize &&
+         f.offset <= fsize && f.size <= fsize - f.offset;
+  }
+  free(ib);
+  if (!ok || !(p->index[0].flags & ANIM_FRAME_KEY)) {
+    Serial.printf("anim: %s has a broken frame index\n", path);
+    return false;
+  }
+
+  if (preload) {
+    p->data = (uint8_t *)heap_caps_malloc(fsize, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    if (p->data && p->file.seek(0) && p->file.read(p->data, fsize) == fsize) {
+      p->file.close();
+      return true;
+    }
+    Serial.printf("anim: cannot preload %u bytes of %s, streaming it\n", (unsigned)fsize, path);
+    free(p->data);
+    p->data = NULL;
+  }
+  p->rbuf = (uint8_t *)heap_caps_malloc(h.max_frame, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!p->rbuf) {
+    Serial.printf("anim: no memory for a %u byte frame buffer\n", (unsigned)h.max_frame);
+    return false;
+  }
+  return true;
+}
+
+// Read frame `i` and apply it to the bitmap
+static bool anim_apply(anim_player_t *p, uint16_t i) {
+  const anim_frame_t &f = p->index[i];
+  uint32_t t0 = micros();
+  const uint8_t *rec = p->data ? p->data + f.offset : p->rbuf;
+  bool ok = p->data || (p->file.seek(f.offset) && p->file.read(p->rbuf, f.size) == f.size);
+  ok = ok && anim_decode_frame(rec, f.size, (uint16_t *)p->buf, (uint32_t)p->hdr.w * p->hdr.h,
+                               LV_COLOR_16_SWAP);
+  p->stats.decode_us += micros() - t0;
+  p->stats.decoded++;
+  p->cur = i;
+  if (!ok) Serial.printf("anim: cannot read frame %u\n", (unsigned)i);
+  return ok;
+}
+
+/******************************************************************************
+ * Playback
+ ******************************************************************************/
+static void anim_stop(anim_player_t *p) {
+  lv_timer_pause(p->timer);
+}
+
+static void anim_tick(lv_timer_t *t) {
+  anim_player_t *p = (anim_player_t *)t->user_data;
+  uint32_t now = lv_tick_get();
+  if ((int32_t)(now - p->due) < 0) return;
+
+  // Walk to the newest frame that is due, noting the last key frame passed
+  uint16_t target = p->cur, key = 0;
+  bool keyed = false;
+  uint32_t steps = 0;
+  while ((int32_t)(now - p->due) >= 0) {
+    uint16_t next = target + 1;
+    if (next == p->hdr.frames) {
+      p->stats.loops++;
+      if (p->loops && ++p->loops_done >= p->loops) {
+        p->finished = true;
+        anim_stop(p);
+        break;
+      }
+      next = 0;
+    }
+    target = next;
+    steps++;
+    if (p->index[target].flags & ANIM_FRAME_KEY) {
+      key = target;
+      keyed = true;
+    }
+    p->due += anim_delay(p, target);
+    if (steps >= p->hdr.frames) {
+      p->due = now + anim_delay(p, target);  // a whole loop behind: resync
+      break;
+    }
+  }
+  if (!steps) return;
+
+  // A key frame makes everything before it irrelevant; delta frames after
+  // it still have to be applied in order
+  uint16_t i = keyed ? key : (p->cur + 1 == p->hdr.frames ? 0 : p->cur + 1);
+  for (;;) {
+    if (!anim_apply(p, i)) {
+      anim_stop(p);
+      break;
+    }
+    if (i == target) break;
+    i = i + 1 == p->hdr.frames ? 0 : i + 1;
+  }
+  p->stats.shown++;
+  p->stats.skipped += steps - 1;
+  lv_obj_invalidate(p->obj);
+}
+
+static void anim_deleted(lv_event_t *e) {
+  anim_free((anim_player_t *)lv_event_get_user_data(e));
+}
+
+lv_obj_t *anim_player_create(lv_obj_t *parent, const char *path, bool preload) {
+  anim_player_t *p = new anim_player_t();
+  if (!anim_load(p, path, preload)) {
+    anim_free(p);
+    return NULL;
+  }
+  const anim_header_t &h = p->hdr;
+  p->buf = (lv_color_t *)heap_caps_malloc((size_t)h.w * h.h * sizeof(lv_color_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!p->buf || !anim_apply(p, 0)) {
+    if (!p->buf) Serial.printf("anim: no memory for a %ux%u bitmap\n", h.w, h.h);
+    anim_free(p);
+    return NULL;
+  }
+  p->magic = ANIM_PLAYER_MAGIC;
+  p->loops = h.loops;
+  p->stats.frames = h.frames;
+  p->stats.shown = 1;
+
+  lv_obj_t *obj = lv_canvas_create(parent);
+  lv_canvas_set_buffer(obj, p->buf, h.w, h.h, LV_IMG_CF_TRUE_COLOR);
+  lv_obj_set_user_data(obj, p);
+  lv_obj_add_event_cb(obj, anim_deleted, LV_EVENT_DELETE, p);
+  p->obj = obj;
+  p->due = lv_tick_get() + anim_delay(p, 0);
+  p->timer = lv_timer_create(anim_tick, ANIM_TICK_MS, p);
+  Serial.printf("anim: %s, %ux%u, %u frames, %s\n", path, h.w, h.h, h.frames,
+                p->data ? "preloaded" : "streamed from SD");
+  return obj;
+}
+
+void anim_player_play(lv_obj_t *obj) {
+  anim_player_t *p = anim_get(obj);
+  if (!p) return;
+  if (p->finished) {
+    // Stopped on the last frame: start over from the first (a key frame),
+    // or the next tick would count the wrap as a loop right away
+    if (!anim_apply(p, 0)) return;
+    p->stats.shown++;
+    lv_obj_invalidate(p->obj);
+    p->finished = false;
+    p->loops_done = 0;
+  }
+  p->due = lv_tick_get() + anim_delay(p, p->cur);
+  lv_timer_resume(p->timer);
+}
+
+void anim_player_pause(lv_obj_t *obj) {
+  anim_player_t *p = anim_get(obj);
+  if (p) anim_stop(p);
+}
+
+void anim_player_set_loops(lv_obj_t *obj, uint16_t loops) {
+  anim_player_t *p = anim_get(obj);
+  if (!p) return;
+  p->loops = loops;
+  p->loops_done = 0;
+}
+
+bool anim_player_get_stats(lv_obj_t *obj, anim_player_stats_t *out) {
+  anim_player_t *p = anim_get(obj);
+  if (!p) return false;
+  *out = p->stats;
+  return true;
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <lvgl.h>
+
+// Player for pre-decoded .wsa animations (anim_codec.h): a canvas whose
+// PSRAM bitmap each frame record is applied to directly, so a frame costs
+// a read of its record plus a copy of the pixels that changed. Records are
+// streamed from the open SD file, or read from a copy of the whole file in
+// PSRAM when `preload` is set.
+// When the render task falls behind, frames that are already late are
+// applied without being shown (from the last key frame among them, if any)
+// and only the newest one is drawn, so playback keeps its pace.
+// Render task only.
+
+typedef struct {
+  uint16_t frames;
+  uint32_t shown;       // frames drawn
+  uint32_t skipped;     // frames applied or jumped over without being drawn
+  uint32_t loops;       // completed loops
+  uint32_t decode_us;   // total time spent reading and applying records
+  uint32_t decoded;     // records applied
+} anim_player_stats_t;
+
+// Create a player for the .wsa file at `path` (an SD path) on `parent`,
+// showing its first frame and playing. NULL if the file is not a valid
+// animation or does not fit in memory.
+lv_obj_t *anim_player_create(lv_obj_t *parent, const char *path, bool preload);
+// True for objects made by anim_player_create()
+bool anim_player_check(lv_obj_t *obj);
+
+void anim_player_play(lv_obj_t *obj);
+void anim_player_pause(lv_obj_t *obj);
+// Times to play the animation before stopping on its last frame, 0 =
+// forever; restarts the count. Defaults to the count stored in the file.
+void anim_player_set_loops(lv_obj_t *obj, uint16_t loops);
+bool anim_player_get_stats(lv_obj_t *obj, anim_player_stats_t *out);
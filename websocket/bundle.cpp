@@ -0,0 +1,209 @@
+#include <Arduino.h>
+#include <SD_MMC.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "bundle.h"
+
+static File g_bundle;
+static bundle_header_t g_bh;
+static bundle_entry_t *g_entries = NULL;
+static char *g_names = NULL;
+static SemaphoreHandle_t g_bundle_lock = NULL;  // the file is read from both tasks
+
+#define BUNDLE_LOCK() xSemaphoreTake(g_bundle_lock, portMAX_DELAY)
+#define BUNDLE_UNLOCK() xSemaphoreGive(g_bundle_lock)
+
+static uint8_t *bundle_alloc(size_t n) {
+  return (uint8_t *)heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+}
+
+/******************************************************************************
+ * Mount
+ ******************************************************************************/
+bool bundle_mount(const char *path) {
+  if (g_entries) return false;
+  if (!g_bundle_lock) g_bundle_lock = xSemaphoreCreateMutex();
+  File f = SD_MMC.open(path, FILE_READ);
+  if (!f) return false;
+
+  // Header, index and names are contiguous: one read after the header
+  uint8_t hb[BUNDLE_HEADER_SIZE];
+  bundle_header_t h;
+  if (f.read(hb, sizeof(hb)) != sizeof(hb) || !bundle_read_header(hb, &h) || h.file_size != f.size() ||
+      h.count == 0 || h.count > (h.file_size - BUNDLE_HEADER_SIZE) / BUNDLE_ENTRY_SIZE) {
+    Serial.printf("bundle: %s is not an app bundle\n", path);
+    f.close();
+    return false;
+  }
+  size_t isize = (size_t)h.count * BUNDLE_ENTRY_SIZE;
+  size_t meta = isize + h.names_size;
+  uint8_t *raw = (uint8_t *)malloc(meta + 1);
+  bundle_entry_t *entries = (bundle_entry_t *)malloc(h.count * sizeof(bundle_entry_t));
+  bool ok = raw && entries && BUNDLE_HEADER_SIZE + meta <= h.data_offset && f.read(raw, meta) == meta &&
+            bundle_crc32(0, raw, meta) == h.index_crc;
+  for (uint32_t i = 0; ok && i < h.count; i++) {
+    bundle_entry_t &e = entries[i];
+    bundle_read_entry(raw + (size_t)i * BUNDLE_ENTRY_SIZE, &e);
+    ok = e.name < h.names_size && e.offset >= h.data_offset && e.offset <= h.file_size &&
+         e.size <= h.file_size - e.offset && ((e.flags & BUNDLE_LZ) || e.size == e.raw_size);
+  }
+  if (!ok) {
+    Serial.printf("bundle: %s has a damaged index\n", path);
+    free(raw);
+    free(entries);
+    f.close();
+    return false;
+  }
+
+  // Keep the names, dropping the index bytes in front of them; lookups
+  // rely on the order
+  memmove(raw, raw + isize, h.names_size);
+  raw[h.names_size] = 0;
+  for (uint32_t i = 1; ok && i < h.count; i++) {
+    ok = strcmp((char *)raw + entries[i - 1].name, (char *)raw + entries[i].name) < 0;
+  }
+  if (!ok) {
+    Serial.printf("bundle: %s index is not sorted\n", path);
+    free(raw);
+    free(entries);
+    f.close();
+    return false;
+  }
+  g_bundle = f;
+  g_bh = h;
+  g_entries = entries;
+  g_names = (char *)raw;
+  Serial.printf("bundle: %s mounted, %u entries\n", path, (unsigned)h.count);
+  return true;
+}
+
+bool bundle_mounted() {
+  return g_entries != NULL;
+}
+
+const bundle_entry_t *bundle_find(const char *path) {
+  if (!g_entries) return NULL;
+  while (*path == '/') path++;
+  uint32_t lo = 0, hi = g_bh.count;
+  while (lo < hi) {
+    uint32_t mid = (lo + hi) / 2;
+    int c = strcmp(g_names + g_entries[mid].name, path);
+    if (c == 0) return &g_entries[mid];
+    if (c < 0) lo = mid + 1;
+    else hi = mid;
+  }
+  return NULL;
+}
+
+static bool bundle_read(uint32_t offset, void *buf, uint32_t n) {
+  BUNDLE_LOCK();
+  bool ok = g_bundle.seek(offset) && g_bundle.read((uint8_t *)buf, n) == n;
+  BUNDLE_UNLOCK();
+  return ok;
+}
+
+uint8_t *bundle_load(const bundle_entry_t *e) {
+  uint8_t *out = bundle_alloc(e->raw_size + 1);
+  uint8_t *stored = (e->flags & BUNDLE_LZ) ? bundle_alloc(e->size) : out;
+  bool ok = out && stored && bundle_read(e->offset, stored, e->size);
+  if (ok && stored != out) ok = bundle_lz_decompress(stored, e->size, out, e->raw_size);
+  if (stored != out) free(stored);
+  if (ok && bundle_crc32(0, out, e->raw_size) != e->crc) {
+    Serial.printf("bundle: %s is damaged\n", g_names + e->name);
+    ok = false;
+  }
+  if (!ok) {
+    free(out);
+    return NULL;
+  }
+  out[e->raw_size] = 0;
+  return out;
+}
+
+/******************************************************************************
+ * "B" Driver: entries by offset in the open bundle, no allocation for
+ * stored entries (compressed ones are decompressed once when opened)
+ ******************************************************************************/
+typedef struct {
+  const bundle_entry_t *e;  // NULL = free slot
+  uint32_t pos;
+  uint8_t *data;            // decompressed content of a BUNDLE_LZ entry
+} bundle_file_t;
+
+static bundle_file_t g_bfiles[BUNDLE_MAX_OPEN];
+
+static void *bundle_open_cb(lv_fs_drv_t *drv, const char *path, lv_fs_mode_t mode) {
+  if (mode != LV_FS_MODE_RD) return NULL;
+  const bundle_entry_t *e = bundle_find(path);
+  if (!e) return NULL;
+  for (int i = 0; i < BUNDLE_MAX_OPEN; i++) {
+    bundle_file_t *bf = &g_bfiles[i];
+    if (bf->e) continue;
+    bf->data = NULL;
+    if ((e->flags & BUNDLE_LZ) && !(bf->data = bundle_load(e))) return NULL;
+    bf->e = e;
+    bf->pos = 0;
+    return bf;
+  }
+  Serial.printf("bundle: more than %d files open, cannot open %s\n", BUNDLE_MAX_OPEN, path);
+  return NULL;
+}
+
+static lv_fs_res_t bundle_close_cb(lv_fs_drv_t *drv, void *file_p) {
+  bundle_file_t *bf = (bundle_file_t *)file_p;
+  if (!bf) return LV_FS_RES_INV_PARAM;
+  free(bf->data);
+  bf->data = NULL;
+  bf->e = NULL;
+  return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t bundle_read_cb(lv_fs_drv_t *drv, void *file_p, void *buf, uint32_t btr, uint32_t *br) {
+  bundle_file_t *bf = (bundle_file_t *)file_p;
+  if (!bf) return LV_FS_RES_INV_PARAM;
+  uint32_t left = bf->e->raw_size - bf->pos;
+  if (btr > left) btr = left;
+  if (bf->data) {
+    memcpy(buf, bf->data + bf->pos, btr);
+  } else if (btr && !bundle_read(bf->e->offset + bf->pos, buf, btr)) {
+    *br = 0;
+    return LV_FS_RES_HW_ERR;
+  }
+  bf->pos += btr;
+  *br = btr;
+  return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t bundle_seek_cb(lv_fs_drv_t *drv, void *file_p, uint32_t pos, lv_fs_whence_t whence) {
+  bundle_file_t *bf = (bundle_file_t *)file_p;
+  if (!bf) return LV_FS_RES_INV_PARAM;
+  uint32_t p = pos;
+  if (whence == LV_FS_SEEK_CUR) p = bf->pos + pos;
+  else if (whence == LV_FS_SEEK_END) p = bf->e->raw_size + pos;
+  bf->pos = p < bf->e->raw_size ? p : bf->e->raw_size;
+  return LV_FS_RES_OK;
+}
+
+static lv_fs_res_t bundle_tell_cb(lv_fs_drv_t *drv, void *file_p, uint32_t *pos_p) {
+  bundle_file_t *bf = (bundle_file_t *)file_p;
+  if (!bf) return LV_FS_RES_INV_PARAM;
+  *pos_p = bf->pos;
+  return LV_FS_RES_OK;
+}
+
+void init_bundle_fs() {
+  static lv_fs_drv_t drv;
+  lv_fs_drv_init(&drv);
+
+  drv.letter = 'B';
+  drv.open_cb  = bundle_open_cb;
+  drv.close_cb = bundle_close_cb;
+  drv.read_cb  = bundle_read_cb;
+  drv.seek_cb  = bundle_seek_cb;
+  drv.tell_cb  = bundle_tell_cb;
+
+  lv_fs_drv_register(&drv);
+  Serial.println("LVGL FS driver 'B' registered (app bundle entries)");
+}
@@ -0,0 +1,27 @@
+#pragma once
+
+#include <lvgl.h>
+#include "bundle_fmt.h"
+
+// The mounted app bundle (bundle_fmt.h). Its index stays in RAM and its
+// file stays open, so finding an asset is a binary search and reading one
+// is a seek and a read on that file. While a bundle is mounted its entries
+// shadow the SD files of the same path for everything that loads assets
+// (images, GIFs), and LVGL can read them directly as "B:/path".
+#define BUNDLE_APP_PATH   "/app.wsb"
+#define BUNDLE_SCRIPT     "script.js"
+#define BUNDLE_MAX_OPEN   8           // 'B' files open at once
+
+// Open `path` and load its index; false if it is missing or damaged.
+// Once, at boot: a bundle stays mounted.
+bool bundle_mount(const char *path);
+bool bundle_mounted();
+
+// Entry for `path` (with or without a leading '/'), NULL if there is none
+const bundle_entry_t *bundle_find(const char *path);
+// Whole content of `e`, decompressed and checked, NUL-terminated, in a
+// heap_caps_malloc'd buffer the caller frees; NULL on failure
+uint8_t *bundle_load(const bundle_entry_t *e);
+
+// Register the 'B' LVGL filesystem driver
+void init_bundle_fs();
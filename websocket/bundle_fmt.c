@@ -0,0 +1,168 @@
+#include "bundle_fmt.h"
+#include <string.h>
+
+static void put16(uint8_t *p, uint16_t v) {
+  p[0] = (uint8_t)v;
+  p[1] = (uint8_t)(v >> 8);
+}
+
+static void put32(uint8_t *p, uint32_t v) {
+  put16(p, (uint16_t)v);
+  put16(p + 2, (uint16_t)(v >> 16));
+}
+
+static uint16_t get16(const uint8_t *p) {
+  return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static uint32_t get32(const uint8_t *p) {
+  return get16(p) | ((uint32_t)get16(p + 2) << 16);
+}
+
+/******************************************************************************
+ * Header and index
+ ******************************************************************************/
+void bundle_write_header(uint8_t *buf, const bundle_header_t *h) {
+  memset(buf, 0, BUNDLE_HEADER_SIZE);
+  memcpy(buf, BUNDLE_MAGIC, 4);
+  put32(buf + 4, h->count);
+  put32(buf + 8, h->names_size);
+  put32(buf + 12, h->data_offset);
+  put32(buf + 16, h->file_size);
+  put32(buf + 20, h->index_crc);
+}
+
+void bundle_write_entry(uint8_t *buf, const bundle_entry_t *e) {
+  put32(buf, e->name);
+  put32(buf + 4, e->offset);
+  put32(buf + 8, e->size);
+  put32(buf + 12, e->raw_size);
+  put32(buf + 16, e->crc);
+  put16(buf + 20, e->flags);
+  put16(buf + 22, 0);
+}
+
+int bundle_read_header(const uint8_t *buf, bundle_header_t *h) {
+  if (memcmp(buf, BUNDLE_MAGIC, 4) != 0) return 0;
+  h->count = get32(buf + 4);
+  h->names_size = get32(buf + 8);
+  h->data_offset = get32(buf + 12);
+  h->file_size = get32(buf + 16);
+  h->index_crc = get32(buf + 20);
+  return 1;
+}
+
+void bundle_read_entry(const uint8_t *buf, bundle_entry_t *e) {
+  e->name = get32(buf);
+  e->offset = get32(buf + 4);
+  e->size = get32(buf + 8);
+  e->raw_size = get32(buf + 12);
+  e->crc = get32(buf + 16);
+  e->flags = get16(buf + 20);
+}
+
+uint32_t bundle_crc32(uint32_t crc, const void *buf, size_t len) {
+  static uint32_t table[256];
+  if (!table[1]) {
+    for (uint32_t i = 0; i < 256; i++) {
+      uint32_t c = i;
+      for (int k = 0; k < 8; k++) c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+      table[i] = c;
+    }
+  }
+  const uint8_t *p = (const uint8_t *)buf;
+  crc = ~crc;
+  while (len--) crc = table[(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+  return ~crc;
+}
+
+/******************************************************************************
+ * Compression
+ ******************************************************************************/
+#define LZ_MIN_MATCH 4
+#define LZ_MAX_DIST 0xFFFF
+#define LZ_HASH_BITS 12
+
+static uint8_t *put_len(uint8_t *o, size_t n) {
+  for (; n >= 255; n -= 255) *o++ = 255;
+  *o++ = (uint8_t)n;
+  return o;
+}
+
+// One sequence; false if it would not fit before `end`
+static int put_seq(uint8_t **o, uint8_t *end, const uint8_t *lit, size_t nlit, size_t mlen, size_t dist) {
+  size_t need = 1 + nlit + nlit / 255 + 1 + (mlen ? 2 + mlen / 255 + 1 : 0);
+  if ((size_t)(end - *o) < need) return 0;
+  size_t ml = mlen ? mlen - LZ_MIN_MATCH : 0;
+  uint8_t *p = *o;
+  *p++ = (uint8_t)(((nlit < 15 ? nlit : 15) << 4) | (ml < 15 ? ml : 15));
+  if (nlit >= 15) p = put_len(p, nlit - 15);
+  memcpy(p, lit, nlit);
+  p += nlit;
+  if (mlen) {
+    put16(p, (uint16_t)dist);
+    p += 2;
+    if (ml >= 15) p = put_len(p, ml - 15);
+  }
+  *o = p;
+  return 1;
+}
+
+size_t bundle_lz_compress(const uint8_t *src, size_t len, uint8_t *dst, size_t cap) {
+  uint32_t head[1 << LZ_HASH_BITS];  // last position + 1 of each 4-byte hash
+  memset(head, 0, sizeof(head));
+  uint8_t *o = dst, *end = dst + cap;
+  size_t i = 0, lit = 0;
+  while (i + LZ_MIN_MATCH <= len) {
+    uint32_t v;
+    memcpy(&v, src + i, 4);
+    uint32_t h = (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+    size_t cand = head[h];
+    head[h] = (uint32_t)(i + 1);
+    if (cand && i - (cand - 1) <= LZ_MAX_DIST && memcmp(src + cand - 1, src + i, LZ_MIN_MATCH) == 0) {
+      size_t m = cand - 1, n = LZ_MIN_MATCH;
+      while (i + n < len && src[m + n] == src[i + n]) n++;
+      if (!put_seq(&o, end, src + lit, i - lit, n, i - m)) return 0;
+      i += n;
+      lit = i;
+    } else {
+      i++;
+    }
+  }
+  if (!put_seq(&o, end, src + lit, len - lit, 0, 0)) return 0;
+  return (size_t)(o - dst);
+}
+
+static int get_len(const uint8_t **p, const uint8_t *end, size_t *n) {
+  uint8_t b;
+  do {
+    if (*p >= end) return 0;
+    b = *(*p)++;
+    *n += b;
+  } while (b == 255);
+  return 1;
+}
+
+int bundle_lz_decompress(const uint8_t *src, size_t len, uint8_t *dst, size_t raw) {
+  const uint8_t *p = src, *end = src + len;
+  size_t o = 0;
+  while (p < end) {
+    uint8_t t = *p++;
+    size_t nlit = t >> 4, ml = t & 15;
+    if (nlit == 15 && !get_len(&p, end, &nlit)) return 0;
+    if (nlit > (size_t)(end - p) || nlit > raw - o) return 0;
+    memcpy(dst + o, p, nlit);
+    p += nlit;
+    o += nlit;
+    if (p == end) break;  // last sequence
+
+    if (end - p < 2) return 0;
+    size_t dist = get16(p);
+    p += 2;
+    if (ml == 15 && !get_len(&p, end, &ml)) return 0;
+    ml += LZ_MIN_MATCH;
+    if (dist == 0 || dist > o || ml > raw - o) return 0;
+    for (size_t k = 0; k < ml; k++, o++) dst[o] = dst[o - dist];  // may overlap
+  }
+  return o == raw;
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// App bundle (.wsb): a script and its assets in one file, so booting an app
+// is one open plus a few large reads instead of a FAT lookup, an open and a
+// String per asset. Made on the host by tools/wsbpack.
+//
+//   header              BUNDLE_HEADER_SIZE bytes
+//   index               count * BUNDLE_ENTRY_SIZE, sorted by path (strcmp)
+//   names               NUL-terminated paths, without a leading '/'
+//   entries             each at a BUNDLE_ALIGN boundary
+//
+// All fields are little endian. index_crc covers the index and the names
+// and is checked at mount; each entry carries the CRC-32 of its content,
+// checked whenever it is loaded whole. Entries flagged BUNDLE_LZ are stored
+// compressed (see bundle_lz_compress()).
+// Plain C and no allocation, so the same file builds into the firmware and
+// into the host tool.
+
+#define BUNDLE_MAGIC "WSB1"
+#define BUNDLE_HEADER_SIZE 32
+#define BUNDLE_ENTRY_SIZE 24
+#define BUNDLE_ALIGN 512   // SD sector: reading one entry never touches another's sectors
+#define BUNDLE_LZ 0x0001
+
+typedef struct {
+  uint32_t count;
+  uint32_t names_size;
+  uint32_t data_offset;  // first entry
+  uint32_t file_size;
+  uint32_t index_crc;
+} bundle_header_t;
+
+typedef struct {
+  uint32_t name;         // offset into the names
+  uint32_t offset;       // from the start of the file
+  uint32_t size;         // stored bytes
+  uint32_t raw_size;     // content bytes, equal to size unless BUNDLE_LZ
+  uint32_t crc;          // CRC-32 of the content
+  uint16_t flags;
+} bundle_entry_t;
+
+// Serialized forms; `buf` holds BUNDLE_HEADER_SIZE / BUNDLE_ENTRY_SIZE bytes
+void bundle_write_header(uint8_t *buf, const bundle_header_t *h);
+void bundle_write_entry(uint8_t *buf, const bundle_entry_t *e);
+// False if `buf` is not a bundle header
+int bundle_read_header(const uint8_t *buf, bundle_header_t *h);
+void bundle_read_entry(const uint8_t *buf, bundle_entry_t *e);
+
+// CRC-32 (IEEE), continued from `crc` (0 to start)
+uint32_t bundle_crc32(uint32_t crc, const void *buf, size_t len);
+
+// LZ77 with LZ4-style sequences: a token byte (literal count in the high
+// nibble, match length - 4 in the low one, 15 meaning more length bytes
+// follow, each adding up to 255), the literals, then a 16-bit distance
+// back into the output. The last sequence has literals only.
+// Returns the compressed size, or 0 if it would not fit in `cap`.
+size_t bundle_lz_compress(const uint8_t *src, size_t len, uint8_t *dst, size_t cap);
+// False unless `src` decodes to exactly `raw` bytes
+int bundle_lz_decompress(const uint8_t *src, size_t len, uint8_t *dst, size_t raw);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,257 @@
+#include "data_ring.h"
+#include <math.h>
+#include <SD_MMC.h>
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+
+typedef struct {
+  float *buf;
+  uint32_t cap;
+  uint32_t head;   // next slot written
+  uint32_t count;
+} data_ring_t;
+
+static data_ring_t g_rings[DATA_RING_MAX];
+static SemaphoreHandle_t g_data_lock = NULL;
+
+#define DATA_LOCK() xSemaphoreTake(g_data_lock, portMAX_DELAY)
+#define DATA_UNLOCK() xSemaphoreGive(g_data_lock)
+
+/******************************************************************************
+ * Tokenizer
+ ******************************************************************************/
+static inline bool data_is_sep(char c) {
+  return c == ',' || c == ';' || c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+// Parse one cell; empty or non-numeric cells are NAN
+static float data_parse_cell(const char *s, size_t len) {
+  char tmp[32];
+  if (len == 0 || len >= sizeof(tmp)) return NAN;
+  memcpy(tmp, s, len);
+  tmp[len] = 0;
+  char *end;
+  float v = strtof(tmp, &end);
+  return end == tmp + len ? v : NAN;
+}
+
+// Numbers from text[*pos..len) into out, advancing *pos past what was read
+static size_t data_parse_from(const char *text, size_t len, size_t *pos, float *out, size_t max) {
+  size_t n = 0, i = *pos;
+  while (n < max) {
+    while (i < len && data_is_sep(text[i])) i++;
+    if (i >= len) break;
+    size_t st = i;
+    while (i < len && !data_is_sep(text[i])) i++;
+    out[n++] = data_parse_cell(text + st, i - st);
+  }
+  *pos = i;
+  return n;
+}
+
+size_t data_parse_numbers(const char *text, size_t len, float *out, size_t max) {
+  size_t pos = 0;
+  return data_parse_from(text, len, &pos, out, max);
+}
+
+/******************************************************************************
+ * Rings
+ ******************************************************************************/
+int data_ring_create(uint32_t capacity) {
+  if (capacity == 0 || capacity > DATA_RING_MAX_CAPACITY) {
+    Serial.printf("data: capacity must be 1..%u\n", (unsigned)DATA_RING_MAX_CAPACITY);
+    return -1;
+  }
+  if (!g_data_lock) g_data_lock = xSemaphoreCreateMutex();
+  if (!g_data_lock) return -1;
+
+  float *buf = (float *)heap_caps_malloc(capacity * sizeof(float), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!buf) buf = (float *)malloc(capacity * sizeof(float));
+  if (!buf) {
+    Serial.printf("data: no memory for %u samples\n", (unsigned)capacity);
+    return -1;
+  }
+
+  int id = -1;
+  DATA_LOCK();
+  for (int i = 0; i < DATA_RING_MAX; i++) {
+    if (g_rings[i].buf) continue;
+    g_rings[i].buf = buf;
+    g_rings[i].cap = capacity;
+    g_rings[i].head = 0;
+    g_rings[i].count = 0;
+    id = i;
+    break;
+  }
+  DATA_UNLOCK();
+  if (id < 0) {
+    Serial.printf("data: at most %d buffers\n", DATA_RING_MAX);
+    free(buf);
+  }
+  return id;
+}
+
+bool data_ring_valid(int id) {
+  return id >= 0 && id < DATA_RING_MAX && g_rings[id].buf;
+}
+
+void data_ring_free(int id) {
+  if (!data_ring_valid(id)) return;
+  DATA_LOCK();
+  float *buf = g_rings[id].buf;
+  g_rings[id].buf = NULL;
+  g_rings[id].count = 0;
+  DATA_UNLOCK();
+  free(buf);
+}
+
+void data_ring_clear(int id) {
+  if (!data_ring_valid(id)) return;
+  DATA_LOCK();
+  g_rings[id].head = 0;
+  g_rings[id].count = 0;
+  DATA_UNLOCK();
+}
+
+uint32_t data_ring_count(int id) {
+  return data_ring_valid(id) ? g_rings[id].count : 0;
+}
+
+// Caller holds the lock
+static void data_ring_put(data_ring_t *r, const float *v, uint32_t n) {
+  if (n > r->cap) {  // only the newest cap samples survive anyway
+    v += n - r->cap;
+    n = r->cap;
+  }
+  uint32_t first = r->cap - r->head;
+  if (first > n) first = n;
+  memcpy(r->buf + r->head, v, first * sizeof(float));
+  memcpy(r->buf, v + first, (n - first) * sizeof(float));
+  r->head = (r->head + n) % r->cap;
+  r->count = (r->count + n > r->cap) ? r->cap : r->count + n;
+}
+
+uint32_t data_ring_push(int id, const float *v, uint32_t n) {
+  if (!data_ring_valid(id)) return 0;
+  DATA_LOCK();
+  if (g_rings[id].buf) data_ring_put(&g_rings[id], v, n);
+  DATA_UNLOCK();
+  return n;
+}
+
+uint32_t data_ring_push_text(int id, const char *text, size_t len) {
+  if (!data_ring_valid(id)) return 0;
+  float chunk[64];
+  uint32_t total = 0;
+  size_t pos = 0;
+  for (;;) {
+    size_t n = data_parse_from(text, len, &pos, chunk, 64);
+    if (n == 0) break;
+    total += data_ring_push(id, chunk, n);
+  }
+  return total;
+}
+
+uint32_t data_ring_load_csv(int id, const char *path, int column, uint32_t first_row, uint32_t rows) {
+  if (!data_ring_valid(id) || column < 0) return 0;
+  File f = SD_MMC.open(path);
+  if (!f) {
+    Serial.printf("data: cannot open %s\n", path);
+    return 0;
+  }
+
+  char line[256];
+  float chunk[64];
+  size_t n = 0;
+  uint32_t row = 0, total = 0;
+  while (f.available() && (rows == 0 || row < first_row + rows)) {
+    size_t len = f.readBytesUntil('\n', line, sizeof(line) - 1);
+    if (len == sizeof(line) - 1) {
+      while (f.available() && f.read() != '\n') {}  // drop the rest of a long row
+    }
+    if (row++ < first_row) continue;
+
+    // Walk to the wanted cell
+    size_t st = 0;
+    for (int c = 0; c < column && st < len; c++) {
+      while (st < len && line[st] != ',') st++;
+      if (st < len) st++;
+    }
+    size_t end = st;
+    while (end < len && line[end] != ',' && line[end] != '\r') end++;
+    while (st < end && line[st] == ' ') st++;
+    chunk[n++] = data_parse_cell(line + st, end - st);
+    if (n == 64) {
+      total += data_ring_push(id, chunk, n);
+      n = 0;
+    }
+  }
+  total += data_ring_push(id, chunk, n);
+  f.close();
+  return total;
+}
+
+uint32_t data_ring_copy(int id, float *out, uint32_t max) {
+  if (!data_ring_valid(id)) return 0;
+  DATA_LOCK();
+  data_ring_t *r = &g_rings[id];
+  uint32_t n = r->count < max ? r->count : max;
+  if (r->buf && n) {
+    uint32_t start = (r->head + r->cap - n) % r->cap;
+    uint32_t first = r->cap - start;
+    if (first > n) first = n;
+    memcpy(out, r->buf + start, first * sizeof(float));
+    memcpy(out + first, r->buf, (n - first) * sizeof(float));
+  }
+  DATA_UNLOCK();
+  return n;
+}
+
+/******************************************************************************
+ * Downsampling
+ ******************************************************************************/
+// `out` may be `in`: no sample is read after its slot has been written
+size_t data_lttb(const float *in, size_t n, float *out, size_t m) {
+  if (m >= n || m < 3) {
+    size_t k = n < m ? n : m;
+    memmove(out, in + (n - k), k * sizeof(float));  // too few buckets: keep the newest
+    return k;
+  }
+
+  double bucket = (double)(n - 2) / (double)(m - 2);
+  size_t a = 0;  // sample picked for the previous bucket
+  out[0] = in[0];
+  for (size_t i = 0; i < m - 2; i++) {
+    // Average of the next bucket is the third corner of the triangle
+    size_t ns = (size_t)((i + 1) * bucket) + 1;
+    size_t ne = (size_t)((i + 2) * bucket) + 1;
+    if (ne > n) ne = n;
+    double ax = 0, ay = 0;
+    size_t cnt = 0;
+    for (size_t j = ns; j < ne; j++) {
+      if (isnan(in[j])) continue;
+      ax += j;
+      ay += in[j];
+      cnt++;
+    }
+    if (cnt) ax /= cnt, ay /= cnt;
+    else ax = ns, ay = isnan(in[a]) ? 0 : in[a];
+
+    // Pick the point of this bucket spanning the largest triangle
+    size_t rs = (size_t)(i * bucket) + 1;
+    size_t re = (size_t)((i + 1) * bucket) + 1;
+    double px = (double)a, py = isnan(in[a]) ? ay : in[a];
+    double best = -1;
+    size_t pick = rs;
+    for (size_t j = rs; j < re; j++) {
+      if (isnan(in[j])) continue;
+      double area = fabs((px - ax) * (in[j] - py) - (px - j) * (ay - py));
+      if (area > best) best = area, pick = j;
+    }
+    out[i + 1] = in[pick];
+    a = pick;
+  }
+  out[m - 1] = in[n - 1];
+  return m;
+}
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <Arduino.h>
+
+// Native sample buffers for charts. Scripts push many samples per call
+// (a CSV/whitespace separated string, or a column of a CSV file on SD) into
+// a float ring held in PSRAM; a chart bridge later copies a ring, or a
+// string, straight into a series array in one go. The oldest samples are
+// overwritten once a ring is full.
+//
+// Rings are written on the Elk task and read by chart bridges on the render
+// task; one mutex guards all of them.
+#ifndef DATA_RING_MAX
+#define DATA_RING_MAX 8               // rings alive at once
+#endif
+#define DATA_RING_MAX_CAPACITY 262144  // samples per ring
+
+// Returns a ring id, or -1 if the table is full or memory is out
+int data_ring_create(uint32_t capacity);
+void data_ring_free(int id);
+void data_ring_clear(int id);
+bool data_ring_valid(int id);
+// Samples currently held (0 for an invalid id)
+uint32_t data_ring_count(int id);
+
+uint32_t data_ring_push(int id, const float *v, uint32_t n);
+// Parse numbers separated by commas, semicolons or whitespace and push
+// them; a token that is not a number is pushed as NAN (a gap). Returns the
+// number of samples pushed.
+uint32_t data_ring_push_text(int id, const char *text, size_t len);
+// Push column `column` (0-based) of rows first_row.. of a CSV file on SD,
+// at most `rows` of them (0 = to the end). Returns samples pushed.
+uint32_t data_ring_load_csv(int id, const char *path, int column, uint32_t first_row, uint32_t rows);
+
+// Copy the newest min(count, max) samples, oldest first. Returns how many.
+uint32_t data_ring_copy(int id, float *out, uint32_t max);
+
+// Same tokenizer as data_ring_push_text() into a plain array; returns the
+// number of values written (at most `max`)
+size_t data_parse_numbers(const char *text, size_t len, float *out, size_t max);
+
+// Largest-triangle-three-buckets: pick `m` of the `n` samples (x = index)
+// that keep the visual shape. First and last samples are always kept;
+// NANs are never picked over a real sample. Writes min(n, m) values.
+size_t data_lttb(const float *in, size_t n, float *out, size_t m);
@@ -0,0 +1,133 @@
+#include <Arduino.h>
+#include <esp_heap_caps.h>
+#include "display.h"
+#include "pins_config.h"
+#include "rm67162.h"
+#include "flush_sched.h"
+#include "pixel_kernels.h"
+
+static lv_disp_t *g_disp = NULL;
+static bool g_panel_up = false;
+static uint32_t g_boot_ms = 0;
+static display_frame_cb_t g_frame_cb = NULL;
+
+static lv_disp_draw_buf_t draw_buf;
+static lv_disp_drv_t disp_drv;
+static lv_color_t *buf = NULL;
+static lv_color_t *buf2 = NULL;  // second band, only in DMA flush mode
+
+// Called from the SPI ISR once the last chunk of a band has been sent
+static void disp_flush_done(void *user) {
+  lv_disp_flush_ready((lv_disp_drv_t *)user);
+}
+
+static void disp_monitor(lv_disp_drv_t *disp, uint32_t ms, uint32_t px) {
+  if (g_frame_cb) g_frame_cb(ms, px);
+}
+
+static void disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
+  // Calculate width/height from the area
+  uint32_t w = (area->x2 - area->x1 + 1);
+  uint32_t h = (area->y2 - area->y1 + 1);
+  uint16_t *px = (uint16_t *)&color_p->full;
+  // Read before pushing: flush-ready (possibly from the ISR) clears it
+  bool last = lv_disp_flush_is_last(disp);
+
+  if (w * h >= LCD_SOLID_MIN_PX && lcd_is_solid(px, w * h)) {
+    // One colour: stream it from the driver's tile, the buffer is free at once
+    lcd_te_frame_begin();
+    lcd_fill_rect(area->x1, area->y1, w, h, px[0]);
+    if (last) lcd_te_frame_done();
+    lv_disp_flush_ready(disp);
+    return;
+  }
+
+  if (buf2) {
+    // Queue the band and return; LVGL renders into the other buffer meanwhile
+    lcd_PushColorsAsync(area->x1, area->y1, w, h, px, disp);
+    if (last) lcd_te_frame_done();
+    return;
+  }
+
+  // Push the rendered data to the display
+  lcd_PushColors(area->x1, area->y1, w, h, px);
+  if (last) lcd_te_frame_done();
+
+  // Tell LVGL flush is done
+  lv_disp_flush_ready(disp);
+}
+
+static bool alloc_draw_buffers() {
+#if LCD_DMA_FLUSH
+  // Two partial bands in internal DMA-capable RAM
+  buf  = (lv_color_t *)heap_caps_malloc(sizeof(lv_color_t) * LVGL_DMA_BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  buf2 = (lv_color_t *)heap_caps_malloc(sizeof(lv_color_t) * LVGL_DMA_BUF_SIZE, MALLOC_CAP_DMA | MALLOC_CAP_INTERNAL);
+  if (buf && buf2) {
+    lcd_set_flush_done_cb(disp_flush_done);
+    lv_disp_draw_buf_init(&draw_buf, buf, buf2, LVGL_DMA_BUF_SIZE);
+    return true;
+  }
+  Serial.println("No DMA RAM for draw buffers, using PSRAM + blocking flush");
+  free(buf);
+  free(buf2);
+  buf = buf2 = NULL;
+#endif
+
+  // One full frame in PSRAM
+  buf = (lv_color_t *)ps_malloc(sizeof(lv_color_t) * LVGL_LCD_BUF_SIZE);
+  if (!buf) {
+    Serial.println("Failed to allocate LVGL buffer in PSRAM");
+    return false;
+  }
+  lv_disp_draw_buf_init(&draw_buf, buf, NULL, LVGL_LCD_BUF_SIZE);
+  return true;
+}
+
+bool display_init() {
+  if (g_disp) return true;
+  uint32_t t0 = millis();
+
+  if (!g_panel_up) {
+    // Turn on backlight / screen power
+    pinMode(PIN_LED, OUTPUT);
+    digitalWrite(PIN_LED, HIGH);
+
+    // Init the AMOLED driver & set rotation
+    if (!rm67162_init()) {
+      Serial.println("Display: panel did not report ready, continuing anyway");
+    }
+    lcd_setRotation(1);
+
+    lv_init();
+    g_panel_up = true;
+  }
+  if (!alloc_draw_buffers()) return false;
+
+  lv_disp_drv_init(&disp_drv);
+  disp_drv.hor_res = EXAMPLE_LCD_H_RES;
+  disp_drv.ver_res = EXAMPLE_LCD_V_RES;
+  disp_drv.flush_cb = disp_flush;
+  disp_drv.draw_buf = &draw_buf;
+  disp_drv.draw_ctx_init = px_draw_ctx_init;  // vector fill/copy/blend kernels
+  disp_drv.monitor_cb = disp_monitor;
+  g_disp = lv_disp_drv_register(&disp_drv);
+  flush_sched_attach(g_disp);
+
+  // Paint the empty screen now so the panel never shows stale frame memory
+  lv_refr_now(g_disp);
+  g_boot_ms = millis() - t0;
+  Serial.printf("Display: ready in %lu ms\n", (unsigned long)g_boot_ms);
+  return true;
+}
+
+lv_disp_t *display_get() {
+  return g_disp;
+}
+
+uint32_t display_boot_ms() {
+  return g_boot_ms;
+}
+
+void display_on_frame(display_frame_cb_t cb) {
+  g_frame_cb = cb;
+}
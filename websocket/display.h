@@ -0,0 +1,17 @@
+#pragma once
+
+#include <lvgl.h>
+
+// Display service shared by fallback and dynamic mode: backlight, panel
+// bring-up, lv_init() and the LVGL display driver happen once, however
+// often (and from whichever mode) display_init() is called.
+// Returns false if the draw buffers could not be allocated.
+bool display_init();
+// The registered LVGL display, NULL before display_init()
+lv_disp_t *display_get();
+// Milliseconds the first display_init() took, reset to first pixel ready
+uint32_t display_boot_ms();
+// Called on the render task after every refreshed frame (LVGL monitor_cb)
+// with the render time in ms and the number of pixels redrawn. One hook.
+typedef void (*display_frame_cb_t)(uint32_t ms, uint32_t px);
+void display_on_frame(display_frame_cb_t cb);
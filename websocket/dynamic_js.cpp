@@ -6,6 +6,8 @@
 #include "pins_config.h"
 #include "rm67162.h"
 #include "lvgl_elk.h"  // Contains init_lvgl_display(), init_lv_fs(), etc.
+#include "ui_queue.h"
+#include "bundle.h"
 
 void dynamic_js_setup() {
   Serial.println("DYNAMIC_JS: Setting up Elk + script.js scenario...");
@@ -29,14 +31,23 @@ void dynamic_js_setup() {
   // 4) 'M' driver for memory usage (GIF)
   init_mem_fs();
 
-  // 5) Init memory storage
-  init_ram_images();
+  // 5) 'B' driver, and the app bundle if there is one (bundle.h)
+  init_bundle_fs();
+  bundle_mount(BUNDLE_APP_PATH);
 
-  // 6) Spawn Elk task
+  // 6) Render task: owns LVGL from here on
+  ui_start();
+
+  // 7) Elk heap and stack as configured, then spawn the Elk task
+  load_elk_config("/webscreen.json");
+  if(!alloc_elk_memory()) {
+    Serial.println("DYNAMIC_JS: not enough memory for the Elk heap");
+    return;
+  }
   xTaskCreatePinnedToCore(
       elk_task,          
       "ElkTask",         
-      16384,             
+      elk_task_stack_size(),
       NULL,              
       1,                 
       NULL,              
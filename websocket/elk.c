@@ -65,6 +65,13 @@ struct js {
   jsoff_t gct;        // GC threshold. If brk > gct, trigger GC
   jsoff_t maxcss;     // Maximum allowed C stack size usage
   void *cstk;         // C stack pointer at the beginning of js_eval()
+  struct jscode *caller;  // Code of the callers, GC moves it like js->code
+};
+
+// Parser position of a caller, saved while a JS function runs
+struct jscode {
+  const char *code;
+  struct jscode *prev;
 };
 
 // A JS memory stores diffenent entities: objects, properties, strings
@@ -340,6 +347,15 @@ static bool is_mem_entity(uint8_t t) {
 }
 
 #define GCMASK ~(((jsoff_t) ~0) >> 1)  // Entity deletion marker
+static const char *fixup_code(struct js *js, const char *code, jsoff_t start, jsoff_t size) {
+  if (code > (char *) js->mem && code - (char *) js->mem < js->size &&
+      code - (char *) js->mem > start) {
+    code -= size;
+    // printf("GC-ing code under us!! %ld\n", code - (char *) js->mem);
+  }
+  return code;
+}
+
 static void js_fixup_offsets(struct js *js, jsoff_t start, jsoff_t size) {
   for (jsoff_t n, v, off = 0; off < js->brk; off += n) {  // start from 0!
     v = loadoff(js, off);
@@ -365,11 +381,10 @@ static void js_fixup_offsets(struct js *js, jsoff_t start, jsoff_t size) {
   jsoff_t off = (jsoff_t) vdata(js->scope);
   if (off > start) js->scope = mkval(T_OBJ, off - size);
   if (js->nogc >= start) js->nogc -= size;
-  // Fixup code that we're executing now, if required
-  if (js->code > (char *) js->mem && js->code - (char *) js->mem < js->size &&
-      js->code - (char *) js->mem > start) {
-    js->code -= size;
-    // printf("GC-ing code under us!! %ld\n", js->code - (char *) js->mem);
+  // Fixup code that we're executing now, and that of the callers, if required
+  js->code = fixup_code(js, js->code, start, size);
+  for (struct jscode *c = js->caller; c != NULL; c = c->prev) {
+    c->code = fixup_code(js, c->code, start, size);
   }
   // printf("FIXEDOFF %u %u\n", start, size);
 }
@@ -755,8 +770,9 @@ static jsval_t do_call_op(struct js *js, jsval_t func, jsval_t args) {
   if (vtype(args) != T_CODEREF) return js_mkerr(js, "bad call");
   if (vtype(func) != T_FUNC && vtype(func) != T_CFUNC)
     return js_mkerr(js, "calling non-function");
-  const char *code = js->code;             // Save current parser state
+  struct jscode caller = {js->code, js->caller};  // Save current parser state
   jsoff_t clen = js->clen, pos = js->pos;  // code, position and code length
+  js->caller = &caller;
   js->code = &js->code[coderefoff(args)];  // Point parser to args
   js->clen = codereflen(args);             // Set args length
   js->pos = skiptonext(js->code, js->clen, 0);  // Skip to 1st arg
@@ -770,7 +786,8 @@ static jsval_t do_call_op(struct js *js, jsval_t func, jsval_t args) {
   } else {
     res = call_c(js, (jsval_t(*)(struct js *, jsval_t *, int)) vdata(func));
   }
-  js->code = code, js->clen = clen, js->pos = pos;  // Restore parser
+  js->caller = caller.prev;
+  js->code = caller.code, js->clen = clen, js->pos = pos;  // Restore parser
   js->flags = flags, js->tok = tok, js->nogc = nogc;
   js->consumed = 1;
   return res;
@@ -1371,6 +1388,7 @@ void js_stats(struct js *js, size_t *total, size_t *lwm, size_t *css) {
   if (lwm) *lwm = js->lwm;
   if (css) *css = js->css;
 }
+size_t js_usage(struct js *js) { return js->brk; }
 // clang-format on
 
 bool js_chkargs(jsval_t *args, int nargs, const char *spec) {
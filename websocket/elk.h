@@ -37,6 +37,7 @@ bool js_truthy(struct js *, jsval_t);                // Check if value is true
 void js_setmaxcss(struct js *, size_t);              // Set max C stack size
 void js_setgct(struct js *, size_t);                 // Set GC trigger threshold
 void js_stats(struct js *, size_t *total, size_t *min, size_t *cstacksize);
+size_t js_usage(struct js *);  // Bytes of the arena currently in use
 void js_dump(struct js *);  // Print debug info. Requires -DJS_DUMP
 
 // Create JS values from C values
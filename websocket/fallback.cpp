@@ -4,42 +4,99 @@
 #include "rm67162.h"          // LCD driver
 #include <lvgl.h>             // Ensure you have LVGL
 #include "notification.h"      // For the GIF data
+#include "display.h"
+#include "ui_queue.h"
 
 // We'll store references to the fallback label + gif
 static lv_obj_t* fb_label = nullptr;
 static lv_obj_t* fb_gif   = nullptr;
 
-// A local display buffer/driver just for fallback, if you want separate from dynamic
-static lv_disp_draw_buf_t fbDrawBuf;
-static lv_color_t* fbBuf = nullptr;
+// Serial input is polled, so never sleep longer than this
+#define FB_INPUT_POLL_MS 50
 
-// The flush callback
-static void fallback_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
-  uint32_t w = (area->x2 - area->x1 + 1);
-  uint32_t h = (area->y2 - area->y1 + 1);
-  lcd_PushColors(area->x1, area->y1, w, h, (uint16_t *)&color_p->full);
-  lv_disp_flush_ready(disp);
-}
+// The ticker moves the label up through the screen. The panel can only
+// scroll in hardware along its native rows, which run along x in landscape;
+// with FB_TICKER_HW_SCROLL the label crosses the screen from right to left
+// instead, on the panel's scroll window, and LVGL only renders the columns
+// each step exposes.
+#ifndef FB_TICKER_HW_SCROLL
+#define FB_TICKER_HW_SCROLL 0
+#endif
+
+#define FB_TICKER_MS 10000
+
+#if FB_TICKER_HW_SCROLL
+// Ticker speed in pixels per second
+#define FB_TICKER_SPEED 150
+
+// Label x at the previous animation step
+static int32_t fb_ticker_x = LV_COORD_MIN;
+
+// Animation callback. Each step draws the newly exposed columns on the
+// right into the frame memory columns they will occupy, then moves the
+// scroll window over them, so nothing stale comes into view.
+static void scroll_anim_cb(void *var, int32_t v) {
+  lv_obj_t *obj = (lv_obj_t *)var;
+  lv_disp_t *disp = lv_obj_get_disp(obj);
+  lv_coord_t hor = lv_disp_get_hor_res(disp);
+  int32_t step = fb_ticker_x - v;
+  fb_ticker_x = v;
+
+  if (!lcd_scroll_active() || step <= 0 || step >= hor) {
+    // First step, a repeat or a jump: plain redraw at the new position
+    lv_obj_set_x(obj, v);
+    return;
+  }
 
+  uint16_t next = lcd_scroll_offset() + step;
+  lcd_scroll_prepare(next);
+  lv_disp_enable_invalidation(disp, false);
+  lv_obj_set_x(obj, v);
+  lv_disp_enable_invalidation(disp, true);
+
+  lv_area_t strip = { (lv_coord_t)(hor - step), 0, (lv_coord_t)(hor - 1),
+                      (lv_coord_t)(lv_disp_get_ver_res(disp) - 1) };
+  _lv_inv_area(disp, &strip);
+  lv_refr_now(disp);
+  lcd_scroll_to(next);  // waits for the strip to leave the bus
+}
+#else
 // Animation callback
 static void scroll_anim_cb(void *var, int32_t v) {
   lv_obj_set_y((lv_obj_t *)var, v);
 }
+#endif
 
 // Helper to create the scrolling animation
-static void create_scroll_animation(lv_obj_t *obj, int32_t start, int32_t end, uint32_t duration) {
+static void create_scroll_animation(lv_obj_t *obj) {
+  lv_obj_update_layout(obj);
   lv_anim_t a;
   lv_anim_init(&a);
   lv_anim_set_var(&a, obj);
+#if FB_TICKER_HW_SCROLL
+  // Enters on the right, leaves on the left
+  int32_t start = lv_disp_get_hor_res(lv_obj_get_disp(obj));
+  int32_t end = -lv_obj_get_width(obj);
+  lcd_scroll_enable(true);
+  fb_ticker_x = LV_COORD_MIN;
   lv_anim_set_values(&a, start, end);
-  lv_anim_set_time(&a, duration);
-  lv_anim_set_exec_cb(&a, scroll_anim_cb);
+  lv_anim_set_time(&a, (start - end) * 1000 / FB_TICKER_SPEED);
+  lv_anim_set_path_cb(&a, lv_anim_path_linear); // Even steps, even strips
+#else
+  lv_anim_set_values(&a, 240, -lv_obj_get_height(obj));
+  lv_anim_set_time(&a, FB_TICKER_MS);
   lv_anim_set_path_cb(&a, lv_anim_path_ease_in_out); // Smooth
+#endif
+  lv_anim_set_exec_cb(&a, scroll_anim_cb);
   lv_anim_set_repeat_count(&a, 2); // Repeat twice
 
   // On animation finish, hide label, show GIF
   lv_anim_set_ready_cb(&a, [](lv_anim_t *anim) {
     lv_obj_t *obj = (lv_obj_t *)anim->var;
+#if FB_TICKER_HW_SCROLL
+    lcd_scroll_enable(false);
+    lv_obj_invalidate(lv_scr_act());  // panel memory no longer lines up
+#endif
     lv_obj_add_flag(obj, LV_OBJ_FLAG_HIDDEN);
     lv_obj_clear_flag(fb_gif, LV_OBJ_FLAG_HIDDEN);
   });
@@ -50,38 +107,13 @@ static void create_scroll_animation(lv_obj_t *obj, int32_t start, int32_t end, u
 void fallback_setup() {
   Serial.println("FALLBACK: Setting up scrolling label + GIF...");
 
-  // 1) Minimal LVGL init (only if not already done).  
-  //    If your main code calls lv_init() elsewhere, 
-  //    you might skip or check if it’s safe to call again.
-  lv_init();
-
-  // 2) Power on the screen, set backlight
-  pinMode(PIN_LED, OUTPUT);
-  digitalWrite(PIN_LED, HIGH);
-
-  // 3) Init your display driver
-  rm67162_init();
-  lcd_setRotation(1);
-
-  // 4) Allocate a buffer for fallback usage
-  fbBuf = (lv_color_t*) ps_malloc(sizeof(lv_color_t) * LVGL_LCD_BUF_SIZE);
-  if(!fbBuf) {
-    Serial.println("FALLBACK: Failed to allocate buffer");
+  // 1) Panel + LVGL display, shared with dynamic mode (no-op if already up)
+  if (!display_init()) {
+    Serial.println("FALLBACK: Display init failed");
     return;
   }
 
-  lv_disp_draw_buf_init(&fbDrawBuf, fbBuf, nullptr, LVGL_LCD_BUF_SIZE);
-
-  // 5) Register fallback display driver
-  static lv_disp_drv_t disp_drv;
-  lv_disp_drv_init(&disp_drv);
-  disp_drv.hor_res = 536;
-  disp_drv.ver_res = 240;
-  disp_drv.flush_cb = fallback_disp_flush;
-  disp_drv.draw_buf = &fbDrawBuf;
-  lv_disp_drv_register(&disp_drv);
-
-  // 6) Create a style for the label
+  // 2) Create a style for the label
   static lv_style_t style;
   lv_style_init(&style);
   lv_style_set_text_font(&style, &lv_font_montserrat_40);
@@ -90,7 +122,7 @@ void fallback_setup() {
   lv_style_set_pad_all(&style, 5);
   lv_style_set_text_align(&style, LV_TEXT_ALIGN_CENTER);
 
-  // 7) Create the label
+  // 3) Create the label
   fb_label = lv_label_create(lv_scr_act());
   lv_obj_add_style(fb_label, &style, 0);
   lv_label_set_text(fb_label, 
@@ -105,10 +137,10 @@ void fallback_setup() {
   lv_obj_set_width(fb_label, 525);
   lv_obj_align(fb_label, LV_ALIGN_CENTER, 0, 0);
 
-  // 8) Create the scroll animation
-  create_scroll_animation(fb_label, 240, -lv_obj_get_height(fb_label), 10000);
+  // 4) Create the scroll animation
+  create_scroll_animation(fb_label);
 
-  // 9) Create the GIF
+  // 5) Create the GIF
   fb_gif = lv_gif_create(lv_scr_act());
   lv_gif_set_src(fb_gif, &notification); // from notification.h
   lv_obj_align(fb_gif, LV_ALIGN_CENTER, 0, 0);
@@ -119,8 +151,8 @@ void fallback_setup() {
 }
 
 void fallback_loop() {
-  // Let LVGL run
-  lv_timer_handler();
+  // Let LVGL run, then sleep until its next timer is due
+  ui_run_once(FB_INPUT_POLL_MS);
 
   // If serial data arrives, treat that as an input to update label
   if (Serial.available()) {
@@ -131,6 +163,6 @@ void fallback_loop() {
     lv_obj_add_flag(fb_gif, LV_OBJ_FLAG_HIDDEN);
 
     // re-run animation
-    create_scroll_animation(fb_label, 240, -lv_obj_get_height(fb_label), 10000);
+    create_scroll_animation(fb_label);
   }
 }
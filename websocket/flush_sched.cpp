@@ -0,0 +1,77 @@
+#include <Arduino.h>
+#include "flush_sched.h"
+#include "rm67162.h"
+
+static flush_sched_stats_t g_sched_stats;
+
+static uint32_t window_cost(const lv_area_t *a) {
+  return lv_area_get_size(a) + FLUSH_WINDOW_COST_PX;
+}
+
+static void flush_sched_coalesce(lv_disp_t *disp) {
+  uint16_t n = disp->inv_p;
+  if (n == 0) return;
+
+  lv_area_t *areas = disp->inv_areas;
+  uint8_t *joined  = disp->inv_area_joined;
+
+  g_sched_stats.frames++;
+  for (uint16_t i = 0; i < n; i++) {
+    if (joined[i]) continue;
+    g_sched_stats.areas_in++;
+    g_sched_stats.dirty_px += lv_area_get_size(&areas[i]);
+  }
+
+  // Greedy pairwise merge until no pair gets cheaper as one window
+  bool merged = true;
+  while (merged) {
+    merged = false;
+    for (uint16_t i = 0; i < n; i++) {
+      if (joined[i]) continue;
+      for (uint16_t j = i + 1; j < n; j++) {
+        if (joined[j]) continue;
+        lv_area_t u;
+        _lv_area_join(&u, &areas[i], &areas[j]);
+        if (window_cost(&u) <= window_cost(&areas[i]) + window_cost(&areas[j])) {
+          areas[i] = u;
+          joined[j] = 1;
+          merged = true;
+        }
+      }
+    }
+  }
+
+  for (uint16_t i = 0; i < n; i++) {
+    if (joined[i]) continue;
+    g_sched_stats.areas_out++;
+    g_sched_stats.window_px += lv_area_get_size(&areas[i]);
+  }
+}
+
+static void flush_sched_refr_timer(lv_timer_t *t) {
+  lv_disp_t *disp = (lv_disp_t *)t->user_data;
+  if (disp) flush_sched_coalesce(disp);
+  _lv_disp_refr_timer(t);
+}
+
+void flush_sched_attach(lv_disp_t *disp) {
+  if (!disp || !disp->refr_timer) return;
+  lv_timer_set_cb(disp->refr_timer, flush_sched_refr_timer);
+}
+
+void flush_sched_get_stats(flush_sched_stats_t *out) {
+  *out = g_sched_stats;
+}
+
+void flush_sched_report() {
+  lcd_push_stats_t ps;
+  lcd_get_push_stats(&ps);
+  Serial.printf("flush: %u frames, %u areas -> %u windows, dirty %llu px, pushed %llu bytes (%u windows, %u trans)\n",
+                (unsigned)g_sched_stats.frames,
+                (unsigned)g_sched_stats.areas_in,
+                (unsigned)g_sched_stats.areas_out,
+                (unsigned long long)g_sched_stats.dirty_px,
+                (unsigned long long)ps.bytes,
+                (unsigned)ps.windows,
+                (unsigned)ps.transactions);
+}
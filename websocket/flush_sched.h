@@ -0,0 +1,26 @@
+#pragma once
+
+#include <lvgl.h>
+
+// Flush scheduler: before LVGL renders a frame, merge invalidated areas
+// whenever one bounding window is cheaper than separate windows. A window
+// costs its pixels plus a fixed setup charge for the CASET/RASET/RAMWR
+// batch and LVGL's per-area render pass, expressed in pixels.
+#ifndef FLUSH_WINDOW_COST_PX
+#define FLUSH_WINDOW_COST_PX 2048
+#endif
+
+typedef struct {
+  uint32_t frames;     // refresh passes that had something to draw
+  uint32_t areas_in;   // invalidated areas handed over by LVGL
+  uint32_t areas_out;  // windows left after coalescing
+  uint64_t dirty_px;   // pixels actually invalidated
+  uint64_t window_px;  // pixels covered by the windows that get rendered
+} flush_sched_stats_t;
+
+// Hook the scheduler into a registered display's refresh timer
+void flush_sched_attach(lv_disp_t *disp);
+void flush_sched_get_stats(flush_sched_stats_t *out);
+// Print dirty vs pushed totals (scheduler + driver counters) to Serial;
+// part of the periodic serial telemetry (js_mon_report() in lvgl_elk.h)
+void flush_sched_report();
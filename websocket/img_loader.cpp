@@ -0,0 +1,322 @@
+#include <Arduino.h>
+#include <SD_MMC.h>
+#include <string.h>
+#include <strings.h>
+#include "esp_heap_caps.h"
+#include "img_loader.h"
+#include "bundle.h"
+
+typedef struct img_entry {
+  struct img_entry *next;
+  char *path;
+  time_t mtime;      // version of the file the copy was decoded from
+  size_t fsize;
+  lv_img_dsc_t dsc;
+  uint16_t refs;     // lv_img objects showing it; 0 = cached only
+  bool stale;        // the file changed while in use, freed on last release
+  uint32_t used;     // LRU tick
+} img_entry_t;
+
+static img_entry_t *g_imgs = NULL;
+static size_t g_img_budget = IMG_CACHE_BUDGET_DEFAULT;
+static uint32_t g_img_tick = 0;
+static img_cache_stats_t g_img_stats;
+
+static uint8_t *img_alloc(size_t n) {
+  return (uint8_t *)heap_caps_malloc(n, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+}
+
+/******************************************************************************
+ * Decoding
+ ******************************************************************************/
+static bool img_bin_header_ok(const lv_img_header_t &h) {
+  return !h.always_zero && h.w && h.h && h.cf >= LV_IMG_CF_TRUE_COLOR && h.cf <= LV_IMG_CF_ALPHA_8BIT;
+}
+
+// LVGL .bin from the app bundle: loaded in one read, header dropped in place
+static bool img_load_bin_bundle(const bundle_entry_t *be, const char *path, lv_img_dsc_t *out) {
+  uint8_t *buf = bundle_load(be);
+  if (!buf) return false;
+  lv_img_header_t h;
+  memcpy(&h, buf, be->raw_size >= sizeof(h) ? sizeof(h) : 0);
+  uint32_t size = 0;
+  if (be->raw_size < sizeof(h) || !img_bin_header_ok(h) ||
+      be->raw_size - sizeof(h) < (size = lv_img_buf_get_img_size(h.w, h.h, h.cf))) {
+    Serial.printf("img: %s is not a complete LVGL image file\n", path);
+    free(buf);
+    return false;
+  }
+  memmove(buf, buf + sizeof(h), size);
+
+  memset(out, 0, sizeof(*out));
+  out->header = h;
+  out->data_size = size;
+  out->data = buf;
+  return true;
+}
+
+// LVGL .bin: lv_img_header_t followed by the pixel data in its colour format
+static bool img_load_bin(const char *path, lv_img_dsc_t *out) {
+  const bundle_entry_t *be = bundle_find(path);
+  if (be) return img_load_bin_bundle(be, path, out);
+
+  File f = SD_MMC.open(path, FILE_READ);
+  if (!f) {
+    Serial.printf("img: cannot open %s\n", path);
+    return false;
+  }
+  lv_img_header_t h;
+  if (f.read((uint8_t *)&h, sizeof(h)) != sizeof(h) || !img_bin_header_ok(h)) {
+    Serial.printf("img: %s is not an LVGL image file\n", path);
+    f.close();
+    return false;
+  }
+  uint32_t size = lv_img_buf_get_img_size(h.w, h.h, h.cf);
+  if (f.size() < sizeof(h) + size) {
+    Serial.printf("img: %s is truncated (%u of %u data bytes)\n", path,
+                  (unsigned)(f.size() - sizeof(h)), (unsigned)size);
+    f.close();
+    return false;
+  }
+  uint8_t *buf = img_alloc(size);
+  if (!buf || f.read(buf, size) != size) {
+    Serial.printf("img: cannot load %u bytes of %s\n", (unsigned)size, path);
+    free(buf);
+    f.close();
+    return false;
+  }
+  f.close();
+
+  memset(out, 0, sizeof(*out));
+  out->header = h;
+  out->data_size = size;
+  out->data = buf;
+  return true;
+}
+
+// PNG, JPEG, ...: whichever LVGL decoder claims the file, run once
+static bool img_decode_lvgl(const char *path, lv_img_dsc_t *out) {
+  String src = String(bundle_find(path) ? "B:" : "S:") + path;
+  lv_img_decoder_dsc_t dsc;
+  if (lv_img_decoder_open(&dsc, src.c_str(), lv_color_black(), 0) != LV_RES_OK) {
+    Serial.printf("img: no decoder could open %s\n", path);
+    return false;
+  }
+
+  bool alpha;
+  switch (dsc.header.cf) {
+    case LV_IMG_CF_TRUE_COLOR: case LV_IMG_CF_RAW:
+      alpha = false;
+      break;
+    case LV_IMG_CF_TRUE_COLOR_ALPHA: case LV_IMG_CF_RAW_ALPHA:
+      alpha = true;
+      break;
+    default:
+      Serial.printf("img: %s decodes to unsupported format %d\n", path, dsc.header.cf);
+      lv_img_decoder_close(&dsc);
+      return false;
+  }
+
+  const uint32_t w = dsc.header.w, h = dsc.header.h;
+  size_t px = alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+  size_t size = (size_t)w * h * px;
+  uint8_t *buf = img_alloc(size);
+  bool ok = buf != NULL;
+  if (ok && dsc.img_data) {
+    memcpy(buf, dsc.img_data, size);  // decoder produced the whole frame
+  } else {
+    for (uint32_t y = 0; ok && y < h; y++) {
+      ok = lv_img_decoder_read_line(&dsc, 0, y, w, buf + y * w * px) == LV_RES_OK;
+    }
+  }
+  lv_img_decoder_close(&dsc);
+  if (!ok) {
+    Serial.printf("img: cannot decode %s (%ux%u)\n", path, (unsigned)w, (unsigned)h);
+    free(buf);
+    return false;
+  }
+
+  // PNG decoders always hand out an alpha byte; drop it if every pixel is
+  // opaque, which saves a third of the memory and the blending when drawn
+  if (alpha) {
+    size_t n = (size_t)w * h, i;
+    for (i = 0; i < n && buf[i * px + px - 1] == LV_OPA_COVER; i++) {}
+    if (i == n) {
+      for (i = 0; i < n; i++) memmove(buf + i * sizeof(lv_color_t), buf + i * px, sizeof(lv_color_t));
+      size = n * sizeof(lv_color_t);
+      uint8_t *shrunk = (uint8_t *)heap_caps_realloc(buf, size, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+      if (shrunk) buf = shrunk;
+      alpha = false;
+    }
+  }
+
+  memset(out, 0, sizeof(*out));
+  out->header.cf = alpha ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+  out->header.w = w;
+  out->header.h = h;
+  out->data_size = size;
+  out->data = buf;
+  return true;
+}
+
+bool img_decode(const char *path, lv_img_dsc_t *out) {
+  size_t len = strlen(path);
+  if (len > 4 && strcasecmp(path + len - 4, ".bin") == 0) return img_load_bin(path, out);
+  return img_decode_lvgl(path, out);
+}
+
+/******************************************************************************
+ * Sharing
+ ******************************************************************************/
+static void img_free(img_entry_t *e) {
+  g_img_stats.entries--;
+  g_img_stats.bytes -= e->dsc.data_size;
+  lv_img_cache_invalidate_src(&e->dsc);
+  free((void *)e->dsc.data);
+  free(e->path);
+  free(e);
+}
+
+static void img_unlink(img_entry_t *e) {
+  for (img_entry_t **pp = &g_imgs; *pp; pp = &(*pp)->next) {
+    if (*pp == e) {
+      *pp = e->next;
+      return;
+    }
+  }
+}
+
+// Drop least recently used unreferenced copies until the cache fits its
+// budget (or `need` more bytes would). Copies in use are never evicted, so
+// the cache can stay over budget while they are on screen.
+static void img_evict(size_t need) {
+  while (g_img_stats.bytes + need > g_img_budget) {
+    img_entry_t *lru = NULL;
+    for (img_entry_t *e = g_imgs; e; e = e->next) {
+      if (!e->refs && (!lru || (int32_t)(e->used - lru->used) < 0)) lru = e;
+    }
+    if (!lru) return;
+    img_unlink(lru);
+    img_free(lru);
+    g_img_stats.evictions++;
+  }
+}
+
+// The file's version is part of the key: a photo replaced on the SD card
+// is decoded again. FAT timestamps without an RTC rarely move, so the size
+// counts too. Bundle entries (which shadow SD files) use their CRC instead.
+static bool img_version(const char *path, time_t *mtime, size_t *fsize) {
+  const bundle_entry_t *be = bundle_find(path);
+  if (be) {
+    *mtime = (time_t)be->crc;
+    *fsize = be->raw_size;
+    return true;
+  }
+  File f = SD_MMC.open(path, FILE_READ);
+  if (!f) {
+    Serial.printf("img: cannot open %s\n", path);
+    return false;
+  }
+  *mtime = f.getLastWrite();
+  *fsize = f.size();
+  f.close();
+  return true;
+}
+
+const lv_img_dsc_t *img_acquire(const char *path) {
+  time_t mtime;
+  size_t fsize;
+  if (!img_version(path, &mtime, &fsize)) return NULL;
+
+  img_entry_t **pp = &g_imgs;
+  while (*pp) {
+    img_entry_t *e = *pp;
+    if (e->stale || strcmp(e->path, path) != 0) {
+      pp = &e->next;
+    } else if (e->mtime == mtime && e->fsize == fsize) {
+      if (e->refs++ == 0) g_img_stats.in_use++;
+      e->used = ++g_img_tick;
+      g_img_stats.hits++;
+      return &e->dsc;
+    } else if (e->refs) {
+      e->stale = true;  // older version still on screen
+      pp = &e->next;
+    } else {
+      *pp = e->next;
+      img_free(e);
+    }
+  }
+  g_img_stats.misses++;
+
+  img_entry_t *e = (img_entry_t *)calloc(1, sizeof(img_entry_t));
+  if (!e) return NULL;
+  e->path = strdup(path);
+  bool ok = e->path && img_decode(path, &e->dsc);
+  if (!ok && e->path && g_imgs) {
+    img_evict(g_img_budget);  // maybe out of PSRAM: drop every idle copy, retry
+    ok = img_decode(path, &e->dsc);
+  }
+  if (!ok) {
+    free(e->path);
+    free(e);
+    return NULL;
+  }
+  e->mtime = mtime;
+  e->fsize = fsize;
+  e->refs = 1;
+  e->used = ++g_img_tick;
+  img_evict(e->dsc.data_size);
+  e->next = g_imgs;
+  g_imgs = e;
+  g_img_stats.entries++;
+  g_img_stats.in_use++;
+  g_img_stats.bytes += e->dsc.data_size;
+  Serial.printf("img: %s decoded, %ux%u, %u bytes\n", path, (unsigned)e->dsc.header.w,
+                (unsigned)e->dsc.header.h, (unsigned)e->dsc.data_size);
+  return &e->dsc;
+}
+
+void img_release(const lv_img_dsc_t *dsc) {
+  for (img_entry_t *e = g_imgs; e; e = e->next) {
+    if (&e->dsc != dsc) continue;
+    if (e->refs && --e->refs == 0) {
+      g_img_stats.in_use--;
+      if (e->stale) {
+        img_unlink(e);
+        img_free(e);
+      } else {
+        e->used = ++g_img_tick;  // stays cached until evicted
+        img_evict(0);
+      }
+    }
+    return;
+  }
+}
+
+void img_cache_set_budget(size_t bytes) {
+  g_img_budget = bytes;
+  img_evict(0);
+}
+
+void img_cache_get_stats(img_cache_stats_t *out) {
+  *out = g_img_stats;
+  out->budget = g_img_budget;
+}
+
+static void img_obj_deleted(lv_event_t *e) {
+  img_release((const lv_img_dsc_t *)lv_event_get_user_data(e));
+}
+
+bool img_set_src(lv_obj_t *img, const char *path) {
+  const lv_img_dsc_t *dsc = img_acquire(path);
+  if (!dsc) return false;
+
+  // Switch first, then drop the previous shared copy (possibly freeing it)
+  const void *old = lv_img_get_src(img);
+  bool owned = old && lv_img_src_get_type(old) == LV_IMG_SRC_VARIABLE &&
+               lv_obj_remove_event_cb_with_user_data(img, img_obj_deleted, (void *)old);
+  lv_img_set_src(img, dsc);
+  lv_obj_add_event_cb(img, img_obj_deleted, LV_EVENT_DELETE, (void *)dsc);
+  if (owned) img_release((const lv_img_dsc_t *)old);
+  return true;
+}
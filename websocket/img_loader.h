@@ -0,0 +1,47 @@
+#pragma once
+
+#include <lvgl.h>
+
+// Decode-once image loader. Images are read from SD (or from the mounted
+// app bundle, whose entries shadow SD files) and turned into a
+// ready-to-draw lv_img_dsc_t in PSRAM:
+//  - LVGL .bin files: the 4-byte lv_img_header_t is parsed and the pixel
+//    data (any colour format) is loaded as is
+//  - PNG, JPEG and anything else an LVGL decoder is registered for
+//    (LV_USE_PNG, LV_USE_SJPG, LV_USE_BMP in lv_conf.h) are decoded once
+//    into RGB565, with an alpha byte per pixel only if the image actually
+//    has transparent pixels
+// LVGL then draws from memory instead of re-decoding from SD on every
+// redraw. Every object showing the same file shares one copy. When the last
+// of them is deleted the copy stays cached, keyed by path and file version,
+// until the least recently used idle copies are evicted to keep the cache
+// within its PSRAM byte budget.
+// Render task only (the decoders and lv_img objects belong to LVGL).
+#define IMG_CACHE_BUDGET_DEFAULT (2 * 1024 * 1024)
+
+typedef struct {
+  uint32_t entries;    // decoded copies held
+  uint32_t in_use;     // of which shown by at least one object
+  size_t bytes;        // pixel data held
+  size_t budget;
+  uint32_t hits, misses, evictions;
+} img_cache_stats_t;
+
+// Decode `path` (an SD path such as "/icon.png") into `out`; the pixel
+// buffer is heap_caps_malloc'd and owned by the caller
+bool img_decode(const char *path, lv_img_dsc_t *out);
+
+// Shared copy of `path`, decoded on a miss or when the file changed; NULL
+// if it cannot be decoded. Each successful call takes a reference.
+const lv_img_dsc_t *img_acquire(const char *path);
+void img_release(const lv_img_dsc_t *dsc);
+
+// Show `path` in `img` from the shared copy; the reference is dropped when
+// the object is deleted or shows another image through this call. False
+// if the image could not be decoded (the object is left unchanged).
+bool img_set_src(lv_obj_t *img, const char *path);
+
+// Bytes of idle copies the cache may keep (copies in use are never evicted)
+void img_cache_set_budget(size_t bytes);
+// Render task too: the counters are not locked
+void img_cache_get_stats(img_cache_stats_t *out);
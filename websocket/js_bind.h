@@ -0,0 +1,173 @@
+#pragma once
+
+// Typed bridges. Instead of hand-writing the nargs check, js_getnum casts,
+// string extraction and handle lookups for every bridge, write a plain C++
+// function with real parameter types and let the compiler generate the
+// marshalling:
+//
+//   JS_BIND_FN(void, style_set_radius, lv_style_t *st, lv_coord_t radius) {
+//     lv_style_set_radius(st, radius);
+//   }
+//   ... js_mkfun(JS_BIND(style_set_radius)) ...
+//
+// Arguments are converted in place, without allocation. Strings are read
+// straight out of the Elk arena (js_getstr; Elk keeps them NUL-terminated),
+// so they stay valid for the duration of the call only. A missing or
+// mistyped argument is reported as "name: argument N: expected T" and the
+// bridge returns null without calling the function.
+//
+// New argument/return types are added by specialising js_arg<T> / js_ret<T>;
+// the lv_obj_t / lv_style_t handle and lv_color_t ones live next to the
+// handle tables in lvgl_elk.h.
+
+#include <Arduino.h>
+#include <tuple>
+#include <type_traits>
+extern "C" {
+  #include "elk.h"
+}
+
+// Report a conversion failure; index is 0-based
+inline void js_bind_fail(const char *name, int index, const char *expected) {
+  Serial.printf("%s: argument %d: expected %s\n", name, index + 1, expected);
+}
+
+// ---------------------------------------------------------------------------
+// Argument conversion: bool get(js, value, &out) plus a name for errors
+// ---------------------------------------------------------------------------
+template<typename T, typename Enable = void>
+struct js_arg;
+
+// Numbers and enums
+template<typename T>
+struct js_arg<T, typename std::enable_if<(std::is_arithmetic<T>::value || std::is_enum<T>::value) &&
+                                         !std::is_same<T, bool>::value>::type> {
+  static const char *what() { return "number"; }
+  static bool get(struct js *js, jsval_t v, T &out) {
+    if(js_type(v) != JS_NUM) return false;
+    out = (T)js_getnum(v);
+    return true;
+  }
+};
+
+// Booleans also accept numbers (0 / non-zero), as scripts have always passed them
+template<>
+struct js_arg<bool> {
+  static const char *what() { return "boolean"; }
+  static bool get(struct js *js, jsval_t v, bool &out) {
+    int t = js_type(v);
+    if(t == JS_TRUE || t == JS_FALSE) out = (t == JS_TRUE);
+    else if(t == JS_NUM) out = js_getnum(v) != 0;
+    else return false;
+    return true;
+  }
+};
+
+// Zero-copy strings
+template<>
+struct js_arg<const char *> {
+  static const char *what() { return "string"; }
+  static bool get(struct js *js, jsval_t v, const char *&out) {
+    if(js_type(v) != JS_STR) return false;
+    out = js_getstr(js, v, NULL);
+    return out != NULL;
+  }
+};
+
+// ---------------------------------------------------------------------------
+// Return conversion
+// ---------------------------------------------------------------------------
+template<typename T, typename Enable = void>
+struct js_ret;
+
+template<typename T>
+struct js_ret<T, typename std::enable_if<(std::is_arithmetic<T>::value || std::is_enum<T>::value) &&
+                                         !std::is_same<T, bool>::value>::type> {
+  static jsval_t make(struct js *js, T v) { return js_mknum((double)v); }
+};
+
+template<>
+struct js_ret<bool> {
+  static jsval_t make(struct js *js, bool v) { return v ? js_mktrue() : js_mkfalse(); }
+};
+
+template<>
+struct js_ret<const char *> {
+  static jsval_t make(struct js *js, const char *s) { return s ? js_mkstr(js, s, strlen(s)) : js_mknull(); }
+};
+
+// Strings built on the fly (HTTP payloads, ...), copied into the arena
+template<>
+struct js_ret<String> {
+  static jsval_t make(struct js *js, const String &s) { return js_mkstr(js, s.c_str(), s.length()); }
+};
+
+// ---------------------------------------------------------------------------
+// The generated bridge
+// ---------------------------------------------------------------------------
+template<int... I> struct js_seq {};
+template<int N, int... I> struct js_make_seq : js_make_seq<N - 1, N - 1, I...> {};
+template<int... I> struct js_make_seq<0, I...> { typedef js_seq<I...> type; };
+
+template<typename T>
+struct js_bare { typedef typename std::remove_cv<typename std::remove_reference<T>::type>::type type; };
+
+template<typename R, typename... A>
+struct js_invoke {
+  template<R (*F)(A...), typename Tuple, int... I>
+  static jsval_t run(struct js *js, Tuple &vals, js_seq<I...>) {
+    return js_ret<typename js_bare<R>::type>::make(js, F(std::get<I>(vals)...));
+  }
+};
+
+template<typename... A>
+struct js_invoke<void, A...> {
+  template<void (*F)(A...), typename Tuple, int... I>
+  static jsval_t run(struct js *js, Tuple &vals, js_seq<I...>) {
+    F(std::get<I>(vals)...);
+    return js_mknull();
+  }
+};
+
+template<typename Sig, Sig F, const char *Name>
+struct js_bound;
+
+template<typename R, typename... A, R (*F)(A...), const char *Name>
+struct js_bound<R (*)(A...), F, Name> {
+  typedef std::tuple<typename js_bare<A>::type...> args_t;
+
+  template<int K>
+  static bool convert(struct js *js, jsval_t *args, args_t &vals) {
+    typedef typename std::tuple_element<K, args_t>::type T;
+    if(js_arg<T>::get(js, args[K], std::get<K>(vals))) return true;
+    js_bind_fail(Name, K, js_arg<T>::what());
+    return false;
+  }
+
+  template<int... I>
+  static jsval_t dispatch(struct js *js, jsval_t *args, int nargs, js_seq<I...> seq) {
+    if(nargs < (int)sizeof...(A)) {
+      Serial.printf("%s: expects %d arguments, got %d\n", Name, (int)sizeof...(A), nargs);
+      return js_mknull();
+    }
+    args_t vals;
+    bool ok = true;
+    // Braced lists evaluate left to right; stop at the first failure
+    bool seen[] = { true, (ok = ok && convert<I>(js, args, vals))... };
+    (void)seen;
+    if(!ok) return js_mknull();
+    return js_invoke<R, A...>::template run<F>(js, vals, seq);
+  }
+
+  static jsval_t call(struct js *js, jsval_t *args, int nargs) {
+    return dispatch(js, args, nargs, typename js_make_seq<sizeof...(A)>::type());
+  }
+};
+
+// Define a typed bridge implementation `name` and its error-message name
+#define JS_BIND_FN(ret, name, ...)                \
+  static const char js_bind_name_##name[] = #name; \
+  static ret name(__VA_ARGS__)
+
+// The Elk bridge for a JS_BIND_FN function
+#define JS_BIND(name) (js_bound<decltype(&name), &name, js_bind_name_##name>::call)
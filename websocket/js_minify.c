@@ -0,0 +1,424 @@
+#include "js_minify.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef ARDUINO
+#include <lvgl.h>
+// In the firmware the values come straight from lvgl.h
+#define K(name, v) { #name, (long)(name) }
+#else
+// Host build: LVGL v8.3 values
+#define K(name, v) { #name, (long)(v) }
+#endif
+
+typedef struct {
+  const char *name;
+  long value;
+} jsm_const_t;
+
+static const jsm_const_t g_consts[] = {
+  K(LV_ALIGN_DEFAULT, 0), K(LV_ALIGN_TOP_LEFT, 1), K(LV_ALIGN_TOP_MID, 2),
+  K(LV_ALIGN_TOP_RIGHT, 3), K(LV_ALIGN_BOTTOM_LEFT, 4), K(LV_ALIGN_BOTTOM_MID, 5),
+  K(LV_ALIGN_BOTTOM_RIGHT, 6), K(LV_ALIGN_LEFT_MID, 7), K(LV_ALIGN_RIGHT_MID, 8),
+  K(LV_ALIGN_CENTER, 9), K(LV_ALIGN_OUT_TOP_LEFT, 10), K(LV_ALIGN_OUT_TOP_MID, 11),
+  K(LV_ALIGN_OUT_TOP_RIGHT, 12), K(LV_ALIGN_OUT_BOTTOM_LEFT, 13),
+  K(LV_ALIGN_OUT_BOTTOM_MID, 14), K(LV_ALIGN_OUT_BOTTOM_RIGHT, 15),
+  K(LV_ALIGN_OUT_LEFT_TOP, 16), K(LV_ALIGN_OUT_LEFT_MID, 17),
+  K(LV_ALIGN_OUT_LEFT_BOTTOM, 18), K(LV_ALIGN_OUT_RIGHT_TOP, 19),
+  K(LV_ALIGN_OUT_RIGHT_MID, 20), K(LV_ALIGN_OUT_RIGHT_BOTTOM, 21),
+
+  K(LV_PART_MAIN, 0x000000), K(LV_PART_SCROLLBAR, 0x010000),
+  K(LV_PART_INDICATOR, 0x020000), K(LV_PART_KNOB, 0x030000),
+  K(LV_PART_SELECTED, 0x040000), K(LV_PART_ITEMS, 0x050000),
+  K(LV_PART_TICKS, 0x060000), K(LV_PART_CURSOR, 0x070000),
+  K(LV_PART_ANY, 0x0F0000),
+
+  K(LV_STATE_DEFAULT, 0x0000), K(LV_STATE_CHECKED, 0x0001), K(LV_STATE_FOCUSED, 0x0002),
+  K(LV_STATE_FOCUS_KEY, 0x0004), K(LV_STATE_EDITED, 0x0008), K(LV_STATE_HOVERED, 0x0010),
+  K(LV_STATE_PRESSED, 0x0020), K(LV_STATE_SCROLLED, 0x0040), K(LV_STATE_DISABLED, 0x0080),
+  K(LV_STATE_ANY, 0xFFFF),
+
+  K(LV_OPA_TRANSP, 0), K(LV_OPA_0, 0), K(LV_OPA_10, 25), K(LV_OPA_20, 51),
+  K(LV_OPA_30, 76), K(LV_OPA_40, 102), K(LV_OPA_50, 127), K(LV_OPA_60, 153),
+  K(LV_OPA_70, 178), K(LV_OPA_80, 204), K(LV_OPA_90, 229), K(LV_OPA_100, 255),
+  K(LV_OPA_COVER, 255),
+
+  K(LV_TEXT_ALIGN_AUTO, 0), K(LV_TEXT_ALIGN_LEFT, 1), K(LV_TEXT_ALIGN_CENTER, 2),
+  K(LV_TEXT_ALIGN_RIGHT, 3),
+
+  K(LV_LABEL_LONG_WRAP, 0), K(LV_LABEL_LONG_DOT, 1), K(LV_LABEL_LONG_SCROLL, 2),
+  K(LV_LABEL_LONG_SCROLL_CIRCULAR, 3), K(LV_LABEL_LONG_CLIP, 4),
+
+  K(LV_DIR_NONE, 0x00), K(LV_DIR_LEFT, 0x01), K(LV_DIR_RIGHT, 0x02), K(LV_DIR_TOP, 0x04),
+  K(LV_DIR_BOTTOM, 0x08), K(LV_DIR_HOR, 0x03), K(LV_DIR_VER, 0x0C), K(LV_DIR_ALL, 0x0F),
+
+  K(LV_ANIM_OFF, 0), K(LV_ANIM_ON, 1),
+
+  K(LV_FLEX_FLOW_ROW, 0x00), K(LV_FLEX_FLOW_COLUMN, 0x01), K(LV_FLEX_FLOW_ROW_WRAP, 0x04),
+  K(LV_FLEX_FLOW_ROW_REVERSE, 0x08), K(LV_FLEX_FLOW_ROW_WRAP_REVERSE, 0x0C),
+  K(LV_FLEX_FLOW_COLUMN_WRAP, 0x05), K(LV_FLEX_FLOW_COLUMN_REVERSE, 0x09),
+  K(LV_FLEX_FLOW_COLUMN_WRAP_REVERSE, 0x0D),
+
+  K(LV_CHART_TYPE_NONE, 0), K(LV_CHART_TYPE_LINE, 1), K(LV_CHART_TYPE_BAR, 2),
+  K(LV_CHART_TYPE_SCATTER, 3),
+  K(LV_CHART_AXIS_PRIMARY_Y, 0x00), K(LV_CHART_AXIS_SECONDARY_Y, 0x01),
+  K(LV_CHART_AXIS_PRIMARY_X, 0x02), K(LV_CHART_AXIS_SECONDARY_X, 0x04),
+  K(LV_CHART_UPDATE_MODE_SHIFT, 0), K(LV_CHART_UPDATE_MODE_CIRCULAR, 1),
+
+  K(LV_SCROLLBAR_MODE_OFF, 0), K(LV_SCROLLBAR_MODE_ON, 1), K(LV_SCROLLBAR_MODE_ACTIVE, 2),
+  K(LV_SCROLLBAR_MODE_AUTO, 3),
+
+  K(LV_OBJ_FLAG_HIDDEN, 1 << 0), K(LV_OBJ_FLAG_CLICKABLE, 1 << 1),
+  K(LV_OBJ_FLAG_CLICK_FOCUSABLE, 1 << 2), K(LV_OBJ_FLAG_CHECKABLE, 1 << 3),
+  K(LV_OBJ_FLAG_SCROLLABLE, 1 << 4),
+
+  K(LV_BORDER_SIDE_NONE, 0x00), K(LV_BORDER_SIDE_BOTTOM, 0x01), K(LV_BORDER_SIDE_TOP, 0x02),
+  K(LV_BORDER_SIDE_LEFT, 0x04), K(LV_BORDER_SIDE_RIGHT, 0x08), K(LV_BORDER_SIDE_FULL, 0x0F),
+
+  K(LV_GRAD_DIR_NONE, 0), K(LV_GRAD_DIR_VER, 1), K(LV_GRAD_DIR_HOR, 2),
+
+  K(LV_RADIUS_CIRCLE, 0x7FFF), K(LV_SIZE_CONTENT, 2001 | (1 << 13)),
+};
+
+#undef K
+
+int js_minify_constant(const char *name, size_t len, long *value) {
+  for (size_t i = 0; i < sizeof(g_consts) / sizeof(g_consts[0]); i++) {
+    if (strlen(g_consts[i].name) == len && memcmp(g_consts[i].name, name, len) == 0) {
+      *value = g_consts[i].value;
+      return 1;
+    }
+  }
+  return 0;
+}
+
+uint32_t js_minify_hash(const char *src, size_t len) {
+  uint32_t h = 2166136261u;
+  for (size_t i = 0; i < len; i++) h = (h ^ (uint8_t)src[i]) * 16777619u;
+  return h;
+}
+
+size_t js_minify_header(const char *src, size_t len, char *out, size_t cap) {
+  int n = snprintf(out, cap, "//jsmin %08lx %lu\n", (unsigned long)js_minify_hash(src, len),
+                   (unsigned long)len);
+  return (n > 0 && (size_t)n < cap) ? (size_t)n : 0;
+}
+
+int js_minify_is_current(const char *min, size_t min_len, const char *src, size_t len) {
+  char hdr[JS_MINIFY_HEADER_MAX];
+  size_t hl = js_minify_header(src, len, hdr, sizeof(hdr));
+  return hl > 0 && min_len >= hl && memcmp(min, hdr, hl) == 0;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Tokens                                                                   */
+/* ------------------------------------------------------------------------ */
+
+enum { JSM_WORD, JSM_NUM, JSM_STR, JSM_PUNCT };
+
+typedef struct {
+  uint32_t off;
+  uint32_t len;
+  uint8_t type;
+} jsm_tok_t;
+
+static int jsm_is_word(int c) {
+  return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || (c >= '0' && c <= '9') ||
+         c == '_' || c == '$';
+}
+
+static int jsm_is_digit(int c) {
+  return c >= '0' && c <= '9';
+}
+
+// Split the source into tokens, dropping comments and whitespace.
+// Punctuation is kept one character per token. Returns -1 on error.
+static long jsm_lex(const char *s, size_t len, jsm_tok_t *toks) {
+  long n = 0;
+  size_t i = 0;
+  while (i < len) {
+    char c = s[i];
+    if (c == ' ' || c == '\t' || c == '\r' || c == '\n' || c == '\f' || c == '\v') {
+      i++;
+    } else if (c == '/' && i + 1 < len && s[i + 1] == '/') {
+      while (i < len && s[i] != '\n') i++;
+    } else if (c == '/' && i + 1 < len && s[i + 1] == '*') {
+      i += 2;
+      while (i + 1 < len && !(s[i] == '*' && s[i + 1] == '/')) i++;
+      if (i + 1 >= len) return -1;
+      i += 2;
+    } else if (c == '"' || c == '\'') {
+      size_t st = i++;
+      while (i < len && s[i] != c) i += (s[i] == '\\') ? 2 : 1;
+      if (i >= len) return -1;
+      i++;
+      toks[n].off = st, toks[n].len = i - st, toks[n++].type = JSM_STR;
+    } else if (jsm_is_digit(c) || (c == '.' && i + 1 < len && jsm_is_digit(s[i + 1]))) {
+      size_t st = i;
+      while (i < len && (jsm_is_word(s[i]) || s[i] == '.')) i++;
+      toks[n].off = st, toks[n].len = i - st, toks[n++].type = JSM_NUM;
+    } else if (jsm_is_word(c)) {
+      size_t st = i;
+      while (i < len && jsm_is_word(s[i])) i++;
+      toks[n].off = st, toks[n].len = i - st, toks[n++].type = JSM_WORD;
+    } else {
+      toks[n].off = i, toks[n].len = 1, toks[n++].type = JSM_PUNCT;
+      i++;
+    }
+  }
+  return n;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Local renaming                                                           */
+/* ------------------------------------------------------------------------ */
+
+#define JSM_MAX_LOCALS 512   // declarations across all open function scopes
+#define JSM_MAX_DEPTH 32     // nested functions
+
+typedef struct {
+  const char *s;
+  const jsm_tok_t *t;
+  long n;
+} jsm_src_t;
+
+typedef struct {
+  uint32_t tok;     // token of the declaration (its spelling is the key)
+  char alias[4];
+} jsm_local_t;
+
+typedef struct {
+  jsm_local_t locals[JSM_MAX_LOCALS];
+  int nlocals;
+  int base[JSM_MAX_DEPTH];     // first local of each open scope
+  long end[JSM_MAX_DEPTH];     // token closing the scope's body
+  uint32_t alias_base[JSM_MAX_DEPTH];
+  int depth;
+  uint32_t next_alias;         // aliases are reused by siblings, never by nested scopes
+  uint32_t renamed;
+} jsm_scopes_t;
+
+static int jsm_tok_is(const jsm_src_t *src, long i, const char *word) {
+  if (i < 0 || i >= src->n) return 0;
+  size_t wl = strlen(word);
+  return src->t[i].len == wl && memcmp(src->s + src->t[i].off, word, wl) == 0;
+}
+
+static int jsm_punct(const jsm_src_t *src, long i, char c) {
+  return i >= 0 && i < src->n && src->t[i].type == JSM_PUNCT && src->s[src->t[i].off] == c;
+}
+
+static int jsm_same(const jsm_src_t *src, long a, long b) {
+  return src->t[a].len == src->t[b].len &&
+         memcmp(src->s + src->t[a].off, src->s + src->t[b].off, src->t[a].len) == 0;
+}
+
+// Index of the token closing the bracket opened at `i`, or -1
+static long jsm_match(const jsm_src_t *src, long i) {
+  char open = src->s[src->t[i].off];
+  char close = open == '(' ? ')' : open == '[' ? ']' : '}';
+  int d = 0;
+  for (; i < src->n; i++) {
+    if (jsm_punct(src, i, open)) d++;
+    else if (jsm_punct(src, i, close) && --d == 0) return i;
+  }
+  return -1;
+}
+
+static const char *const g_reserved[] = {"do", "if", "in"};
+
+// n-th candidate alias: a..z, A..Z, then two characters
+static void jsm_alias(uint32_t n, char *out) {
+  static const char first[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_$";
+  static const char rest[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ_$0123456789";
+  const uint32_t nf = sizeof(first) - 1, nr = sizeof(rest) - 1;
+  if (n < nf) {
+    out[0] = first[n], out[1] = 0;
+  } else if ((n -= nf) < nf * nr) {
+    out[0] = first[n / nr], out[1] = rest[n % nr], out[2] = 0;
+  } else {
+    n -= nf * nr;
+    out[0] = first[(n / nr / nr) % nf], out[1] = rest[(n / nr) % nr], out[2] = rest[n % nr], out[3] = 0;
+  }
+}
+
+// Next alias that no identifier in the script spells
+static void jsm_fresh_alias(const jsm_src_t *src, jsm_scopes_t *sc, char *out) {
+  for (;;) {
+    jsm_alias(sc->next_alias++, out);
+    size_t al = strlen(out);
+    int taken = 0;
+    for (size_t r = 0; r < sizeof(g_reserved) / sizeof(g_reserved[0]); r++) {
+      if (strcmp(out, g_reserved[r]) == 0) taken = 1;
+    }
+    for (long i = 0; i < src->n && !taken; i++) {
+      if (src->t[i].type == JSM_WORD && src->t[i].len == al &&
+          memcmp(src->s + src->t[i].off, out, al) == 0) taken = 1;
+    }
+    if (!taken) return;
+  }
+}
+
+static void jsm_declare(const jsm_src_t *src, jsm_scopes_t *sc, long tok) {
+  if (src->t[tok].type != JSM_WORD || sc->nlocals >= JSM_MAX_LOCALS) return;
+  int from = sc->base[sc->depth - 1];
+  for (int i = from; i < sc->nlocals; i++) {
+    if (jsm_same(src, sc->locals[i].tok, tok)) return;  // already declared here
+  }
+  jsm_local_t *l = &sc->locals[sc->nlocals];
+  jsm_fresh_alias(src, sc, l->alias);
+  if (strlen(l->alias) >= src->t[tok].len) return;  // would not save anything
+  l->tok = (uint32_t)tok;
+  sc->nlocals++;
+  sc->renamed++;
+}
+
+// Open the scope of the function whose parameter list starts at `lparen`:
+// parameters plus every `let` in its body outside nested functions.
+// Returns the index of the body's closing brace, or -1.
+static long jsm_enter_function(const jsm_src_t *src, jsm_scopes_t *sc, long lparen) {
+  long rparen = jsm_match(src, lparen);
+  if (rparen < 0 || !jsm_punct(src, rparen + 1, '{')) return -1;
+  long rbrace = jsm_match(src, rparen + 1);
+  if (rbrace < 0) return -1;
+  if (sc->depth >= JSM_MAX_DEPTH) return rbrace;  // too deep: leave names alone
+
+  sc->base[sc->depth] = sc->nlocals;
+  sc->end[sc->depth] = rbrace;
+  sc->alias_base[sc->depth] = sc->next_alias;
+  sc->depth++;
+
+  for (long i = lparen + 1; i < rparen; i++) {
+    if (src->t[i].type == JSM_WORD) jsm_declare(src, sc, i);
+  }
+  for (long i = rparen + 2; i < rbrace; i++) {
+    if (jsm_tok_is(src, i, "function")) {
+      long p = i + 1;
+      if (src->t[p].type == JSM_WORD) p++;
+      long r = jsm_punct(src, p, '(') ? jsm_match(src, p) : -1;
+      long b = (r >= 0 && jsm_punct(src, r + 1, '{')) ? jsm_match(src, r + 1) : -1;
+      if (b > i) i = b;
+      continue;
+    }
+    if (!jsm_tok_is(src, i, "let")) continue;
+    // let a = ..., b = ...;  declarators are separated by top-level commas
+    jsm_declare(src, sc, i + 1);
+    int d = 0;
+    for (long j = i + 2; j < rbrace; j++) {
+      if (src->t[j].type != JSM_PUNCT) continue;
+      char c = src->s[src->t[j].off];
+      if (c == '(' || c == '[' || c == '{') d++;
+      else if (c == ')' || c == ']' || c == '}') d--;
+      if (d < 0 || (d == 0 && c == ';')) break;
+      if (d == 0 && c == ',') jsm_declare(src, sc, j + 1);
+    }
+  }
+  return rbrace;
+}
+
+static const char *jsm_lookup(const jsm_src_t *src, const jsm_scopes_t *sc, long tok) {
+  for (int i = sc->nlocals - 1; i >= 0; i--) {
+    if (jsm_same(src, sc->locals[i].tok, tok)) return sc->locals[i].alias;
+  }
+  return NULL;
+}
+
+/* ------------------------------------------------------------------------ */
+/* Output                                                                   */
+/* ------------------------------------------------------------------------ */
+
+size_t js_minify(const char *s, size_t len, char *out, size_t cap, js_minify_stats_t *stats) {
+  jsm_tok_t *toks = (jsm_tok_t *)malloc((len + 1) * sizeof(jsm_tok_t));
+  jsm_scopes_t *sc = (jsm_scopes_t *)calloc(1, sizeof(jsm_scopes_t));
+  size_t o = 0;
+  uint32_t inlined = 0;
+  long n = -1;
+  if (!toks || !sc) goto fail;
+  n = jsm_lex(s, len, toks);
+  if (n < 0) goto fail;
+
+  {
+    jsm_src_t src = {s, toks, n};
+    char prev_last = 0;      // last character written
+    uint8_t prev_type = JSM_PUNCT;
+
+    for (long i = 0; i < n; i++) {
+      const jsm_tok_t *t = &toks[i];
+      const char *text = s + t->off;
+      size_t tl = t->len;
+      uint8_t type = t->type;
+      char num[24];
+
+      if (type == JSM_WORD) {
+        int after_dot = jsm_punct(&src, i - 1, '.');
+        int is_key = (jsm_punct(&src, i - 1, '{') || jsm_punct(&src, i - 1, ',')) &&
+                     jsm_punct(&src, i + 1, ':');
+        long value;
+        const char *alias;
+        if (after_dot || is_key) {
+          // property name: leave as is
+        } else if (tl > 3 && memcmp(text, "LV_", 3) == 0 && js_minify_constant(text, tl, &value)) {
+          // Build the digits backwards, then emit them as a number
+          char tmp[24];
+          int k = 0, neg = value < 0;
+          unsigned long v = neg ? (unsigned long)-value : (unsigned long)value;
+          do { tmp[k++] = (char)('0' + v % 10); v /= 10; } while (v);
+          int m = 0;
+          if (neg) num[m++] = '-';
+          while (k) num[m++] = tmp[--k];
+          text = num, tl = (size_t)m, type = JSM_NUM;
+          inlined++;
+        } else if ((alias = jsm_lookup(&src, sc, i)) != NULL) {
+          text = alias, tl = strlen(alias);
+        }
+      }
+
+      // Separator only where the two tokens would otherwise merge
+      int sep = 0;
+      if (o > 0) {
+        if (jsm_is_word(prev_last) && jsm_is_word(text[0])) sep = 1;
+        // `a + +b` keeps its space; `i++` is lexed as two adjacent '+' and
+        // stays as written
+        int joined = t->type == JSM_PUNCT && toks[i - 1].off + toks[i - 1].len == t->off;
+        if ((prev_last == '+' || prev_last == '-') && text[0] == prev_last && !joined) sep = 1;
+        if (prev_type == JSM_NUM && text[0] == '.') sep = 1;
+      }
+      if (o + sep + tl + 1 > cap) goto fail;
+      if (sep) out[o++] = ' ';
+      memcpy(out + o, text, tl);
+      o += tl;
+      prev_last = text[tl - 1];
+      prev_type = type;
+
+      if (t->type == JSM_WORD && jsm_tok_is(&src, i, "function")) {
+        long p = i + 1;
+        if (p < n && toks[p].type == JSM_WORD) p++;  // named: the name stays
+        if (jsm_punct(&src, p, '(') && jsm_enter_function(&src, sc, p) < 0) goto fail;
+      }
+      // Close every scope whose body ends here
+      while (sc->depth > 0 && sc->end[sc->depth - 1] == i) {
+        sc->depth--;
+        sc->nlocals = sc->base[sc->depth];
+        sc->next_alias = sc->alias_base[sc->depth];
+      }
+    }
+    out[o] = 0;
+  }
+
+  if (stats) {
+    stats->in_len = len;
+    stats->out_len = o;
+    stats->tokens = (uint32_t)n;
+    stats->renamed = sc->renamed;
+    stats->inlined = inlined;
+  }
+  free(toks);
+  free(sc);
+  return o;
+
+fail:
+  free(toks);
+  free(sc);
+  return 0;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Source-to-source preprocessing for Elk scripts. Elk keeps function bodies
+// as text and re-scans them on every call, so everything dropped here is
+// saved on every call and in the arena:
+//  - comments and whitespace go (Elk needs explicit semicolons, so no
+//    line break is ever significant)
+//  - parameters and `let` locals of functions get the shortest names not
+//    used anywhere in the script; globals, properties and object keys keep
+//    theirs
+//  - LV_* constant names are replaced by their numeric values (Elk has no
+//    such globals, so scripts using them only run in minified form)
+// Plain C and no allocation besides the token list, so the same file builds
+// into the firmware and into the host tool (tools/jsmin).
+
+typedef struct {
+  size_t in_len;
+  size_t out_len;
+  uint32_t tokens;
+  uint32_t renamed;   // local declarations renamed
+  uint32_t inlined;   // LV_* constants replaced
+} js_minify_stats_t;
+
+// Writes the minified script to `out` (NUL-terminated). Returns its length,
+// or 0 if `cap` is too small, a string or comment is unterminated, braces
+// do not balance or the token list could not be allocated. The output is
+// never longer than the input.
+size_t js_minify(const char *src, size_t len, char *out, size_t cap, js_minify_stats_t *stats);
+
+// Numeric value of an LV_* constant known to the minifier
+int js_minify_constant(const char *name, size_t len, long *value);
+
+// FNV-1a of the source. Minified files start with a one-line comment
+// naming the hash and length of their source, so a stale copy is recognised
+// without a clock (SD timestamps are meaningless on a board without RTC).
+uint32_t js_minify_hash(const char *src, size_t len);
+#define JS_MINIFY_HEADER_MAX 32
+// Write that first line; returns its length
+size_t js_minify_header(const char *src, size_t len, char *out, size_t cap);
+// True if `min` starts with the header of exactly this source
+int js_minify_is_current(const char *min, size_t min_len, const char *src, size_t len);
+
+#ifdef __cplusplus
+}
+#endif
@@ -0,0 +1,237 @@
+#include "js_timers.h"
+#include <lvgl.h>
+
+enum { JS_TIMER_FREE, JS_TIMER_TIMEOUT, JS_TIMER_INTERVAL, JS_TIMER_FRAME };
+
+typedef struct {
+  uint8_t kind;
+  bool by_value;       // callback kept in a hidden global, see js_timer_slot_name()
+  uint32_t id;
+  uint32_t due;        // millis() deadline
+  uint32_t period;
+  char name[JS_TIMER_NAME_MAX];
+} js_timer_t;
+
+static js_timer_t g_timers[JS_TIMERS_MAX];
+static uint32_t g_timer_next_id = 1;
+static TaskHandle_t g_timer_task = NULL;
+static volatile bool g_frame_wanted = false;
+static volatile bool g_frame_ready = false;
+static uint32_t g_frame_last = 0;  // millis() of the last frame batch
+static js_timers_hook_t g_timer_hook = NULL;
+
+// Function values cannot be called from C directly: they are parked in a
+// per-slot global and called by name. Reusing the slot's name keeps the
+// global object from growing.
+static void js_timer_slot_name(int slot, char *out, size_t len) {
+  snprintf(out, len, "__tm%d", slot);
+}
+
+static bool js_timer_valid_name(const char *s, size_t len) {
+  if (len == 0 || len >= JS_TIMER_NAME_MAX) return false;
+  for (size_t i = 0; i < len; i++) {
+    char c = s[i];
+    bool ok = (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_' || c == '$' ||
+              (i > 0 && c >= '0' && c <= '9');
+    if (!ok) return false;
+  }
+  return true;
+}
+
+static jsval_t js_timer_add(struct js *js, jsval_t *args, int nargs, uint8_t kind) {
+  if (nargs < 1) return js_mknum(0);
+  int slot = -1;
+  for (int i = 0; i < JS_TIMERS_MAX; i++) {
+    if (g_timers[i].kind == JS_TIMER_FREE) {
+      slot = i;
+      break;
+    }
+  }
+  if (slot < 0) {
+    Serial.println("timers: no free timer slot");
+    return js_mknum(0);
+  }
+
+  js_timer_t *t = &g_timers[slot];
+  if (js_type(args[0]) == JS_STR) {
+    size_t len;
+    const char *name = js_getstr(js, args[0], &len);
+    if (!js_timer_valid_name(name, len)) {
+      Serial.println("timers: callback must be a function or a function name");
+      return js_mknum(0);
+    }
+    memcpy(t->name, name, len);
+    t->name[len] = 0;
+    t->by_value = false;
+  } else {
+    js_timer_slot_name(slot, t->name, sizeof(t->name));
+    js_set(js, js_glob(js), t->name, args[0]);
+    t->by_value = true;
+  }
+
+  uint32_t ms = 0;
+  if (kind != JS_TIMER_FRAME && nargs >= 2) {
+    double d = js_getnum(args[1]);
+    ms = d > 0 ? (uint32_t)d : 0;
+  }
+  if (kind == JS_TIMER_INTERVAL && ms == 0) ms = 1;
+
+  t->kind = kind;
+  t->id = g_timer_next_id++;
+  t->period = ms;
+  t->due = millis() + ms;
+  if (kind == JS_TIMER_FRAME) g_frame_wanted = true;
+  return js_mknum(t->id);
+}
+
+static jsval_t js_timer_clear(struct js *js, jsval_t *args, int nargs) {
+  if (nargs < 1) return js_mknull();
+  uint32_t id = (uint32_t)js_getnum(args[0]);
+  for (int i = 0; i < JS_TIMERS_MAX; i++) {
+    js_timer_t *t = &g_timers[i];
+    if (t->kind != JS_TIMER_FREE && t->id == id) {
+      if (t->by_value) js_set(js, js_glob(js), t->name, js_mkundef());
+      t->kind = JS_TIMER_FREE;
+    }
+  }
+  return js_mknull();
+}
+
+// setTimeout(fn, ms) / setInterval(fn, ms) / requestAnimationFrame(fn) => id
+static jsval_t js_set_timeout(struct js *js, jsval_t *args, int nargs) {
+  return js_timer_add(js, args, nargs, JS_TIMER_TIMEOUT);
+}
+
+static jsval_t js_set_interval(struct js *js, jsval_t *args, int nargs) {
+  return js_timer_add(js, args, nargs, JS_TIMER_INTERVAL);
+}
+
+static jsval_t js_request_animation_frame(struct js *js, jsval_t *args, int nargs) {
+  return js_timer_add(js, args, nargs, JS_TIMER_FRAME);
+}
+
+void js_timers_register(struct js *js) {
+  jsval_t global = js_glob(js);
+  js_set(js, global, "setTimeout",            js_mkfun(js_set_timeout));
+  js_set(js, global, "setInterval",           js_mkfun(js_set_interval));
+  js_set(js, global, "requestAnimationFrame", js_mkfun(js_request_animation_frame));
+  js_set(js, global, "clearTimeout",          js_mkfun(js_timer_clear));
+  js_set(js, global, "clearInterval",         js_mkfun(js_timer_clear));
+  js_set(js, global, "cancelAnimationFrame",  js_mkfun(js_timer_clear));
+}
+
+static void js_timer_fire(struct js *js, js_timer_t *t, uint32_t now) {
+  char code[JS_TIMER_NAME_MAX + 16];
+  if (t->kind == JS_TIMER_FRAME) snprintf(code, sizeof(code), "%s(%lu);", t->name, (unsigned long)now);
+  else snprintf(code, sizeof(code), "%s();", t->name);
+
+  // One-shots are released before the call so the callback can re-arm
+  uint32_t id = t->id;
+  if (t->kind == JS_TIMER_INTERVAL) {
+    t->due += t->period;
+    if ((int32_t)(t->due - now) <= 0) t->due = now + t->period;  // fell behind
+  } else {
+    t->kind = JS_TIMER_FREE;
+  }
+
+  jsval_t res = js_eval(js, code, strlen(code));
+  if (js_type(res) == JS_ERR) Serial.printf("timer %lu: %s\n", (unsigned long)id, js_str(js, res));
+
+  // A callback slower than its period would be due again at once: count
+  // the period from when it returned
+  if (t->kind == JS_TIMER_INTERVAL && t->id == id) {
+    uint32_t after = millis();
+    if ((int32_t)(t->due - after) <= 0) t->due = after + t->period;
+  }
+
+  // Drop a parked function value once its one-shot timer is done, unless
+  // the callback re-armed the slot
+  if (t->kind == JS_TIMER_FREE && t->by_value) {
+    js_set(js, js_glob(js), t->name, js_mkundef());
+    t->by_value = false;
+  }
+}
+
+// Timers that were due when the round started, in deadline order, each at
+// most once; animation frames once per frame boundary. Timers armed or
+// falling due during the round wait for the next one, so slow callbacks
+// cannot keep the loop from returning.
+static void js_timers_dispatch(struct js *js) {
+  uint32_t now = millis();
+  uint32_t armed = g_timer_next_id;  // ids below this existed at the start
+  for (;;) {
+    js_timer_t *next = NULL;
+    for (int i = 0; i < JS_TIMERS_MAX; i++) {
+      js_timer_t *t = &g_timers[i];
+      if (t->kind != JS_TIMER_TIMEOUT && t->kind != JS_TIMER_INTERVAL) continue;
+      if (t->id >= armed || (int32_t)(t->due - now) > 0) continue;
+      if (!next || (int32_t)(t->due - next->due) < 0) next = t;
+    }
+    if (!next) break;
+    js_timer_fire(js, next, now);
+  }
+  now = millis();
+
+  // No frame gets rendered while the screen is static: release the batch
+  // after a display refresh period anyway
+  if (g_frame_wanted && now - g_frame_last >= LV_DISP_DEF_REFR_PERIOD) g_frame_ready = true;
+  if (!g_frame_ready) return;
+  g_frame_ready = false;
+  g_frame_last = now;
+  g_frame_wanted = false;
+  // Only frames requested before this boundary; new requests wait for the next
+  uint32_t batch = g_timer_next_id;
+  for (int i = 0; i < JS_TIMERS_MAX; i++) {
+    js_timer_t *t = &g_timers[i];
+    if (t->kind == JS_TIMER_FRAME && t->id < batch) js_timer_fire(js, t, now);
+  }
+  for (int i = 0; i < JS_TIMERS_MAX; i++) {
+    if (g_timers[i].kind == JS_TIMER_FRAME) g_frame_wanted = true;
+  }
+}
+
+// ms until the next timer or frame batch is due, UINT32_MAX if none
+static uint32_t js_timers_next_ms() {
+  uint32_t now = millis();
+  uint32_t wait = UINT32_MAX;
+  for (int i = 0; i < JS_TIMERS_MAX; i++) {
+    js_timer_t *t = &g_timers[i];
+    if (t->kind == JS_TIMER_FRAME) {
+      uint32_t since = now - g_frame_last;
+      uint32_t w = since < LV_DISP_DEF_REFR_PERIOD ? LV_DISP_DEF_REFR_PERIOD - since : 0;
+      if (w < wait) wait = w;
+    } else if (t->kind != JS_TIMER_FREE) {
+      int32_t d = (int32_t)(t->due - now);
+      uint32_t w = d > 0 ? (uint32_t)d : 0;
+      if (w < wait) wait = w;
+    }
+  }
+  return wait;
+}
+
+void js_timers_loop(struct js *js) {
+  g_timer_task = xTaskGetCurrentTaskHandle();
+  for (;;) {
+    uint32_t wait = js_timers_next_ms();
+    if (wait) {
+      TickType_t ticks = (wait == UINT32_MAX) ? portMAX_DELAY : pdMS_TO_TICKS(wait);
+      ulTaskNotifyTake(pdTRUE, ticks);
+    }
+    if (g_timer_hook) g_timer_hook(js);
+    js_timers_dispatch(js);
+  }
+}
+
+void js_timers_frame() {
+  if (!g_frame_wanted || !g_timer_task) return;
+  g_frame_ready = true;
+  xTaskNotifyGive(g_timer_task);
+}
+
+void js_timers_set_hook(js_timers_hook_t hook) {
+  g_timer_hook = hook;
+}
+
+void js_timers_wake() {
+  if (g_timer_task) xTaskNotifyGive(g_timer_task);
+}
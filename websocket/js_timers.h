@@ -0,0 +1,25 @@
+#pragma once
+
+#include <Arduino.h>
+extern "C" {
+  #include "elk.h"
+}
+
+// Event loop for scripts: setTimeout, setInterval and requestAnimationFrame
+// (plus their clear/cancel counterparts). Callbacks are a function value or
+// the name of a global function. They run on the Elk task between frames;
+// requestAnimationFrame callbacks get the time in ms as their argument.
+#define JS_TIMERS_MAX 32
+#define JS_TIMER_NAME_MAX 32
+
+// Add the timer functions to the script's global object
+void js_timers_register(struct js *js);
+// Run timers until the end of time; call after the script's top level ran
+void js_timers_loop(struct js *js);
+// Frame boundary from the render side: releases pending animation frames
+void js_timers_frame();
+// Hook run on the Elk task before every dispatch round, for other native
+// events that need to call into the script; js_timers_wake() forces a round
+typedef void (*js_timers_hook_t)(struct js *js);
+void js_timers_set_hook(js_timers_hook_t hook);
+void js_timers_wake();
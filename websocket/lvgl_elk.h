@@ -2,6 +2,23 @@
 
 #include <lvgl.h>
 #include <HTTPClient.h>
+#include <ArduinoJson.h>
+#include <esp_heap_caps.h>
+#include <freertos/timers.h>
+#include <freertos/semphr.h>
+#include <new>
+#include "flush_sched.h"
+#include "display.h"
+#include "ui_queue.h"
+#include "js_timers.h"
+#include "js_minify.h"
+#include "js_bind.h"
+#include "data_ring.h"
+#include "strip_chart.h"
+#include "img_loader.h"
+#include "anim_player.h"
+#include "bundle.h"
+#include "sd_cache.h"
 
 // For BLE
 #include <NimBLEDevice.h>
@@ -19,48 +36,180 @@ extern "C" {
 /******************************************************************************
  * A) Elk Memory + Global Instances
  ******************************************************************************/
-static uint8_t elk_memory[16 * 1024]; // 16 KB
-struct js *js = NULL;               // Global Elk instance
-// Adjust as needed
-#define MAX_RAM_IMAGES  16
-
-// 4) Memory storage
-struct RamImage {
-  bool     used;          // Is this slot in use?
-  uint8_t *buffer;        // Raw image data allocated from ps_malloc()
-  size_t   size;          // Byte size of that buffer
-  lv_img_dsc_t dsc;       // The descriptor we pass to lv_img_set_src()
+// Heap, GC and stack sizing come from the "js" block of the settings in
+// /webscreen.json, e.g.
+//   "settings": { "js": { "heap_kb": 48, "heap_in": "psram",
+//                         "gc_threshold_pct": 60, "c_stack_kb": 12,
+//                         "report_s": 60, "low_memory_kb": 2 } }
+// Anything missing keeps the default below (the old fixed 16 KB internal
+// arena, GC at half of it, 16 KB task stack). Like stock Elk, recursion is
+// only bounded once "c_stack_kb" is set. The decoded image cache
+// budget is read from the same file:
+//   "settings": { "images": { "cache_kb": 2048 } }
+#define ELK_HEAP_DEFAULT      (16 * 1024)
+#define ELK_HEAP_MIN          (4 * 1024)
+#define ELK_GC_PCT_DEFAULT    50
+#define ELK_CSTACK_DEFAULT    0             // no js_setmaxcss() limit
+#define ELK_CSTACK_MIN        (2 * 1024)
+#define ELK_TASK_STACK_DEFAULT (16 * 1024)  // task stack while the C stack is unlimited
+#define ELK_STACK_HEADROOM    (8 * 1024)    // bridges + Serial on top of Elk's recursion
+#define ELK_INTERNAL_RESERVE  (48 * 1024)   // left for Wi-Fi, BLE, LVGL and other tasks
+#define ELK_PSRAM_RESERVE     (512 * 1024)  // left for GIFs and decoded images
+#define ELK_REPORT_S_DEFAULT  60                // serial telemetry period, 0 = off
+
+struct ElkConfig {
+  size_t heap_size;
+  bool   heap_psram;
+  uint8_t gc_pct;      // GC runs once the arena is this full
+  size_t c_stack;      // js_setmaxcss(), 0 = unlimited; the task stack adds ELK_STACK_HEADROOM
+  uint32_t report_s;   // see js_mon_report()
+  size_t low_memory;   // free bytes below which sys_on_low_memory() fires, 0 = off
 };
 
-static RamImage g_ram_images[MAX_RAM_IMAGES];
+static ElkConfig g_elk_cfg = { ELK_HEAP_DEFAULT, false, ELK_GC_PCT_DEFAULT, ELK_CSTACK_DEFAULT,
+                               ELK_REPORT_S_DEFAULT, 0 };
+static uint8_t *elk_memory = NULL;  // allocated by alloc_elk_memory()
+struct js *js = NULL;               // Global Elk instance
+
+// Read the "js" and "images" settings; a missing file or block leaves the defaults
+static void load_elk_config(const char *path) {
+  File f = SD_MMC.open(path);
+  if(!f) return;
+  String jsonStr = f.readString();
+  f.close();
+
+  StaticJsonDocument<1024> doc;
+  if(deserializeJson(doc, jsonStr)) {
+    Serial.println("Elk config: JSON parse error, using defaults");
+    return;
+  }
+  img_cache_set_budget((size_t)(doc["settings"]["images"]["cache_kb"] |
+                                (int)(IMG_CACHE_BUDGET_DEFAULT / 1024)) * 1024);
+
+  JsonObject cfg = doc["settings"]["js"];
+  if(cfg.isNull()) return;
+
+  g_elk_cfg.heap_size  = (size_t)(cfg["heap_kb"] | (int)(ELK_HEAP_DEFAULT / 1024)) * 1024;
+  g_elk_cfg.heap_psram = strcmp(cfg["heap_in"] | "internal", "psram") == 0;
+  g_elk_cfg.gc_pct     = (uint8_t)constrain(cfg["gc_threshold_pct"] | ELK_GC_PCT_DEFAULT, 10, 100);
+  g_elk_cfg.c_stack    = (size_t)(cfg["c_stack_kb"] | (int)(ELK_CSTACK_DEFAULT / 1024)) * 1024;
+  g_elk_cfg.report_s   = cfg["report_s"] | ELK_REPORT_S_DEFAULT;
+  g_elk_cfg.low_memory = (size_t)(cfg["low_memory_kb"] | 0) * 1024;
+}
+
+// Check the configured sizes against what is actually free, shrink what
+// does not fit, then allocate the arena. False only if not even the
+// minimum heap could be had.
+static bool alloc_elk_memory() {
+  ElkConfig &c = g_elk_cfg;
 
-void init_ram_images() {
-  for (int i = 0; i < MAX_RAM_IMAGES; i++) {
-    g_ram_images[i].used   = false;
-    g_ram_images[i].buffer = NULL;
-    g_ram_images[i].size   = 0;
-    // g_ram_images[i].dsc can remain zeroed
+  if(c.heap_psram && !psramFound()) {
+    Serial.println("Elk config: no PSRAM, heap goes to internal RAM");
+    c.heap_psram = false;
+  }
+  uint32_t caps = c.heap_psram ? (MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT)
+                               : (MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  size_t reserve = c.heap_psram ? ELK_PSRAM_RESERVE : ELK_INTERNAL_RESERVE;
+  size_t free_now = heap_caps_get_free_size(caps);
+  size_t largest = heap_caps_get_largest_free_block(caps);
+  size_t room = free_now > reserve ? free_now - reserve : 0;
+  if(room > largest) room = largest;
+  if(c.heap_size < ELK_HEAP_MIN) c.heap_size = ELK_HEAP_MIN;
+  if(c.heap_size > room) {
+    Serial.printf("Elk config: heap %u bytes does not fit (%u free, %u largest), using %u\n",
+                  (unsigned)c.heap_size, (unsigned)free_now, (unsigned)largest, (unsigned)room);
+    c.heap_size = room;
   }
+  if(c.heap_size < ELK_HEAP_MIN) return false;
+
+  // The task stack is internal RAM too
+  size_t stack_room = heap_caps_get_largest_free_block(MALLOC_CAP_INTERNAL | MALLOC_CAP_8BIT);
+  if(!c.heap_psram) stack_room = stack_room > c.heap_size ? stack_room - c.heap_size : 0;
+  if(c.c_stack && c.c_stack < ELK_CSTACK_MIN) c.c_stack = ELK_CSTACK_MIN;
+  if(c.c_stack && c.c_stack + ELK_STACK_HEADROOM > stack_room / 2) {
+    size_t fit = stack_room / 2 > ELK_STACK_HEADROOM ? stack_room / 2 - ELK_STACK_HEADROOM : 0;
+    c.c_stack = fit > ELK_CSTACK_MIN ? fit : ELK_CSTACK_MIN;
+    Serial.printf("Elk config: C stack limited to %u bytes\n", (unsigned)c.c_stack);
+  }
+
+  elk_memory = (uint8_t *)heap_caps_malloc(c.heap_size, caps);
+  if(!elk_memory) return false;
+  char cstack[24] = "unlimited";
+  if(c.c_stack) snprintf(cstack, sizeof(cstack), "%u bytes", (unsigned)c.c_stack);
+  Serial.printf("Elk config: heap %u bytes in %s, GC at %u%%, C stack %s\n",
+                (unsigned)c.heap_size, c.heap_psram ? "PSRAM" : "internal RAM",
+                (unsigned)c.gc_pct, cstack);
+  return true;
 }
 
+// Stack for elk_task: Elk's own limit plus room for the bridges
+static uint32_t elk_task_stack_size() {
+  if(!g_elk_cfg.c_stack) return ELK_TASK_STACK_DEFAULT;
+  return (uint32_t)(g_elk_cfg.c_stack + ELK_STACK_HEADROOM);
+}
 /******************************************************************************
  * C) "S" Driver for Reading Files from SD
  ******************************************************************************/
+// Files opened for reading go through sd_cache.h: a read-ahead buffer per
+// file plus a block cache shared by all of them, both in PSRAM. Files
+// opened for writing talk to the card directly, and they, sd_write_file and
+// sd_delete_file drop the file's cached blocks; the file size is the only
+// version check, as cards are not edited behind a running board. The cache
+// is touched from both tasks.
 typedef struct {
   File file;
+  bool cached;           // opened for reading
+  sdc_file_t sf;         // its read-ahead buffer follows the struct
 } lv_arduino_fs_file_t;
 
+static sdc_cache_t g_sd_cache;
+static SemaphoreHandle_t g_sd_cache_lock = NULL;
+
+#define SD_CACHE_LOCK() xSemaphoreTake(g_sd_cache_lock, portMAX_DELAY)
+#define SD_CACHE_UNLOCK() xSemaphoreGive(g_sd_cache_lock)
+
+static uint32_t sd_cache_read(void *handle, uint32_t off, void *buf, uint32_t n) {
+  File *f = (File *)handle;
+  if(f->position() != off && !f->seek(off)) return 0;
+  return f->read((uint8_t *)buf, n);
+}
+
+// Drop the cached blocks of `path` (an SD path such as "/font.bin")
+static void sd_cache_forget(const char *path) {
+  if(!g_sd_cache_lock) return;
+  while(*path == '/') path++;
+  SD_CACHE_LOCK();
+  sdc_invalidate(&g_sd_cache, sdc_path_hash(path));
+  SD_CACHE_UNLOCK();
+}
+
 static void *my_open_cb(lv_fs_drv_t *drv, const char *path, lv_fs_mode_t mode) {
-  String fullPath = String("/") + path; 
-  const char *modeStr = (mode == LV_FS_MODE_WR) ? FILE_WRITE : FILE_READ;
-  File f = SD_MMC.open(fullPath, modeStr);
+  while (*path == '/') path++;
+  char fullPath[128];
+  snprintf(fullPath, sizeof(fullPath), "/%s", path);
+  bool rd = mode != LV_FS_MODE_WR;
+  if (!rd) sd_cache_forget(path);
+  File f = SD_MMC.open(fullPath, rd ? FILE_READ : FILE_WRITE);
   if (!f) {
-    Serial.printf("my_open_cb: failed to open %s\n", fullPath.c_str());
+    Serial.printf("my_open_cb: failed to open %s\n", fullPath);
     return NULL;
   }
 
-  lv_arduino_fs_file_t *fp = new lv_arduino_fs_file_t();
+  size_t extra = rd ? SDC_READAHEAD_DEFAULT : 0;
+  lv_arduino_fs_file_t *fp = (lv_arduino_fs_file_t *)heap_caps_malloc(sizeof(*fp) + extra,
+                                                                      MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!fp) {
+    f.close();
+    return NULL;
+  }
+  new (fp) lv_arduino_fs_file_t();
   fp->file = f;
+  fp->cached = rd;
+  if (rd) {
+    uint32_t size = f.size();
+    sdc_open(&fp->sf, &g_sd_cache, sdc_path_hash(path), size, size, (uint8_t *)(fp + 1),
+             SDC_READAHEAD_DEFAULT, sd_cache_read, &fp->file);
+  }
   return fp;
 }
 
@@ -68,28 +217,43 @@ static lv_fs_res_t my_close_cb(lv_fs_drv_t *drv, void *file_p) {
   lv_arduino_fs_file_t *fp = (lv_arduino_fs_file_t *)file_p;
   if (!fp) return LV_FS_RES_INV_PARAM;
   fp->file.close();
-  delete fp;
+  fp->~lv_arduino_fs_file_t();
+  heap_caps_free(fp);
   return LV_FS_RES_OK;
 }
 
 static lv_fs_res_t my_read_cb(lv_fs_drv_t *drv, void *file_p, void *buf, uint32_t btr, uint32_t *br) {
   lv_arduino_fs_file_t *fp = (lv_arduino_fs_file_t *)file_p;
   if (!fp) return LV_FS_RES_INV_PARAM;
-  *br = fp->file.read((uint8_t*)buf, btr);
-  return LV_FS_RES_OK;
+  if (!fp->cached) {
+    *br = fp->file.read((uint8_t*)buf, btr);
+    return LV_FS_RES_OK;
+  }
+  SD_CACHE_LOCK();
+  bool ok = sdc_read(&fp->sf, buf, btr, br);
+  SD_CACHE_UNLOCK();
+  return ok ? LV_FS_RES_OK : LV_FS_RES_HW_ERR;
 }
 
 static lv_fs_res_t my_write_cb(lv_fs_drv_t *drv, void *file_p, const void *buf, uint32_t btw, uint32_t *bw) {
   lv_arduino_fs_file_t *fp = (lv_arduino_fs_file_t *)file_p;
-  if (!fp) return LV_FS_RES_INV_PARAM;
+  if (!fp || fp->cached) return LV_FS_RES_INV_PARAM;
   *bw = fp->file.write((const uint8_t *)buf, btw);
   return LV_FS_RES_OK;
 }
 
+// Reads only move the cached position; the card seeks when a read misses
 static lv_fs_res_t my_seek_cb(lv_fs_drv_t *drv, void *file_p, uint32_t pos, lv_fs_whence_t whence) {
   lv_arduino_fs_file_t *fp = (lv_arduino_fs_file_t *)file_p;
   if (!fp) return LV_FS_RES_INV_PARAM;
 
+  if (fp->cached) {
+    if (whence == LV_FS_SEEK_CUR) pos += fp->sf.pos;
+    if (whence == LV_FS_SEEK_END) pos += fp->sf.size;
+    sdc_seek(&fp->sf, pos);
+    return LV_FS_RES_OK;
+  }
+
   SeekMode m = SeekSet;
   if (whence == LV_FS_SEEK_CUR) m = SeekCur;
   if (whence == LV_FS_SEEK_END) m = SeekEnd;
@@ -101,7 +265,7 @@ static lv_fs_res_t my_seek_cb(lv_fs_drv_t *drv, void *file_p, uint32_t pos, lv_f
 static lv_fs_res_t my_tell_cb(lv_fs_drv_t *drv, void *file_p, uint32_t *pos_p) {
   lv_arduino_fs_file_t *fp = (lv_arduino_fs_file_t *)file_p;
   if (!fp) return LV_FS_RES_INV_PARAM;
-  *pos_p = fp->file.position();
+  *pos_p = fp->cached ? fp->sf.pos : fp->file.position();
   return LV_FS_RES_OK;
 }
 
@@ -109,6 +273,11 @@ void init_lv_fs() {
   static lv_fs_drv_t fs_drv;
   lv_fs_drv_init(&fs_drv);
 
+  // Shared blocks in PSRAM; without it the read-ahead buffers still work
+  g_sd_cache_lock = xSemaphoreCreateMutex();
+  void *mem = heap_caps_malloc(SDC_CACHE_DEFAULT, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  uint32_t blocks = sdc_cache_init(&g_sd_cache, mem, mem ? SDC_CACHE_DEFAULT : 0);
+
   fs_drv.letter = 'S';
   fs_drv.open_cb  = my_open_cb;
   fs_drv.close_cb = my_close_cb;
@@ -118,28 +287,71 @@ void init_lv_fs() {
   fs_drv.tell_cb  = my_tell_cb;
 
   lv_fs_drv_register(&fs_drv);
-  Serial.println("LVGL FS driver 'S' registered");
+  Serial.printf("LVGL FS driver 'S' registered (%u cached blocks, %u bytes read-ahead per file)\n",
+                (unsigned)blocks, (unsigned)SDC_READAHEAD_DEFAULT);
 }
 
 /******************************************************************************
  * D) "M" Memory Driver (for GIF usage)
  ******************************************************************************/
+// "M:/anim.gif" reads the copy of /anim.gif that gif_mem_acquire() loaded
+// into PSRAM. Every GIF widget holds a reference until it is deleted, and
+// so does every open file (lv_gif keeps its file open and decodes from it
+// frame by frame), so a buffer is freed once both are gone. Showing the
+// same path twice shares one buffer. Render task only.
+typedef struct GifMem {
+  struct GifMem *next;
+  char *path;
+  uint8_t *data;
+  size_t size;
+  uint16_t refs;
+} GifMem;
+
+static GifMem *g_gif_mems = NULL;
+
+static GifMem *gif_mem_find(const char *path) {
+  for(GifMem *m = g_gif_mems; m; m = m->next) {
+    if(strcmp(m->path, path) == 0) return m;
+  }
+  return NULL;
+}
+
+static void gif_mem_release(GifMem *m) {
+  if(--m->refs) return;
+  for(GifMem **pp = &g_gif_mems; *pp; pp = &(*pp)->next) {
+    if(*pp == m) {
+      *pp = m->next;
+      break;
+    }
+  }
+  Serial.printf("GIF %s released (%u bytes)\n", m->path, (unsigned)m->size);
+  free(m->data);
+  free(m->path);
+  free(m);
+}
+
 typedef struct {
+  GifMem *mem;
   size_t pos;
 } mem_file_t;
 
-static uint8_t *g_gifBuffer = NULL;
-static size_t   g_gifSize   = 0;
-
 static void *my_mem_open_cb(lv_fs_drv_t *drv, const char *path, lv_fs_mode_t mode) {
+  GifMem *m = gif_mem_find(path);
+  if(!m) {
+    Serial.printf("my_mem_open_cb: %s is not loaded\n", path);
+    return NULL;
+  }
   mem_file_t *mf = new mem_file_t();
+  mf->mem = m;
   mf->pos = 0;
+  m->refs++;
   return mf;
 }
 
 static lv_fs_res_t my_mem_close_cb(lv_fs_drv_t *drv, void *file_p) {
   mem_file_t *mf = (mem_file_t *)file_p;
   if(!mf) return LV_FS_RES_INV_PARAM;
+  gif_mem_release(mf->mem);
   delete mf;
   return LV_FS_RES_OK;
 }
@@ -148,10 +360,10 @@ static lv_fs_res_t my_mem_read_cb(lv_fs_drv_t *drv, void *file_p, void *buf, uin
   mem_file_t *mf = (mem_file_t *)file_p;
   if(!mf) return LV_FS_RES_INV_PARAM;
 
-  size_t remaining = g_gifSize - mf->pos;
+  size_t remaining = mf->mem->size - mf->pos;
   if (btr > remaining) btr = remaining;
 
-  memcpy(buf, g_gifBuffer + mf->pos, btr);
+  memcpy(buf, mf->mem->data + mf->pos, btr);
   mf->pos += btr;
   *br = btr;
   return LV_FS_RES_OK;
@@ -169,9 +381,9 @@ static lv_fs_res_t my_mem_seek_cb(lv_fs_drv_t *drv, void *file_p, uint32_t pos,
   size_t newpos = mf->pos;
   if(whence == LV_FS_SEEK_SET) newpos = pos;
   else if(whence == LV_FS_SEEK_CUR) newpos += pos;
-  else if(whence == LV_FS_SEEK_END) newpos = g_gifSize + pos;
+  else if(whence == LV_FS_SEEK_END) newpos = mf->mem->size + pos;
 
-  if(newpos > g_gifSize) newpos = g_gifSize;
+  if(newpos > mf->mem->size) newpos = mf->mem->size;
   mf->pos = newpos;
   return LV_FS_RES_OK;
 }
@@ -202,53 +414,11 @@ void init_mem_fs() {
 /******************************************************************************
  * B) LVGL + Display
  ******************************************************************************/
-static lv_disp_draw_buf_t draw_buf;
-static lv_color_t *buf = NULL;
-
-void my_disp_flush(lv_disp_drv_t *disp, const lv_area_t *area, lv_color_t *color_p) {
-  // Calculate width/height from the area
-  uint32_t w = (area->x2 - area->x1 + 1);
-  uint32_t h = (area->y2 - area->y1 + 1);
-
-  // Push the rendered data to the display
-  lcd_PushColors(area->x1, area->y1, w, h, (uint16_t *)&color_p->full);
-
-  // Tell LVGL flush is done
-  lv_disp_flush_ready(disp);
-}
-
 void init_lvgl_display() {
   Serial.println("Initializing display...");
 
-  // Turn on backlight / screen power
-  pinMode(PIN_LED, OUTPUT);
-  digitalWrite(PIN_LED, HIGH);
-
-  // Init the AMOLED driver & set rotation
-  rm67162_init();
-  lcd_setRotation(1);
-
-  // Init LVGL
-  lv_init();
-
-  // Allocate LVGL draw buffer in PSRAM
-  buf = (lv_color_t *)ps_malloc(sizeof(lv_color_t) * LVGL_LCD_BUF_SIZE);
-  if (!buf) {
-    Serial.println("Failed to allocate LVGL buffer in PSRAM");
-    return;
-  }
-
-  // Initialize LVGL draw buffer
-  lv_disp_draw_buf_init(&draw_buf, buf, NULL, LVGL_LCD_BUF_SIZE);
-
-  // Register the display driver
-  static lv_disp_drv_t disp_drv;
-  lv_disp_drv_init(&disp_drv);
-  disp_drv.hor_res = EXAMPLE_LCD_H_RES;
-  disp_drv.ver_res = EXAMPLE_LCD_V_RES;
-  disp_drv.flush_cb = my_disp_flush;
-  disp_drv.draw_buf = &draw_buf;
-  lv_disp_drv_register(&disp_drv);
+  // Shared with fallback mode; the panel is only brought up once
+  if (!display_init()) return;
 
   Serial.println("LVGL + Display initialized.");
 }
@@ -263,7 +433,9 @@ void lvgl_loop() {
  ******************************************************************************/
 static jsval_t js_print(struct js *js, jsval_t *args, int nargs) {
   for (int i = 0; i < nargs; i++) {
-    const char *str = js_str(js, args[i]);
+    // Strings as they are, anything else in its JSON form
+    const char *str = js_getstr(js, args[i], NULL);
+    if (!str) str = js_str(js, args[i]);
     if (str) Serial.println(str);
     else     Serial.println("print: argument is not a string");
   }
@@ -271,24 +443,9 @@ static jsval_t js_print(struct js *js, jsval_t *args, int nargs) {
 }
 
 // Wi-Fi connect
-static jsval_t js_wifi_connect(struct js *js, jsval_t *args, int nargs) {
-  if (nargs != 2) return js_mkfalse();
-  const char* ssidQ  = js_str(js, args[0]);
-  const char* passQ  = js_str(js, args[1]);
-  if (!ssidQ || !passQ) return js_mkfalse();
-
-  // Strip quotes if any
-  String ssid(ssidQ);
-  String pass(passQ);
-  if (ssid.startsWith("\"") && ssid.endsWith("\"")) {
-    ssid = ssid.substring(1, ssid.length()-1);
-  }
-  if (pass.startsWith("\"") && pass.endsWith("\"")) {
-    pass = pass.substring(1, pass.length()-1);
-  }
-
-  Serial.printf("Connecting to Wi-Fi SSID: %s\n", ssid.c_str());
-  WiFi.begin(ssid.c_str(), pass.c_str());
+JS_BIND_FN(bool, wifi_connect, const char *ssid, const char *pass) {
+  Serial.printf("Connecting to Wi-Fi SSID: %s\n", ssid);
+  WiFi.begin(ssid, pass);
 
   int attempts = 20;
   while (WiFi.status() != WL_CONNECTED && attempts > 0) {
@@ -300,10 +457,10 @@ static jsval_t js_wifi_connect(struct js *js, jsval_t *args, int nargs) {
 
   if (WiFi.status() == WL_CONNECTED) {
     Serial.println("Wi-Fi connected");
-    return js_mktrue();
+    return true;
   } else {
     Serial.println("Failed to connect to Wi-Fi");
-    return js_mkfalse();
+    return false;
   }
 }
 
@@ -321,7 +478,7 @@ static jsval_t js_wifi_get_ip(struct js *js, jsval_t *args, int nargs) {
   return js_mkstr(js, ipStr.c_str(), ipStr.length());
 }
 
-// Delay in JS: "delay(ms)"
+// Delay in JS: "delay(ms)". Only the script waits, rendering goes on.
 static jsval_t js_delay(struct js *js, jsval_t *args, int nargs) {
   if (nargs != 1) return js_mknull();
   double ms = js_getnum(args[0]);
@@ -329,10 +486,295 @@ static jsval_t js_delay(struct js *js, jsval_t *args, int nargs) {
   return js_mknull();
 }
 
+// set_vsync(divider, [autoPace]) => 0 turns TE sync off, n presents on every n-th TE pulse.
+// Queued: the gating state belongs to the render task, which reads it mid-frame.
+static jsval_t js_set_vsync(struct js *js, jsval_t *args, int nargs) {
+  if (nargs < 1) return js_mkfalse();
+  int divider = (int)js_getnum(args[0]);
+  bool autoPace = (nargs >= 2) ? js_truthy(js, args[1]) : true;
+  if (divider < 0) divider = 0;
+  lcd_te_set_divider((uint8_t)divider, autoPace);
+  Serial.printf("set_vsync: divider=%d auto=%d\n", divider, autoPace);
+  return js_mktrue();
+}
+
+// lcd_fill_rect(x, y, w, h, 0xRRGGBB) => draws straight to the panel, bypassing LVGL
+static jsval_t js_lcd_fill_rect(struct js *js, jsval_t *args, int nargs) {
+  if (nargs < 5) return js_mkfalse();
+  int x = (int)js_getnum(args[0]);
+  int y = (int)js_getnum(args[1]);
+  int w = (int)js_getnum(args[2]);
+  int h = (int)js_getnum(args[3]);
+  lv_color_t c = lv_color_hex((uint32_t)js_getnum(args[4]));
+  if (x < 0 || y < 0 || w <= 0 || h <= 0 ||
+      x + w > EXAMPLE_LCD_H_RES || y + h > EXAMPLE_LCD_V_RES) return js_mkfalse();
+  lcd_fill_rect(x, y, w, h, c.full);
+  return js_mktrue();
+}
+
+// lcd_clear_rect(x, y, w, h)
+static jsval_t js_lcd_clear_rect(struct js *js, jsval_t *args, int nargs) {
+  if (nargs < 4) return js_mkfalse();
+  int x = (int)js_getnum(args[0]);
+  int y = (int)js_getnum(args[1]);
+  int w = (int)js_getnum(args[2]);
+  int h = (int)js_getnum(args[3]);
+  if (x < 0 || y < 0 || w <= 0 || h <= 0 ||
+      x + w > EXAMPLE_LCD_H_RES || y + h > EXAMPLE_LCD_V_RES) return js_mkfalse();
+  lcd_clear_rect(x, y, w, h);
+  return js_mktrue();
+}
+
+// lcd_blit_pattern(x, y, w, h, pw, ph, "0xRRGGBB,0xRRGGBB,...") => pw*ph colours, row-major
+static jsval_t js_lcd_blit_pattern(struct js *js, jsval_t *args, int nargs) {
+  if (nargs < 7) return js_mkfalse();
+  int x  = (int)js_getnum(args[0]);
+  int y  = (int)js_getnum(args[1]);
+  int w  = (int)js_getnum(args[2]);
+  int h  = (int)js_getnum(args[3]);
+  int pw = (int)js_getnum(args[4]);
+  int ph = (int)js_getnum(args[5]);
+  const char *list = js_getstr(js, args[6], NULL);
+  if (!list || pw <= 0 || ph <= 0 || pw * ph > 64) return js_mkfalse();
+  if (x < 0 || y < 0 || w <= 0 || h <= 0 ||
+      x + w > EXAMPLE_LCD_H_RES || y + h > EXAMPLE_LCD_V_RES) return js_mkfalse();
+
+  uint16_t pattern[64];
+  int n = 0;
+  const char *p = list;
+  while (*p && n < pw * ph) {
+    while (*p && !isxdigit((unsigned char)*p)) p++;  // skips separators
+    if (!*p) break;
+    char *end;
+    uint32_t rgb = (uint32_t)strtoul(p, &end, 16);
+    if (end == p) break;
+    pattern[n++] = lv_color_hex(rgb).full;
+    p = end;
+  }
+  if (n != pw * ph) {
+    Serial.println("lcd_blit_pattern: colour count does not match pw*ph");
+    return js_mkfalse();
+  }
+  return lcd_blit_pattern(x, y, w, h, pattern, pw, ph) ? js_mktrue() : js_mkfalse();
+}
+
+// sys_flush_stats() => { frames, areas_in, windows, dirty_px, pushed_bytes }
+static jsval_t js_sys_flush_stats(struct js *js, jsval_t *args, int nargs) {
+  flush_sched_stats_t fs;
+  lcd_push_stats_t ps;
+  flush_sched_get_stats(&fs);
+  lcd_get_push_stats(&ps);
+
+  jsval_t obj = js_mkobj(js);
+  js_set(js, obj, "frames",       js_mknum(fs.frames));
+  js_set(js, obj, "areas_in",     js_mknum(fs.areas_in));
+  js_set(js, obj, "windows",      js_mknum(fs.areas_out));
+  js_set(js, obj, "dirty_px",     js_mknum((double)fs.dirty_px));
+  js_set(js, obj, "pushed_bytes", js_mknum((double)ps.bytes));
+  return obj;
+}
+
+// sys_ui_stats() => { commands, batches, wakeups, woken, idle_ms, light_sleep_ms }
+static jsval_t js_sys_ui_stats(struct js *js, jsval_t *args, int nargs) {
+  ui_stats_t us;
+  ui_get_stats(&us);
+
+  jsval_t obj = js_mkobj(js);
+  js_set(js, obj, "commands",       js_mknum(us.applied));
+  js_set(js, obj, "batches",        js_mknum(us.batches));
+  js_set(js, obj, "wakeups",        js_mknum(us.wakeups));
+  js_set(js, obj, "woken",          js_mknum(us.woken));
+  js_set(js, obj, "idle_ms",        js_mknum(us.idle_ms));
+  js_set(js, obj, "light_sleep_ms", js_mknum(us.light_sleep_ms));
+  return obj;
+}
+
+// sys_obj_stats() => { capacity, used, peak, allocs, frees, stale, bytes }
+static jsval_t js_sys_obj_stats(struct js *js, jsval_t *args, int nargs) {
+  ui_handle_stats_t hs;
+  ui_handle_get_stats(&hs);
+
+  jsval_t obj = js_mkobj(js);
+  js_set(js, obj, "capacity", js_mknum(hs.capacity));
+  js_set(js, obj, "used",     js_mknum(hs.used));
+  js_set(js, obj, "peak",     js_mknum(hs.peak));
+  js_set(js, obj, "allocs",   js_mknum(hs.allocs));
+  js_set(js, obj, "frees",    js_mknum(hs.frees));
+  js_set(js, obj, "stale",    js_mknum(hs.stale));
+  js_set(js, obj, "bytes",    js_mknum(hs.bytes));
+  return obj;
+}
+
+// The image cache belongs to the render task: a UI_SYNC call copies its
+// counters there, and the object is built here from the copy
+static img_cache_stats_t g_img_stats_copy;
+static jsval_t js_img_stats_copy(struct js *js, jsval_t *args, int nargs) {
+  img_cache_get_stats(&g_img_stats_copy);
+  return js_mktrue();
+}
+
+// sys_img_stats() => { entries, in_use, bytes, budget, hits, misses, evictions }
+static jsval_t js_sys_img_stats(struct js *js, jsval_t *args, int nargs) {
+  ui_forward(js, js_img_stats_copy, UI_CMD_SYNC, NULL, 0);
+  img_cache_stats_t is = g_img_stats_copy;
+
+  jsval_t obj = js_mkobj(js);
+  js_set(js, obj, "entries",   js_mknum(is.entries));
+  js_set(js, obj, "in_use",    js_mknum(is.in_use));
+  js_set(js, obj, "bytes",     js_mknum(is.bytes));
+  js_set(js, obj, "budget",    js_mknum(is.budget));
+  js_set(js, obj, "hits",      js_mknum(is.hits));
+  js_set(js, obj, "misses",    js_mknum(is.misses));
+  js_set(js, obj, "evictions", js_mknum(is.evictions));
+  return obj;
+}
+
+// sys_sd_stats() => { reads, hits, block_hits, sd_reads, bytes, saved, sd_bytes }
+// for the 'S' driver's read cache; hits / reads is the hit rate
+static jsval_t js_sys_sd_stats(struct js *js, jsval_t *args, int nargs) {
+  sdc_stats_t st = {};
+  if(g_sd_cache_lock) {
+    SD_CACHE_LOCK();
+    st = g_sd_cache.stats;
+    SD_CACHE_UNLOCK();
+  }
+
+  jsval_t obj = js_mkobj(js);
+  js_set(js, obj, "reads",      js_mknum(st.reads));
+  js_set(js, obj, "hits",       js_mknum(st.hits));
+  js_set(js, obj, "block_hits", js_mknum(st.block_hits));
+  js_set(js, obj, "sd_reads",   js_mknum(st.sd_reads));
+  js_set(js, obj, "bytes",      js_mknum((double)st.bytes));
+  js_set(js, obj, "saved",      js_mknum((double)st.saved));
+  js_set(js, obj, "sd_bytes",   js_mknum((double)st.sd_bytes));
+  return obj;
+}
+
+/******************************************************************************
+ * JS runtime telemetry: sampled at the end of every frame and after every
+ * timer round, reported on serial every report_s seconds together with the
+ * flush scheduler totals
+ ******************************************************************************/
+struct JsMon {
+  volatile size_t   free_now;
+  volatile size_t   free_min;    // Elk's low watermark
+  volatile size_t   cstack_max;  // deepest C stack Elk saw, bytes
+  volatile size_t   stack_free;  // ElkTask stack never touched, bytes
+  volatile uint32_t samples;
+  size_t            warn;        // low-memory threshold, 0 = off
+  volatile bool     low;         // crossed, callback not run yet
+  bool              armed;
+  bool              has_cb;
+  char              cb[JS_TIMER_NAME_MAX];
+};
+static JsMon g_jsmon = {};
+static TaskHandle_t g_elk_task = NULL;
+static TimerHandle_t g_jsmon_timer = NULL;
+
+// Safe from any task: only reads counters Elk keeps up to date
+static void js_mon_sample() {
+  if(!js) return;
+  size_t total, lwm, css;
+  js_stats(js, &total, &lwm, &css);
+  size_t used = js_usage(js);
+  g_jsmon.free_now = used < total ? total - used : 0;
+  g_jsmon.free_min = lwm;
+  g_jsmon.cstack_max = css;
+  if(g_elk_task) g_jsmon.stack_free = uxTaskGetStackHighWaterMark(g_elk_task) * sizeof(StackType_t);
+  g_jsmon.samples++;
+
+  if(!g_jsmon.warn) return;
+  if(g_jsmon.armed && g_jsmon.free_now < g_jsmon.warn) {
+    g_jsmon.armed = false;
+    g_jsmon.low = true;
+    js_timers_wake();
+  } else if(!g_jsmon.armed && g_jsmon.free_now >= g_jsmon.warn + g_jsmon.warn / 8) {
+    g_jsmon.armed = true;  // re-arm once clearly back above the threshold
+  }
+}
+
+static void js_mon_report(TimerHandle_t t) {
+  js_mon_sample();
+  size_t total = 0;
+  if(js) js_stats(js, &total, NULL, NULL);
+  Serial.printf("JS: heap %u, free %u, min free %u, C stack %u/%u, task stack left %u\n",
+                (unsigned)total, (unsigned)g_jsmon.free_now, (unsigned)g_jsmon.free_min,
+                (unsigned)g_jsmon.cstack_max, (unsigned)g_elk_cfg.c_stack,
+                (unsigned)g_jsmon.stack_free);
+  flush_sched_report();
+}
+
+// Elk-task side: run the script's low-memory callback, see js_timers_set_hook()
+static void js_mon_hook(struct js *js) {
+  js_mon_sample();
+  if(!g_jsmon.low) return;
+  g_jsmon.low = false;
+  if(!g_jsmon.has_cb) {
+    Serial.printf("JS: low memory, %u bytes free\n", (unsigned)g_jsmon.free_now);
+    return;
+  }
+  char code[JS_TIMER_NAME_MAX + 16];
+  snprintf(code, sizeof(code), "%s(%u);", g_jsmon.cb, (unsigned)g_jsmon.free_now);
+  jsval_t res = js_eval(js, code, strlen(code));
+  if(js_type(res) == JS_ERR) Serial.printf("JS: low-memory callback: %s\n", js_str(js, res));
+}
+
+static void js_mon_start() {
+  g_elk_task = xTaskGetCurrentTaskHandle();
+  g_jsmon.warn = g_elk_cfg.low_memory;
+  g_jsmon.armed = true;
+  js_timers_set_hook(js_mon_hook);
+  if(g_elk_cfg.report_s && !g_jsmon_timer) {
+    g_jsmon_timer = xTimerCreate("JsReport", pdMS_TO_TICKS(g_elk_cfg.report_s * 1000UL),
+                                 pdTRUE, NULL, js_mon_report);
+    if(g_jsmon_timer) xTimerStart(g_jsmon_timer, 0);
+  }
+}
+
+// sys_js_stats() => { total, free, min_free, cstack, cstack_limit, stack_free, samples }
+// (cstack_limit 0: the C stack is not limited)
+static jsval_t js_sys_js_stats(struct js *js, jsval_t *args, int nargs) {
+  js_mon_sample();
+  size_t total;
+  js_stats(js, &total, NULL, NULL);
+
+  jsval_t obj = js_mkobj(js);
+  js_set(js, obj, "total",        js_mknum(total));
+  js_set(js, obj, "free",         js_mknum(g_jsmon.free_now));
+  js_set(js, obj, "min_free",     js_mknum(g_jsmon.free_min));
+  js_set(js, obj, "cstack",       js_mknum(g_jsmon.cstack_max));
+  js_set(js, obj, "cstack_limit", js_mknum(g_elk_cfg.c_stack));
+  js_set(js, obj, "stack_free",   js_mknum(g_jsmon.stack_free));
+  js_set(js, obj, "samples",      js_mknum(g_jsmon.samples));
+  return obj;
+}
+
+// sys_on_low_memory(fn_or_name[, bytes]) => called with the free byte count
+// whenever free memory drops below the threshold (default: low_memory_kb)
+static jsval_t js_sys_on_low_memory(struct js *js, jsval_t *args, int nargs) {
+  if(nargs < 1) return js_mkfalse();
+  if(js_type(args[0]) == JS_STR) {
+    size_t len;
+    const char *name = js_getstr(js, args[0], &len);
+    if(len == 0 || len >= sizeof(g_jsmon.cb)) return js_mkfalse();
+    memcpy(g_jsmon.cb, name, len);
+    g_jsmon.cb[len] = 0;
+  } else {
+    // Function values are parked in a global and called by name
+    strcpy(g_jsmon.cb, "__lowmem");
+    js_set(js, js_glob(js), g_jsmon.cb, args[0]);
+  }
+  g_jsmon.has_cb = true;
+  if(nargs >= 2 && js_getnum(args[1]) > 0) g_jsmon.warn = (size_t)js_getnum(args[1]);
+  if(!g_jsmon.warn) Serial.println("sys_on_low_memory: no threshold set");
+  g_jsmon.armed = true;
+  return js_mktrue();
+}
+
 // sd_read_file(path)
 static jsval_t js_sd_read_file(struct js *js, jsval_t *args, int nargs) {
   if (nargs != 1) return js_mknull();
-  const char* path = js_str(js, args[0]);
+  const char* path = js_getstr(js, args[0], NULL);
   if(!path) return js_mknull();
 
   File file = SD_MMC.open(path);
@@ -346,37 +788,27 @@ static jsval_t js_sd_read_file(struct js *js, jsval_t *args, int nargs) {
 }
 
 // sd_write_file(path, data)
-static jsval_t js_sd_write_file(struct js *js, jsval_t *args, int nargs) {
-  if (nargs != 2) return js_mkfalse();
-  const char *path = js_str(js, args[0]);
-  const char *data = js_str(js, args[1]);
-  if(!path || !data) return js_mkfalse();
-
+JS_BIND_FN(bool, sd_write_file, const char *path, const char *data) {
+  sd_cache_forget(path);
   File f = SD_MMC.open(path, FILE_WRITE);
   if(!f) {
     Serial.printf("Failed to open for writing: %s\n", path);
-    return js_mkfalse();
+    return false;
   }
   f.write((const uint8_t*)data, strlen(data));
   f.close();
-  return js_mktrue();
+  return true;
 }
 
 // sd_list_dir(path)
 static jsval_t js_sd_list_dir(struct js *js, jsval_t *args, int nargs) {
   if (nargs != 1) return js_mknull();
-  const char* pathQ = js_str(js, args[0]);
-  if (!pathQ) return js_mknull();
-
-  // Strip quotes
-  String path(pathQ);
-  if (path.startsWith("\"") && path.endsWith("\"")) {
-    path = path.substring(1, path.length()-1);
-  }
+  const char* path = js_getstr(js, args[0], NULL);
+  if (!path) return js_mknull();
 
   File root = SD_MMC.open(path);
   if(!root) {
-    Serial.printf("Failed to open directory: %s\n", path.c_str());
+    Serial.printf("Failed to open directory: %s\n", path);
     return js_mknull();
   }
   if(!root.isDirectory()) {
@@ -404,13 +836,47 @@ static jsval_t js_sd_list_dir(struct js *js, jsval_t *args, int nargs) {
 }
 
 /******************************************************************************
- * F) Load GIF from SD => g_gifBuffer => "M:mygif"
+ * F) Load GIF from SD => shared PSRAM buffer => "M:<path>"
  ******************************************************************************/
-bool load_gif_into_ram(const char *path) {
+// Register `data` (ps_malloc'd, taken over) as the buffer for `path`
+static GifMem *gif_mem_add(const char *path, uint8_t *data, size_t size) {
+  GifMem *m = (GifMem *)calloc(1, sizeof(GifMem));
+  char *name = strdup(path);
+  if(!m || !name) {
+    free(m);
+    free(name);
+    return NULL;
+  }
+  m->path = name;
+  m->data = data;
+  m->size = size;
+  m->refs = 1;
+  m->next = g_gif_mems;
+  g_gif_mems = m;
+  return m;
+}
+
+// Buffer for `path` with a reference taken, loaded on first use from the
+// app bundle if it has the file, else from SD
+static GifMem *gif_mem_acquire(const char *path) {
+  GifMem *m = gif_mem_find(path);
+  if(m) {
+    m->refs++;
+    return m;
+  }
+
+  const bundle_entry_t *be = bundle_find(path);
+  if(be) {
+    uint8_t *data = bundle_load(be);
+    m = data ? gif_mem_add(path, data, be->raw_size) : NULL;
+    if(!m) free(data);
+    return m;
+  }
+
   File f = SD_MMC.open(path, FILE_READ);
   if(!f) {
     Serial.printf("Failed to open %s\n", path);
-    return false;
+    return NULL;
   }
   size_t fileSize = f.size();
   Serial.printf("File %s is %u bytes\n", path, (unsigned)fileSize);
@@ -419,7 +885,7 @@ bool load_gif_into_ram(const char *path) {
   if(!tmp) {
     Serial.printf("Failed to allocate %u bytes in PSRAM\n",(unsigned)fileSize);
     f.close();
-    return false;
+    return NULL;
   }
   size_t bytesRead = f.read(tmp, fileSize);
   f.close();
@@ -427,96 +893,65 @@ bool load_gif_into_ram(const char *path) {
     Serial.printf("Failed to read full file: only %u of %u\n",
                   (unsigned)bytesRead,(unsigned)fileSize);
     free(tmp);
-    return false;
+    return NULL;
+  }
+  m = gif_mem_add(path, tmp, fileSize);
+  if(!m) {
+    free(tmp);
+    return NULL;
   }
-  g_gifBuffer = tmp;
-  g_gifSize   = fileSize;
   Serial.println("GIF loaded into PSRAM successfully");
-  return true;
+  return m;
 }
 
-static jsval_t js_show_gif_from_sd(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<1) {
-    Serial.println("show_gif_from_sd: expects path");
-    return js_mknull();
-  }
-  const char* rawPath = js_str(js, args[0]);
-  if(!rawPath) return js_mknull();
+static void on_gif_deleted(lv_event_t *e) {
+  gif_mem_release((GifMem *)lv_event_get_user_data(e));
+}
 
-  // Strip quotes
-  String path(rawPath);
-  if (path.startsWith("\"") && path.endsWith("\"")) {
-    path = path.substring(1, path.length()-1);
-  }
+// GIF widget on the active screen playing `path` from PSRAM; NULL if the
+// file could not be loaded
+static lv_obj_t *create_gif(const char *path) {
+  GifMem *m = gif_mem_acquire(path);
+  if(!m) return NULL;
 
-  if(!load_gif_into_ram(path.c_str())) {
+  lv_obj_t *gif = lv_gif_create(lv_scr_act());
+  lv_obj_add_event_cb(gif, on_gif_deleted, LV_EVENT_DELETE, m);
+  String src = String("M:") + m->path;
+  lv_gif_set_src(gif, src.c_str());
+  return gif;
+}
+
+JS_BIND_FN(void, show_gif_from_sd, const char *path) {
+  lv_obj_t *gif = create_gif(path);
+  if(!gif) {
     Serial.println("Could not load GIF into RAM");
-    return js_mknull();
+    return;
   }
-
-  lv_obj_t *gif = lv_gif_create(lv_scr_act());
-  lv_gif_set_src(gif, "M:mygif");   // memory-based
   lv_obj_align(gif, LV_ALIGN_CENTER, 0, 0);
 
-  Serial.printf("Showing GIF from memory driver (file was %s)\n", path.c_str());
-  return js_mknull();
+  Serial.printf("Showing GIF from memory driver (file was %s)\n", path);
 }
 
 
 /******************************************************************************
  * J) Load + Execute JS from SD
  ******************************************************************************/
-bool load_image_file_into_ram(const char *path, RamImage *outImg) {
-  // 1) Open file
-  File f = SD_MMC.open(path, FILE_READ);
-  if (!f) {
-    Serial.printf("Failed to open %s\n", path);
-    return false;
-  }
-  size_t fileSize = f.size();
-  Serial.printf("File %s is %u bytes\n", path, (unsigned)fileSize);
+void register_js_functions(const char *src, size_t len);
 
-  // 2) Allocate PSRAM
-  uint8_t *buf = (uint8_t *)ps_malloc(fileSize);
-  if (!buf) {
-    Serial.printf("Failed to allocate %u bytes in PSRAM\n", (unsigned)fileSize);
-    f.close();
-    return false;
-  }
+// Registers the bridges the script uses, then runs it
+static bool execute_js_source(const char *src, size_t len) {
+  register_js_functions(src, len);
 
-  // 3) Read all data
-  size_t bytesRead = f.read(buf, fileSize);
-  f.close();
-  if (bytesRead < fileSize) {
-    Serial.printf("Failed to read full file: only %u of %u\n",
-                  (unsigned)bytesRead, (unsigned)fileSize);
-    free(buf);
+  uint32_t t0 = micros();
+  jsval_t res = js_eval(js, src, len);
+  uint32_t us = micros() - t0;
+  if(js_type(res) == JS_ERR) {
+    const char *error = js_str(js, res);
+    Serial.printf("Error executing script: %s\n", error);
     return false;
   }
-
-  // 4) Fill out the RamImage struct
-  outImg->used   = true;
-  outImg->buffer = buf;
-  outImg->size   = fileSize;
-
-  // 5) Fill out the lv_img_dsc_t with minimal info
-  //    - If it's a "raw" or "true color" format, you can do:
-  lv_img_dsc_t *d = &outImg->dsc;
-  memset(d, 0, sizeof(*d));
-
-  // Basic mandatory fields:
-  d->data_size       = fileSize;
-  d->data            = buf;
-  d->header.always_zero = 0;
-  d->header.w       = 200;
-  d->header.h       = 200;
-  d->header.cf      = LV_IMG_CF_TRUE_COLOR; 
-  // or LV_IMG_CF_RAW if using a custom decoder
-
-  // If you can't know width/height from file alone, you may just guess or parse
-  // For a PNG/JPG you'd typically use an external decoder to fill w,h
-
-  Serial.println("Image loaded into PSRAM successfully");
+  Serial.printf("JavaScript script executed successfully (%u bytes, %lu us)\n",
+                (unsigned)len, (unsigned long)us);
   return true;
 }
 
@@ -530,35 +965,79 @@ bool load_and_execute_js_script(const char* path) {
   }
   String jsScript = file.readString();
   file.close();
+  return execute_js_source(jsScript.c_str(), jsScript.length());
+}
 
-  jsval_t res = js_eval(js, jsScript.c_str(), jsScript.length());
-  if(js_type(res) == JS_ERR) {
-    const char *error = js_str(js, res);
-    Serial.printf("Error executing script: %s\n", error);
+// The script of the mounted app bundle, run as packed (tools/wsbpack
+// minifies it on the host)
+static bool load_and_execute_bundle_script() {
+  const bundle_entry_t *e = bundle_find(BUNDLE_SCRIPT);
+  if(!e) {
+    Serial.println("App bundle has no " BUNDLE_SCRIPT);
     return false;
   }
-  Serial.println("JavaScript script executed successfully");
-  return true;
+  Serial.printf("Loading JavaScript script from: %s:%s\n", BUNDLE_APP_PATH, BUNDLE_SCRIPT);
+  char *src = (char *)bundle_load(e);
+  if(!src) return false;
+  bool ok = execute_js_source(src, e->raw_size);
+  free(src);
+  return ok;
+}
+
+// Make sure min_path holds the minified form of src_path (see js_minify.h)
+// and return the path to run: the minified copy, or the source if it could
+// not be produced.
+static const char *prepare_js_script(const char *src_path, const char *min_path) {
+  File f = SD_MMC.open(src_path);
+  if(!f) return src_path;
+  String src = f.readString();
+  f.close();
+
+  File m = SD_MMC.open(min_path);
+  if(m) {
+    char head[JS_MINIFY_HEADER_MAX];
+    size_t hl = m.read((uint8_t *)head, sizeof(head));
+    m.close();
+    if(js_minify_is_current(head, hl, src.c_str(), src.length())) return min_path;
+  }
+
+  size_t cap = src.length() + JS_MINIFY_HEADER_MAX + 1;
+  char *out = (char *)malloc(cap);
+  if(!out) return src_path;
+  size_t hl = js_minify_header(src.c_str(), src.length(), out, JS_MINIFY_HEADER_MAX);
+  js_minify_stats_t st;
+  uint32_t t0 = micros();
+  size_t n = js_minify(src.c_str(), src.length(), out + hl, cap - hl, &st);
+  uint32_t us = micros() - t0;
+  if(n == 0) {
+    Serial.printf("Minify: %s not minified (unterminated string/comment or unbalanced braces)\n", src_path);
+    free(out);
+    return src_path;
+  }
+
+  File w = SD_MMC.open(min_path, FILE_WRITE);
+  bool ok = w && w.write((const uint8_t *)out, hl + n) == hl + n;
+  if(w) w.close();
+  free(out);
+  if(!ok) {
+    Serial.printf("Minify: failed to write %s\n", min_path);
+    return src_path;
+  }
+  Serial.printf("Minify: %s %u -> %u bytes, %lu locals renamed, %lu constants inlined, %lu us\n",
+                min_path, (unsigned)st.in_len, (unsigned)(hl + n), (unsigned long)st.renamed,
+                (unsigned long)st.inlined, (unsigned long)us);
+  return min_path;
 }
 
 /******************************************************************************
  * G) Basic draw_label, draw_rect, show_image from SD
  ******************************************************************************/
-static jsval_t js_lvgl_draw_label(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<3) {
-    Serial.println("draw_label: expects text, x, y");
-    return js_mknull();
-  }
-  const char* labelText = js_str(js, args[0]);
-  int x = (int)js_getnum(args[1]);
-  int y = (int)js_getnum(args[2]);
-
+JS_BIND_FN(void, draw_label, const char *text, lv_coord_t x, lv_coord_t y) {
   lv_obj_t *label = lv_label_create(lv_scr_act());
-  if(labelText) lv_label_set_text(label, labelText);
+  lv_label_set_text(label, text);
   lv_obj_set_pos(label, x, y);
 
-  Serial.printf("draw_label: '%s' at (%d,%d)\n", labelText, x, y);
-  return js_mknull();
+  Serial.printf("draw_label: '%s' at (%d,%d)\n", text, x, y);
 }
 
 static jsval_t js_lvgl_draw_rect(struct js *js, jsval_t *args, int nargs) {
@@ -586,52 +1065,45 @@ static jsval_t js_lvgl_draw_rect(struct js *js, jsval_t *args, int nargs) {
   return js_mknull();
 }
 
-static jsval_t js_lvgl_show_image(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<3) {
-    Serial.println("show_image: expects path,x,y");
-    return js_mknull();
-  }
-  const char* rawPath = js_str(js, args[0]);
-  int x = (int)js_getnum(args[1]);
-  int y = (int)js_getnum(args[2]);
-
-  if(!rawPath) {
-    Serial.println("show_image: invalid path");
-    return js_mknull();
-  }
-  // Build "S:/filename"
-  String path(rawPath);
-  if(path.startsWith("\"") && path.endsWith("\"")) {
-    path = path.substring(1, path.length()-1);
-  }
-  String lvglPath = "S:" + path;
+// Show an SD image from memory, decoded once and shared between objects
+// (img_loader.h); if that fails, stream it through the 'S' driver as before
+static void set_img_src(lv_obj_t *img, const char *path) {
+  if(img_set_src(img, path)) return;
+  char lvglPath[256];  // LVGL copies file sources
+  snprintf(lvglPath, sizeof(lvglPath), "S:%s", path);
+  lv_img_set_src(img, lvglPath);
+}
 
+JS_BIND_FN(void, show_image, const char *path, lv_coord_t x, lv_coord_t y) {
   lv_obj_t *img = lv_img_create(lv_scr_act());
-  lv_img_set_src(img, lvglPath.c_str());
+  set_img_src(img, path);
   lv_obj_set_pos(img, x, y);
 
-  Serial.printf("show_image: '%s' at (%d,%d)\n", lvglPath.c_str(), x, y);
-  return js_mknull();
+  Serial.printf("show_image: '%s' at (%d,%d)\n", path, x, y);
 }
 
 /******************************************************************************
  * G2) create_image, rotate_obj, move_obj, animate_obj (Object Handle Approach)
  ******************************************************************************/
-static const int MAX_OBJECTS = 16;
-static lv_obj_t *g_lv_obj_map[MAX_OBJECTS] = { nullptr };
+// Handles come from the generational table in ui_queue.cpp; each stored
+// object releases its handle when LVGL deletes it (obj_delete, a deleted
+// parent, a cleaned screen), after which the handle no longer resolves.
+static void on_lv_obj_deleted(lv_event_t *e) {
+  ui_handle_release((int)(intptr_t)lv_event_get_user_data(e));
+}
 
+// Runs on the render task; the id was usually reserved by the Elk task
+// already and returned to the script (see UI_CREATE)
 static int store_lv_obj(lv_obj_t *obj) {
-  for(int i=0; i<MAX_OBJECTS; i++) {
-    if(!g_lv_obj_map[i]) {
-      g_lv_obj_map[i] = obj;
-      return i;
-    }
-  }
-  return -1; // No free slot
+  if(!obj) return -1;
+  int i = ui_handle_claim();
+  if(i < 0) return -1; // Table full
+  ui_handle_set(i, obj);
+  lv_obj_add_event_cb(obj, on_lv_obj_deleted, LV_EVENT_DELETE, (void *)(intptr_t)i);
+  return i;
 }
 static lv_obj_t* get_lv_obj(int handle) {
-  if(handle<0 || handle>=MAX_OBJECTS) return nullptr;
-  return g_lv_obj_map[handle];
+  return (lv_obj_t *)ui_handle_get(handle);
 }
 
 // Helper functions to extract RGB components from lv_color_t
@@ -648,80 +1120,19 @@ uint8_t get_blue(lv_color_t color) {
 }
 
 // create_image("/messi.png", x,y) => returns handle
-static jsval_t js_create_image(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<3) {
-    Serial.println("create_image: expects path,x,y");
-    return js_mknum(-1);
-  }
-  const char* rawPath = js_str(js, args[0]);
-  int x = (int)js_getnum(args[1]);
-  int y = (int)js_getnum(args[2]);
-  if(!rawPath) return js_mknum(-1);
-
-  String path(rawPath);
-  if(path.startsWith("\"") && path.endsWith("\"")) {
-    path = path.substring(1, path.length()-1);
-  }
-  String fullPath = "S:" + path;
-
+JS_BIND_FN(lv_obj_t *, create_image, const char *path, lv_coord_t x, lv_coord_t y) {
   lv_obj_t *img = lv_img_create(lv_scr_act());
-  lv_img_set_src(img, fullPath.c_str());
+  set_img_src(img, path);
   lv_obj_set_pos(img, x, y);
 
-  int handle = store_lv_obj(img);
-  Serial.printf("create_image: '%s' => handle %d\n", fullPath.c_str(), handle);
-  return js_mknum(handle);
+  Serial.printf("create_image: '%s' at (%d,%d)\n", path, x, y);
+  return img;
 }
 
-// create_image_from_ram("/somefile.bin", x, y)
-static jsval_t js_create_image_from_ram(struct js *js, jsval_t *args, int nargs) {
-  if (nargs < 3) {
-    Serial.println("create_image_from_ram: expects path, x, y");
-    return js_mknum(-1);
-  }
-
-  // 1) Parse arguments
-  const char *rawPath = js_str(js, args[0]);
-  int x = (int) js_getnum(args[1]);
-  int y = (int) js_getnum(args[2]);
-  if (!rawPath) return js_mknum(-1);
-
-  // 2) Find a free RamImage slot
-  int slot = -1;
-  for (int i = 0; i < MAX_RAM_IMAGES; i++) {
-    if (!g_ram_images[i].used) { slot = i; break; }
-  }
-  if (slot < 0) {
-    Serial.println("No free RamImage slots!");
-    return js_mknum(-1);
-  }
-  RamImage *ri = &g_ram_images[slot];
-
-  // 3) Strip quotes
-  String path = String(rawPath);
-  if (path.startsWith("\"") && path.endsWith("\"")) {
-    path = path.substring(1, path.length() - 1);
-  }
-
-  // 4) Actually load the file into the RamImage
-  if (!load_image_file_into_ram(path.c_str(), ri)) {
-    Serial.println("Could not load image into RAM");
-    return js_mknum(-1);
-  }
-
-  // 5) Create the LVGL object
-  lv_obj_t *img = lv_img_create(lv_scr_act());
-  // 6) lv_img_set_src with the in-RAM descriptor
-  lv_img_set_src(img, &ri->dsc);  // <--- the magic
-
-  // 7) Set position
-  lv_obj_set_pos(img, x, y);
-
-  // 8) Store it in our handle-based system
-  int handle = store_lv_obj(img);
-  Serial.printf("create_image_from_ram: '%s' => ram slot=%d => handle %d\n",
-                path.c_str(), slot, handle);
-  return js_mknum(handle);
+// create_image_from_ram("/somefile.bin", x, y): create_image always loads
+// into RAM now; kept for existing scripts
+JS_BIND_FN(lv_obj_t *, create_image_from_ram, const char *path, lv_coord_t x, lv_coord_t y) {
+  return create_image(path, x, y);
 }
 
 // rotate_obj(handle, angle)
@@ -829,6 +1240,62 @@ static lv_style_t* get_lv_style(int handle) {
   return g_style_map[handle];
 }
 
+// Typed-bridge conversions (js_bind.h) for object/style handles and colours
+template<>
+struct js_arg<lv_obj_t *> {
+  static const char *what() { return "object handle"; }
+  static bool get(struct js *js, jsval_t v, lv_obj_t *&out) {
+    if(js_type(v) != JS_NUM) return false;
+    out = get_lv_obj((int)js_getnum(v));
+    return out != nullptr;
+  }
+};
+
+template<>
+struct js_arg<lv_style_t *> {
+  static const char *what() { return "style handle"; }
+  static bool get(struct js *js, jsval_t v, lv_style_t *&out) {
+    if(js_type(v) != JS_NUM) return false;
+    out = get_lv_style((int)js_getnum(v));
+    return out != nullptr;
+  }
+};
+
+// Colours are 0xRRGGBB numbers
+template<>
+struct js_arg<lv_color_t> {
+  static const char *what() { return "colour"; }
+  static bool get(struct js *js, jsval_t v, lv_color_t &out) {
+    if(js_type(v) != JS_NUM) return false;
+    out = lv_color_hex((uint32_t)js_getnum(v));
+    return true;
+  }
+};
+
+// Button icons (LV_SYMBOL_... or text) are optional: null, undefined or ""
+// pass NULL to LVGL
+struct LvIcon { const char *src; };
+
+template<>
+struct js_arg<LvIcon> {
+  static const char *what() { return "icon string or null"; }
+  static bool get(struct js *js, jsval_t v, LvIcon &out) {
+    out.src = NULL;
+    if(js_type(v) == JS_NULL || js_type(v) == JS_UNDEF) return true;
+    if(!js_arg<const char *>::get(js, v, out.src)) return false;
+    if(!out.src[0]) out.src = NULL;
+    return true;
+  }
+};
+
+// Returning an object stores it and hands the script its handle
+template<>
+struct js_ret<lv_obj_t *> {
+  static jsval_t make(struct js *js, lv_obj_t *obj) {
+    return js_mknum(obj ? store_lv_obj(obj) : -1);
+  }
+};
+
 // create_style()
 static jsval_t js_create_style(struct js *js, jsval_t *args, int nargs) {
   for(int i=0; i<MAX_STYLES; i++) {
@@ -845,1141 +1312,806 @@ static jsval_t js_create_style(struct js *js, jsval_t *args, int nargs) {
 }
 
 // obj_add_style(objHandle, styleHandle, partOrState)
-static jsval_t js_obj_add_style(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int objHandle   = (int)js_getnum(args[0]);
-  int styleHandle = (int)js_getnum(args[1]);
-  int partState   = 0;
-  if(nargs>=3) partState = (int)js_getnum(args[2]);
-
-  lv_obj_t* obj    = get_lv_obj(objHandle);
-  lv_style_t* st   = get_lv_style(styleHandle);
-  if(!obj || !st) {
-    Serial.println("obj_add_style => invalid handle");
-    return js_mknull();
-  }
-  lv_obj_add_style(obj, st, partState);
-  return js_mknull();
+JS_BIND_FN(void, obj_add_style, lv_obj_t *obj, lv_style_t *st, lv_style_selector_t selector) {
+  lv_obj_add_style(obj, st, selector);
 }
 
 // ***Full style property setters***
-static jsval_t js_style_set_radius(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int radius = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_radius(st, (lv_coord_t)radius);
-  return js_mknull();
-}
-
-static jsval_t js_style_set_bg_opa(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int opaVal = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_bg_opa(st, (lv_opa_t)opaVal);
-  return js_mknull();
-}
-
-static jsval_t js_style_set_bg_color(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH   = (int)js_getnum(args[0]);
-  double color = js_getnum(args[1]); // numeric hex
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_bg_color(st, lv_color_hex((uint32_t)color));
-  return js_mknull();
-}
-
-static jsval_t js_style_set_border_color(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH    = (int)js_getnum(args[0]);
-  double color  = js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_border_color(st, lv_color_hex((uint32_t)color));
-  return js_mknull();
-}
-
-static jsval_t js_style_set_border_width(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int bw     = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_border_width(st, bw);
-  return js_mknull();
-}
-
-static jsval_t js_style_set_border_opa(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int opa    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_border_opa(st, (lv_opa_t)opa);
-  return js_mknull();
-}
+// style_set_<prop>(styleHandle, value); colours are 0xRRGGBB
+#define STYLE_SETTER(prop, type)                                \
+  JS_BIND_FN(void, style_set_##prop, lv_style_t *st, type v) {  \
+    lv_style_set_##prop(st, v);                                 \
+  }
 
-static jsval_t js_style_set_border_side(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int side   = (int)js_getnum(args[1]); // e.g. LV_BORDER_SIDE_BOTTOM|LV_BORDER_SIDE_RIGHT
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_border_side(st, side);
-  return js_mknull();
-}
+STYLE_SETTER(radius, lv_coord_t)
+STYLE_SETTER(bg_opa, lv_opa_t)
+STYLE_SETTER(bg_color, lv_color_t)
+STYLE_SETTER(border_color, lv_color_t)
+STYLE_SETTER(border_width, lv_coord_t)
+STYLE_SETTER(border_opa, lv_opa_t)
+STYLE_SETTER(border_side, lv_border_side_t)
 
 // Outline
-static jsval_t js_style_set_outline_width(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int w      = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_outline_width(st, w);
-  return js_mknull();
-}
-
-static jsval_t js_style_set_outline_color(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH  = (int)js_getnum(args[0]);
-  double col  = js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_outline_color(st, lv_color_hex((uint32_t)col));
-  return js_mknull();
-}
-
-static jsval_t js_style_set_outline_pad(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int pad    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_outline_pad(st, pad);
-  return js_mknull();
-}
+STYLE_SETTER(outline_width, lv_coord_t)
+STYLE_SETTER(outline_color, lv_color_t)
+STYLE_SETTER(outline_pad, lv_coord_t)
 
 // Shadow
-static jsval_t js_style_set_shadow_width(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int w      = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_shadow_width(st, w);
-  return js_mknull();
-}
-
-static jsval_t js_style_set_shadow_color(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH   = (int)js_getnum(args[0]);
-  double color = js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_shadow_color(st, lv_color_hex((uint32_t)color));
-  return js_mknull();
-}
-
-static jsval_t js_style_set_shadow_ofs_x(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int ofs    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_shadow_ofs_x(st, ofs);
-  return js_mknull();
-}
+STYLE_SETTER(shadow_width, lv_coord_t)
+STYLE_SETTER(shadow_color, lv_color_t)
+STYLE_SETTER(shadow_ofs_x, lv_coord_t)
+STYLE_SETTER(shadow_ofs_y, lv_coord_t)
 
-static jsval_t js_style_set_shadow_ofs_y(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int ofs    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_shadow_ofs_y(st, ofs);
-  return js_mknull();
-}
-
-// Image recolor, transform
-static jsval_t js_style_set_img_recolor(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH   = (int)js_getnum(args[0]);
-  double color = js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_img_recolor(st, lv_color_hex((uint32_t)color));
-  return js_mknull();
-}
-
-static jsval_t js_style_set_img_recolor_opa(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int opa    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_img_recolor_opa(st, (lv_opa_t)opa);
-  return js_mknull();
-}
-
-static jsval_t js_style_set_transform_angle(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int angle  = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_transform_angle(st, (lv_coord_t)angle);
-  return js_mknull();
-}
+// Image
+STYLE_SETTER(img_recolor, lv_color_t)
+STYLE_SETTER(img_recolor_opa, lv_opa_t)
+STYLE_SETTER(transform_angle, lv_coord_t)
 
 // Text
-static jsval_t js_style_set_text_color(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH   = (int)js_getnum(args[0]);
-  double color = js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_text_color(st, lv_color_hex((uint32_t)color));
-  return js_mknull();
-}
-
-static jsval_t js_style_set_text_letter_space(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int space  = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_text_letter_space(st, space);
-  return js_mknull();
-}
-
-static jsval_t js_style_set_text_line_space(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int space  = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_text_line_space(st, space);
-  return js_mknull();
-}
-
-static jsval_t js_style_set_text_decor(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int decor  = (int)js_getnum(args[1]); // e.g. LV_TEXT_DECOR_UNDERLINE
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_text_decor(st, decor);
-  return js_mknull();
-}
+STYLE_SETTER(text_color, lv_color_t)
+STYLE_SETTER(text_letter_space, lv_coord_t)
+STYLE_SETTER(text_line_space, lv_coord_t)
+STYLE_SETTER(text_decor, lv_text_decor_t)
 
 // Line
-static jsval_t js_style_set_line_color(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH   = (int)js_getnum(args[0]);
-  double color = js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_line_color(st, lv_color_hex((uint32_t)color));
-  return js_mknull();
-}
-
-static jsval_t js_style_set_line_width(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int w      = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_line_width(st, w);
-  return js_mknull();
-}
-
-static jsval_t js_style_set_line_rounded(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH  = (int)js_getnum(args[0]);
-  bool round  = (bool)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_line_rounded(st, round);
-  return js_mknull();
-}
+STYLE_SETTER(line_color, lv_color_t)
+STYLE_SETTER(line_width, lv_coord_t)
+STYLE_SETTER(line_rounded, bool)
 
 // Padding
-static jsval_t js_style_set_pad_all(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int pad    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_pad_all(st, pad);
-  return js_mknull();
-}
+STYLE_SETTER(pad_all, lv_coord_t)
+STYLE_SETTER(pad_left, lv_coord_t)
+STYLE_SETTER(pad_right, lv_coord_t)
+STYLE_SETTER(pad_top, lv_coord_t)
+STYLE_SETTER(pad_bottom, lv_coord_t)
+STYLE_SETTER(pad_ver, lv_coord_t)
+STYLE_SETTER(pad_hor, lv_coord_t)
+
+// Size and position
+STYLE_SETTER(width, lv_coord_t)
+STYLE_SETTER(height, lv_coord_t)
+STYLE_SETTER(x, lv_coord_t)
+STYLE_SETTER(y, lv_coord_t)
+
+#undef STYLE_SETTER
 
-static jsval_t js_style_set_pad_left(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int pad    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_pad_left(st, pad);
-  return js_mknull();
+/******************************************************************************
+ * H2) Additional object property functions
+ ******************************************************************************/
+// obj_delete(h): deletes the object and its children; their handles go stale
+JS_BIND_FN(void, obj_delete, lv_obj_t *obj) {
+  lv_obj_del(obj);
 }
 
-static jsval_t js_style_set_pad_right(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int pad    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_pad_right(st, pad);
-  return js_mknull();
+JS_BIND_FN(void, obj_set_size, lv_obj_t *obj, lv_coord_t w, lv_coord_t h) {
+  lv_obj_set_size(obj, w, h);
 }
 
-static jsval_t js_style_set_pad_top(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int pad    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_pad_top(st, pad);
-  return js_mknull();
+// obj_align(objHandle, alignConst, xOfs, yOfs)
+JS_BIND_FN(void, obj_align, lv_obj_t *obj, lv_align_t align, lv_coord_t x_ofs, lv_coord_t y_ofs) {
+  lv_obj_align(obj, align, x_ofs, y_ofs);
 }
 
-static jsval_t js_style_set_pad_bottom(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int pad    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_pad_bottom(st, pad);
-  return js_mknull();
+/******************************************************************************
+ * ***ADDED FOR NEW EXAMPLES***
+ * For scrolling, flex, flags, etc.
+ ******************************************************************************/
+JS_BIND_FN(void, obj_set_scroll_snap_x, lv_obj_t *obj, lv_scroll_snap_t snap) {
+  lv_obj_set_scroll_snap_x(obj, snap);
 }
 
-static jsval_t js_style_set_pad_ver(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int pad    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_pad_ver(st, pad);
-  return js_mknull();
+JS_BIND_FN(void, obj_set_scroll_snap_y, lv_obj_t *obj, lv_scroll_snap_t snap) {
+  lv_obj_set_scroll_snap_y(obj, snap);
 }
 
-static jsval_t js_style_set_pad_hor(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int pad    = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_pad_hor(st, pad);
-  return js_mknull();
+JS_BIND_FN(void, obj_add_flag, lv_obj_t *obj, uint32_t flag) {
+  lv_obj_add_flag(obj, (lv_obj_flag_t)flag);
 }
 
-// Some dimension-related style props
-static jsval_t js_style_set_width(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int w      = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_width(st, (lv_coord_t)w);
-  return js_mknull();
+JS_BIND_FN(void, obj_clear_flag, lv_obj_t *obj, uint32_t flag) {
+  lv_obj_clear_flag(obj, (lv_obj_flag_t)flag);
 }
 
-static jsval_t js_style_set_height(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH = (int)js_getnum(args[0]);
-  int h      = (int)js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_height(st, (lv_coord_t)h);
-  return js_mknull();
+JS_BIND_FN(void, obj_set_scroll_dir, lv_obj_t *obj, lv_dir_t dir) {
+  lv_obj_set_scroll_dir(obj, dir);
 }
 
-static jsval_t js_style_set_x(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH  = (int)js_getnum(args[0]);
-  double val  = js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_x(st, (lv_coord_t)val);
-  return js_mknull();
+JS_BIND_FN(void, obj_set_scrollbar_mode, lv_obj_t *obj, lv_scrollbar_mode_t mode) {
+  lv_obj_set_scrollbar_mode(obj, mode);
 }
 
-static jsval_t js_style_set_y(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int styleH  = (int)js_getnum(args[0]);
-  double val  = js_getnum(args[1]);
-  lv_style_t *st = get_lv_style(styleH);
-  if(!st) return js_mknull();
-  lv_style_set_y(st, (lv_coord_t)val);
-  return js_mknull();
+JS_BIND_FN(void, obj_set_flex_flow, lv_obj_t *obj, lv_flex_flow_t flow) {
+  lv_obj_set_flex_flow(obj, flow);
 }
 
-/******************************************************************************
- * H2) Additional object property functions
- ******************************************************************************/
-static jsval_t js_obj_set_size(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<3) return js_mknull();
-  int handle = (int)js_getnum(args[0]);
-  int w      = (int)js_getnum(args[1]);
-  int h      = (int)js_getnum(args[2]);
-
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) {
-    Serial.printf("obj_set_size => invalid handle %d\n", handle);
-    return js_mknull();
-  }
-  lv_obj_set_size(obj, w, h);
-  return js_mknull();
-}
-
-// obj_align(objHandle, alignConst, xOfs, yOfs)
-static jsval_t js_obj_align(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<4) return js_mknull();
-  int handle   = (int)js_getnum(args[0]);
-  int alignVal = (int)js_getnum(args[1]);
-  int xOfs     = (int)js_getnum(args[2]);
-  int yOfs     = (int)js_getnum(args[3]);
-
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) {
-    Serial.printf("obj_align => invalid handle %d\n", handle);
-    return js_mknull();
-  }
-  lv_obj_align(obj, (lv_align_t)alignVal, xOfs, yOfs);
-  return js_mknull();
+JS_BIND_FN(void, obj_set_flex_align, lv_obj_t *obj, lv_flex_align_t main_place, lv_flex_align_t cross_place,
+                            lv_flex_align_t track_place) {
+  lv_obj_set_flex_align(obj, main_place, cross_place, track_place);
 }
 
-/******************************************************************************
- * ***ADDED FOR NEW EXAMPLES***
- * For scrolling, flex, flags, etc.
- ******************************************************************************/
-static jsval_t js_obj_set_scroll_snap_x(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int handle     = (int)js_getnum(args[0]);
-  int snap_mode  = (int)js_getnum(args[1]); // numeric for LV_SCROLL_SNAP_x
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_set_scroll_snap_x(obj, (lv_scroll_snap_t)snap_mode);
-  return js_mknull();
-}
-
-static jsval_t js_obj_set_scroll_snap_y(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int handle     = (int)js_getnum(args[0]);
-  int snap_mode  = (int)js_getnum(args[1]);
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_set_scroll_snap_y(obj, (lv_scroll_snap_t)snap_mode);
-  return js_mknull();
+JS_BIND_FN(void, obj_set_style_clip_corner, lv_obj_t *obj, bool en, lv_style_selector_t part) {
+  lv_obj_set_style_clip_corner(obj, en, part);
 }
 
-static jsval_t js_obj_add_flag(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int handle = (int)js_getnum(args[0]);
-  int flag   = (int)js_getnum(args[1]);
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_add_flag(obj, (lv_obj_flag_t)flag);
-  return js_mknull();
+JS_BIND_FN(void, obj_set_style_base_dir, lv_obj_t *obj, lv_base_dir_t base_dir, lv_style_selector_t part) {
+  lv_obj_set_style_base_dir(obj, base_dir, part);
 }
 
-static jsval_t js_obj_clear_flag(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int handle = (int)js_getnum(args[0]);
-  int flag   = (int)js_getnum(args[1]);
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_clear_flag(obj, (lv_obj_flag_t)flag);
-  return js_mknull();
+// gif_create("/anim.gif", x, y) => handle; GIFs showing the same file share
+// one PSRAM buffer, freed with the last of them
+JS_BIND_FN(lv_obj_t *, gif_create, const char *path, lv_coord_t x, lv_coord_t y) {
+  lv_obj_t *gif = create_gif(path);
+  if(gif) lv_obj_set_pos(gif, x, y);
+  return gif;
 }
 
-static jsval_t js_obj_set_scroll_dir(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int handle = (int)js_getnum(args[0]);
-  int dir    = (int)js_getnum(args[1]); // e.g. LV_DIR_VER or ...
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_set_scroll_dir(obj, (lv_dir_t)dir);
-  return js_mknull();
-}
+/*******************************************************
+ * SUB-OBJECT REGISTRIES (chart series, meter scales and indicators, spans)
+ *******************************************************/
+// LVGL hands out raw pointers for these and frees them with their parent.
+// Scripts get small per-parent ids instead (0, 1, 2... in creation order),
+// kept in a table hung off the chart's/meter's/spangroup's user_data and
+// freed with it.
+// An id is only resolved against its own parent and only as its own kind,
+// so a typo or a leftover id is reported instead of dereferenced.
+#define LV_SUB_MAX 16
+enum { LV_SUB_SERIES, LV_SUB_SCALE, LV_SUB_INDICATOR, LV_SUB_SPAN };
+static const char *const g_lv_sub_kinds[] = { "series", "scale", "indicator", "span" };
+
+struct LvSubTable {
+  uint8_t n;
+  uint8_t kind[LV_SUB_MAX];
+  void   *item[LV_SUB_MAX];
+  char   *owned[LV_SUB_MAX];  // copies LVGL keeps pointing at (needle image paths, static span texts)
+};
 
-static jsval_t js_obj_set_scrollbar_mode(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int handle = (int)js_getnum(args[0]);
-  int mode   = (int)js_getnum(args[1]); // e.g. LV_SCROLLBAR_MODE_OFF
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_set_scrollbar_mode(obj, (lv_scrollbar_mode_t)mode);
-  return js_mknull();
+static void on_lv_sub_parent_deleted(lv_event_t *e) {
+  LvSubTable *t = (LvSubTable *)lv_event_get_user_data(e);
+  for(int i = 0; i < t->n; i++) free(t->owned[i]);
+  delete t;
 }
 
-static jsval_t js_obj_set_flex_flow(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mknull();
-  int handle   = (int)js_getnum(args[0]);
-  int flowEnum = (int)js_getnum(args[1]); // e.g. LV_FLEX_FLOW_ROW_WRAP
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_set_flex_flow(obj, (lv_flex_flow_t)flowEnum);
-  return js_mknull();
+// Table with room for one more entry, created on first use
+static LvSubTable *lv_sub_room(lv_obj_t *parent, const char *fn) {
+  LvSubTable *t = (LvSubTable *)lv_obj_get_user_data(parent);
+  if(!t) {
+    t = new LvSubTable();
+    lv_obj_set_user_data(parent, t);
+    lv_obj_add_event_cb(parent, on_lv_sub_parent_deleted, LV_EVENT_DELETE, t);
+  }
+  if(t->n >= LV_SUB_MAX) {
+    Serial.printf("%s: at most %d series/scales/indicators/spans per object\n", fn, LV_SUB_MAX);
+    return NULL;
+  }
+  return t;
 }
 
-static jsval_t js_obj_set_flex_align(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<4) return js_mknull();
-  int handle     = (int)js_getnum(args[0]);
-  int main_place = (int)js_getnum(args[1]);
-  int cross_place= (int)js_getnum(args[2]);
-  int track_place= (int)js_getnum(args[3]);
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_set_flex_align(obj, (lv_flex_align_t)main_place,
-                             (lv_flex_align_t)cross_place,
-                             (lv_flex_align_t)track_place);
-  return js_mknull();
+static int lv_sub_add(LvSubTable *t, uint8_t kind, void *item, char *owned = NULL) {
+  if(!item) {
+    free(owned);
+    return -1;
+  }
+  t->kind[t->n] = kind;
+  t->item[t->n] = item;
+  t->owned[t->n] = owned;
+  return t->n++;
 }
 
-static jsval_t js_obj_set_style_clip_corner(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<3) return js_mknull();
-  int handle  = (int)js_getnum(args[0]);
-  bool en     = (bool)js_getnum(args[1]);
-  int part    = (int)js_getnum(args[2]);
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_set_style_clip_corner(obj, en, part);
-  return js_mknull();
+static void *lv_sub_find(lv_obj_t *parent, uint8_t kind, int id) {
+  LvSubTable *t = (LvSubTable *)lv_obj_get_user_data(parent);
+  if(!t || id < 0 || id >= t->n || t->kind[id] != kind) return NULL;
+  return t->item[id];
 }
 
-static jsval_t js_obj_set_style_base_dir(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<3) return js_mknull();
-  int handle   = (int)js_getnum(args[0]);
-  int base_dir = (int)js_getnum(args[1]); // e.g. LV_BASE_DIR_RTL
-  int part     = (int)js_getnum(args[2]);
-  lv_obj_t *obj = get_lv_obj(handle);
-  if(!obj) return js_mknull();
-  lv_obj_set_style_base_dir(obj, (lv_base_dir_t)base_dir, part);
-  return js_mknull();
+static void *lv_sub_get(lv_obj_t *parent, uint8_t kind, int id, const char *fn) {
+  void *item = lv_sub_find(parent, kind, id);
+  if(!item) Serial.printf("%s: no %s %d\n", fn, g_lv_sub_kinds[kind], id);
+  return item;
 }
 
+// Typed-bridge arguments that must be a chart / meter handle
+struct LvChart { lv_obj_t *obj; };
+struct LvMeter { lv_obj_t *obj; };
+
+template<typename W, const lv_obj_class_t *Cls>
+struct js_arg_class {
+  static bool get(struct js *js, jsval_t v, W &out) {
+    return js_arg<lv_obj_t *>::get(js, v, out.obj) && lv_obj_check_type(out.obj, Cls);
+  }
+};
+template<>
+struct js_arg<LvChart> : js_arg_class<LvChart, &lv_chart_class> {
+  static const char *what() { return "chart handle"; }
+};
+template<>
+struct js_arg<LvMeter> : js_arg_class<LvMeter, &lv_meter_class> {
+  static const char *what() { return "meter handle"; }
+};
+
 /*******************************************************
  * CHART BRIDGING
  *******************************************************/
-
-static jsval_t js_lv_chart_create(struct js *js, jsval_t *args, int nargs) {
-    // Creates a chart object on the current screen
+// chart_create() => handle of a 200x150 chart centred on the screen
+JS_BIND_FN(lv_obj_t *, chart_create) {
     lv_obj_t *chart = lv_chart_create(lv_scr_act());
-    // Optionally set default size or alignment
     lv_obj_set_size(chart, 200, 150);
     lv_obj_center(chart);
+    return chart;
+}
 
-    // Store in your handle-based system
-    int handle = store_lv_obj(chart);
-    Serial.printf("lv_chart_create => handle %d\n", handle);
-
-    // Return handle to JS
-    return js_mknum(handle);
+JS_BIND_FN(void, chart_set_type, LvChart c, lv_chart_type_t type) {
+    lv_chart_set_type(c.obj, type);
 }
 
-static jsval_t js_lv_chart_set_type(struct js *js, jsval_t *args, int nargs) {
-    // (handle, lv_chart_type int)
-    if(nargs < 2) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    int t = (int)js_getnum(args[1]); // e.g. LV_CHART_TYPE_LINE, LV_CHART_TYPE_BAR, etc.
+JS_BIND_FN(void, chart_set_div_line_count, LvChart c, uint8_t y_div, uint8_t x_div) {
+    lv_chart_set_div_line_count(c.obj, y_div, x_div);
+}
 
-    lv_obj_t *obj = get_lv_obj(h);
-    if(!obj) return js_mknull();
+JS_BIND_FN(void, chart_set_update_mode, LvChart c, lv_chart_update_mode_t mode) {
+    lv_chart_set_update_mode(c.obj, mode);
+}
 
-    lv_chart_set_type(obj, (lv_chart_type_t)t);
-    return js_mknull();
+JS_BIND_FN(void, chart_set_range, LvChart c, lv_chart_axis_t axis, lv_coord_t min, lv_coord_t max) {
+    lv_chart_set_range(c.obj, axis, min, max);
 }
 
-static jsval_t js_lv_chart_set_div_line_count(struct js *js, jsval_t *args, int nargs) {
-    // (handle, y_div, x_div)
-    if(nargs < 3) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    int y_div = (int)js_getnum(args[1]);
-    int x_div = (int)js_getnum(args[2]);
+JS_BIND_FN(void, chart_set_point_count, LvChart c, uint16_t count) {
+    lv_chart_set_point_count(c.obj, count);
+}
 
-    lv_obj_t *obj = get_lv_obj(h);
-    if(!obj) return js_mknull();
+JS_BIND_FN(void, chart_refresh, LvChart c) {
+    lv_chart_refresh(c.obj);
+}
 
-    lv_chart_set_div_line_count(obj, y_div, x_div);
-    return js_mknull();
+// chart_add_series(chart, color, axis) => series id (0, 1, ... per chart), -1 on failure
+JS_BIND_FN(int, chart_add_series, LvChart c, lv_color_t color, lv_chart_axis_t axis) {
+    LvSubTable *t = lv_sub_room(c.obj, "chart_add_series");
+    if(!t) return -1;
+    return lv_sub_add(t, LV_SUB_SERIES, lv_chart_add_series(c.obj, color, axis));
 }
 
-static jsval_t js_lv_chart_set_update_mode(struct js *js, jsval_t *args, int nargs) {
-    // (handle, mode)
-    // e.g. mode = LV_CHART_UPDATE_MODE_SHIFT, LV_CHART_UPDATE_MODE_CIRCULAR
-    if(nargs < 2) return js_mknull();
-    int h    = (int)js_getnum(args[0]);
-    int mode = (int)js_getnum(args[1]);
+JS_BIND_FN(void, chart_set_next_value, LvChart c, int ser, lv_coord_t value) {
+    void *s = lv_sub_get(c.obj, LV_SUB_SERIES, ser, "chart_set_next_value");
+    if(s) lv_chart_set_next_value(c.obj, (lv_chart_series_t *)s, value);
+}
 
-    lv_obj_t *obj = get_lv_obj(h);
-    if(!obj) return js_mknull();
+JS_BIND_FN(void, chart_set_next_value2, LvChart c, int ser, lv_coord_t x, lv_coord_t y) {
+    void *s = lv_sub_get(c.obj, LV_SUB_SERIES, ser, "chart_set_next_value2");
+    if(s) lv_chart_set_next_value2(c.obj, (lv_chart_series_t *)s, x, y);
+}
 
-    lv_chart_set_update_mode(obj, (lv_chart_update_mode_t)mode);
+// chart_set_next_values(chart, v0, v1, ...): next value of series 0, 1, ...
+// in one command; a non-number skips that series. Up to UI_MAX_ARGS - 1
+// values: the UI queue rejects longer calls, and values past the last
+// series are reported and dropped.
+static jsval_t js_chart_set_next_values(struct js *js, jsval_t *args, int nargs) {
+    LvChart c;
+    if(nargs < 2 || !js_arg<LvChart>::get(js, args[0], c)) {
+        Serial.println("chart_set_next_values: expects chart, values...");
+        return js_mknull();
+    }
+    for(int i = 1; i < nargs; i++) {
+        if(js_type(args[i]) != JS_NUM) continue;
+        void *s = lv_sub_get(c.obj, LV_SUB_SERIES, i - 1, "chart_set_next_values");
+        if(!s) break;
+        lv_chart_set_next_value(c.obj, (lv_chart_series_t *)s, (lv_coord_t)js_getnum(args[i]));
+    }
     return js_mknull();
 }
 
-static jsval_t js_lv_chart_set_range(struct js *js, jsval_t *args, int nargs) {
-    // (handle, axis, min, max)
-    // e.g. axis=LV_CHART_AXIS_PRIMARY_Y, min=0, max=100
-    if(nargs < 4) return js_mknull();
-    int h    = (int)js_getnum(args[0]);
-    int axis = (int)js_getnum(args[1]);
-    int mn   = (int)js_getnum(args[2]);
-    int mx   = (int)js_getnum(args[3]);
+JS_BIND_FN(void, chart_set_axis_tick, LvChart c, lv_chart_axis_t axis, lv_coord_t major_len,
+           lv_coord_t minor_len, lv_coord_t major_cnt, lv_coord_t minor_cnt, bool label_en,
+           lv_coord_t draw_size) {
+    lv_chart_set_axis_tick(c.obj, axis, major_len, minor_len, major_cnt, minor_cnt, label_en, draw_size);
+}
 
-    lv_obj_t *obj = get_lv_obj(h);
-    if(!obj) return js_mknull();
+JS_BIND_FN(void, chart_set_zoom_x, LvChart c, uint16_t zoom) {
+    lv_chart_set_zoom_x(c.obj, zoom);
+}
 
-    lv_chart_set_range(obj, (lv_chart_axis_t)axis, mn, mx);
-    return js_mknull();
+JS_BIND_FN(void, chart_set_zoom_y, LvChart c, uint16_t zoom) {
+    lv_chart_set_zoom_y(c.obj, zoom);
 }
 
-static jsval_t js_lv_chart_set_point_count(struct js *js, jsval_t *args, int nargs) {
-    // (handle, count)
-    if(nargs < 2) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    int c = (int)js_getnum(args[1]);
+// chart_get_value(chart, series, index) => y value of that point, null if out of range
+// (replaces chart_get_y_array, which handed the script a raw pointer)
+static jsval_t js_chart_get_value(struct js *js, jsval_t *args, int nargs) {
+    LvChart c;
+    if(nargs < 3 || !js_arg<LvChart>::get(js, args[0], c)) return js_mknull();
+    void *s = lv_sub_get(c.obj, LV_SUB_SERIES, (int)js_getnum(args[1]), "chart_get_value");
+    int i = (int)js_getnum(args[2]);
+    if(!s || i < 0 || i >= (int)lv_chart_get_point_count(c.obj)) return js_mknull();
+    return js_mknum(lv_chart_get_y_array(c.obj, (lv_chart_series_t *)s)[i]);
+}
 
-    lv_obj_t *obj = get_lv_obj(h);
-    if(!obj) return js_mknull();
 
-    lv_chart_set_point_count(obj, c);
-    return js_mknull();
+/*******************************************************
+ * BULK CHART DATA
+ *******************************************************/
+// Samples for a series come from a data buffer (a number, see data_ring.h)
+// or a string of numbers. Either way they are written straight into the
+// series' y array and the chart is invalidated once per call. Strings travel
+// through the UI queue's scratch arena, so keep them to a few KB; longer
+// histories go into a data buffer first (data_load_csv, data_push).
+
+// Chart value of a sample; NAN is a gap
+static lv_coord_t chart_coord(float v) {
+    if(isnan(v)) return LV_CHART_POINT_NONE;
+    if(v < -32768.0f) return -32768;
+    if(v > 32766.0f) return 32766;  // 32767 is LV_CHART_POINT_NONE
+    return (lv_coord_t)lroundf(v);
+}
+
+static float *chart_tmp_alloc(size_t n) {
+    float *p = (float *)heap_caps_malloc(n * sizeof(float), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+    return p ? p : (float *)malloc(n * sizeof(float));
+}
+
+// Samples of `src` in a temporary array (free() it), NULL if there are none
+static float *chart_source(struct js *js, jsval_t src, size_t *n, const char *fn) {
+    float *v = NULL;
+    *n = 0;
+    if(js_type(src) == JS_NUM) {
+        int id = (int)js_getnum(src);
+        uint32_t cnt = data_ring_count(id);
+        if(!data_ring_valid(id)) Serial.printf("%s: no data buffer %d\n", fn, id);
+        if(cnt && (v = chart_tmp_alloc(cnt))) *n = data_ring_copy(id, v, cnt);
+    } else if(js_type(src) == JS_STR) {
+        size_t len;
+        const char *s = js_getstr(js, src, &len);
+        size_t cap = len / 2 + 1;  // at least one separator per number
+        if((v = chart_tmp_alloc(cap))) *n = data_parse_numbers(s, len, v, cap);
+    } else {
+        Serial.printf("%s: expected a data buffer or a string of numbers\n", fn);
+    }
+    if(v && !*n) {
+        free(v);
+        v = NULL;
+    }
+    return v;
 }
 
-static jsval_t js_lv_chart_refresh(struct js *js, jsval_t *args, int nargs) {
-    // (handle)
-    if(nargs < 1) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-
-    lv_obj_t *obj = get_lv_obj(h);
-    if(!obj) return js_mknull();
+// chart_set_series_data(chart, series, src[, downsample]): replace the whole
+// series. Longer input is reduced to the chart's point count with LTTB
+// (downsample, default true) or cut to its newest points; shorter input is
+// right-aligned so later chart_set_next_value() calls continue it.
+static jsval_t js_chart_set_series_data(struct js *js, jsval_t *args, int nargs) {
+    LvChart c;
+    if(nargs < 3 || !js_arg<LvChart>::get(js, args[0], c) || js_type(args[1]) != JS_NUM) {
+        Serial.println("chart_set_series_data: expects chart, series, data[, downsample]");
+        return js_mknull();
+    }
+    lv_chart_series_t *ser = (lv_chart_series_t *)lv_sub_get(c.obj, LV_SUB_SERIES, (int)js_getnum(args[1]),
+                                                             "chart_set_series_data");
+    if(!ser) return js_mknull();
+    size_t n;
+    float *v = chart_source(js, args[2], &n, "chart_set_series_data");
+    if(!v) return js_mknull();
+
+    uint16_t cnt = lv_chart_get_point_count(c.obj);
+    bool downsample = nargs < 4 || js_truthy(js, args[3]);
+    const float *in = v;
+    if(n > cnt) {
+        if(downsample) n = data_lttb(v, n, v, cnt);  // LTTB output never overtakes its input
+        else in += n - cnt, n = cnt;
+    }
 
-    lv_chart_refresh(obj);
+    lv_coord_t *y = lv_chart_get_y_array(c.obj, ser);
+    uint16_t pad = cnt - n;
+    for(uint16_t i = 0; i < cnt; i++) y[i] = i < pad ? LV_CHART_POINT_NONE : chart_coord(in[i - pad]);
+    lv_chart_set_x_start_point(c.obj, ser, 0);
+    lv_chart_refresh(c.obj);
+    free(v);
     return js_mknull();
 }
 
-static jsval_t js_lv_chart_add_series(struct js *js, jsval_t *args, int nargs) {
-    // (handle, color, axis)
-    if(nargs < 3) return js_mknull();
-    int h     = (int)js_getnum(args[0]);
-    double col= js_getnum(args[1]);
-    int axis  = (int)js_getnum(args[2]);
+// chart_push_values(chart, series, src): append like repeated
+// chart_set_next_value() calls, with a single invalidation
+static jsval_t js_chart_push_values(struct js *js, jsval_t *args, int nargs) {
+    LvChart c;
+    if(nargs < 3 || !js_arg<LvChart>::get(js, args[0], c) || js_type(args[1]) != JS_NUM) {
+        Serial.println("chart_push_values: expects chart, series, data");
+        return js_mknull();
+    }
+    lv_chart_series_t *ser = (lv_chart_series_t *)lv_sub_get(c.obj, LV_SUB_SERIES, (int)js_getnum(args[1]),
+                                                             "chart_push_values");
+    if(!ser) return js_mknull();
+    size_t n;
+    float *v = chart_source(js, args[2], &n, "chart_push_values");
+    if(!v) return js_mknull();
+
+    uint16_t cnt = lv_chart_get_point_count(c.obj);
+    lv_coord_t *y = lv_chart_get_y_array(c.obj, ser);
+    uint16_t at = lv_chart_get_x_start_point(c.obj, ser);
+    size_t first = n > cnt ? n - cnt : 0;  // older ones would be overwritten in this call
+    for(size_t i = first; i < n; i++) {
+        y[at] = chart_coord(v[i]);
+        at = (at + 1) % cnt;
+    }
+    lv_chart_set_x_start_point(c.obj, ser, at);
+    lv_chart_refresh(c.obj);
+    free(v);
+    return js_mknull();
+}
 
-    lv_obj_t *obj = get_lv_obj(h);
-    if(!obj) return js_mknull();
+/*******************************************************
+ * STRIP CHART (see strip_chart.h)
+ *******************************************************/
+// For live values: scrolls its own bitmap and draws only the new column,
+// where a shift-mode chart redraws everything on every value.
+struct LvStrip { lv_obj_t *obj; };
+
+template<>
+struct js_arg<LvStrip> {
+    static const char *what() { return "strip chart handle"; }
+    static bool get(struct js *js, jsval_t v, LvStrip &out) {
+        return js_arg<lv_obj_t *>::get(js, v, out.obj) && strip_chart_check(out.obj);
+    }
+};
 
-    lv_chart_series_t *ser = lv_chart_add_series(obj, lv_color_hex((uint32_t)col), (lv_chart_axis_t)axis);
-    // Return the pointer as a number (NOT safe on 64-bit, but workable for small usage)
-    // Alternatively, you can store it in a separate map if you want handle-based approach for series.
-    intptr_t p = (intptr_t)(ser);
-    return js_mknum((double)p);
+// strip_chart_create(w, h) => handle
+JS_BIND_FN(lv_obj_t *, lv_strip_chart_create, lv_coord_t w, lv_coord_t h) {
+    return strip_chart_create(lv_scr_act(), w, h);
 }
 
-static jsval_t js_lv_chart_set_next_value(struct js *js, jsval_t *args, int nargs) {
-    // (chartHandle, seriesPtr, value)
-    if(nargs < 3) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    intptr_t sp = (intptr_t)js_getnum(args[1]);
-    int val = (int)js_getnum(args[2]);
-
-    lv_obj_t *chart = get_lv_obj(h);
-    if(!chart) return js_mknull();
+// strip_chart_add_series(strip, color) => series id, -1 when full
+JS_BIND_FN(int, lv_strip_chart_add_series, LvStrip s, lv_color_t color) {
+    return strip_chart_add_series(s.obj, color);
+}
 
-    lv_chart_series_t *ser = (lv_chart_series_t *)sp;
-    lv_chart_set_next_value(chart, ser, val);
-    return js_mknull();
+JS_BIND_FN(void, lv_strip_chart_set_range, LvStrip s, int32_t min, int32_t max) {
+    strip_chart_set_range(s.obj, min, max);
 }
 
-static jsval_t js_lv_chart_set_next_value2(struct js *js, jsval_t *args, int nargs) {
-    // (chartHandle, seriesPtr, xVal, yVal)
-    if(nargs < 4) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    intptr_t sp = (intptr_t)js_getnum(args[1]);
-    int xval = (int)js_getnum(args[2]);
-    int yval = (int)js_getnum(args[3]);
+// strip_chart_set_grid(strip, bg, grid_color, h_div, v_every): clears the chart
+JS_BIND_FN(void, lv_strip_chart_set_grid, LvStrip s, lv_color_t bg, lv_color_t grid, uint8_t h_div,
+           uint16_t v_every) {
+    strip_chart_set_grid(s.obj, bg, grid, h_div, v_every);
+}
 
-    lv_obj_t *chart = get_lv_obj(h);
-    if(!chart) return js_mknull();
+JS_BIND_FN(void, lv_strip_chart_set_step, LvStrip s, uint8_t px) {
+    strip_chart_set_step(s.obj, px);
+}
 
-    lv_chart_series_t *ser = (lv_chart_series_t *)sp;
-    lv_chart_set_next_value2(chart, ser, xval, yval);
+// strip_chart_push(strip, v0, v1, ...): one sample per series, scrolls one step.
+// At most STRIP_CHART_MAX_SERIES values; more are reported and dropped.
+static jsval_t js_strip_chart_push(struct js *js, jsval_t *args, int nargs) {
+    LvStrip s;
+    if(nargs < 2 || !js_arg<LvStrip>::get(js, args[0], s)) {
+        Serial.println("strip_chart_push: expects strip chart, values...");
+        return js_mknull();
+    }
+    if(nargs - 1 > STRIP_CHART_MAX_SERIES) {
+        Serial.printf("strip_chart_push: %d values, only %d series fit\n", nargs - 1, STRIP_CHART_MAX_SERIES);
+        nargs = STRIP_CHART_MAX_SERIES + 1;
+    }
+    int32_t v[STRIP_CHART_MAX_SERIES];
+    int n = 0;
+    for(int i = 1; i < nargs; i++) {
+        v[n++] = js_type(args[i]) == JS_NUM ? (int32_t)js_getnum(args[i]) : LV_CHART_POINT_NONE;
+    }
+    strip_chart_push(s.obj, v, n);
     return js_mknull();
 }
 
-static jsval_t js_lv_chart_set_axis_tick(struct js *js, jsval_t *args, int nargs) {
-    // (chartH, axis, majorLen, minorLen, majorCnt, minorCnt, label_en, draw_size)
-    if(nargs < 8) return js_mknull();
-    int h       = (int)js_getnum(args[0]);
-    int axis    = (int)js_getnum(args[1]);
-    int majorLen= (int)js_getnum(args[2]);
-    int minorLen= (int)js_getnum(args[3]);
-    int majorCnt= (int)js_getnum(args[4]);
-    int minorCnt= (int)js_getnum(args[5]);
-    bool label  = (bool)js_getnum(args[6]);
-    int drawSiz = (int)js_getnum(args[7]);
+/*******************************************************
+ * ANIMATION PLAYER (see anim_player.h)
+ *******************************************************/
+// Plays .wsa files made from GIFs by tools/gif2wsa; frames are pre-decoded,
+// so playback costs no LZW decoding at all.
+struct LvAnim { lv_obj_t *obj; };
+
+template<>
+struct js_arg<LvAnim> {
+    static const char *what() { return "animation handle"; }
+    static bool get(struct js *js, jsval_t v, LvAnim &out) {
+        return js_arg<lv_obj_t *>::get(js, v, out.obj) && anim_player_check(out.obj);
+    }
+};
 
-    lv_obj_t *chart = get_lv_obj(h);
-    if(!chart) return js_mknull();
+// anim_create("/clock.wsa", x, y, preload) => handle; preload copies the
+// file to PSRAM instead of streaming frames from SD
+JS_BIND_FN(lv_obj_t *, anim_create, const char *path, lv_coord_t x, lv_coord_t y, bool preload) {
+    lv_obj_t *obj = anim_player_create(lv_scr_act(), path, preload);
+    if(obj) lv_obj_set_pos(obj, x, y);
+    return obj;
+}
 
-    lv_chart_set_axis_tick(chart, (lv_chart_axis_t)axis, majorLen, minorLen,
-                           majorCnt, minorCnt, label, drawSiz);
-    return js_mknull();
+JS_BIND_FN(void, anim_play, LvAnim a) {
+    anim_player_play(a.obj);
 }
 
-static jsval_t js_lv_chart_set_zoom_x(struct js *js, jsval_t *args, int nargs) {
-    // (chartH, zoom)
-    if(nargs < 2) return js_mknull();
-    int h   = (int)js_getnum(args[0]);
-    int zm  = (int)js_getnum(args[1]);
-    lv_obj_t *chart = get_lv_obj(h);
-    if(!chart) return js_mknull();
+JS_BIND_FN(void, anim_pause, LvAnim a) {
+    anim_player_pause(a.obj);
+}
 
-    lv_chart_set_zoom_x(chart, zm);
-    return js_mknull();
+// anim_set_loops(anim, n): play n times, then stop on the last frame; 0 = forever
+JS_BIND_FN(void, anim_set_loops, LvAnim a, uint16_t loops) {
+    anim_player_set_loops(a.obj, loops);
+}
+
+// UI_SYNC results can only be primitives: the player's counters are copied
+// on the render task, and js_anim_stats() builds the object from the copy
+static anim_player_stats_t g_anim_stats_copy;
+static jsval_t js_anim_stats_copy(struct js *js, jsval_t *args, int nargs) {
+    LvAnim a;
+    if(nargs < 1 || !js_arg<LvAnim>::get(js, args[0], a)) return js_mkfalse();
+    return anim_player_get_stats(a.obj, &g_anim_stats_copy) ? js_mktrue() : js_mkfalse();
 }
 
-static jsval_t js_lv_chart_set_zoom_y(struct js *js, jsval_t *args, int nargs) {
-    // (chartH, zoom)
-    if(nargs < 2) return js_mknull();
-    int h   = (int)js_getnum(args[0]);
-    int zm  = (int)js_getnum(args[1]);
-    lv_obj_t *chart = get_lv_obj(h);
-    if(!chart) return js_mknull();
+// anim_stats(anim) => { frames, shown, skipped, loops, avg_decode_us }
+static jsval_t js_anim_stats(struct js *js, jsval_t *args, int nargs) {
+    if(js_type(ui_forward(js, js_anim_stats_copy, UI_CMD_SYNC, args, nargs)) != JS_TRUE) {
+        Serial.println("anim_stats: expects animation handle");
+        return js_mknull();
+    }
+    const anim_player_stats_t &st = g_anim_stats_copy;
+    jsval_t obj = js_mkobj(js);
+    js_set(js, obj, "frames",        js_mknum(st.frames));
+    js_set(js, obj, "shown",         js_mknum(st.shown));
+    js_set(js, obj, "skipped",       js_mknum(st.skipped));
+    js_set(js, obj, "loops",         js_mknum(st.loops));
+    js_set(js, obj, "avg_decode_us", js_mknum(st.decoded ? (double)st.decode_us / st.decoded : 0));
+    return obj;
+}
 
-    lv_chart_set_zoom_y(chart, zm);
-    return js_mknull();
+/*******************************************************
+ * DATA BUFFERS (Elk task: no LVGL involved)
+ *******************************************************/
+// data_create(capacity) => buffer id, -1 on failure
+JS_BIND_FN(int, data_create, uint32_t capacity) {
+    return data_ring_create(capacity);
+}
+
+// data_push(id, value | "1,2,3 ...") => samples added
+static jsval_t js_data_push(struct js *js, jsval_t *args, int nargs) {
+    if(nargs < 2 || js_type(args[0]) != JS_NUM) return js_mknum(0);
+    int id = (int)js_getnum(args[0]);
+    if(js_type(args[1]) == JS_NUM) {
+        float v = (float)js_getnum(args[1]);
+        return js_mknum(data_ring_push(id, &v, 1));
+    }
+    size_t len;
+    const char *s = js_type(args[1]) == JS_STR ? js_getstr(js, args[1], &len) : NULL;
+    return js_mknum(s ? data_ring_push_text(id, s, len) : 0);
 }
 
-static jsval_t js_lv_chart_get_y_array(struct js *js, jsval_t *args, int nargs) {
-    // (chartH, seriesPtr) -> returns a pointer number to the array
-    if(nargs < 2) return js_mknull();
-    int h      = (int)js_getnum(args[0]);
-    intptr_t sp= (intptr_t)js_getnum(args[1]);
+// data_load_csv(id, path, column[, first_row[, rows]]) => samples added;
+// first_row skips headers, rows = 0 reads to the end
+static jsval_t js_data_load_csv(struct js *js, jsval_t *args, int nargs) {
+    if(nargs < 3 || js_type(args[0]) != JS_NUM || js_type(args[1]) != JS_STR || js_type(args[2]) != JS_NUM) {
+        Serial.println("data_load_csv: expects id, path, column[, first_row[, rows]]");
+        return js_mknum(0);
+    }
+    const char *path = js_getstr(js, args[1], NULL);
+    uint32_t first = nargs > 3 ? (uint32_t)js_getnum(args[3]) : 0;
+    uint32_t rows  = nargs > 4 ? (uint32_t)js_getnum(args[4]) : 0;
+    return js_mknum(data_ring_load_csv((int)js_getnum(args[0]), path, (int)js_getnum(args[2]), first, rows));
+}
 
-    lv_obj_t *chart = get_lv_obj(h);
-    if(!chart) return js_mknull();
+JS_BIND_FN(uint32_t, data_count, int id) {
+    return data_ring_count(id);
+}
 
-    lv_chart_series_t *ser = (lv_chart_series_t *)sp;
-    lv_coord_t *arr = lv_chart_get_y_array(chart, ser);
-    // Return pointer as numeric
-    intptr_t ret = (intptr_t)arr;
-    return js_mknum((double)ret);
+JS_BIND_FN(void, data_clear, int id) {
+    data_ring_clear(id);
 }
 
-// Similarly you can add bridging for lv_chart_set_ext_y_array, lv_chart_set_ext_x_array,
-// lv_chart_get_x_array, lv_chart_get_pressed_point, lv_chart_set_cursor_point, etc.
-// if your examples require them.
+JS_BIND_FN(void, data_free, int id) {
+    data_ring_free(id);
+}
 
 
 /********************************************************************************
  * METER
  ********************************************************************************/
-// Example calls: 
-//   lv_meter_create, lv_meter_add_scale, lv_meter_set_scale_ticks, 
-//   lv_meter_set_scale_major_ticks, lv_meter_set_scale_range
-//   lv_meter_add_arc, lv_meter_add_scale_lines, lv_meter_add_needle_line,
-//   lv_meter_add_needle_img
-//   lv_meter_set_indicator_start_value, lv_meter_set_indicator_end_value, lv_meter_set_indicator_value
-
-static jsval_t js_lv_meter_create(struct js *js, jsval_t *args, int nargs) {
-    // no params
-    lv_obj_t *m = lv_meter_create(lv_scr_act());
-    int handle = store_lv_obj(m);
-    return js_mknum(handle);
+// Scales and indicators are ids local to their meter, like chart series:
+//   m = lv_meter_create(); s = lv_meter_add_scale(m);
+//   n = lv_meter_add_needle_line(m, s, 4, 0xff0000, -10);
+//   lv_meter_set_indicator_value(m, n, 42);
+
+JS_BIND_FN(lv_obj_t *, meter_create) {
+    return lv_meter_create(lv_scr_act());
 }
 
-static jsval_t js_lv_meter_add_scale(struct js *js, jsval_t *args, int nargs) {
-    // (meterHandle) -> scale pointer as number
-    if(nargs<1) return js_mknull();
-    int mh = (int)js_getnum(args[0]);
-    lv_obj_t *mt = get_lv_obj(mh);
-    if(!mt) return js_mknull();
-
-    lv_meter_scale_t *sc = lv_meter_add_scale(mt);
-    // Return pointer as numeric
-    intptr_t p = (intptr_t)sc;
-    return js_mknum((double)p);
-}
-
-static jsval_t js_lv_meter_set_scale_ticks(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, scalePtr, cnt, width, length, color)
-    if(nargs<6) return js_mknull();
-    int mH     = (int)js_getnum(args[0]);
-    intptr_t scP = (intptr_t)js_getnum(args[1]);
-    int cnt    = (int)js_getnum(args[2]);
-    int width  = (int)js_getnum(args[3]);
-    int length = (int)js_getnum(args[4]);
-    double col = js_getnum(args[5]);
-
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
-    lv_meter_scale_t *sc = (lv_meter_scale_t*) scP;
-    lv_meter_set_scale_ticks(mt, sc, cnt, width, length, lv_color_hex((uint32_t)col));
-    return js_mknull();
+// meter_add_scale(meter) => scale id
+JS_BIND_FN(int, meter_add_scale, LvMeter m) {
+    LvSubTable *t = lv_sub_room(m.obj, "meter_add_scale");
+    if(!t) return -1;
+    return lv_sub_add(t, LV_SUB_SCALE, lv_meter_add_scale(m.obj));
 }
 
-static jsval_t js_lv_meter_set_scale_major_ticks(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, scalePtr, freq, width, length, color, label_gap)
-    if(nargs<7) return js_mknull();
-    int mH     = (int)js_getnum(args[0]);
-    intptr_t scP = (intptr_t)js_getnum(args[1]);
-    int freq   = (int)js_getnum(args[2]);
-    int width  = (int)js_getnum(args[3]);
-    int length = (int)js_getnum(args[4]);
-    double col = js_getnum(args[5]);
-    int label_gap = (int)js_getnum(args[6]);
+JS_BIND_FN(void, meter_set_scale_ticks, LvMeter m, int scale, uint16_t cnt, uint16_t width,
+           uint16_t len, lv_color_t color) {
+    void *sc = lv_sub_get(m.obj, LV_SUB_SCALE, scale, "meter_set_scale_ticks");
+    if(sc) lv_meter_set_scale_ticks(m.obj, (lv_meter_scale_t *)sc, cnt, width, len, color);
+}
 
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
+JS_BIND_FN(void, meter_set_scale_major_ticks, LvMeter m, int scale, uint16_t nth, uint16_t width,
+           uint16_t len, lv_color_t color, int16_t label_gap) {
+    void *sc = lv_sub_get(m.obj, LV_SUB_SCALE, scale, "meter_set_scale_major_ticks");
+    if(sc) lv_meter_set_scale_major_ticks(m.obj, (lv_meter_scale_t *)sc, nth, width, len, color, label_gap);
+}
 
-    lv_meter_scale_t *sc = (lv_meter_scale_t*) scP;
-    lv_meter_set_scale_major_ticks(mt, sc, freq, width, length, lv_color_hex((uint32_t)col), label_gap);
-    return js_mknull();
+JS_BIND_FN(void, meter_set_scale_range, LvMeter m, int scale, int32_t min, int32_t max,
+           uint32_t angle_range, uint32_t rotation) {
+    void *sc = lv_sub_get(m.obj, LV_SUB_SCALE, scale, "meter_set_scale_range");
+    if(sc) lv_meter_set_scale_range(m.obj, (lv_meter_scale_t *)sc, min, max, angle_range, rotation);
 }
 
-static jsval_t js_lv_meter_set_scale_range(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, scalePtr, min, max, angle_range, rotation)
-    if(nargs<6) return js_mknull();
-    int mH   = (int)js_getnum(args[0]);
-    intptr_t scP= (intptr_t)js_getnum(args[1]);
-    int minV = (int)js_getnum(args[2]);
-    int maxV = (int)js_getnum(args[3]);
-    int angleRange = (int)js_getnum(args[4]);
-    int rotation   = (int)js_getnum(args[5]);
-
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
-    lv_meter_scale_t *sc = (lv_meter_scale_t*) scP;
-    lv_meter_set_scale_range(mt, sc, minV, maxV, angleRange, rotation);
-    return js_mknull();
+// Indicator creation: each returns an indicator id of the meter, -1 on failure
+JS_BIND_FN(int, meter_add_arc, LvMeter m, int scale, uint16_t width, lv_color_t color, int16_t r_mod) {
+    void *sc = lv_sub_get(m.obj, LV_SUB_SCALE, scale, "meter_add_arc");
+    LvSubTable *t = sc ? lv_sub_room(m.obj, "meter_add_arc") : NULL;
+    if(!t) return -1;
+    return lv_sub_add(t, LV_SUB_INDICATOR,
+                      lv_meter_add_arc(m.obj, (lv_meter_scale_t *)sc, width, color, r_mod));
 }
 
-// meter indicator creation
-static jsval_t js_lv_meter_add_arc(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, scalePtr, width, color, rMod)
-    // returns indicator pointer
-    if(nargs<5) return js_mknull();
-    int mH     = (int)js_getnum(args[0]);
-    intptr_t scP = (intptr_t)js_getnum(args[1]);
-    int width  = (int)js_getnum(args[2]);
-    double col = js_getnum(args[3]);
-    int rMod   = (int)js_getnum(args[4]);
-
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
-    lv_meter_scale_t *sc = (lv_meter_scale_t *)scP;
-
-    lv_meter_indicator_t *ind = lv_meter_add_arc(mt, sc, width, lv_color_hex((uint32_t)col), rMod);
-    intptr_t ret = (intptr_t)ind;
-    return js_mknum((double)ret);
-}
-
-static jsval_t js_lv_meter_add_scale_lines(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, scalePtr, color_main, color_grad, local, width_mod)
-    // returns indicator pointer
-    if(nargs<6) return js_mknull();
-    int mH         = (int)js_getnum(args[0]);
-    intptr_t scP   = (intptr_t)js_getnum(args[1]);
-    double colorM  = js_getnum(args[2]);
-    double colorG  = js_getnum(args[3]);
-    bool local     = (bool)js_getnum(args[4]);
-    int widthMod   = (int)js_getnum(args[5]);
-
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
-    lv_meter_scale_t *sc = (lv_meter_scale_t *)scP;
-
-    lv_meter_indicator_t *ind = lv_meter_add_scale_lines(mt, sc,
-        lv_color_hex((uint32_t)colorM),
-        lv_color_hex((uint32_t)colorG),
-        local, widthMod
-    );
-    intptr_t ret = (intptr_t)ind;
-    return js_mknum((double)ret);
-}
-
-static jsval_t js_lv_meter_add_needle_line(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, scalePtr, width, color, rMod)
-    if(nargs<5) return js_mknull();
-    int mH     = (int)js_getnum(args[0]);
-    intptr_t scP= (intptr_t)js_getnum(args[1]);
-    int width  = (int)js_getnum(args[2]);
-    double col = js_getnum(args[3]);
-    int rMod   = (int)js_getnum(args[4]);
-
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
-    lv_meter_scale_t *sc = (lv_meter_scale_t *)scP;
-
-    lv_meter_indicator_t *ind = lv_meter_add_needle_line(mt, sc, width, lv_color_hex((uint32_t)col), rMod);
-    intptr_t ret = (intptr_t)ind;
-    return js_mknum((double)ret);
-}
-
-static jsval_t js_lv_meter_add_needle_img(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, scalePtr, srcAddr, pivot_x, pivot_y)
-    // returns indicator pointer
-    if(nargs<5) return js_mknull();
-    int mH        = (int)js_getnum(args[0]);
-    intptr_t scP  = (intptr_t)js_getnum(args[1]);
-    // "srcAddr" is an image source pointer or something
-    intptr_t srcPtr= (intptr_t)js_getnum(args[2]);
-    int pivotX    = (int)js_getnum(args[3]);
-    int pivotY    = (int)js_getnum(args[4]);
-
-    // If we have a global or static "LV_IMG_DECLARE(img_hand);" we normally pass &img_hand
-    // from JS. That means we store "img_hand" pointer in a variable. 
-    // For simplicity let's assume srcPtr is the actual pointer to an lv_img_dsc_t.
-
-    const lv_img_dsc_t * src_dsc = (const lv_img_dsc_t *)srcPtr;
-
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
-    lv_meter_scale_t *sc = (lv_meter_scale_t *)scP;
-
-    lv_meter_indicator_t *ind = lv_meter_add_needle_img(mt, sc, src_dsc, pivotX, pivotY);
-    intptr_t ret = (intptr_t)ind;
-    return js_mknum((double)ret);
-}
-
-// meter set indicator
-static jsval_t js_lv_meter_set_indicator_start_value(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, indicatorPtr, startVal)
-    if(nargs<3) return js_mknull();
-    int mH      = (int)js_getnum(args[0]);
-    intptr_t indP= (intptr_t)js_getnum(args[1]);
-    int stVal   = (int)js_getnum(args[2]);
-
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
-    lv_meter_indicator_t *ind = (lv_meter_indicator_t*) indP;
-
-    lv_meter_set_indicator_start_value(mt, ind, stVal);
-    return js_mknull();
+JS_BIND_FN(int, meter_add_scale_lines, LvMeter m, int scale, lv_color_t color_main,
+           lv_color_t color_end, bool local, int16_t width_mod) {
+    void *sc = lv_sub_get(m.obj, LV_SUB_SCALE, scale, "meter_add_scale_lines");
+    LvSubTable *t = sc ? lv_sub_room(m.obj, "meter_add_scale_lines") : NULL;
+    if(!t) return -1;
+    return lv_sub_add(t, LV_SUB_INDICATOR,
+                      lv_meter_add_scale_lines(m.obj, (lv_meter_scale_t *)sc, color_main, color_end,
+                                               local, width_mod));
 }
 
-static jsval_t js_lv_meter_set_indicator_end_value(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, indicatorPtr, endVal)
-    if(nargs<3) return js_mknull();
-    int mH      = (int)js_getnum(args[0]);
-    intptr_t indP= (intptr_t)js_getnum(args[1]);
-    int endVal  = (int)js_getnum(args[2]);
+JS_BIND_FN(int, meter_add_needle_line, LvMeter m, int scale, uint16_t width, lv_color_t color,
+           int16_t r_mod) {
+    void *sc = lv_sub_get(m.obj, LV_SUB_SCALE, scale, "meter_add_needle_line");
+    LvSubTable *t = sc ? lv_sub_room(m.obj, "meter_add_needle_line") : NULL;
+    if(!t) return -1;
+    return lv_sub_add(t, LV_SUB_INDICATOR,
+                      lv_meter_add_needle_line(m.obj, (lv_meter_scale_t *)sc, width, color, r_mod));
+}
 
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
-    lv_meter_indicator_t *ind = (lv_meter_indicator_t*) indP;
+// meter_add_needle_img(meter, scale, "/needle.png", pivot_x, pivot_y): the
+// image is read from SD; LVGL keeps the path, so the table owns a copy
+JS_BIND_FN(int, meter_add_needle_img, LvMeter m, int scale, const char *path, lv_coord_t pivot_x,
+           lv_coord_t pivot_y) {
+    void *sc = lv_sub_get(m.obj, LV_SUB_SCALE, scale, "meter_add_needle_img");
+    LvSubTable *t = sc ? lv_sub_room(m.obj, "meter_add_needle_img") : NULL;
+    if(!t) return -1;
+    char *src = (char *)malloc(strlen(path) + 3);
+    if(!src) return -1;
+    sprintf(src, "S:%s", path);
+    return lv_sub_add(t, LV_SUB_INDICATOR,
+                      lv_meter_add_needle_img(m.obj, (lv_meter_scale_t *)sc, src, pivot_x, pivot_y), src);
+}
 
-    lv_meter_set_indicator_end_value(mt, ind, endVal);
-    return js_mknull();
+JS_BIND_FN(void, meter_set_indicator_start_value, LvMeter m, int ind, int32_t value) {
+    void *i = lv_sub_get(m.obj, LV_SUB_INDICATOR, ind, "meter_set_indicator_start_value");
+    if(i) lv_meter_set_indicator_start_value(m.obj, (lv_meter_indicator_t *)i, value);
 }
 
-static jsval_t js_lv_meter_set_indicator_value(struct js *js, jsval_t *args, int nargs) {
-    // (meterH, indicatorPtr, val)
-    if(nargs<3) return js_mknull();
-    int mH      = (int)js_getnum(args[0]);
-    intptr_t indP= (intptr_t)js_getnum(args[1]);
-    int val     = (int)js_getnum(args[2]);
+JS_BIND_FN(void, meter_set_indicator_end_value, LvMeter m, int ind, int32_t value) {
+    void *i = lv_sub_get(m.obj, LV_SUB_INDICATOR, ind, "meter_set_indicator_end_value");
+    if(i) lv_meter_set_indicator_end_value(m.obj, (lv_meter_indicator_t *)i, value);
+}
 
-    lv_obj_t *mt = get_lv_obj(mH);
-    if(!mt) return js_mknull();
-    lv_meter_indicator_t *ind = (lv_meter_indicator_t*) indP;
+JS_BIND_FN(void, meter_set_indicator_value, LvMeter m, int ind, int32_t value) {
+    void *i = lv_sub_get(m.obj, LV_SUB_INDICATOR, ind, "meter_set_indicator_value");
+    if(i) lv_meter_set_indicator_value(m.obj, (lv_meter_indicator_t *)i, value);
+}
 
-    lv_meter_set_indicator_value(mt, ind, val);
+// meter_set_indicator_values(meter, first, v0, v1, ...): value of indicators
+// first, first+1, ... in one command; a non-number skips that indicator.
+// Up to UI_MAX_ARGS - 2 values: the UI queue rejects longer calls, and
+// values past the last indicator are reported and dropped.
+static jsval_t js_meter_set_indicator_values(struct js *js, jsval_t *args, int nargs) {
+    LvMeter m;
+    if(nargs < 3 || !js_arg<LvMeter>::get(js, args[0], m) || js_type(args[1]) != JS_NUM) {
+        Serial.println("meter_set_indicator_values: expects meter, first, values...");
+        return js_mknull();
+    }
+    int first = (int)js_getnum(args[1]);
+    for(int i = 2; i < nargs; i++) {
+        if(js_type(args[i]) != JS_NUM) continue;
+        void *ind = lv_sub_get(m.obj, LV_SUB_INDICATOR, first + i - 2, "meter_set_indicator_values");
+        if(!ind) break;
+        lv_meter_set_indicator_value(m.obj, (lv_meter_indicator_t *)ind, (int32_t)js_getnum(args[i]));
+    }
     return js_mknull();
 }
 
 /********************************************************************************
  * SPINBOX
  ********************************************************************************/
-static jsval_t js_lv_spinbox_create(struct js *js, jsval_t *args, int nargs) {
-    lv_obj_t *sb = lv_spinbox_create(lv_scr_act());
-    int handle = store_lv_obj(sb);
-    return js_mknum(handle);
+JS_BIND_FN(lv_obj_t *, spinbox_create) {
+    return lv_spinbox_create(lv_scr_act());
 }
 
-static jsval_t js_lv_spinbox_set_range(struct js *js, jsval_t *args, int nargs) {
-    // (spinboxH, min, max)
-    if(nargs<3) return js_mknull();
-    int h   = (int)js_getnum(args[0]);
-    int mn  = (int)js_getnum(args[1]);
-    int mx  = (int)js_getnum(args[2]);
-
-    lv_obj_t *sb = get_lv_obj(h);
-    if(!sb) return js_mknull();
-    lv_spinbox_set_range(sb, mn, mx);
-    return js_mknull();
+JS_BIND_FN(void, spinbox_set_range, lv_obj_t *sb, int32_t min, int32_t max) {
+    lv_spinbox_set_range(sb, min, max);
 }
 
-static jsval_t js_lv_spinbox_set_digit_format(struct js *js, jsval_t *args, int nargs) {
-    // (spinboxH, digit_count, separator_pos)
-    if(nargs<3) return js_mknull();
-    int h        = (int)js_getnum(args[0]);
-    int digCount = (int)js_getnum(args[1]);
-    int sepPos   = (int)js_getnum(args[2]);
-
-    lv_obj_t *sb = get_lv_obj(h);
-    if(!sb) return js_mknull();
-    lv_spinbox_set_digit_format(sb, digCount, sepPos);
-    return js_mknull();
+JS_BIND_FN(void, spinbox_set_digit_format, lv_obj_t *sb, uint8_t digit_count, uint8_t separator_pos) {
+    lv_spinbox_set_digit_format(sb, digit_count, separator_pos);
 }
 
-static jsval_t js_lv_spinbox_step_prev(struct js *js, jsval_t *args, int nargs) {
-    // (spinboxH)
-    if(nargs<1) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *sb = get_lv_obj(h);
-    if(!sb) return js_mknull();
+JS_BIND_FN(void, spinbox_step_prev, lv_obj_t *sb) {
     lv_spinbox_step_prev(sb);
-    return js_mknull();
 }
-static jsval_t js_lv_spinbox_step_next(struct js *js, jsval_t *args, int nargs) {
-    // (spinboxH)
-    if(nargs<1) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *sb = get_lv_obj(h);
-    if(!sb) return js_mknull();
+JS_BIND_FN(void, spinbox_step_next, lv_obj_t *sb) {
     lv_spinbox_step_next(sb);
-    return js_mknull();
 }
 
-static jsval_t js_lv_spinbox_increment(struct js *js, jsval_t *args, int nargs) {
-    // (spinboxH)
-    if(nargs<1) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *sb = get_lv_obj(h);
-    if(!sb) return js_mknull();
+JS_BIND_FN(void, spinbox_increment, lv_obj_t *sb) {
     lv_spinbox_increment(sb);
-    return js_mknull();
 }
 
-static jsval_t js_lv_spinbox_decrement(struct js *js, jsval_t *args, int nargs) {
-    // (spinboxH)
-    if(nargs<1) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *sb = get_lv_obj(h);
-    if(!sb) return js_mknull();
+JS_BIND_FN(void, spinbox_decrement, lv_obj_t *sb) {
     lv_spinbox_decrement(sb);
-    return js_mknull();
 }
 
 /********************************************************************************
  * MSGBOX
  ********************************************************************************/
-static jsval_t js_lv_msgbox_create(struct js *js, jsval_t *args, int nargs) {
-    // (parentH or -1), titleStr, txtStr, an array of const char*(?), add_ok? 
-    // This is tricky because we need a char** for the buttons. Let's do a simpler approach:
-    // We might do: (title, text, btn1, btn2, ...) or the user can pass a single string "btn1,btn2"
-    // For simplicity let's just do an overloaded approach: (title, text, "OK\nClose"), or (NULL for last param)
-    // We can't easily parse an array from Elk JS. Let's do a simpler approach: 
-    // (title, text, "OK,Close", is_modal_bool)
-    if(nargs<4) return js_mknull();
-
-    const char* title = js_str(js, args[0]);
-    const char* msg   = js_str(js, args[1]);
-    const char* btns  = js_str(js, args[2]);
-    bool addModal     = (bool)js_getnum(args[3]);
-
-    // parse the "OK,Close" into a static array of char*
-    // E.g. we can do a quick split
-    static const char * defBtns[16];
-    memset(defBtns, 0, sizeof(defBtns));
-
-    char tmp[256];
-    strncpy(tmp, btns ? btns : "", sizeof(tmp)-1);
-    tmp[sizeof(tmp)-1] = '\0';
-
-    int idx=0;
-    char *token = strtok(tmp, ",");
-    while(token && idx< (int)(sizeof(defBtns)/sizeof(defBtns[0]) -1 )) {
-        defBtns[idx++] = token;
-        token = strtok(NULL, ",");
+// LVGL's button matrix keeps pointing at the button map, so the map and
+// the labels it points into live in one block freed with the message box
+#define MSGBOX_MAX_BTNS 15
+
+static void on_msgbox_deleted(lv_event_t *e) {
+    free(lv_event_get_user_data(e));
+}
+
+// msgbox_create(title, text, "OK,Close", add_close_btn) => handle; "" for no buttons
+JS_BIND_FN(lv_obj_t *, msgbox_create, const char *title, const char *msg, const char *btns,
+           bool add_close) {
+    size_t len = strlen(btns) + 1;
+    const char **map = (const char **)malloc((MSGBOX_MAX_BTNS + 1) * sizeof(char *) + len);
+    if(!map) return NULL;
+    char *labels = (char *)(map + MSGBOX_MAX_BTNS + 1);
+    memcpy(labels, btns, len);
+
+    int idx = 0;
+    char *save = NULL;
+    for(char *tok = strtok_r(labels, ",", &save); tok && idx < MSGBOX_MAX_BTNS; tok = strtok_r(NULL, ",", &save)) {
+        map[idx++] = tok;
     }
-    defBtns[idx] = NULL; // terminator
+    map[idx] = NULL; // terminator
 
-    lv_obj_t * mb = lv_msgbox_create(NULL, title, msg, defBtns[0] ? defBtns : NULL, addModal);
-    int handle = store_lv_obj(mb);
-    return js_mknum(handle);
+    lv_obj_t *mb = lv_msgbox_create(NULL, title, msg, idx ? map : NULL, add_close);
+    if(!mb) {
+        free(map);
+        return NULL;
+    }
+    lv_obj_add_event_cb(mb, on_msgbox_deleted, LV_EVENT_DELETE, map);
+    return mb;
 }
 
-static jsval_t js_lv_msgbox_get_active_btn_text(struct js *js, jsval_t *args, int nargs) {
-    // (msgboxH) -> string
-    if(nargs<1) return js_mkstr(js, "", 0);
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *mb = get_lv_obj(h);
-    if(!mb) return js_mkstr(js,"",0);
-
-    const char* t = lv_msgbox_get_active_btn_text(mb);
-    if(!t) t = "";
-    return js_mkstr(js, t, strlen(t));
+// (msgboxH) -> string, "" when no button was pressed
+JS_BIND_FN(const char *, msgbox_get_active_btn_text, lv_obj_t *mb) {
+    const char *t = lv_msgbox_get_active_btn_text(mb);
+    return t ? t : "";
 }
 
 /********************************************************************************
  * ROLLER
  ********************************************************************************/
-static jsval_t js_lv_roller_create(struct js *js, jsval_t *args, int nargs) {
-    // no param
-    lv_obj_t *roll = lv_roller_create(lv_scr_act());
-    int handle = store_lv_obj(roll);
-    return js_mknum(handle);
+JS_BIND_FN(lv_obj_t *, roller_create) {
+    return lv_roller_create(lv_scr_act());
 }
 
-static jsval_t js_lv_roller_set_options(struct js *js, jsval_t *args, int nargs) {
-    // (rollerH, "str with \n", modeEnum)
-    if(nargs<3) return js_mknull();
-    int h  = (int)js_getnum(args[0]);
-    const char* opts = js_str(js, args[1]);
-    int mode = (int)js_getnum(args[2]); // e.g. LV_ROLLER_MODE_NORMAL or LV_ROLLER_MODE_INFINITE
-
-    lv_obj_t *roll = get_lv_obj(h);
-    if(!roll) return js_mknull();
-
-    lv_roller_set_options(roll, opts ? opts : "", (lv_roller_mode_t)mode);
-    return js_mknull();
+// (rollerH, "options separated by \n", LV_ROLLER_MODE_NORMAL / INFINITE)
+JS_BIND_FN(void, roller_set_options, lv_obj_t *roll, const char *opts, lv_roller_mode_t mode) {
+    lv_roller_set_options(roll, opts, mode);
 }
 
-static jsval_t js_lv_roller_set_visible_row_count(struct js *js, jsval_t *args, int nargs) {
-    // (rollerH, rowCount)
-    if(nargs<2) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    int r = (int)js_getnum(args[1]);
-    lv_obj_t *roll = get_lv_obj(h);
-    if(!roll) return js_mknull();
-    lv_roller_set_visible_row_count(roll, r);
-    return js_mknull();
+JS_BIND_FN(void, roller_set_visible_row_count, lv_obj_t *roll, uint8_t rows) {
+    lv_roller_set_visible_row_count(roll, rows);
 }
 
-static jsval_t js_lv_roller_get_selected_str(struct js *js, jsval_t *args, int nargs) {
-    // (rollerH) -> string
-    if(nargs<1) return js_mkstr(js,"",0);
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *roll = get_lv_obj(h);
-    if(!roll) return js_mkstr(js,"",0);
-
-    char buf[64];
+JS_BIND_FN(const char *, roller_get_selected_str, lv_obj_t *roll) {
+    static char buf[64];  // copied into a JS string before the next call
     lv_roller_get_selected_str(roll, buf, sizeof(buf));
-    return js_mkstr(js, buf, strlen(buf));
+    return buf;
 }
 
-static jsval_t js_lv_roller_set_selected(struct js *js, jsval_t *args, int nargs) {
-    // (rollerH, sel, animOff0or1)
-    if(nargs<3) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    int sel = (int)js_getnum(args[1]);
-    int anim = (int)js_getnum(args[2]);
-
-    lv_obj_t *roll = get_lv_obj(h);
-    if(!roll) return js_mknull();
-
+JS_BIND_FN(void, roller_set_selected, lv_obj_t *roll, uint16_t sel, bool anim) {
     lv_roller_set_selected(roll, sel, anim ? LV_ANIM_ON : LV_ANIM_OFF);
-    return js_mknull();
 }
 
 /*******************************************************
@@ -2014,26 +2146,10 @@ static jsval_t js_lv_btn_create(struct js *js, jsval_t *args, int nargs) {
 }
 
 // button_set_text(buttonHandle, "Button Text")
-static jsval_t js_lv_button_set_text(struct js *js, jsval_t *args, int nargs) {
-    if(nargs < 2) {
-        Serial.println("lv_button_set_text: expects buttonHandle, text");
-        return js_mknull();
-    }
-    int btnHandle = (int)js_getnum(args[0]);
-    const char* text = js_str(js, args[1]);
-
-    lv_obj_t *button = get_lv_obj(btnHandle);
-    if(!button) {
-        Serial.println("lv_button_set_text: invalid button handle");
-        return js_mknull();
-    }
-
+JS_BIND_FN(void, button_set_text, lv_obj_t *button, const char *text) {
     lv_obj_t *label = lv_label_create(button);
-    lv_label_set_text(label, text ? text : "");
+    lv_label_set_text(label, text);
     lv_obj_center(label); // Center the label within the button
-
-    Serial.printf("lv_button_set_text: handle=%d, text=%s\n", btnHandle, text ? text : "");
-    return js_mknull();
 }
 
 
@@ -2043,178 +2159,111 @@ static jsval_t js_lv_button_set_text(struct js *js, jsval_t *args, int nargs) {
  *   lv_slider_set_mode, lv_slider_set_value, lv_slider_set_left_value, lv_slider_get_value, lv_slider_get_left_value
  ********************************************************************************/
 
-static jsval_t js_lv_slider_create(struct js *js, jsval_t *args, int nargs) {
-    // no params
-    lv_obj_t *sld = lv_slider_create(lv_scr_act());
-    int handle = store_lv_obj(sld);
-    return js_mknum(handle);
+JS_BIND_FN(lv_obj_t *, slider_create) {
+    return lv_slider_create(lv_scr_act());
 }
 
-static jsval_t js_lv_slider_set_mode(struct js *js, jsval_t *args, int nargs) {
-    // (sliderH, modeEnum) -> e.g. LV_SLIDER_MODE_NORMAL, LV_SLIDER_MODE_RANGE
-    if(nargs<2) return js_mknull();
-    int h   = (int)js_getnum(args[0]);
-    int md  = (int)js_getnum(args[1]);
-
-    lv_obj_t *sld = get_lv_obj(h);
-    if(!sld) return js_mknull();
-    lv_slider_set_mode(sld, (lv_slider_mode_t)md);
-    return js_mknull();
+JS_BIND_FN(void, slider_set_mode, lv_obj_t *sld, lv_slider_mode_t mode) {
+    lv_slider_set_mode(sld, mode);
 }
 
-static jsval_t js_lv_slider_set_value(struct js *js, jsval_t *args, int nargs) {
-    // (sliderH, val, animOff0or1)
-    if(nargs<3) return js_mknull();
-    int h      = (int)js_getnum(args[0]);
-    int val    = (int)js_getnum(args[1]);
-    bool anim  = (bool)js_getnum(args[2]);
-
-    lv_obj_t *sld = get_lv_obj(h);
-    if(!sld) return js_mknull();
+JS_BIND_FN(void, slider_set_value, lv_obj_t *sld, int32_t val, bool anim) {
     lv_slider_set_value(sld, val, anim ? LV_ANIM_ON : LV_ANIM_OFF);
-    return js_mknull();
 }
 
-static jsval_t js_lv_slider_set_left_value(struct js *js, jsval_t *args, int nargs) {
-    // (sliderH, val, animOff0or1)
-    if(nargs<3) return js_mknull();
-    int h      = (int)js_getnum(args[0]);
-    int val    = (int)js_getnum(args[1]);
-    bool anim  = (bool)js_getnum(args[2]);
-
-    lv_obj_t *sld = get_lv_obj(h);
-    if(!sld) return js_mknull();
+JS_BIND_FN(void, slider_set_left_value, lv_obj_t *sld, int32_t val, bool anim) {
     lv_slider_set_left_value(sld, val, anim ? LV_ANIM_ON : LV_ANIM_OFF);
-    return js_mknull();
 }
 
-static jsval_t js_lv_slider_get_value(struct js *js, jsval_t *args, int nargs) {
-    // (sliderH) -> int
-    if(nargs<1) return js_mknum(0);
-    int h = (int)js_getnum(args[0]);
-
-    lv_obj_t *sld = get_lv_obj(h);
-    if(!sld) return js_mknum(0);
-
-    int v = lv_slider_get_value(sld);
-    return js_mknum((double)v);
+JS_BIND_FN(int32_t, slider_get_value, lv_obj_t *sld) {
+    return lv_slider_get_value(sld);
 }
 
-static jsval_t js_lv_slider_get_left_value(struct js *js, jsval_t *args, int nargs) {
-    // (sliderH) -> int
-    if(nargs<1) return js_mknum(0);
-    int h = (int)js_getnum(args[0]);
-
-    lv_obj_t *sld = get_lv_obj(h);
-    if(!sld) return js_mknum(0);
-
-    int v = lv_slider_get_left_value(sld);
-    return js_mknum((double)v);
+JS_BIND_FN(int32_t, slider_get_left_value, lv_obj_t *sld) {
+    return lv_slider_get_left_value(sld);
 }
 
 
 /********************************************************************************
  * SPAN
  ********************************************************************************/
-static jsval_t js_lv_spangroup_create(struct js *js, jsval_t *args, int nargs) {
-    lv_obj_t * spg = lv_spangroup_create(lv_scr_act());
-    int handle = store_lv_obj(spg);
-    return js_mknum(handle);
+JS_BIND_FN(lv_obj_t *, spangroup_create) {
+    return lv_spangroup_create(lv_scr_act());
 }
 
-static jsval_t js_lv_spangroup_set_align(struct js *js, jsval_t *args, int nargs) {
-    // (spangroupH, alignEnum=LV_TEXT_ALIGN_LEFT/CENTER/RIGHT/AUTO)
-    if(nargs<2) return js_mknull();
-    int h   = (int)js_getnum(args[0]);
-    int alg = (int)js_getnum(args[1]);
-    lv_obj_t *spg = get_lv_obj(h);
-    if(!spg) return js_mknull();
-
-    lv_spangroup_set_align(spg, (lv_text_align_t)alg);
-    return js_mknull();
+JS_BIND_FN(void, spangroup_set_align, lv_obj_t *spg, lv_text_align_t align) {
+    lv_spangroup_set_align(spg, align);
 }
 
-static jsval_t js_lv_spangroup_set_overflow(struct js *js, jsval_t *args, int nargs) {
-    // (spangroupH, overflowEnum=LV_SPAN_OVERFLOW_CLIP/ELLIPSIS)
-    if(nargs<2) return js_mknull();
-    int h   = (int)js_getnum(args[0]);
-    int ovf = (int)js_getnum(args[1]);
-    lv_obj_t *spg = get_lv_obj(h);
-    if(!spg) return js_mknull();
-
-    lv_spangroup_set_overflow(spg, (lv_span_overflow_t)ovf);
-    return js_mknull();
+JS_BIND_FN(void, spangroup_set_overflow, lv_obj_t *spg, lv_span_overflow_t overflow) {
+    lv_spangroup_set_overflow(spg, overflow);
 }
 
-static jsval_t js_lv_spangroup_set_indent(struct js *js, jsval_t *args, int nargs) {
-    // (spangroupH, indentPX)
-    if(nargs<2) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    int indent = (int)js_getnum(args[1]);
-    lv_obj_t *spg = get_lv_obj(h);
-    if(!spg) return js_mknull();
-
+JS_BIND_FN(void, spangroup_set_indent, lv_obj_t *spg, lv_coord_t indent) {
     lv_spangroup_set_indent(spg, indent);
-    return js_mknull();
 }
 
-static jsval_t js_lv_spangroup_set_mode(struct js *js, jsval_t *args, int nargs) {
-    // (spangroupH, mode=LV_SPAN_MODE_FIXED/NOWRAP/BREAK)
-    if(nargs<2) return js_mknull();
-    int h   = (int)js_getnum(args[0]);
-    int md  = (int)js_getnum(args[1]);
-    lv_obj_t *spg = get_lv_obj(h);
-    if(!spg) return js_mknull();
-
-    lv_spangroup_set_mode(spg, (lv_span_mode_t)md);
-    return js_mknull();
+JS_BIND_FN(void, spangroup_set_mode, lv_obj_t *spg, lv_span_mode_t mode) {
+    lv_spangroup_set_mode(spg, mode);
 }
 
-static jsval_t js_lv_spangroup_new_span(struct js *js, jsval_t *args, int nargs) {
-    // (spangroupH) -> pointer
-    if(nargs<1) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *spg = get_lv_obj(h);
-    if(!spg) return js_mknull();
+// Spans live in the spangroup's sub-object table. A span handle packs the
+// group's object handle and the span id (group * LV_SUB_MAX + id), so the
+// span calls take just the span, as they did when it was a raw pointer.
+struct LvSpanGroup { lv_obj_t *obj; int handle; };
+struct LvSpan { lv_obj_t *group; int id; lv_span_t *span; };
 
-    lv_span_t * sp = lv_spangroup_new_span(spg);
-    intptr_t ret = (intptr_t)sp;
-    return js_mknum((double)ret);
-}
+template<>
+struct js_arg<LvSpanGroup> {
+    static const char *what() { return "spangroup handle"; }
+    static bool get(struct js *js, jsval_t v, LvSpanGroup &out) {
+        if(!js_arg<lv_obj_t *>::get(js, v, out.obj) || !lv_obj_check_type(out.obj, &lv_spangroup_class)) return false;
+        out.handle = (int)js_getnum(v);
+        return true;
+    }
+};
 
-static jsval_t js_lv_span_set_text(struct js *js, jsval_t *args, int nargs) {
-    // (spanPtr, text)
-    if(nargs<2) return js_mknull();
-    intptr_t spP = (intptr_t)js_getnum(args[0]);
-    const char* txt = js_str(js, args[1]);
-    if(!txt) return js_mknull();
+template<>
+struct js_arg<LvSpan> {
+    static const char *what() { return "span handle"; }
+    static bool get(struct js *js, jsval_t v, LvSpan &out) {
+        if(js_type(v) != JS_NUM) return false;
+        double d = js_getnum(v);
+        if(d < 0 || d >= 4294967296.0) return false;  // object handles stay below 2^28
+        uint32_t h = (uint32_t)d;
+        out.group = get_lv_obj((int)(h / LV_SUB_MAX));
+        if(!out.group || !lv_obj_check_type(out.group, &lv_spangroup_class)) return false;
+        out.id = h % LV_SUB_MAX;
+        out.span = (lv_span_t *)lv_sub_find(out.group, LV_SUB_SPAN, out.id);
+        return out.span != NULL;
+    }
+};
 
-    lv_span_t * sp = (lv_span_t *)spP;
-    lv_span_set_text(sp, txt);
-    return js_mknull();
+// spangroup_new_span(spangroupH) => span handle, -1 on failure
+JS_BIND_FN(double, spangroup_new_span, LvSpanGroup g) {
+    LvSubTable *t = lv_sub_room(g.obj, "spangroup_new_span");
+    if(!t) return -1;
+    int id = lv_sub_add(t, LV_SUB_SPAN, lv_spangroup_new_span(g.obj));
+    return id < 0 ? -1 : (double)g.handle * LV_SUB_MAX + id;
 }
 
-static jsval_t js_lv_span_set_text_static(struct js *js, jsval_t *args, int nargs) {
-    // (spanPtr, text) => static
-    if(nargs<2) return js_mknull();
-    intptr_t spP = (intptr_t)js_getnum(args[0]);
-    const char* txt = js_str(js, args[1]);
-    if(!txt) return js_mknull();
-
-    lv_span_t * sp = (lv_span_t *)spP;
-    lv_span_set_text_static(sp, txt);
-    return js_mknull();
+JS_BIND_FN(void, span_set_text, LvSpan s, const char *txt) {
+    lv_span_set_text(s.span, txt);
 }
 
-static jsval_t js_lv_spangroup_refr_mode(struct js *js, jsval_t *args, int nargs) {
-    // (spangroupH)
-    if(nargs<1) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *spg = get_lv_obj(h);
-    if(!spg) return js_mknull();
+// LVGL keeps pointing at a static text; the script's string only lives for
+// the call, so the spangroup's table owns a copy until the next one
+JS_BIND_FN(void, span_set_text_static, LvSpan s, const char *txt) {
+    char *copy = strdup(txt);
+    if(!copy) return;
+    LvSubTable *t = (LvSubTable *)lv_obj_get_user_data(s.group);
+    lv_span_set_text_static(s.span, copy);
+    free(t->owned[s.id]);
+    t->owned[s.id] = copy;
+}
 
+JS_BIND_FN(void, spangroup_refr_mode, lv_obj_t *spg) {
     lv_spangroup_refr_mode(spg);
-    return js_mknull();
 }
 
 /********************************************************************************
@@ -2235,33 +2284,14 @@ static jsval_t js_lv_win_create(struct js *js, jsval_t *args, int nargs) {
     return js_mknum(handle);
 }
 
-static jsval_t js_lv_win_add_btn(struct js *js, jsval_t *args, int nargs) {
-    // (winH, symbolOrText, btnWidth)
-    if(nargs<3) return js_mknum(-1);
-    int wh = (int)js_getnum(args[0]);
-    const char* txt = js_str(js, args[1]);
-    int width = (int)js_getnum(args[2]);
-
-    lv_obj_t *win = get_lv_obj(wh);
-    if(!win) return js_mknum(-1);
-
-    lv_obj_t *btn = lv_win_add_btn(win, txt, width);
-    int handle = store_lv_obj(btn);
-    return js_mknum(handle);
+// (winH, symbolOrText, btnWidth): the icon may be null or ""
+JS_BIND_FN(lv_obj_t *, win_add_btn, lv_obj_t *win, LvIcon icon, lv_coord_t width) {
+    return lv_win_add_btn(win, icon.src, width);
 }
 
-static jsval_t js_lv_win_add_title(struct js *js, jsval_t *args, int nargs) {
-    // (winH, "mytitle")
-    if(nargs<2) return js_mknull();
-    int wh = (int)js_getnum(args[0]);
-    const char* t = js_str(js, args[1]);
-    if(!t) return js_mknull();
-
-    lv_obj_t *win = get_lv_obj(wh);
-    if(!win) return js_mknull();
-
-    lv_win_add_title(win, t);
-    return js_mknull();
+// (winH, "mytitle"); the title label copies the text
+JS_BIND_FN(void, win_add_title, lv_obj_t *win, const char *title) {
+    lv_win_add_title(win, title);
 }
 
 static jsval_t js_lv_win_get_content(struct js *js, jsval_t *args, int nargs) {
@@ -2315,41 +2345,14 @@ static jsval_t js_lv_list_create(struct js *js, jsval_t *args, int nargs) {
     return js_mknum(handle);
 }
 
-static jsval_t js_lv_list_add_btn(struct js *js, jsval_t *args, int nargs) {
-    // (listH, iconSymbolOrNULL, txt)
-    if(nargs < 3) return js_mknull();
-    int lh = (int)js_getnum(args[0]);
-    const char* icon = js_str(js, args[1]);
-    const char* txt  = js_str(js, args[2]);
-
-    lv_obj_t *list = get_lv_obj(lh);
-    if(!list) return js_mknull();
-
-    // If icon is "NULL" or "", pass NULL
-    const char* useIcon = NULL;
-    if(icon && strlen(icon) > 0) {
-        useIcon = icon; // e.g. LV_SYMBOL_OK
-    }
-
-    lv_obj_t *btn = lv_list_add_btn(list, useIcon, txt ? txt : "");
-    int handle = store_lv_obj(btn);
-    Serial.printf("lv_list_add_btn => handle %d\n", handle);
-    return js_mknum(handle);
+// (listH, iconSymbolOrNull, txt): the icon may be null or "", e.g. LV_SYMBOL_OK
+JS_BIND_FN(lv_obj_t *, list_add_btn, lv_obj_t *list, LvIcon icon, const char *txt) {
+    return lv_list_add_btn(list, icon.src, txt);
 }
 
-static jsval_t js_lv_list_add_text(struct js *js, jsval_t *args, int nargs) {
-    // (listH, txt)
-    if(nargs < 2) return js_mknull();
-    int lh = (int)js_getnum(args[0]);
-    const char* txt = js_str(js, args[1]);
-
-    lv_obj_t *list = get_lv_obj(lh);
-    if(!list) return js_mknull();
-
-    lv_obj_t *obj = lv_list_add_text(list, txt ? txt : "");
-    int handle = store_lv_obj(obj);
-    Serial.printf("lv_list_add_text => handle %d\n", handle);
-    return js_mknum(handle);
+// (listH, txt)
+JS_BIND_FN(lv_obj_t *, list_add_text, lv_obj_t *list, const char *txt) {
+    return lv_list_add_text(list, txt);
 }
 
 static jsval_t js_lv_list_get_btn_text(struct js *js, jsval_t *args, int nargs) {
@@ -2413,126 +2416,76 @@ static jsval_t js_lv_line_set_points(struct js *js, jsval_t *args, int nargs) {
  * LED BRIDGING
  *******************************************************/
 
-static jsval_t js_lv_led_create(struct js *js, jsval_t *args, int nargs) {
-    lv_obj_t *led = lv_led_create(lv_scr_act());
-    int handle = store_lv_obj(led);
-    Serial.printf("lv_led_create => handle %d\n", handle);
-    return js_mknum(handle);
+JS_BIND_FN(lv_obj_t *, led_create) {
+    return lv_led_create(lv_scr_act());
 }
 
-static jsval_t js_lv_led_on(struct js *js, jsval_t *args, int nargs) {
-    if(nargs<1) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *led = get_lv_obj(h);
-    if(!led) return js_mknull();
-
+JS_BIND_FN(void, led_on, lv_obj_t *led) {
     lv_led_on(led);
-    return js_mknull();
 }
 
-static jsval_t js_lv_led_off(struct js *js, jsval_t *args, int nargs) {
-    if(nargs<1) return js_mknull();
-    int h = (int)js_getnum(args[0]);
-    lv_obj_t *led = get_lv_obj(h);
-    if(!led) return js_mknull();
-
+JS_BIND_FN(void, led_off, lv_obj_t *led) {
     lv_led_off(led);
-    return js_mknull();
 }
 
-static jsval_t js_lv_led_set_brightness(struct js *js, jsval_t *args, int nargs) {
-    if(nargs<2) return js_mknull();
-    int h    = (int)js_getnum(args[0]);
-    int bright = (int)js_getnum(args[1]);
-    lv_obj_t *led = get_lv_obj(h);
-    if(!led) return js_mknull();
-
+JS_BIND_FN(void, led_set_brightness, lv_obj_t *led, uint8_t bright) {
     lv_led_set_brightness(led, bright);
-    return js_mknull();
 }
 
-static jsval_t js_lv_led_set_color(struct js *js, jsval_t *args, int nargs) {
-    if(nargs<2) return js_mknull();
-    int h    = (int)js_getnum(args[0]);
-    double col = js_getnum(args[1]);
-    lv_obj_t *led = get_lv_obj(h);
-    if(!led) return js_mknull();
-
-    lv_led_set_color(led, lv_color_hex((uint32_t)col));
-    return js_mknull();
+JS_BIND_FN(void, led_set_color, lv_obj_t *led, lv_color_t color) {
+    lv_led_set_color(led, color);
 }
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~ 1) HTTP ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // http_get(url)
-static jsval_t js_http_get(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<1) return js_mkstr(js,"",0);
-  const char* url = js_str(js, args[0]);
-  if(!url) return js_mkstr(js,"",0);
-
+JS_BIND_FN(String, http_get, const char *url) {
   HTTPClient http;
   http.begin(url);
   int httpCode = http.GET();
   if(httpCode<=0) {
     http.end();
-    return js_mkstr(js,"",0);
+    return String();
   }
   String payload = http.getString();
   http.end();
-  return js_mkstr(js, payload.c_str(), payload.length());
+  return payload;
 }
 
 // http_post(url, body)
-static jsval_t js_http_post(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<2) return js_mkstr(js,"",0);
-  const char* url  = js_str(js, args[0]);
-  const char* body = js_str(js, args[1]);
-  if(!url || !body) return js_mkstr(js,"",0);
-
+JS_BIND_FN(String, http_post, const char *url, const char *body) {
   HTTPClient http;
   http.begin(url);
   http.addHeader("Content-Type", "application/json");
   int httpCode = http.POST((uint8_t*)body, strlen(body));
   if(httpCode<=0) {
     http.end();
-    return js_mkstr(js,"",0);
+    return String();
   }
   String payload = http.getString();
   http.end();
-  return js_mkstr(js, payload.c_str(), payload.length());
+  return payload;
 }
 
 // Similarly for PUT, PATCH, DELETE (example: http_delete)
-static jsval_t js_http_delete(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<1) return js_mkstr(js,"",0);
-  const char* url = js_str(js, args[0]);
-  if(!url) return js_mkstr(js,"",0);
-
+JS_BIND_FN(String, http_delete, const char *url) {
   HTTPClient http;
   http.begin(url);
   int httpCode = http.sendRequest("DELETE");
   if(httpCode<=0) {
     http.end();
-    return js_mkstr(js,"",0);
+    return String();
   }
   String payload = http.getString();
   http.end();
-  return js_mkstr(js, payload.c_str(), payload.length());
+  return payload;
 }
 
 
 //~~~~~~~~~~~~~~~~~~~~~~~~~~~ 4) Extended SD ops ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
 // We already have sd_list_dir, sd_read_file, sd_write_file. Add file delete:
-static jsval_t js_sd_delete_file(struct js *js, jsval_t *args, int nargs) {
-  if(nargs<1) return js_mkfalse();
-  const char* path = js_str(js, args[0]);
-  if(!path) return js_mkfalse();
-
-  String fullPath = String(path);
-  if(SD_MMC.exists(fullPath)) {
-    bool ok = SD_MMC.remove(fullPath);
-    return ok ? js_mktrue() : js_mkfalse();
-  }
-  return js_mkfalse();
+JS_BIND_FN(bool, sd_delete_file, const char *path) {
+  sd_cache_forget(path);
+  return SD_MMC.exists(path) && SD_MMC.remove(path);
 }
 
 // ~~~~~~~~~~~~~~~~~~~~~~~~~~~ 5) Basic BLE bridging ~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~~
@@ -2565,13 +2518,7 @@ class MyCharCallbacks : public NimBLECharacteristicCallbacks {
 };
 
 // ble_init(devName, serviceUUID, charUUID)
-static jsval_t js_ble_init(struct js *js, jsval_t *args, int nargs) {
-  if(nargs < 3) return js_mkfalse();
-  const char* devName  = js_str(js, args[0]);
-  const char* svcUUID  = js_str(js, args[1]);
-  const char* charUUID = js_str(js, args[2]);
-  if(!devName || !svcUUID || !charUUID) return js_mkfalse();
-
+JS_BIND_FN(bool, ble_init, const char *devName, const char *svcUUID, const char *charUUID) {
   // Initialize NimBLE
   NimBLEDevice::init(devName);
 
@@ -2595,7 +2542,7 @@ static jsval_t js_ble_init(struct js *js, jsval_t *args, int nargs) {
   // Start advertising
   g_bleServer->getAdvertising()->start();
   Serial.println("NimBLE advertising started");
-  return js_mktrue();
+  return true;
 }
 
 // ble_is_connected() => bool
@@ -2604,208 +2551,377 @@ static jsval_t js_ble_is_connected(struct js *js, jsval_t *args, int nargs) {
 }
 
 // ble_write(str)
-static jsval_t js_ble_write(struct js *js, jsval_t *args, int nargs) {
-  if(!g_bleChar) return js_mkfalse();
-  if(nargs < 1) return js_mkfalse();
-  const char* data = js_str(js, args[0]);
-  if(!data) return js_mkfalse();
-
+JS_BIND_FN(bool, ble_write, const char *data) {
+  if(!g_bleChar) return false;
   g_bleChar->setValue(data);
   g_bleChar->notify();
-  return js_mktrue();
+  return true;
 }
 
 /******************************************************************************
  * I) Register All JS Functions
  ******************************************************************************/
-void register_js_functions() {
-  jsval_t global = js_glob(js);
+// Bridges that touch LVGL or the panel are wrapped with UI_ASYNC/UI_CREATE/
+// UI_SYNC and run on the render task (see ui_queue.h); the rest run here.
+// Bridges are grouped into namespace objects (lv, style, sd, net, ble, data);
+// core ones (print, delay, sys_*) stay plain globals. Elk resolves a global
+// by walking the global object's properties, newest first, so registering
+// all ~190 names made every call to an early-registered one walk most of
+// the list and cost arena space (tools/elkbench lookup measures both).
+// Instead, register_js_functions() only registers what the script names:
+// a namespace when it contains `ns.` (with only the members it names), a
+// legacy flat name (kept for existing scripts) when that word appears
+// anywhere in it.
+enum { JS_NS_NONE, JS_NS_LV, JS_NS_STYLE, JS_NS_SD, JS_NS_NET, JS_NS_BLE, JS_NS_DATA, JS_NS_COUNT };
+static const char *const g_js_ns_names[JS_NS_COUNT] = { NULL, "lv", "style", "sd", "net", "ble", "data" };
+
+struct JsBinding {
+  uint8_t     ns;
+  const char *member;  // name inside the namespace
+  const char *flat;    // legacy global name
+  jsval_t   (*fn)(struct js *, jsval_t *, int);
+};
 
+static const JsBinding g_js_bindings[] = {
   // Basic
-  js_set(js, global, "print",        js_mkfun(js_print));
-  js_set(js, global, "wifi_connect", js_mkfun(js_wifi_connect));
-  js_set(js, global, "wifi_status",  js_mkfun(js_wifi_status));
-  js_set(js, global, "wifi_get_ip",  js_mkfun(js_wifi_get_ip));
-  js_set(js, global, "delay",        js_mkfun(js_delay));
+  { JS_NS_NONE,  "print",                           "print",                              js_print },
+  { JS_NS_NET,   "wifi_connect",                    "wifi_connect",                       JS_BIND(wifi_connect) },
+  { JS_NS_NET,   "wifi_status",                     "wifi_status",                        js_wifi_status },
+  { JS_NS_NET,   "wifi_get_ip",                     "wifi_get_ip",                        js_wifi_get_ip },
+  { JS_NS_NONE,  "delay",                           "delay",                              js_delay },
+  { JS_NS_NONE,  "set_vsync",                       "set_vsync",                          UI_ASYNC(js_set_vsync) },
+  { JS_NS_NONE,  "sys_flush_stats",                 "sys_flush_stats",                    js_sys_flush_stats },
+  { JS_NS_NONE,  "sys_ui_stats",                    "sys_ui_stats",                       js_sys_ui_stats },
+  { JS_NS_NONE,  "sys_obj_stats",                   "sys_obj_stats",                      js_sys_obj_stats },
+  { JS_NS_NONE,  "sys_img_stats",                   "sys_img_stats",                      js_sys_img_stats },
+  { JS_NS_NONE,  "sys_sd_stats",                    "sys_sd_stats",                       js_sys_sd_stats },
+  { JS_NS_NONE,  "sys_js_stats",                    "sys_js_stats",                       js_sys_js_stats },
+  { JS_NS_NONE,  "sys_on_low_memory",               "sys_on_low_memory",                  js_sys_on_low_memory },
+
+  // Direct panel fills (not tracked by LVGL, redrawn over on its next refresh)
+  { JS_NS_LV,    "lcd_fill_rect",                   "lcd_fill_rect",                      UI_ASYNC(js_lcd_fill_rect) },
+  { JS_NS_LV,    "lcd_clear_rect",                  "lcd_clear_rect",                     UI_ASYNC(js_lcd_clear_rect) },
+  { JS_NS_LV,    "lcd_blit_pattern",                "lcd_blit_pattern",                   UI_SYNC(js_lcd_blit_pattern) },
 
   // HTTP
-  js_set(js, global, "http_get",    js_mkfun(js_http_get));
-  js_set(js, global, "http_post",   js_mkfun(js_http_post));
-  js_set(js, global, "http_delete", js_mkfun(js_http_delete));
+  { JS_NS_NET,   "http_get",                        "http_get",                           JS_BIND(http_get) },
+  { JS_NS_NET,   "http_post",                       "http_post",                          JS_BIND(http_post) },
+  { JS_NS_NET,   "http_delete",                     "http_delete",                        JS_BIND(http_delete) },
 
   // SD functions
-  js_set(js, global, "sd_read_file", js_mkfun(js_sd_read_file));
-  js_set(js, global, "sd_write_file",js_mkfun(js_sd_write_file));
-  js_set(js, global, "sd_list_dir",  js_mkfun(js_sd_list_dir));
-  js_set(js, global, "sd_delete_file", js_mkfun(js_sd_delete_file));
+  { JS_NS_SD,    "read_file",                       "sd_read_file",                       js_sd_read_file },
+  { JS_NS_SD,    "write_file",                      "sd_write_file",                      JS_BIND(sd_write_file) },
+  { JS_NS_SD,    "list_dir",                        "sd_list_dir",                        js_sd_list_dir },
+  { JS_NS_SD,    "delete_file",                     "sd_delete_file",                     JS_BIND(sd_delete_file) },
 
   // BLE
-  js_set(js, global, "ble_init",         js_mkfun(js_ble_init));
-  js_set(js, global, "ble_is_connected", js_mkfun(js_ble_is_connected));
-  js_set(js, global, "ble_write",        js_mkfun(js_ble_write));
+  { JS_NS_BLE,   "init",                            "ble_init",                           JS_BIND(ble_init) },
+  { JS_NS_BLE,   "is_connected",                    "ble_is_connected",                   js_ble_is_connected },
+  { JS_NS_BLE,   "write",                           "ble_write",                          JS_BIND(ble_write) },
 
   // GIF from memory
-  js_set(js, global, "show_gif_from_sd", js_mkfun(js_show_gif_from_sd));
+  { JS_NS_LV,    "show_gif_from_sd",                "show_gif_from_sd",                   UI_SYNC(JS_BIND(show_gif_from_sd)) },
+  { JS_NS_LV,    "gif_create",                      "gif_create",                         UI_CREATE(JS_BIND(gif_create)) },
 
   // Basic shapes
-  js_set(js, global, "draw_label",   js_mkfun(js_lvgl_draw_label));
-  js_set(js, global, "draw_rect",    js_mkfun(js_lvgl_draw_rect));
-  js_set(js, global, "show_image",   js_mkfun(js_lvgl_show_image));
+  { JS_NS_LV,    "draw_label",                      "draw_label",                         UI_ASYNC(JS_BIND(draw_label)) },
+  { JS_NS_LV,    "draw_rect",                       "draw_rect",                          UI_ASYNC(js_lvgl_draw_rect) },
+  { JS_NS_LV,    "show_image",                      "show_image",                         UI_ASYNC(JS_BIND(show_image)) },
 
   // Handle-based image creation + transforms
-  js_set(js, global, "create_image",          js_mkfun(js_create_image));
-  js_set(js, global, "create_image_from_ram", js_mkfun(js_create_image_from_ram));
-  js_set(js, global, "rotate_obj",            js_mkfun(js_rotate_obj));
-  js_set(js, global, "move_obj",              js_mkfun(js_move_obj));
-  js_set(js, global, "animate_obj",           js_mkfun(js_animate_obj));
+  { JS_NS_LV,    "create_image",                    "create_image",                       UI_CREATE(JS_BIND(create_image)) },
+  { JS_NS_LV,    "create_image_from_ram",           "create_image_from_ram",              UI_CREATE(JS_BIND(create_image_from_ram)) },
+  { JS_NS_LV,    "rotate_obj",                      "rotate_obj",                         UI_ASYNC(js_rotate_obj) },
+  { JS_NS_LV,    "move_obj",                        "move_obj",                           UI_ASYNC(js_move_obj) },
+  { JS_NS_LV,    "animate_obj",                     "animate_obj",                        UI_ASYNC(js_animate_obj) },
 
   // Style creation + property setters
-  js_set(js, global, "create_style",              js_mkfun(js_create_style));
-  js_set(js, global, "obj_add_style",             js_mkfun(js_obj_add_style));
-
-  js_set(js, global, "style_set_radius",          js_mkfun(js_style_set_radius));
-  js_set(js, global, "style_set_bg_opa",          js_mkfun(js_style_set_bg_opa));
-  js_set(js, global, "style_set_bg_color",        js_mkfun(js_style_set_bg_color));
-  js_set(js, global, "style_set_border_color",    js_mkfun(js_style_set_border_color));
-  js_set(js, global, "style_set_border_width",    js_mkfun(js_style_set_border_width));
-  js_set(js, global, "style_set_border_opa",      js_mkfun(js_style_set_border_opa));
-  js_set(js, global, "style_set_border_side",     js_mkfun(js_style_set_border_side));
-  js_set(js, global, "style_set_outline_width",   js_mkfun(js_style_set_outline_width));
-  js_set(js, global, "style_set_outline_color",   js_mkfun(js_style_set_outline_color));
-  js_set(js, global, "style_set_outline_pad",     js_mkfun(js_style_set_outline_pad));
-  js_set(js, global, "style_set_shadow_width",    js_mkfun(js_style_set_shadow_width));
-  js_set(js, global, "style_set_shadow_color",    js_mkfun(js_style_set_shadow_color));
-  js_set(js, global, "style_set_shadow_ofs_x",    js_mkfun(js_style_set_shadow_ofs_x));
-  js_set(js, global, "style_set_shadow_ofs_y",    js_mkfun(js_style_set_shadow_ofs_y));
-  js_set(js, global, "style_set_img_recolor",     js_mkfun(js_style_set_img_recolor));
-  js_set(js, global, "style_set_img_recolor_opa", js_mkfun(js_style_set_img_recolor_opa));
-  js_set(js, global, "style_set_transform_angle",  js_mkfun(js_style_set_transform_angle));
-  js_set(js, global, "style_set_text_color",      js_mkfun(js_style_set_text_color));
-  js_set(js, global, "style_set_text_letter_space", js_mkfun(js_style_set_text_letter_space));
-  js_set(js, global, "style_set_text_line_space", js_mkfun(js_style_set_text_line_space));
-  js_set(js, global, "style_set_text_decor",      js_mkfun(js_style_set_text_decor));
-  js_set(js, global, "style_set_line_color",      js_mkfun(js_style_set_line_color));
-  js_set(js, global, "style_set_line_width",      js_mkfun(js_style_set_line_width));
-  js_set(js, global, "style_set_line_rounded",    js_mkfun(js_style_set_line_rounded));
-  js_set(js, global, "style_set_pad_all",         js_mkfun(js_style_set_pad_all));
-  js_set(js, global, "style_set_pad_left",        js_mkfun(js_style_set_pad_left));
-  js_set(js, global, "style_set_pad_right",       js_mkfun(js_style_set_pad_right));
-  js_set(js, global, "style_set_pad_top",         js_mkfun(js_style_set_pad_top));
-  js_set(js, global, "style_set_pad_bottom",      js_mkfun(js_style_set_pad_bottom));
-  js_set(js, global, "style_set_pad_ver",         js_mkfun(js_style_set_pad_ver));
-  js_set(js, global, "style_set_pad_hor",         js_mkfun(js_style_set_pad_hor));
-  js_set(js, global, "style_set_width",           js_mkfun(js_style_set_width));
-  js_set(js, global, "style_set_height",          js_mkfun(js_style_set_height));
-  js_set(js, global, "style_set_x",               js_mkfun(js_style_set_x));
-  js_set(js, global, "style_set_y",               js_mkfun(js_style_set_y));
+  { JS_NS_STYLE, "create",                          "create_style",                       UI_SYNC(js_create_style) },
+  { JS_NS_STYLE, "add",                             "obj_add_style",                      UI_ASYNC(JS_BIND(obj_add_style)) },
+
+  { JS_NS_STYLE, "set_radius",                      "style_set_radius",                   UI_ASYNC(JS_BIND(style_set_radius)) },
+  { JS_NS_STYLE, "set_bg_opa",                      "style_set_bg_opa",                   UI_ASYNC(JS_BIND(style_set_bg_opa)) },
+  { JS_NS_STYLE, "set_bg_color",                    "style_set_bg_color",                 UI_ASYNC(JS_BIND(style_set_bg_color)) },
+  { JS_NS_STYLE, "set_border_color",                "style_set_border_color",             UI_ASYNC(JS_BIND(style_set_border_color)) },
+  { JS_NS_STYLE, "set_border_width",                "style_set_border_width",             UI_ASYNC(JS_BIND(style_set_border_width)) },
+  { JS_NS_STYLE, "set_border_opa",                  "style_set_border_opa",               UI_ASYNC(JS_BIND(style_set_border_opa)) },
+  { JS_NS_STYLE, "set_border_side",                 "style_set_border_side",              UI_ASYNC(JS_BIND(style_set_border_side)) },
+  { JS_NS_STYLE, "set_outline_width",               "style_set_outline_width",            UI_ASYNC(JS_BIND(style_set_outline_width)) },
+  { JS_NS_STYLE, "set_outline_color",               "style_set_outline_color",            UI_ASYNC(JS_BIND(style_set_outline_color)) },
+  { JS_NS_STYLE, "set_outline_pad",                 "style_set_outline_pad",              UI_ASYNC(JS_BIND(style_set_outline_pad)) },
+  { JS_NS_STYLE, "set_shadow_width",                "style_set_shadow_width",             UI_ASYNC(JS_BIND(style_set_shadow_width)) },
+  { JS_NS_STYLE, "set_shadow_color",                "style_set_shadow_color",             UI_ASYNC(JS_BIND(style_set_shadow_color)) },
+  { JS_NS_STYLE, "set_shadow_ofs_x",                "style_set_shadow_ofs_x",             UI_ASYNC(JS_BIND(style_set_shadow_ofs_x)) },
+  { JS_NS_STYLE, "set_shadow_ofs_y",                "style_set_shadow_ofs_y",             UI_ASYNC(JS_BIND(style_set_shadow_ofs_y)) },
+  { JS_NS_STYLE, "set_img_recolor",                 "style_set_img_recolor",              UI_ASYNC(JS_BIND(style_set_img_recolor)) },
+  { JS_NS_STYLE, "set_img_recolor_opa",             "style_set_img_recolor_opa",          UI_ASYNC(JS_BIND(style_set_img_recolor_opa)) },
+  { JS_NS_STYLE, "set_transform_angle",             "style_set_transform_angle",          UI_ASYNC(JS_BIND(style_set_transform_angle)) },
+  { JS_NS_STYLE, "set_text_color",                  "style_set_text_color",               UI_ASYNC(JS_BIND(style_set_text_color)) },
+  { JS_NS_STYLE, "set_text_letter_space",           "style_set_text_letter_space",        UI_ASYNC(JS_BIND(style_set_text_letter_space)) },
+  { JS_NS_STYLE, "set_text_line_space",             "style_set_text_line_space",          UI_ASYNC(JS_BIND(style_set_text_line_space)) },
+  { JS_NS_STYLE, "set_text_decor",                  "style_set_text_decor",               UI_ASYNC(JS_BIND(style_set_text_decor)) },
+  { JS_NS_STYLE, "set_line_color",                  "style_set_line_color",               UI_ASYNC(JS_BIND(style_set_line_color)) },
+  { JS_NS_STYLE, "set_line_width",                  "style_set_line_width",               UI_ASYNC(JS_BIND(style_set_line_width)) },
+  { JS_NS_STYLE, "set_line_rounded",                "style_set_line_rounded",             UI_ASYNC(JS_BIND(style_set_line_rounded)) },
+  { JS_NS_STYLE, "set_pad_all",                     "style_set_pad_all",                  UI_ASYNC(JS_BIND(style_set_pad_all)) },
+  { JS_NS_STYLE, "set_pad_left",                    "style_set_pad_left",                 UI_ASYNC(JS_BIND(style_set_pad_left)) },
+  { JS_NS_STYLE, "set_pad_right",                   "style_set_pad_right",                UI_ASYNC(JS_BIND(style_set_pad_right)) },
+  { JS_NS_STYLE, "set_pad_top",                     "style_set_pad_top",                  UI_ASYNC(JS_BIND(style_set_pad_top)) },
+  { JS_NS_STYLE, "set_pad_bottom",                  "style_set_pad_bottom",               UI_ASYNC(JS_BIND(style_set_pad_bottom)) },
+  { JS_NS_STYLE, "set_pad_ver",                     "style_set_pad_ver",                  UI_ASYNC(JS_BIND(style_set_pad_ver)) },
+  { JS_NS_STYLE, "set_pad_hor",                     "style_set_pad_hor",                  UI_ASYNC(JS_BIND(style_set_pad_hor)) },
+  { JS_NS_STYLE, "set_width",                       "style_set_width",                    UI_ASYNC(JS_BIND(style_set_width)) },
+  { JS_NS_STYLE, "set_height",                      "style_set_height",                   UI_ASYNC(JS_BIND(style_set_height)) },
+  { JS_NS_STYLE, "set_x",                           "style_set_x",                        UI_ASYNC(JS_BIND(style_set_x)) },
+  { JS_NS_STYLE, "set_y",                           "style_set_y",                        UI_ASYNC(JS_BIND(style_set_y)) },
 
   // Object property setters
-  js_set(js, global, "obj_set_size",        js_mkfun(js_obj_set_size));
-  js_set(js, global, "obj_align",           js_mkfun(js_obj_align));
+  { JS_NS_LV,    "obj_delete",                      "obj_delete",                         UI_ASYNC(JS_BIND(obj_delete)) },
+  { JS_NS_LV,    "obj_set_size",                    "obj_set_size",                       UI_ASYNC(JS_BIND(obj_set_size)) },
+  { JS_NS_LV,    "obj_align",                       "obj_align",                          UI_ASYNC(JS_BIND(obj_align)) },
 
   // Scroll, flex, flags
-  js_set(js, global, "obj_set_scroll_snap_x",   js_mkfun(js_obj_set_scroll_snap_x));
-  js_set(js, global, "obj_set_scroll_snap_y",   js_mkfun(js_obj_set_scroll_snap_y));
-  js_set(js, global, "obj_add_flag",            js_mkfun(js_obj_add_flag));
-  js_set(js, global, "obj_clear_flag",          js_mkfun(js_obj_clear_flag));
-  js_set(js, global, "obj_set_scroll_dir",      js_mkfun(js_obj_set_scroll_dir));
-  js_set(js, global, "obj_set_scrollbar_mode",  js_mkfun(js_obj_set_scrollbar_mode));
-  js_set(js, global, "obj_set_flex_flow",       js_mkfun(js_obj_set_flex_flow));
-  js_set(js, global, "obj_set_flex_align",      js_mkfun(js_obj_set_flex_align));
-  js_set(js, global, "obj_set_style_clip_corner", js_mkfun(js_obj_set_style_clip_corner));
-  js_set(js, global, "obj_set_style_base_dir",  js_mkfun(js_obj_set_style_base_dir));
+  { JS_NS_LV,    "obj_set_scroll_snap_x",           "obj_set_scroll_snap_x",              UI_ASYNC(JS_BIND(obj_set_scroll_snap_x)) },
+  { JS_NS_LV,    "obj_set_scroll_snap_y",           "obj_set_scroll_snap_y",              UI_ASYNC(JS_BIND(obj_set_scroll_snap_y)) },
+  { JS_NS_LV,    "obj_add_flag",                    "obj_add_flag",                       UI_ASYNC(JS_BIND(obj_add_flag)) },
+  { JS_NS_LV,    "obj_clear_flag",                  "obj_clear_flag",                     UI_ASYNC(JS_BIND(obj_clear_flag)) },
+  { JS_NS_LV,    "obj_set_scroll_dir",              "obj_set_scroll_dir",                 UI_ASYNC(JS_BIND(obj_set_scroll_dir)) },
+  { JS_NS_LV,    "obj_set_scrollbar_mode",          "obj_set_scrollbar_mode",             UI_ASYNC(JS_BIND(obj_set_scrollbar_mode)) },
+  { JS_NS_LV,    "obj_set_flex_flow",               "obj_set_flex_flow",                  UI_ASYNC(JS_BIND(obj_set_flex_flow)) },
+  { JS_NS_LV,    "obj_set_flex_align",              "obj_set_flex_align",                 UI_ASYNC(JS_BIND(obj_set_flex_align)) },
+  { JS_NS_LV,    "obj_set_style_clip_corner",       "obj_set_style_clip_corner",          UI_ASYNC(JS_BIND(obj_set_style_clip_corner)) },
+  { JS_NS_LV,    "obj_set_style_base_dir",          "obj_set_style_base_dir",             UI_ASYNC(JS_BIND(obj_set_style_base_dir)) },
+
+  //==================== CHART ============================
+  { JS_NS_LV,    "chart_create",                    "lv_chart_create",                    UI_CREATE(JS_BIND(chart_create)) },
+  { JS_NS_LV,    "chart_set_type",                  "lv_chart_set_type",                  UI_ASYNC(JS_BIND(chart_set_type)) },
+  { JS_NS_LV,    "chart_set_div_line_count",        "lv_chart_set_div_line_count",        UI_ASYNC(JS_BIND(chart_set_div_line_count)) },
+  { JS_NS_LV,    "chart_set_update_mode",           "lv_chart_set_update_mode",           UI_ASYNC(JS_BIND(chart_set_update_mode)) },
+  { JS_NS_LV,    "chart_set_range",                 "lv_chart_set_range",                 UI_ASYNC(JS_BIND(chart_set_range)) },
+  { JS_NS_LV,    "chart_set_point_count",           "lv_chart_set_point_count",           UI_ASYNC(JS_BIND(chart_set_point_count)) },
+  { JS_NS_LV,    "chart_refresh",                   "lv_chart_refresh",                   UI_ASYNC(JS_BIND(chart_refresh)) },
+  { JS_NS_LV,    "chart_add_series",                "lv_chart_add_series",                UI_SYNC(JS_BIND(chart_add_series)) },
+  { JS_NS_LV,    "chart_set_next_value",            "lv_chart_set_next_value",            UI_ASYNC(JS_BIND(chart_set_next_value)) },
+  { JS_NS_LV,    "chart_set_next_value2",           "lv_chart_set_next_value2",           UI_ASYNC(JS_BIND(chart_set_next_value2)) },
+  { JS_NS_LV,    "chart_set_next_values",           "lv_chart_set_next_values",           UI_ASYNC(js_chart_set_next_values) },
+  { JS_NS_LV,    "chart_set_axis_tick",             "lv_chart_set_axis_tick",             UI_ASYNC(JS_BIND(chart_set_axis_tick)) },
+  { JS_NS_LV,    "chart_set_zoom_x",                "lv_chart_set_zoom_x",                UI_ASYNC(JS_BIND(chart_set_zoom_x)) },
+  { JS_NS_LV,    "chart_set_zoom_y",                "lv_chart_set_zoom_y",                UI_ASYNC(JS_BIND(chart_set_zoom_y)) },
+  { JS_NS_LV,    "chart_get_value",                 "lv_chart_get_value",                 UI_SYNC(js_chart_get_value) },
+  { JS_NS_LV,    "chart_set_series_data",           "lv_chart_set_series_data",           UI_ASYNC(js_chart_set_series_data) },
+  { JS_NS_LV,    "chart_push_values",               "lv_chart_push_values",               UI_ASYNC(js_chart_push_values) },
+  { JS_NS_LV,    "strip_chart_create",              "lv_strip_chart_create",              UI_CREATE(JS_BIND(lv_strip_chart_create)) },
+  { JS_NS_LV,    "strip_chart_add_series",          "lv_strip_chart_add_series",          UI_SYNC(JS_BIND(lv_strip_chart_add_series)) },
+  { JS_NS_LV,    "strip_chart_set_range",           "lv_strip_chart_set_range",           UI_ASYNC(JS_BIND(lv_strip_chart_set_range)) },
+  { JS_NS_LV,    "strip_chart_set_grid",            "lv_strip_chart_set_grid",            UI_ASYNC(JS_BIND(lv_strip_chart_set_grid)) },
+  { JS_NS_LV,    "strip_chart_set_step",            "lv_strip_chart_set_step",            UI_ASYNC(JS_BIND(lv_strip_chart_set_step)) },
+  { JS_NS_LV,    "strip_chart_push",                "lv_strip_chart_push",                UI_ASYNC(js_strip_chart_push) },
+
+  // Pre-decoded animations
+  { JS_NS_LV,    "anim_create",                     "anim_create",                        UI_CREATE(JS_BIND(anim_create)) },
+  { JS_NS_LV,    "anim_play",                       "anim_play",                          UI_ASYNC(JS_BIND(anim_play)) },
+  { JS_NS_LV,    "anim_pause",                      "anim_pause",                         UI_ASYNC(JS_BIND(anim_pause)) },
+  { JS_NS_LV,    "anim_set_loops",                  "anim_set_loops",                     UI_ASYNC(JS_BIND(anim_set_loops)) },
+  { JS_NS_LV,    "anim_stats",                      "anim_stats",                         js_anim_stats },
+
+  // Native sample buffers feeding charts
+  { JS_NS_DATA,  "create",                          "data_create",                        JS_BIND(data_create) },
+  { JS_NS_DATA,  "push",                            "data_push",                          js_data_push },
+  { JS_NS_DATA,  "load_csv",                        "data_load_csv",                      js_data_load_csv },
+  { JS_NS_DATA,  "count",                           "data_count",                         JS_BIND(data_count) },
+  { JS_NS_DATA,  "clear",                           "data_clear",                         JS_BIND(data_clear) },
+  { JS_NS_DATA,  "free",                            "data_free",                          JS_BIND(data_free) },
 
   //==================== METER ============================
-  js_set(js, global, "lv_meter_create",                   js_mkfun(js_lv_meter_create));
-  js_set(js, global, "lv_meter_add_scale",                js_mkfun(js_lv_meter_add_scale));
-  js_set(js, global, "lv_meter_set_scale_ticks",          js_mkfun(js_lv_meter_set_scale_ticks));
-  js_set(js, global, "lv_meter_set_scale_major_ticks",    js_mkfun(js_lv_meter_set_scale_major_ticks));
-  js_set(js, global, "lv_meter_set_scale_range",          js_mkfun(js_lv_meter_set_scale_range));
-  js_set(js, global, "lv_meter_add_arc",                  js_mkfun(js_lv_meter_add_arc));
-  js_set(js, global, "lv_meter_add_scale_lines",          js_mkfun(js_lv_meter_add_scale_lines));
-  js_set(js, global, "lv_meter_add_needle_line",          js_mkfun(js_lv_meter_add_needle_line));
-  js_set(js, global, "lv_meter_add_needle_img",           js_mkfun(js_lv_meter_add_needle_img));
-  js_set(js, global, "lv_meter_set_indicator_start_value",js_mkfun(js_lv_meter_set_indicator_start_value));
-  js_set(js, global, "lv_meter_set_indicator_end_value",  js_mkfun(js_lv_meter_set_indicator_end_value));
-  js_set(js, global, "lv_meter_set_indicator_value",      js_mkfun(js_lv_meter_set_indicator_value));
+  { JS_NS_LV,    "meter_create",                    "lv_meter_create",                    UI_CREATE(JS_BIND(meter_create)) },
+  { JS_NS_LV,    "meter_add_scale",                 "lv_meter_add_scale",                 UI_SYNC(JS_BIND(meter_add_scale)) },
+  { JS_NS_LV,    "meter_set_scale_ticks",           "lv_meter_set_scale_ticks",           UI_ASYNC(JS_BIND(meter_set_scale_ticks)) },
+  { JS_NS_LV,    "meter_set_scale_major_ticks",     "lv_meter_set_scale_major_ticks",     UI_ASYNC(JS_BIND(meter_set_scale_major_ticks)) },
+  { JS_NS_LV,    "meter_set_scale_range",           "lv_meter_set_scale_range",           UI_ASYNC(JS_BIND(meter_set_scale_range)) },
+  { JS_NS_LV,    "meter_add_arc",                   "lv_meter_add_arc",                   UI_SYNC(JS_BIND(meter_add_arc)) },
+  { JS_NS_LV,    "meter_add_scale_lines",           "lv_meter_add_scale_lines",           UI_SYNC(JS_BIND(meter_add_scale_lines)) },
+  { JS_NS_LV,    "meter_add_needle_line",           "lv_meter_add_needle_line",           UI_SYNC(JS_BIND(meter_add_needle_line)) },
+  { JS_NS_LV,    "meter_add_needle_img",            "lv_meter_add_needle_img",            UI_SYNC(JS_BIND(meter_add_needle_img)) },
+  { JS_NS_LV,    "meter_set_indicator_start_value", "lv_meter_set_indicator_start_value", UI_ASYNC(JS_BIND(meter_set_indicator_start_value)) },
+  { JS_NS_LV,    "meter_set_indicator_end_value",   "lv_meter_set_indicator_end_value",   UI_ASYNC(JS_BIND(meter_set_indicator_end_value)) },
+  { JS_NS_LV,    "meter_set_indicator_value",       "lv_meter_set_indicator_value",       UI_ASYNC(JS_BIND(meter_set_indicator_value)) },
+  { JS_NS_LV,    "meter_set_indicator_values",      "lv_meter_set_indicator_values",      UI_ASYNC(js_meter_set_indicator_values) },
 
   //==================== SPINBOX =========================
-  js_set(js, global, "lv_spinbox_create",           js_mkfun(js_lv_spinbox_create));
-  js_set(js, global, "lv_spinbox_set_range",        js_mkfun(js_lv_spinbox_set_range));
-  js_set(js, global, "lv_spinbox_set_digit_format", js_mkfun(js_lv_spinbox_set_digit_format));
-  js_set(js, global, "lv_spinbox_step_prev",        js_mkfun(js_lv_spinbox_step_prev));
-  js_set(js, global, "lv_spinbox_step_next",        js_mkfun(js_lv_spinbox_step_next));
-  js_set(js, global, "lv_spinbox_increment",        js_mkfun(js_lv_spinbox_increment));
-  js_set(js, global, "lv_spinbox_decrement",        js_mkfun(js_lv_spinbox_decrement));
+  { JS_NS_LV,    "spinbox_create",                  "lv_spinbox_create",                  UI_CREATE(JS_BIND(spinbox_create)) },
+  { JS_NS_LV,    "spinbox_set_range",               "lv_spinbox_set_range",               UI_ASYNC(JS_BIND(spinbox_set_range)) },
+  { JS_NS_LV,    "spinbox_set_digit_format",        "lv_spinbox_set_digit_format",        UI_ASYNC(JS_BIND(spinbox_set_digit_format)) },
+  { JS_NS_LV,    "spinbox_step_prev",               "lv_spinbox_step_prev",               UI_ASYNC(JS_BIND(spinbox_step_prev)) },
+  { JS_NS_LV,    "spinbox_step_next",               "lv_spinbox_step_next",               UI_ASYNC(JS_BIND(spinbox_step_next)) },
+  { JS_NS_LV,    "spinbox_increment",               "lv_spinbox_increment",               UI_ASYNC(JS_BIND(spinbox_increment)) },
+  { JS_NS_LV,    "spinbox_decrement",               "lv_spinbox_decrement",               UI_ASYNC(JS_BIND(spinbox_decrement)) },
 
   //==================== MSGBOX ==========================
-  js_set(js, global, "lv_msgbox_create",            js_mkfun(js_lv_msgbox_create));
-  js_set(js, global, "lv_msgbox_get_active_btn_text", js_mkfun(js_lv_msgbox_get_active_btn_text));
+  { JS_NS_LV,    "msgbox_create",                   "lv_msgbox_create",                   UI_CREATE(JS_BIND(msgbox_create)) },
+  { JS_NS_LV,    "msgbox_get_active_btn_text",      "lv_msgbox_get_active_btn_text",      UI_SYNC(JS_BIND(msgbox_get_active_btn_text)) },
 
   //==================== ROLLER =========================
-  js_set(js, global, "lv_roller_create",         js_mkfun(js_lv_roller_create));
-  js_set(js, global, "lv_roller_set_options",    js_mkfun(js_lv_roller_set_options));
-  js_set(js, global, "lv_roller_set_visible_row_count", js_mkfun(js_lv_roller_set_visible_row_count));
-  js_set(js, global, "lv_roller_get_selected_str", js_mkfun(js_lv_roller_get_selected_str));
-  js_set(js, global, "lv_roller_set_selected",   js_mkfun(js_lv_roller_set_selected));
+  { JS_NS_LV,    "roller_create",                   "lv_roller_create",                   UI_CREATE(JS_BIND(roller_create)) },
+  { JS_NS_LV,    "roller_set_options",              "lv_roller_set_options",              UI_ASYNC(JS_BIND(roller_set_options)) },
+  { JS_NS_LV,    "roller_set_visible_row_count",    "lv_roller_set_visible_row_count",    UI_ASYNC(JS_BIND(roller_set_visible_row_count)) },
+  { JS_NS_LV,    "roller_get_selected_str",         "lv_roller_get_selected_str",         UI_SYNC(JS_BIND(roller_get_selected_str)) },
+  { JS_NS_LV,    "roller_set_selected",             "lv_roller_set_selected",             UI_ASYNC(JS_BIND(roller_set_selected)) },
 
   //==================== SLIDER (additional) =============
-  js_set(js, global, "lv_slider_create",         js_mkfun(js_lv_slider_create));
-  js_set(js, global, "lv_slider_set_mode",       js_mkfun(js_lv_slider_set_mode));
-  js_set(js, global, "lv_slider_set_value",      js_mkfun(js_lv_slider_set_value));
-  js_set(js, global, "lv_slider_set_left_value", js_mkfun(js_lv_slider_set_left_value));
-  js_set(js, global, "lv_slider_get_value",      js_mkfun(js_lv_slider_get_value));
-  js_set(js, global, "lv_slider_get_left_value", js_mkfun(js_lv_slider_get_left_value));
+  { JS_NS_LV,    "slider_create",                   "lv_slider_create",                   UI_CREATE(JS_BIND(slider_create)) },
+  { JS_NS_LV,    "slider_set_mode",                 "lv_slider_set_mode",                 UI_ASYNC(JS_BIND(slider_set_mode)) },
+  { JS_NS_LV,    "slider_set_value",                "lv_slider_set_value",                UI_ASYNC(JS_BIND(slider_set_value)) },
+  { JS_NS_LV,    "slider_set_left_value",           "lv_slider_set_left_value",           UI_ASYNC(JS_BIND(slider_set_left_value)) },
+  { JS_NS_LV,    "slider_get_value",                "lv_slider_get_value",                UI_SYNC(JS_BIND(slider_get_value)) },
+  { JS_NS_LV,    "slider_get_left_value",           "lv_slider_get_left_value",           UI_SYNC(JS_BIND(slider_get_left_value)) },
 
   //==================== SPAN ============================
-  js_set(js, global, "lv_spangroup_create",      js_mkfun(js_lv_spangroup_create));
-  js_set(js, global, "lv_spangroup_set_align",   js_mkfun(js_lv_spangroup_set_align));
-  js_set(js, global, "lv_spangroup_set_overflow",js_mkfun(js_lv_spangroup_set_overflow));
-  js_set(js, global, "lv_spangroup_set_indent",  js_mkfun(js_lv_spangroup_set_indent));
-  js_set(js, global, "lv_spangroup_set_mode",    js_mkfun(js_lv_spangroup_set_mode));
-  js_set(js, global, "lv_spangroup_new_span",    js_mkfun(js_lv_spangroup_new_span));
-  js_set(js, global, "lv_span_set_text",         js_mkfun(js_lv_span_set_text));
-  js_set(js, global, "lv_span_set_text_static",  js_mkfun(js_lv_span_set_text_static));
-  js_set(js, global, "lv_spangroup_refr_mode",   js_mkfun(js_lv_spangroup_refr_mode));
+  { JS_NS_LV,    "spangroup_create",                "lv_spangroup_create",                UI_CREATE(JS_BIND(spangroup_create)) },
+  { JS_NS_LV,    "spangroup_set_align",             "lv_spangroup_set_align",             UI_ASYNC(JS_BIND(spangroup_set_align)) },
+  { JS_NS_LV,    "spangroup_set_overflow",          "lv_spangroup_set_overflow",          UI_ASYNC(JS_BIND(spangroup_set_overflow)) },
+  { JS_NS_LV,    "spangroup_set_indent",            "lv_spangroup_set_indent",            UI_ASYNC(JS_BIND(spangroup_set_indent)) },
+  { JS_NS_LV,    "spangroup_set_mode",              "lv_spangroup_set_mode",              UI_ASYNC(JS_BIND(spangroup_set_mode)) },
+  { JS_NS_LV,    "spangroup_new_span",              "lv_spangroup_new_span",              UI_SYNC(JS_BIND(spangroup_new_span)) },
+  { JS_NS_LV,    "span_set_text",                   "lv_span_set_text",                   UI_ASYNC(JS_BIND(span_set_text)) },
+  { JS_NS_LV,    "span_set_text_static",            "lv_span_set_text_static",            UI_ASYNC(JS_BIND(span_set_text_static)) },
+  { JS_NS_LV,    "spangroup_refr_mode",             "lv_spangroup_refr_mode",             UI_ASYNC(JS_BIND(spangroup_refr_mode)) },
 
   //==================== WIN =============================
-  js_set(js, global, "lv_win_create",             js_mkfun(js_lv_win_create));
-  js_set(js, global, "lv_win_add_btn",            js_mkfun(js_lv_win_add_btn));
-  js_set(js, global, "lv_win_add_title",          js_mkfun(js_lv_win_add_title));
-  js_set(js, global, "lv_win_get_content",        js_mkfun(js_lv_win_get_content));
+  { JS_NS_LV,    "win_create",                      "lv_win_create",                      UI_CREATE(js_lv_win_create) },
+  { JS_NS_LV,    "win_add_btn",                     "lv_win_add_btn",                     UI_CREATE(JS_BIND(win_add_btn)) },
+  { JS_NS_LV,    "win_add_title",                   "lv_win_add_title",                   UI_ASYNC(JS_BIND(win_add_title)) },
+  { JS_NS_LV,    "win_get_content",                 "lv_win_get_content",                 UI_CREATE(js_lv_win_get_content) },
 
   //==================== TILEVIEW ========================
-  js_set(js, global, "lv_tileview_create",        js_mkfun(js_lv_tileview_create));
-  js_set(js, global, "lv_tileview_add_tile",      js_mkfun(js_lv_tileview_add_tile));
+  { JS_NS_LV,    "tileview_create",                 "lv_tileview_create",                 UI_CREATE(js_lv_tileview_create) },
+  { JS_NS_LV,    "tileview_add_tile",               "lv_tileview_add_tile",               UI_CREATE(js_lv_tileview_add_tile) },
 
   // ---------- LIST bridging
-  js_set(js, global, "lv_list_create",          js_mkfun(js_lv_list_create));
-  js_set(js, global, "lv_list_add_btn",         js_mkfun(js_lv_list_add_btn));
-  js_set(js, global, "lv_list_add_text",        js_mkfun(js_lv_list_add_text));
-  js_set(js, global, "lv_list_get_btn_text",    js_mkfun(js_lv_list_get_btn_text));
+  { JS_NS_LV,    "list_create",                     "lv_list_create",                     UI_CREATE(js_lv_list_create) },
+  { JS_NS_LV,    "list_add_btn",                    "lv_list_add_btn",                    UI_CREATE(JS_BIND(list_add_btn)) },
+  { JS_NS_LV,    "list_add_text",                   "lv_list_add_text",                   UI_CREATE(JS_BIND(list_add_text)) },
+  { JS_NS_LV,    "list_get_btn_text",               "lv_list_get_btn_text",               UI_SYNC(js_lv_list_get_btn_text) },
 
   // ---------- LINE bridging
-  js_set(js, global, "lv_line_create",          js_mkfun(js_lv_line_create));
-  js_set(js, global, "lv_line_set_points",      js_mkfun(js_lv_line_set_points));
+  { JS_NS_LV,    "line_create",                     "lv_line_create",                     UI_CREATE(js_lv_line_create) },
+  { JS_NS_LV,    "line_set_points",                 "lv_line_set_points",                 UI_ASYNC(js_lv_line_set_points) },
 
   // ---------- LED bridging
-  js_set(js, global, "lv_led_create",           js_mkfun(js_lv_led_create));
-  js_set(js, global, "lv_led_on",               js_mkfun(js_lv_led_on));
-  js_set(js, global, "lv_led_off",              js_mkfun(js_lv_led_off));
-  js_set(js, global, "lv_led_set_brightness",   js_mkfun(js_lv_led_set_brightness));
-  js_set(js, global, "lv_led_set_color",        js_mkfun(js_lv_led_set_color));
+  { JS_NS_LV,    "led_create",                      "lv_led_create",                      UI_CREATE(JS_BIND(led_create)) },
+  { JS_NS_LV,    "led_on",                          "lv_led_on",                          UI_ASYNC(JS_BIND(led_on)) },
+  { JS_NS_LV,    "led_off",                         "lv_led_off",                         UI_ASYNC(JS_BIND(led_off)) },
+  { JS_NS_LV,    "led_set_brightness",              "lv_led_set_brightness",              UI_ASYNC(JS_BIND(led_set_brightness)) },
+  { JS_NS_LV,    "led_set_color",                   "lv_led_set_color",                   UI_ASYNC(JS_BIND(led_set_color)) },
 
   // ---------- BUTTON bridging
-  js_set(js, global, "lv_btn_create", js_mkfun(js_lv_btn_create));
-  js_set(js, global, "lv_button_set_text", js_mkfun(js_lv_button_set_text));
+  { JS_NS_LV,    "btn_create",                      "lv_btn_create",                      UI_CREATE(js_lv_btn_create) },
+  { JS_NS_LV,    "button_set_text",                 "lv_button_set_text",                 UI_ASYNC(JS_BIND(button_set_text)) },
+};
+
+// FNV-1a over an identifier
+static uint32_t js_word_hash(const char *w, size_t len) {
+  uint32_t h = 2166136261u;
+  for(size_t i = 0; i < len; i++) h = (h ^ (uint8_t)w[i]) * 16777619u;
+  return h;
+}
+
+static int js_word_cmp(const void *a, const void *b) {
+  uint32_t x = *(const uint32_t *)a, y = *(const uint32_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static bool js_is_word_char(char c) {
+  return isalnum((unsigned char)c) || c == '_' || c == '$';
+}
+
+// Sorted hashes of every identifier-like word in the script (strings
+// included, they may name callbacks), plus which namespaces it dereferences
+struct JsWords {
+  uint32_t *h;
+  size_t    n;
+  bool      ns_used[JS_NS_COUNT];
+};
+
+static void js_scan_words(const char *src, size_t len, JsWords &w) {
+  memset(&w, 0, sizeof(w));
+  w.h = (uint32_t *)malloc((len / 2 + 1) * sizeof(uint32_t));
+  if(!w.h) return;
+  const char *prev = NULL;  // previous word, to spot `let ns`
+  size_t prev_len = 0;
+  bool declared[JS_NS_COUNT] = {};
+  for(size_t i = 0; i < len;) {
+    if(!js_is_word_char(src[i])) { i++; continue; }
+    size_t st = i;
+    while(i < len && js_is_word_char(src[i])) i++;
+    w.h[w.n++] = js_word_hash(src + st, i - st);
+
+    size_t j = i;
+    while(j < len && isspace((unsigned char)src[j])) j++;
+    bool after_let = prev && prev_len == 3 && memcmp(prev, "let", 3) == 0;
+    for(int ns = 1; ns < JS_NS_COUNT; ns++) {
+      if(strlen(g_js_ns_names[ns]) != i - st || memcmp(g_js_ns_names[ns], src + st, i - st) != 0) continue;
+      if(after_let) declared[ns] = true;
+      else if(j < len && src[j] == '.') w.ns_used[ns] = true;
+    }
+    prev = src + st, prev_len = i - st;
+  }
+  // A script global of the same name wins over the namespace
+  for(int ns = 1; ns < JS_NS_COUNT; ns++) {
+    if(declared[ns]) w.ns_used[ns] = false;
+  }
+  qsort(w.h, w.n, sizeof(uint32_t), js_word_cmp);
+}
+
+static bool js_has_word(const JsWords &w, const char *name) {
+  uint32_t h = js_word_hash(name, strlen(name));
+  return w.h && bsearch(&h, w.h, w.n, sizeof(uint32_t), js_word_cmp) != NULL;
+}
+
+// Register the bridges `src` can reach; NULL registers every flat name
+void register_js_functions(const char *src, size_t len) {
+  jsval_t global = js_glob(js);
+  const size_t count = sizeof(g_js_bindings) / sizeof(g_js_bindings[0]);
+
+  js_timers_register(js);
+  JsWords words;
+  if(src) js_scan_words(src, len, words);
+
+  jsval_t ns_obj[JS_NS_COUNT];
+  for(int ns = 1; ns < JS_NS_COUNT; ns++) {
+    ns_obj[ns] = (src && words.ns_used[ns]) ? js_mkobj(js) : js_mkundef();
+  }
+
+  unsigned flat = 0, members = 0;
+  for(size_t i = 0; i < count; i++) {
+    const JsBinding &b = g_js_bindings[i];
+    jsval_t fn = js_mkfun(b.fn);
+    if(b.ns != JS_NS_NONE && js_type(ns_obj[b.ns]) != JS_UNDEF && js_has_word(words, b.member)) {
+      js_set(js, ns_obj[b.ns], b.member, fn);
+      members++;
+    }
+    if(b.ns == JS_NS_NONE || !src || js_has_word(words, b.flat)) {
+      js_set(js, global, b.flat, fn);
+      flat++;
+    }
+  }
+  for(int ns = 1; ns < JS_NS_COUNT; ns++) {
+    if(js_type(ns_obj[ns]) != JS_UNDEF) js_set(js, global, g_js_ns_names[ns], ns_obj[ns]);
+  }
+  if(src) free(words.h);
+  Serial.printf("Bindings: %u globals, %u namespace members, %u available\n", flat, members, (unsigned)count);
 }
 
 //------------------------------------------------------------------------------
 // K) The elk_task -- runs Elk + bridging in a separate FreeRTOS task
 //------------------------------------------------------------------------------
+static void on_frame(uint32_t ms, uint32_t px) {
+  js_timers_frame();
+  js_mon_sample();
+}
+
 static void elk_task(void *pvParam) {
   // 1) Create Elk
-  js = js_create(elk_memory, sizeof(elk_memory));
+  js = elk_memory ? js_create(elk_memory, g_elk_cfg.heap_size) : NULL;
   if(!js) {
     Serial.println("Failed to initialize Elk in elk_task");
     // Delete this task if you want
@@ -2813,23 +2929,25 @@ static void elk_task(void *pvParam) {
     return;
   }
 
-  // 2) Register bridging
-  register_js_functions();
+  js_setgct(js, g_elk_cfg.heap_size * g_elk_cfg.gc_pct / 100);
+  if(g_elk_cfg.c_stack) js_setmaxcss(js, g_elk_cfg.c_stack);
 
-  // 3) Load & execute your script
-  if(!load_and_execute_js_script("/script.js")) {
+  js_mon_start();
+
+  // 2) Load the script (from the app bundle if one is mounted), register
+  //    the bridges it uses & execute it
+  bool ran = bundle_mounted() ? load_and_execute_bundle_script()
+                              : load_and_execute_js_script(prepare_js_script("/script.js", "/script.min.js"));
+  if(!ran) {
     Serial.println("Failed to load and execute JavaScript script");
   } else {
     Serial.println("Script executed successfully in elk_task");
   }
 
-  // 4) Now keep running lv_timer_handler() or your lvgl_loop
-  // so that the UI remains active
-  for(;;) {
-    lv_timer_handler();
-    delay(5);
-    // or lvgl_loop() if you prefer
-  }
+  // 3) The render task keeps the UI running; serve the script's timers and
+  //    animation frames from here on (sleeps until one is due)
+  display_on_frame(on_frame);
+  js_timers_loop(js);
 
   // If you ever want to exit the task, do:
   // vTaskDelete(NULL);
@@ -11,11 +11,22 @@
 #define EXAMPLE_LCD_V_RES 240
 #define LVGL_LCD_BUF_SIZE (EXAMPLE_LCD_H_RES * EXAMPLE_LCD_V_RES)
 
+// Double-buffered DMA flush: LVGL renders one band while the other is on the bus
+#define LCD_DMA_FLUSH 1
+#define LVGL_DMA_BUF_LINES 24
+#define LVGL_DMA_BUF_SIZE (EXAMPLE_LCD_H_RES * LVGL_DMA_BUF_LINES)
+
+// Start each frame on the panel's TE pulse (can also be toggled at runtime)
+#define LCD_TE_SYNC 0
+
 /***********************config*************************/
 
 #define TFT_WIDTH 240
 #define TFT_HEIGHT 536
 #define SEND_BUF_SIZE (0x4000)
+#define LCD_QUEUE_SIZE 17
+#define LCD_TILE_PX (EXAMPLE_LCD_H_RES * 8)  // fill/pattern tile, internal DMA RAM
+#define LCD_SOLID_MIN_PX 2048  // flushed areas at least this big are checked for one colour
 
 #define TFT_TE 9
 #define TFT_SDO 8 
@@ -0,0 +1,611 @@
+#include <Arduino.h>
+#include <string.h>
+#include "pixel_kernels.h"
+
+static px_stats_t g_px_stats;
+
+#if PX_USE_PIE
+// Broadcast constants for px_mix_pie(), in the order it loads them. Each
+// channel is masked in place, and (c << shift) * a >> shift is c * a, so one
+// multiply both extracts and weights it; 0x8081 >> 23 is LV_UDIV255.
+static const uint16_t px_mix_k[] = {
+#if LV_COLOR_16_SWAP
+  256,  // x * 256 and x * 256 >> 16 swap the bytes
+#endif
+  255,
+  0xF800, 128, 0x8081, 1 << 11,  // red
+  0x07E0, 128, 0x8081, 1 << 5,   // green
+  0x001F, 128, 0x8081,           // blue
+#if LV_COLOR_16_SWAP
+  256,
+#endif
+};
+#endif
+
+#if PX_USE_PIE && defined(PX_PIE_EMULATE)
+// Host builds (tools/pxbench): the same 16-byte block moves in plain C.
+// Like ee.vld/ee.vst they drop the low address bits, so a misaligned call
+// shows up as wrong pixels rather than working by accident.
+static inline uint16_t *px_pie_align(const uint16_t *p) {
+  return (uint16_t *)((uintptr_t)p & ~(uintptr_t)15);
+}
+
+static void px_fill_pie(uint16_t *dst, const uint16_t *pattern, uint32_t n16) {
+  for (uint32_t i = 0; i < n16; i++, dst += 8) memcpy(px_pie_align(dst), px_pie_align(pattern), 16);
+}
+
+static void px_copy_pie(uint16_t *dst, const uint16_t *src, uint32_t n16) {
+  for (uint32_t i = 0; i < n16; i++, dst += 8, src += 8) memcpy(px_pie_align(dst), px_pie_align(src), 16);
+}
+
+// The lane arithmetic of px_mix_pie(): ee.vmul.u16 keeps the low 16 bits of
+// the 32-bit product shifted right by SAR, ee.vadds/vsubs.s16 saturate
+typedef struct {
+  uint16_t h[8];
+} px_q_t;
+
+static inline void px_q_mul(px_q_t *z, const px_q_t *x, const px_q_t *y, uint32_t sar) {
+  for (int i = 0; i < 8; i++) z->h[i] = (uint16_t)(((uint32_t)x->h[i] * y->h[i]) >> sar);
+}
+
+static inline void px_q_adds(px_q_t *z, const px_q_t *x, const px_q_t *y, int sign) {
+  for (int i = 0; i < 8; i++) {
+    int32_t v = (int16_t)x->h[i] + sign * (int16_t)y->h[i];
+    z->h[i] = (uint16_t)(v > 32767 ? 32767 : v < -32768 ? -32768 : v);
+  }
+}
+
+static inline void px_q_bc(px_q_t *z, const uint16_t *&k) {
+  for (int i = 0; i < 8; i++) z->h[i] = *k;
+  k++;
+}
+
+static inline void px_q_and(px_q_t *z, const px_q_t *x, const px_q_t *y) {
+  for (int i = 0; i < 8; i++) z->h[i] = x->h[i] & y->h[i];
+}
+
+static inline void px_q_or(px_q_t *z, const px_q_t *x, const px_q_t *y) {
+  for (int i = 0; i < 8; i++) z->h[i] = x->h[i] | y->h[i];
+}
+
+#if LV_COLOR_16_SWAP
+// m holds 256 in every lane
+static inline void px_q_swap(px_q_t *x, const px_q_t *m) {
+  px_q_t t;
+  px_q_mul(&t, x, m, 0);
+  px_q_mul(x, x, m, 16);
+  px_q_or(x, x, &t);
+}
+#endif
+
+// One channel: mask, weight, add, round, divide by 255, move back in place
+static inline void px_q_channel(px_q_t *out, const px_q_t *d, const px_q_t *s, const px_q_t *a, const px_q_t *ia,
+                                const uint16_t *&k, uint32_t shift, bool last) {
+  px_q_t m, t, u;
+  px_q_bc(&m, k);
+  px_q_and(&t, s, &m);
+  px_q_and(&u, d, &m);
+  px_q_mul(&t, &t, a, shift);
+  px_q_mul(&u, &u, ia, shift);
+  px_q_adds(&t, &t, &u, 1);
+  px_q_bc(&u, k);
+  px_q_adds(&t, &t, &u, 1);
+  px_q_bc(&u, k);
+  px_q_mul(&t, &t, &u, 23);
+  if (!last) {
+    px_q_bc(&u, k);
+    px_q_mul(&t, &t, &u, 0);
+  }
+  px_q_or(out, out, &t);
+}
+
+static void px_mix_pie(uint16_t *dst, const uint16_t *src, const uint16_t *alpha, uint32_t n16, uint32_t src_step) {
+  for (uint32_t i = 0; i < n16; i++, dst += 8, src += src_step / 2, alpha += 8) {
+    const uint16_t *k = px_mix_k;
+    px_q_t d, s, a, ia, out = { { 0 } };
+    memcpy(&d, px_pie_align(dst), 16);
+    memcpy(&s, px_pie_align(src), 16);
+    memcpy(&a, px_pie_align(alpha), 16);
+#if LV_COLOR_16_SWAP
+    px_q_t m;
+    px_q_bc(&m, k);
+    px_q_swap(&d, &m);
+    px_q_swap(&s, &m);
+#endif
+    px_q_bc(&ia, k);
+    px_q_adds(&ia, &ia, &a, -1);
+    px_q_channel(&out, &d, &s, &a, &ia, k, 11, false);
+    px_q_channel(&out, &d, &s, &a, &ia, k, 5, false);
+    px_q_channel(&out, &d, &s, &a, &ia, k, 0, true);
+#if LV_COLOR_16_SWAP
+    px_q_bc(&m, k);
+    px_q_swap(&out, &m);
+#endif
+    memcpy(px_pie_align(dst), &out, 16);
+  }
+}
+#elif PX_USE_PIE
+// PIE state is not saved on context switches, so each kernel loads and
+// consumes q0 within a single asm block. n16 counts 16-byte blocks.
+static void px_fill_pie(uint16_t *dst, const uint16_t *pattern, uint32_t n16) {
+  asm volatile(
+    "ee.vld.128.ip q0, %[pat], 0\n"
+    "loopnez %[n], 1f\n"
+    "ee.vst.128.ip q0, %[dst], 16\n"
+    "1:\n"
+    : [dst] "+r"(dst)
+    : [pat] "r"(pattern), [n] "r"(n16)
+    : "memory");
+}
+
+static void px_copy_pie(uint16_t *dst, const uint16_t *src, uint32_t n16) {
+  asm volatile(
+    "loopnez %[n], 1f\n"
+    "ee.vld.128.ip q0, %[src], 16\n"
+    "ee.vst.128.ip q0, %[dst], 16\n"
+    "1:\n"
+    : [dst] "+r"(dst), [src] "+r"(src)
+    : [n] "r"(n16)
+    : "memory");
+}
+
+// dst = mix(src, dst, alpha) for n16 blocks of 8 pixels, alpha widened to
+// 16 bits. src advances by src_step bytes a block (0 for a colour pattern).
+// Lanes stay below 0x4000 until the divide, so the signed adds never
+// saturate; SAR is set before each multiply that uses it.
+static void px_mix_pie(uint16_t *dst, const uint16_t *src, const uint16_t *alpha, uint32_t n16, uint32_t src_step) {
+  const uint16_t *k = px_mix_k;
+  asm volatile(
+    "loopnez %[n], 1f\n"
+    "ee.vld.128.ip q0, %[dst], 0\n"
+    "ee.vld.128.xp q1, %[src], %[step]\n"
+    "ee.vld.128.ip q2, %[a], 16\n"
+#if LV_COLOR_16_SWAP
+    "ee.vldbc.16.ip q5, %[k], 2\n"
+    "ssai 0\n"
+    "ee.vmul.u16 q6, q0, q5\n"
+    "ee.vmul.u16 q7, q1, q5\n"
+    "ssai 16\n"
+    "ee.vmul.u16 q0, q0, q5\n"
+    "ee.vmul.u16 q1, q1, q5\n"
+    "ee.orq q0, q0, q6\n"
+    "ee.orq q1, q1, q7\n"
+#endif
+    "ee.vldbc.16.ip q3, %[k], 2\n"
+    "ee.vsubs.s16 q3, q3, q2\n"
+    // red
+    "ee.vldbc.16.ip q5, %[k], 2\n"
+    "ee.andq q6, q1, q5\n"
+    "ee.andq q7, q0, q5\n"
+    "ssai 11\n"
+    "ee.vmul.u16 q6, q6, q2\n"
+    "ee.vmul.u16 q7, q7, q3\n"
+    "ee.vadds.s16 q6, q6, q7\n"
+    "ee.vldbc.16.ip q7, %[k], 2\n"
+    "ee.vadds.s16 q6, q6, q7\n"
+    "ee.vldbc.16.ip q7, %[k], 2\n"
+    "ssai 23\n"
+    "ee.vmul.u16 q6, q6, q7\n"
+    "ee.vldbc.16.ip q7, %[k], 2\n"
+    "ssai 0\n"
+    "ee.vmul.u16 q4, q6, q7\n"
+    // green
+    "ee.vldbc.16.ip q5, %[k], 2\n"
+    "ee.andq q6, q1, q5\n"
+    "ee.andq q7, q0, q5\n"
+    "ssai 5\n"
+    "ee.vmul.u16 q6, q6, q2\n"
+    "ee.vmul.u16 q7, q7, q3\n"
+    "ee.vadds.s16 q6, q6, q7\n"
+    "ee.vldbc.16.ip q7, %[k], 2\n"
+    "ee.vadds.s16 q6, q6, q7\n"
+    "ee.vldbc.16.ip q7, %[k], 2\n"
+    "ssai 23\n"
+    "ee.vmul.u16 q6, q6, q7\n"
+    "ee.vldbc.16.ip q7, %[k], 2\n"
+    "ssai 0\n"
+    "ee.vmul.u16 q6, q6, q7\n"
+    "ee.orq q4, q4, q6\n"
+    // blue
+    "ee.vldbc.16.ip q5, %[k], 2\n"
+    "ee.andq q6, q1, q5\n"
+    "ee.andq q7, q0, q5\n"
+    "ee.vmul.u16 q6, q6, q2\n"
+    "ee.vmul.u16 q7, q7, q3\n"
+    "ee.vadds.s16 q6, q6, q7\n"
+    "ee.vldbc.16.ip q7, %[k], 2\n"
+    "ee.vadds.s16 q6, q6, q7\n"
+    "ee.vldbc.16.ip q7, %[k], 2\n"
+    "ssai 23\n"
+    "ee.vmul.u16 q6, q6, q7\n"
+    "ee.orq q4, q4, q6\n"
+#if LV_COLOR_16_SWAP
+    "ee.vldbc.16.ip q5, %[k], 2\n"
+    "ssai 0\n"
+    "ee.vmul.u16 q6, q4, q5\n"
+    "ssai 16\n"
+    "ee.vmul.u16 q4, q4, q5\n"
+    "ee.orq q4, q4, q6\n"
+#endif
+    "ee.vst.128.ip q4, %[dst], 16\n"
+    "addi %[k], %[k], %[rewind]\n"
+    "1:\n"
+    : [dst] "+r"(dst), [src] "+r"(src), [a] "+r"(alpha), [k] "+r"(k)
+    : [n] "r"(n16), [step] "r"(src_step), [rewind] "i"(-(int)sizeof(px_mix_k))
+    : "memory");
+}
+#endif
+
+void px_fill(lv_color_t *dst, lv_color_t color, uint32_t n) {
+  uint16_t *d = (uint16_t *)dst;
+  uint16_t c = color.full;
+#if PX_USE_PIE
+  // Scalar up to a 16-byte boundary, vectors for the middle, scalar tail
+  while (n && ((uintptr_t)d & 15)) {
+    *d++ = c;
+    n--;
+  }
+  if (n >= 8) {
+    uint16_t pattern[8] __attribute__((aligned(16))) = { c, c, c, c, c, c, c, c };
+    px_fill_pie(d, pattern, n / 8);
+    d += n & ~7u;
+    n &= 7;
+  }
+#else
+  // Two pixels per word once aligned
+  if (n && ((uintptr_t)d & 2)) {
+    *d++ = c;
+    n--;
+  }
+  uint32_t cc = ((uint32_t)c << 16) | c;
+  uint32_t *d32 = (uint32_t *)d;
+  for (uint32_t i = 0; i < n / 2; i++) d32[i] = cc;
+  d += n & ~1u;
+  n &= 1;
+#endif
+  while (n--) *d++ = c;
+}
+
+void px_copy(lv_color_t *dst, const lv_color_t *src, uint32_t n) {
+#if PX_USE_PIE
+  uint16_t *d = (uint16_t *)dst;
+  const uint16_t *s = (const uint16_t *)src;
+  if ((((uintptr_t)d ^ (uintptr_t)s) & 15) == 0) {
+    while (n && ((uintptr_t)d & 15)) {
+      *d++ = *s++;
+      n--;
+    }
+    if (n >= 8) {
+      px_copy_pie(d, s, n / 8);
+      d += n & ~7u;
+      s += n & ~7u;
+      n &= 7;
+    }
+    while (n--) *d++ = *s++;
+    return;
+  }
+#endif
+  memcpy(dst, src, n * sizeof(lv_color_t));
+}
+
+// Per-channel results of lv_color_mix_premult() for one colour/opacity pair,
+// each entry holding only its own channel's bits
+typedef struct {
+  uint16_t r[32];
+  uint16_t g[64];
+  uint16_t b[32];
+} px_mix_lut_t;
+
+static void px_build_lut(px_mix_lut_t *lut, lv_color_t color, lv_opa_t opa) {
+  uint16_t premult[3];
+  lv_color_premult(color, opa, premult);
+  lv_opa_t opa_inv = 255 - opa;
+  lv_color_t c, m;
+  for (uint32_t i = 0; i < 64; i++) {
+    c.full = 0;
+    if (i < 32) {
+      LV_COLOR_SET_R(c, i);
+      m = lv_color_mix_premult(premult, c, opa_inv);
+      c.full = 0;
+      LV_COLOR_SET_R(c, LV_COLOR_GET_R(m));
+      lut->r[i] = c.full;
+
+      c.full = 0;
+      LV_COLOR_SET_B(c, i);
+      m = lv_color_mix_premult(premult, c, opa_inv);
+      c.full = 0;
+      LV_COLOR_SET_B(c, LV_COLOR_GET_B(m));
+      lut->b[i] = c.full;
+    }
+    c.full = 0;
+    LV_COLOR_SET_G(c, i);
+    m = lv_color_mix_premult(premult, c, opa_inv);
+    c.full = 0;
+    LV_COLOR_SET_G(c, LV_COLOR_GET_G(m));
+    lut->g[i] = c.full;
+  }
+}
+
+static inline uint16_t px_lut_mix(const px_mix_lut_t *lut, lv_color_t p) {
+  return lut->r[LV_COLOR_GET_R(p)] | lut->g[LV_COLOR_GET_G(p)] | lut->b[LV_COLOR_GET_B(p)];
+}
+
+void px_recolor(lv_color_t *dst, const lv_color_t *src, uint32_t n, lv_color_t color, lv_opa_t opa) {
+  static px_mix_lut_t lut;
+  static lv_color_t lut_color;
+  static lv_opa_t lut_opa = 0;  // 0 never reaches here, so the first call builds
+  if (lut_opa != opa || lut_color.full != color.full) {
+    px_build_lut(&lut, color, opa);
+    lut_color = color;
+    lut_opa = opa;
+  }
+  for (uint32_t i = 0; i < n; i++) dst[i].full = px_lut_mix(&lut, src[i]);
+}
+
+// LVGL's lv_color_mix() for one pixel
+static inline uint16_t px_mix1(uint16_t src, uint16_t dst, lv_opa_t a) {
+  lv_color_t s, d;
+  s.full = src;
+  d.full = dst;
+  return lv_color_mix(s, d, a).full;
+}
+
+static void px_blend_scalar(uint16_t *d, const uint16_t *s, uint32_t s_step, const lv_opa_t *a, uint32_t n) {
+  for (uint32_t i = 0; i < n; i++, s += s_step) {
+    if (a[i] == LV_OPA_TRANSP) continue;
+    d[i] = a[i] == LV_OPA_COVER ? *s : px_mix1(*s, d[i], a[i]);
+  }
+}
+
+// s_step is 1 for an image, 0 for a single colour
+static void px_blend_run(uint16_t *d, const uint16_t *s, uint32_t s_step, const lv_opa_t *a, uint32_t n) {
+#if PX_USE_PIE
+  if (s_step == 0 || (((uintptr_t)d ^ (uintptr_t)s) & 15) == 0) {
+    while (n && ((uintptr_t)d & 15)) {
+      px_blend_scalar(d++, s, s_step, a++, 1);
+      s += s_step;
+      n--;
+    }
+    // Blocks of 8 that are fully transparent or fully covered need no
+    // arithmetic, as in LVGL; runs of the others go to the vector unit with
+    // their alpha widened to 16 bits
+    enum { RUN = 128 };
+    uint16_t a16[RUN] __attribute__((aligned(16)));
+    uint16_t pattern[8] __attribute__((aligned(16)));
+    if (s_step == 0)
+      for (int i = 0; i < 8; i++) pattern[i] = *s;
+    uint16_t *run_d = d;
+    const uint16_t *run_s = s;
+    uint32_t run = 0;
+    while (n >= 8) {
+      uint32_t lo, hi;
+      memcpy(&lo, a, 4);
+      memcpy(&hi, a + 4, 4);
+      bool mixed = (lo | hi) != 0 && (lo & hi) != 0xFFFFFFFFu;
+      if (mixed) {
+        if (run == 0) {
+          run_d = d;
+          run_s = s;
+        }
+        for (int i = 0; i < 8; i++) a16[run + i] = a[i];
+        run += 8;
+      } else if (lo) {
+        for (int i = 0; i < 8; i++) d[i] = s[i * s_step];
+      }
+      d += 8;
+      s += 8 * s_step;
+      a += 8;
+      n -= 8;
+      if (run && (!mixed || run == RUN || n < 8)) {
+        px_mix_pie(run_d, s_step ? run_s : pattern, a16, run / 8, s_step * 16);
+        run = 0;
+      }
+    }
+  }
+#endif
+  px_blend_scalar(d, s, s_step, a, n);
+}
+
+void px_blend(lv_color_t *dst, const lv_color_t *src, const lv_opa_t *alpha, uint32_t n) {
+  px_blend_run((uint16_t *)dst, (const uint16_t *)src, 1, alpha, n);
+}
+
+void px_blend_color(lv_color_t *dst, lv_color_t color, const lv_opa_t *alpha, uint32_t n) {
+  px_blend_run((uint16_t *)dst, &color.full, 0, alpha, n);
+}
+
+/******************************************************************************
+ * LVGL hook
+ ******************************************************************************/
+// Uniform-opacity fill as LVGL's fill_normal() does it: the result is cached
+// for runs of equal destination pixels, and the cache starts out holding
+// lv_color_mix() of black. Keeping that behaviour keeps the output identical.
+static void px_blend_fill(lv_color_t *dest, lv_coord_t stride, int32_t w, int32_t h,
+                          lv_color_t color, lv_opa_t opa) {
+  lv_color_t last_dest = lv_color_black();
+  lv_color_t last_res = lv_color_mix(color, last_dest, opa);
+  for (int32_t y = 0; y < h; y++) {
+    for (int32_t x = 0; x < w; x++) {
+      if (dest[x].full != last_dest.full) {
+        last_dest = dest[x];
+        px_recolor(&last_res, &last_dest, 1, color, opa);
+      }
+      dest[x] = last_res;
+    }
+    dest += stride;
+  }
+}
+
+// Masked fills and masked or translucent images. The alpha of each pixel is
+// the mask, the opacity or their product, chosen and rounded the way LVGL's
+// fill_normal() and map_normal() do it (they differ slightly), so the
+// output stays identical.
+static void px_blend_alpha(lv_color_t *dest, lv_coord_t dest_stride, const lv_color_t *src, lv_coord_t src_stride,
+                           lv_color_t color, const lv_opa_t *mask, lv_coord_t mask_stride, int32_t w, int32_t h,
+                           lv_opa_t opa) {
+  // Near-full opacity: the mask alone
+  bool mask_only = mask && (src ? opa > LV_OPA_MAX : opa >= LV_OPA_MAX);
+  // Mask values from which the opacity is taken unscaled
+  lv_opa_t full = src ? LV_OPA_MAX : LV_OPA_COVER;
+  lv_opa_t *alpha = NULL;
+  if (!mask_only) {
+    alpha = (lv_opa_t *)lv_mem_buf_get(w);
+    if (!mask) memset(alpha, opa, w);
+  }
+  for (int32_t y = 0; y < h; y++) {
+    if (mask && alpha) {
+      for (int32_t x = 0; x < w; x++) alpha[x] = mask[x] >= full ? opa : (lv_opa_t)((mask[x] * opa) >> 8);
+    }
+    const lv_opa_t *a = alpha ? alpha : mask;
+    if (src) {
+      px_blend(dest, src, a, w);
+      src += src_stride;
+    } else {
+      px_blend_color(dest, color, a, w);
+    }
+    dest += dest_stride;
+    if (mask) mask += mask_stride;
+  }
+  if (alpha) lv_mem_buf_release(alpha);
+}
+
+static void px_draw_blend(lv_draw_ctx_t *draw_ctx, const lv_draw_sw_blend_dsc_t *dsc) {
+  if (dsc->opa <= LV_OPA_MIN) return;
+  if (dsc->mask_buf && dsc->mask_res == LV_DRAW_MASK_RES_TRANSP) return;
+
+  lv_disp_t *disp = _lv_refr_get_disp_refreshing();
+  if (dsc->blend_mode != LV_BLEND_MODE_NORMAL || disp->driver->set_px_cb || disp->driver->screen_transp) {
+    g_px_stats.fallbacks++;
+    lv_draw_sw_blend_basic(draw_ctx, dsc);
+    return;
+  }
+
+  lv_area_t blend_area;
+  if (!_lv_area_intersect(&blend_area, dsc->blend_area, draw_ctx->clip_area)) return;
+
+  lv_coord_t dest_stride = lv_area_get_width(draw_ctx->buf_area);
+  lv_color_t *dest = (lv_color_t *)draw_ctx->buf;
+  dest += dest_stride * (blend_area.y1 - draw_ctx->buf_area->y1) + (blend_area.x1 - draw_ctx->buf_area->x1);
+  int32_t w = lv_area_get_width(&blend_area);
+  int32_t h = lv_area_get_height(&blend_area);
+
+  lv_coord_t src_stride = 0;
+  const lv_color_t *src = dsc->src_buf;
+  if (src) {
+    src_stride = lv_area_get_width(dsc->blend_area);
+    src += src_stride * (blend_area.y1 - dsc->blend_area->y1) + (blend_area.x1 - dsc->blend_area->x1);
+  }
+  lv_coord_t mask_stride = 0;
+  const lv_opa_t *mask = dsc->mask_res == LV_DRAW_MASK_RES_FULL_COVER ? NULL : dsc->mask_buf;
+  if (mask) {
+    mask_stride = lv_area_get_width(dsc->mask_area);
+    mask += mask_stride * (blend_area.y1 - dsc->mask_area->y1) + (blend_area.x1 - dsc->mask_area->x1);
+  }
+
+  if (mask || (src && dsc->opa < LV_OPA_MAX)) {
+    px_blend_alpha(dest, dest_stride, src, src_stride, dsc->color, mask, mask_stride, w, h, dsc->opa);
+    g_px_stats.masked++;
+  } else if (src) {
+    for (int32_t y = 0; y < h; y++) {
+      px_copy(dest, src, w);
+      dest += dest_stride;
+      src += src_stride;
+    }
+    g_px_stats.copies++;
+  } else if (dsc->opa >= LV_OPA_MAX) {
+    for (int32_t y = 0; y < h; y++) {
+      px_fill(dest, dsc->color, w);
+      dest += dest_stride;
+    }
+    g_px_stats.fills++;
+  } else {
+    px_blend_fill(dest, dest_stride, w, h, dsc->color, dsc->opa);
+    g_px_stats.blends++;
+  }
+}
+
+// lv_draw_sw_img_decoded() for recoloured true-colour images drawn without
+// rotation or zoom: the same conversion in the same chunks, with the
+// recolour pass on px_recolor. Everything else is left to LVGL.
+static void px_draw_img_decoded(lv_draw_ctx_t *draw_ctx, const lv_draw_img_dsc_t *draw_dsc, const lv_area_t *coords,
+                                const uint8_t *src_buf, lv_img_cf_t cf) {
+  if (draw_dsc->recolor_opa <= LV_OPA_MIN || draw_dsc->angle || draw_dsc->zoom != LV_IMG_ZOOM_NONE ||
+      (cf != LV_IMG_CF_TRUE_COLOR && cf != LV_IMG_CF_TRUE_COLOR_ALPHA)) {
+    lv_draw_sw_img_decoded(draw_ctx, draw_dsc, coords, src_buf, cf);
+    return;
+  }
+
+  lv_area_t blend_area = *draw_ctx->clip_area;
+  bool mask_any = lv_draw_mask_is_any(&blend_area);
+  lv_coord_t src_w = lv_area_get_width(coords);
+  lv_coord_t blend_w = lv_area_get_width(&blend_area);
+  uint32_t max_buf_size = lv_disp_get_hor_res(_lv_refr_get_disp_refreshing());
+  uint32_t buf_h = lv_area_get_size(&blend_area) <= max_buf_size ? (uint32_t)lv_area_get_height(&blend_area)
+                                                                   : max_buf_size / blend_w;
+  lv_color_t *rgb_buf = (lv_color_t *)lv_mem_buf_get(blend_w * buf_h * sizeof(lv_color_t));
+  lv_opa_t *mask_buf = (lv_opa_t *)lv_mem_buf_get(blend_w * buf_h);
+
+  lv_draw_sw_blend_dsc_t blend_dsc;
+  memset(&blend_dsc, 0, sizeof(blend_dsc));
+  blend_dsc.opa = draw_dsc->opa;
+  blend_dsc.blend_mode = draw_dsc->blend_mode;
+  blend_dsc.blend_area = &blend_area;
+  blend_dsc.src_buf = rgb_buf;
+  blend_dsc.mask_buf = mask_buf;
+  blend_dsc.mask_area = &blend_area;
+  blend_dsc.mask_res = cf == LV_IMG_CF_TRUE_COLOR ? LV_DRAW_MASK_RES_FULL_COVER : LV_DRAW_MASK_RES_CHANGED;
+
+  lv_coord_t y_last = blend_area.y2;
+  blend_area.y2 = blend_area.y1 + buf_h - 1;
+  while (blend_area.y1 <= y_last) {
+    int32_t h = lv_area_get_height(&blend_area);
+    uint32_t first = src_w * (blend_area.y1 - coords->y1) + (blend_area.x1 - coords->x1);
+    if (cf == LV_IMG_CF_TRUE_COLOR) {
+      const lv_color_t *src = (const lv_color_t *)src_buf + first;
+      for (int32_t y = 0; y < h; y++) memcpy(rgb_buf + y * blend_w, src + y * src_w, blend_w * sizeof(lv_color_t));
+      memset(mask_buf, LV_OPA_COVER, blend_w * h);
+    } else {
+      const uint8_t *src = src_buf + first * LV_IMG_PX_SIZE_ALPHA_BYTE;
+      for (int32_t y = 0; y < h; y++) {
+        lv_color_t *c = rgb_buf + y * blend_w;
+        lv_opa_t *a = mask_buf + y * blend_w;
+        const uint8_t *p = src + y * src_w * LV_IMG_PX_SIZE_ALPHA_BYTE;
+        for (int32_t x = 0; x < blend_w; x++, p += LV_IMG_PX_SIZE_ALPHA_BYTE) {
+          c[x].full = p[0] | (p[1] << 8);
+          a[x] = p[2];
+        }
+      }
+    }
+    px_recolor(rgb_buf, rgb_buf, blend_w * h, draw_dsc->recolor, draw_dsc->recolor_opa);
+#if LV_DRAW_COMPLEX
+    if (mask_any) {
+      lv_opa_t *line = mask_buf;
+      for (lv_coord_t y = blend_area.y1; y <= blend_area.y2; y++, line += blend_w) {
+        lv_draw_mask_res_t res = lv_draw_mask_apply(line, blend_area.x1, y, blend_w);
+        if (res == LV_DRAW_MASK_RES_TRANSP) memset(line, 0, blend_w);
+        if (res == LV_DRAW_MASK_RES_TRANSP || res == LV_DRAW_MASK_RES_CHANGED)
+          blend_dsc.mask_res = LV_DRAW_MASK_RES_CHANGED;
+      }
+    }
+#endif
+    lv_draw_sw_blend(draw_ctx, &blend_dsc);
+
+    blend_area.y1 = blend_area.y2 + 1;
+    blend_area.y2 = blend_area.y1 + buf_h - 1;
+    if (blend_area.y2 > y_last) blend_area.y2 = y_last;
+  }
+
+  lv_mem_buf_release(mask_buf);
+  lv_mem_buf_release(rgb_buf);
+  g_px_stats.recolors++;
+}
+
+void px_draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx) {
+  lv_draw_sw_init_ctx(drv, draw_ctx);
+  ((lv_draw_sw_ctx_t *)draw_ctx)->blend = px_draw_blend;
+  draw_ctx->draw_img_decoded = px_draw_img_decoded;
+}
+
+void px_get_stats(px_stats_t *out) {
+  *out = g_px_stats;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <lvgl.h>
+
+// Pixel kernels for lv_color_t (RGB565) buffers. Each one has a portable C
+// version. On the ESP32-S3, fill, copy and the per-pixel alpha blend also
+// move the 16-byte aligned middle of every run through the PIE 128-bit
+// vector unit; anything else (mismatched alignment, short runs, other
+// targets) takes the C path. The alpha blend computes LVGL's lv_color_mix()
+// per channel with the same rounding; the recolor kernel works through small
+// lookup tables built with LVGL's own mixing functions. Either way results
+// are identical to LVGL's. Set PX_USE_PIE to 0 to force the portable versions.
+#ifndef PX_USE_PIE
+#if defined(CONFIG_IDF_TARGET_ESP32S3)
+#define PX_USE_PIE 1
+#else
+#define PX_USE_PIE 0
+#endif
+#endif
+
+void px_fill(lv_color_t *dst, lv_color_t color, uint32_t n);
+void px_copy(lv_color_t *dst, const lv_color_t *src, uint32_t n);
+// dst[i] = mix(color, src[i], opa), the way LVGL fills and recolors
+// (dst may equal src)
+void px_recolor(lv_color_t *dst, const lv_color_t *src, uint32_t n, lv_color_t color, lv_opa_t opa);
+// dst[i] = mix(src[i], dst[i], alpha[i]), the way LVGL blends masked and
+// translucent images (alpha 0 keeps dst, 255 takes src)
+void px_blend(lv_color_t *dst, const lv_color_t *src, const lv_opa_t *alpha, uint32_t n);
+// The same with one colour for every pixel, as masked fills (text,
+// anti-aliased edges) blend
+void px_blend_color(lv_color_t *dst, lv_color_t color, const lv_opa_t *alpha, uint32_t n);
+
+typedef struct {
+  uint32_t fills;      // opaque fills taken by px_fill
+  uint32_t blends;     // uniform-opacity fills taken by px_recolor
+  uint32_t copies;     // opaque image copies taken by px_copy
+  uint32_t masked;     // masked fills, masked or translucent images taken by px_blend
+  uint32_t recolors;   // recoloured images whose recolour ran on px_recolor
+  uint32_t fallbacks;  // blends left to LVGL (blend modes, set_px_cb, ...)
+} px_stats_t;
+
+// draw_ctx_init for lv_disp_drv_t: LVGL's software renderer with the normal
+// blend mode of its blend step, and the recolour of untransformed images,
+// routed to the kernels
+void px_draw_ctx_init(lv_disp_drv_t *drv, lv_draw_ctx_t *draw_ctx);
+void px_get_stats(px_stats_t *out);
@@ -2,6 +2,13 @@
 #include "SPI.h"
 #include "Arduino.h"
 #include "driver/spi_master.h"
+#include "driver/gpio.h"
+#include "esp_attr.h"
+#include "esp_rom_gpio.h"
+#include "soc/spi_periph.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
 
 const static lcd_cmd_t rm67162_spi_init[] = {
   { 0xFE, { 0x00 }, 0x01 },  // PAGE
@@ -20,19 +27,134 @@ const static lcd_cmd_t rm67162_spi_init[] = {
 const static lcd_cmd_t rm67162_qspi_init[] = {
   { 0x11, { 0x00 }, 0x80 },  // Sleep Out
   // {0x44, {0x01, 0x66},        0x02}, //Set_Tear_Scanline
-  // {0x35, {0x00},        0x00}, //TE ON
+  { 0x35, { 0x00 }, 0x01 },  // TE ON, V-blank only
   // {0x34, {0x00},        0x00}, //TE OFF
   // {0x36, {0x00},        0x01}, //Scan Direction Control
   { 0x3A, { 0x55 }, 0x01 },  // Interface Pixel Format 16bit/pixel
   // {0x3A, {0x66},        0x01}, //Interface Pixel Format    18bit/pixel
   // {0x3A, {0x77},        0x01}, //Interface Pixel Format    24bit/pixel
   { 0x51, { 0x00 }, 0x01 },  // Write Display Brightness MAX_VAL=0XFF
-  { 0x29, { 0x00 }, 0x80 },  // Display on
+  { 0x29, { 0x00 }, 0x00 },  // Display on
   { 0x51, { 0xD0 }, 0x01 },  // Write Display Brightness   MAX_VAL=0XFF
 };
 
+// Bring-up timing. The panel accepts commands a few ms after reset while it
+// is still asleep; only Sleep Out needs the long wait.
+#define LCD_RESET_LOW_MS 10
+#define LCD_RESET_SETTLE_MS 10
+#define LCD_SLEEP_OUT_MS 120
+#define LCD_INIT_RETRIES 3
+#define LCD_RDDPM_READY 0x14  // RDDPM: sleep out (0x10) + display on (0x04)
+
+static bool lcd_bus_ready = false;
+
 static spi_device_handle_t spi;
 
+#if LCD_USB_QSPI_DREVER == 1
+// Queued transactions must stay valid until the SPI driver hands them back,
+// so asynchronous pushes draw their descriptors from this ring.
+#define LCD_TRANS_CS_END 0x01    // release CS once this transaction is done
+#define LCD_TRANS_NOTIFY 0x02    // call the flush-done callback for this one
+#define LCD_TRANS_CS_BEGIN 0x04  // assert CS right before this transaction
+
+typedef struct {
+  spi_transaction_ext_t t;
+  uint8_t flags;
+  void *user;
+} lcd_queued_trans_t;
+
+static lcd_queued_trans_t lcd_trans_ring[LCD_QUEUE_SIZE];
+static uint32_t lcd_trans_next = 0;
+static uint32_t lcd_trans_inflight = 0;
+#endif
+static lcd_flush_done_cb_t lcd_flush_done_cb = NULL;
+static lcd_push_stats_t lcd_push_stats = { 0 };
+
+// Reusable source for fills and pattern blits, streamed repeatedly by DMA
+DMA_ATTR static uint16_t lcd_tile[LCD_TILE_PX];
+static int32_t lcd_tile_solid = -1;  // colour filling the whole tile, or -1
+
+// Hardware scroll state, see lcd_scroll_enable()
+#define LCD_SCROLL_LINES TFT_HEIGHT
+static bool lcd_scroll_on = false;
+static uint16_t lcd_scroll_pos = 0;
+
+// Tearing-effect gating. Pulses come from the TE pin interrupt, or from any
+// other source calling lcd_te_pulse(). A frame may only start on a fresh
+// pulse that is at least `divider` pulses after the previous frame start.
+#define LCD_TE_TIMEOUT_MS 50  // give up waiting if TE is not wired/enabled
+#define LCD_TE_MAX_DIVIDER 4
+
+static SemaphoreHandle_t lcd_te_sem = NULL;
+static volatile uint32_t lcd_te_count = 0;
+static volatile int64_t lcd_te_last_us = 0;
+static volatile uint32_t lcd_te_period_us = 0;  // smoothed pulse period
+static uint32_t lcd_te_frame_pulse = 0;         // pulse count at last frame start
+static int64_t lcd_te_frame_start_us = 0;
+static uint8_t lcd_te_divider = 0;              // 0 = TE gating off
+static bool lcd_te_auto = false;
+static bool lcd_te_armed = true;
+static bool lcd_te_attached = false;
+static uint32_t lcd_te_frames = 0;
+static uint32_t lcd_te_timeouts = 0;
+
+static inline bool lcd_te_due(uint32_t now, uint32_t last, uint8_t divider) {
+  return (uint32_t)(now - last) >= divider;
+}
+
+void IRAM_ATTR lcd_te_pulse(void) {
+  int64_t now = esp_timer_get_time();
+  if (lcd_te_last_us) {
+    uint32_t dt = (uint32_t)(now - lcd_te_last_us);
+    lcd_te_period_us = lcd_te_period_us ? (lcd_te_period_us * 7 + dt) / 8 : dt;
+  }
+  lcd_te_last_us = now;
+  lcd_te_count++;
+  if (!lcd_te_sem) return;
+  if (xPortInIsrContext()) {
+    BaseType_t woken = pdFALSE;
+    xSemaphoreGiveFromISR(lcd_te_sem, &woken);
+    if (woken) portYIELD_FROM_ISR();
+  } else {
+    xSemaphoreGive(lcd_te_sem);
+  }
+}
+
+static void IRAM_ATTR lcd_te_isr(void) {
+  lcd_te_pulse();
+}
+
+// The pin interrupt is only wanted while gating is on: ~60 interrupts a
+// second for nothing otherwise
+static void lcd_te_attach(bool on) {
+  if (on == lcd_te_attached || !lcd_bus_ready) return;
+  if (on) {
+    pinMode(TFT_TE, INPUT);
+    attachInterrupt(TFT_TE, lcd_te_isr, RISING);
+  } else {
+    detachInterrupt(TFT_TE);
+  }
+  lcd_te_attached = on;
+}
+
+// Hold back the first push of a frame until the panel signals V-blank
+void lcd_te_frame_begin(void) {
+  if (!lcd_te_divider || !lcd_te_armed || !lcd_te_sem) return;
+  lcd_te_armed = false;
+
+  xSemaphoreTake(lcd_te_sem, 0);  // an edge already in the past is no use
+  do {
+    if (xSemaphoreTake(lcd_te_sem, pdMS_TO_TICKS(LCD_TE_TIMEOUT_MS)) != pdTRUE) {
+      lcd_te_timeouts++;
+      break;
+    }
+  } while (!lcd_te_due(lcd_te_count, lcd_te_frame_pulse, lcd_te_divider));
+
+  lcd_te_frame_pulse = lcd_te_count;
+  lcd_te_frame_start_us = esp_timer_get_time();
+  lcd_te_frames++;
+}
+
 static void WriteComm(uint8_t data) {
   TFT_CS_L;
   SPI.beginTransaction(SPISettings(SPI_FREQUENCY, MSBFIRST, TFT_SPI_MODE));
@@ -61,8 +183,75 @@ static void WriteData16(uint16_t data) {
   TFT_CS_H;
 }
 
+#if LCD_USB_QSPI_DREVER == 1
+// Run in the SPI ISR. Polling transactions leave t->user NULL and are ignored.
+static void lcd_spi_pre_cb(spi_transaction_t *t) {
+  lcd_queued_trans_t *q = (lcd_queued_trans_t *)t->user;
+  if (q && (q->flags & LCD_TRANS_CS_BEGIN))
+    gpio_set_level((gpio_num_t)TFT_CS, 0);
+}
+
+static void lcd_spi_post_cb(spi_transaction_t *t) {
+  lcd_queued_trans_t *q = (lcd_queued_trans_t *)t->user;
+  if (!q) return;
+  if (q->flags & LCD_TRANS_CS_END)
+    gpio_set_level((gpio_num_t)TFT_CS, 1);
+  if ((q->flags & LCD_TRANS_NOTIFY) && lcd_flush_done_cb)
+    lcd_flush_done_cb(q->user);
+}
+
+// Collect finished queued transactions until at most max_inflight remain.
+static void lcd_reclaim(uint32_t max_inflight) {
+  spi_transaction_t *done;
+  while (lcd_trans_inflight > max_inflight) {
+    spi_device_get_trans_result(spi, &done, portMAX_DELAY);
+    lcd_trans_inflight--;
+  }
+}
+
+// Next free descriptor of the ring, zeroed
+static lcd_queued_trans_t *lcd_trans_alloc(void) {
+  lcd_reclaim(LCD_QUEUE_SIZE - 1);
+  lcd_queued_trans_t *q = &lcd_trans_ring[lcd_trans_next];
+  lcd_trans_next = (lcd_trans_next + 1) % LCD_QUEUE_SIZE;
+  memset(q, 0, sizeof(*q));
+  q->t.base.user = q;
+  return q;
+}
+
+static void lcd_trans_submit(lcd_queued_trans_t *q) {
+  spi_device_queue_trans(spi, (spi_transaction_t *)&q->t, portMAX_DELAY);
+  lcd_trans_inflight++;
+  lcd_push_stats.transactions++;
+}
+
+// Queued counterpart of lcd_send_cmd(): one CS-framed transaction, data
+// carried inline so the caller's buffer can go out of scope.
+static void lcd_queue_cmd(uint8_t cmd, const uint8_t *dat, uint32_t len) {
+  lcd_queued_trans_t *q = lcd_trans_alloc();
+  q->flags = LCD_TRANS_CS_BEGIN | LCD_TRANS_CS_END;
+  q->t.base.flags = (SPI_TRANS_MULTILINE_CMD | SPI_TRANS_MULTILINE_ADDR);
+  q->t.base.cmd = 0x02;
+  q->t.base.addr = cmd << 8;
+  if (len != 0) {
+    q->t.base.flags |= SPI_TRANS_USE_TXDATA;
+    memcpy(q->t.base.tx_data, dat, len);
+    q->t.base.length = 8 * len;
+  }
+  lcd_trans_submit(q);
+}
+#endif
+
+void lcd_wait_idle() {
+#if LCD_USB_QSPI_DREVER == 1
+  lcd_reclaim(0);
+#endif
+}
+
 static void lcd_send_cmd(uint32_t cmd, uint8_t *dat, uint32_t len) {
 #if LCD_USB_QSPI_DREVER == 1
+  // Polling transactions may not overlap queued ones on the same device
+  lcd_wait_idle();
   TFT_CS_L;
   spi_transaction_t t;
   memset(&t, 0, sizeof(t));
@@ -88,14 +277,58 @@ static void lcd_send_cmd(uint32_t cmd, uint8_t *dat, uint32_t len) {
 #endif
 }
 
-void rm67162_init(void) {
-  pinMode(TFT_CS, OUTPUT);
-  pinMode(TFT_RES, OUTPUT);
+// Read one register back, -1 if this bus mode cannot read
+static int lcd_read_reg(uint8_t reg) {
+#if LCD_USB_QSPI_DREVER == 1
+  lcd_wait_idle();
+  // The panel answers single-line reads on SDO; borrow the SPI input for it
+  int spiq = spi_periph_signal[TFT_SPI_HOST].spiq_in;
+  esp_rom_gpio_connect_in_signal(TFT_SDO, spiq, false);
+  TFT_CS_L;
+  spi_transaction_t t;
+  memset(&t, 0, sizeof(t));
+  t.flags = SPI_TRANS_USE_RXDATA;
+  t.cmd = 0x03;
+  t.addr = reg << 8;
+  t.rxlength = 8;
+  spi_device_polling_transmit(spi, &t);
+  TFT_CS_H;
+  esp_rom_gpio_connect_in_signal(TFT_QSPI_D1, spiq, false);
+  return t.rx_data[0];
+#else
+  return -1;
+#endif
+}
 
+static void lcd_reset(void) {
   TFT_RES_L;
-  delay(300);
+  delay(LCD_RESET_LOW_MS);
   TFT_RES_H;
-  delay(200);
+  delay(LCD_RESET_SETTLE_MS);
+}
+
+static void lcd_run_init_table(void) {
+#if LCD_USB_QSPI_DREVER == 1
+  const lcd_cmd_t *lcd_init = rm67162_qspi_init;
+  for (int i = 0; i < sizeof(rm67162_qspi_init) / sizeof(lcd_cmd_t); i++)
+#else
+  const lcd_cmd_t *lcd_init = rm67162_spi_init;
+  for (int i = 0; i < sizeof(rm67162_spi_init) / sizeof(lcd_cmd_t); i++)
+#endif
+  {
+    lcd_send_cmd(lcd_init[i].cmd,
+                 (uint8_t *)lcd_init[i].data,
+                 lcd_init[i].len & 0x7f);
+
+    if (lcd_init[i].len & 0x80)
+      delay(LCD_SLEEP_OUT_MS);
+  }
+}
+
+static void lcd_bus_init(void) {
+  pinMode(TFT_CS, OUTPUT);
+  pinMode(TFT_RES, OUTPUT);
+  pinMode(TFT_SDO, INPUT);
 
 #if LCD_USB_QSPI_DREVER == 1
   esp_err_t ret;
@@ -119,7 +352,9 @@ void rm67162_init(void) {
     .spics_io_num = -1,
     // .spics_io_num = TFT_QSPI_CS,
     .flags = SPI_DEVICE_HALFDUPLEX,
-    .queue_size = 17,
+    .queue_size = LCD_QUEUE_SIZE,
+    .pre_cb = lcd_spi_pre_cb,
+    .post_cb = lcd_spi_post_cb,
   };
   ret = spi_bus_initialize(TFT_SPI_HOST, &buscfg, SPI_DMA_CH_AUTO);
   ESP_ERROR_CHECK(ret);
@@ -131,25 +366,34 @@ void rm67162_init(void) {
   SPI.setFrequency(SPI_FREQUENCY);
   pinMode(TFT_DC, OUTPUT);
 #endif
-  // Initialize the screen multiple times to prevent initialization failure
-  int i = 3;
-  while (i--) {
-#if LCD_USB_QSPI_DREVER == 1
-    const lcd_cmd_t *lcd_init = rm67162_qspi_init;
-    for (int i = 0; i < sizeof(rm67162_qspi_init) / sizeof(lcd_cmd_t); i++)
-#else
-    const lcd_cmd_t *lcd_init = rm67162_spi_init;
-    for (int i = 0; i < sizeof(rm67162_spi_init) / sizeof(lcd_cmd_t); i++)
+
+  lcd_te_sem = xSemaphoreCreateBinary();
+  lcd_bus_ready = true;
+  lcd_te_attach(lcd_te_divider > 0);
+}
+
+bool rm67162_init(void) {
+  if (!lcd_bus_ready) lcd_bus_init();
+  lcd_scroll_on = false;
+  lcd_scroll_pos = 0;
+#if LCD_TE_SYNC
+  lcd_te_set_divider(1, true);
 #endif
-    {
-      lcd_send_cmd(lcd_init[i].cmd,
-                   (uint8_t *)lcd_init[i].data,
-                   lcd_init[i].len & 0x7f);
 
-      if (lcd_init[i].len & 0x80)
-        delay(120);
+  // One pass, then ask the panel whether it took; only retry on a mismatch
+  for (int attempt = 1; attempt <= LCD_INIT_RETRIES; attempt++) {
+    lcd_reset();
+    lcd_run_init_table();
+
+    int mode = lcd_read_reg(0x0A);
+    if (mode < 0) return true;  // no read-back on this bus, trust the pass
+    if ((mode & LCD_RDDPM_READY) == LCD_RDDPM_READY) {
+      Serial.printf("rm67162: ready (id 0x%02X, attempt %d)\n", lcd_read_reg(0xDA), attempt);
+      return true;
     }
+    Serial.printf("rm67162: power mode 0x%02X after init, retrying\n", mode);
   }
+  return false;
 }
 
 void lcd_setRotation(uint8_t r) {
@@ -189,19 +433,23 @@ void lcd_fill(uint16_t xsta,
               uint16_t xend,
               uint16_t yend,
               uint16_t color) {
+  lcd_fill_rect(xsta, ysta, xend - xsta, yend - ysta, color);
+}
 
-  uint16_t w = xend - xsta;
-  uint16_t h = yend - ysta;
-  uint16_t *color_p = (uint16_t *)ps_malloc(w * h * 2);
-  if (!color_p) {
-    return;
-  }
-  memset(color_p, color, w * h * 2);
-  lcd_PushColors(xsta, ysta, w, h, color_p);
-  free(color_p);
+// Frame-memory column of logical column x under the current scroll offset.
+// *fit is how many of the `width` columns fit before the scroll area wraps.
+static uint16_t lcd_scroll_map(uint16_t x, uint16_t width, uint16_t *fit) {
+  uint16_t m = (x + lcd_scroll_pos) % LCD_SCROLL_LINES;
+  *fit = (m + width > LCD_SCROLL_LINES) ? LCD_SCROLL_LINES - m : width;
+  return m;
 }
 
+static void lcd_push_wrapped(uint16_t x, uint16_t y, uint16_t width, uint16_t fit, uint16_t high,
+                             const uint16_t *data, bool notify, void *user);
+
 void lcd_DrawPoint(uint16_t x, uint16_t y, uint16_t color) {
+  uint16_t fit;
+  if (lcd_scroll_on) x = lcd_scroll_map(x, 1, &fit);
   lcd_address_set(x, y, x + 1, y + 1);
   lcd_PushColors(&color, 1);
 }
@@ -211,6 +459,17 @@ void lcd_PushColors(uint16_t x,
                     uint16_t width,
                     uint16_t high,
                     uint16_t *data) {
+  lcd_te_frame_begin();
+  if (lcd_scroll_on) {
+    uint16_t fit;
+    x = lcd_scroll_map(x, width, &fit);
+    if (fit < width) {
+      lcd_push_wrapped(x, y, width, fit, high, data, false, NULL);
+      return;
+    }
+  }
+  lcd_push_stats.windows++;
+  lcd_push_stats.bytes += (uint32_t)width * high * 2;
 #if LCD_USB_QSPI_DREVER == 1
   bool first_send = 1;
   size_t len = width * high;
@@ -302,6 +561,287 @@ void lcd_PushColors(uint16_t *data, uint32_t len) {
 #endif
 }
 
+void lcd_set_flush_done_cb(lcd_flush_done_cb_t cb) {
+  lcd_flush_done_cb = cb;
+}
+
+#if LCD_USB_QSPI_DREVER == 1
+// CASET, RASET and RAMWR + pixels go out as one batch of queued
+// transactions, so a new window never waits for the previous one.
+static void lcd_queue_window(uint16_t x, uint16_t y, uint16_t width, uint16_t high) {
+  uint16_t x2 = x + width - 1;
+  uint16_t y2 = y + high - 1;
+  const uint8_t caset[4] = { uint8_t(x >> 8), (uint8_t)x, (uint8_t)(x2 >> 8), (uint8_t)x2 };
+  const uint8_t raset[4] = { uint8_t(y >> 8), (uint8_t)y, (uint8_t)(y2 >> 8), (uint8_t)y2 };
+  lcd_queue_cmd(0x2a, caset, 4);
+  lcd_queue_cmd(0x2b, raset, 4);
+  lcd_push_stats.windows++;
+  lcd_push_stats.bytes += (uint32_t)width * high * 2;
+}
+
+// Queue `len` pixels into the window opened by lcd_queue_window(). With
+// `wrap` > 0 every chunk restarts at `p`, which streams a tile of `wrap`
+// pixels over and over. The last chunk raises CS and, if `notify`, calls the
+// flush-done callback with `user`. `open`/`close` false let one window be
+// fed by several calls: only the first sends RAMWR, only the last ends it.
+static void lcd_queue_pixels(const uint16_t *p, size_t len, size_t wrap, bool notify, void *user,
+                             bool open = true, bool close = true) {
+  bool first_send = open;
+  size_t step = wrap ? wrap : SEND_BUF_SIZE;
+  do {
+    size_t chunk_size = len;
+    lcd_queued_trans_t *q = lcd_trans_alloc();
+    if (first_send) {
+      q->flags = LCD_TRANS_CS_BEGIN;
+      q->t.base.flags =
+        SPI_TRANS_MODE_QIO /* | SPI_TRANS_MODE_DIOQIO_ADDR */;
+      q->t.base.cmd = 0x32 /* 0x12 */;
+      q->t.base.addr = 0x002C00;
+      first_send = 0;
+    } else {
+      q->t.base.flags = SPI_TRANS_MODE_QIO | SPI_TRANS_VARIABLE_CMD | SPI_TRANS_VARIABLE_ADDR | SPI_TRANS_VARIABLE_DUMMY;
+      q->t.command_bits = 0;
+      q->t.address_bits = 0;
+      q->t.dummy_bits = 0;
+    }
+    if (chunk_size > step) {
+      chunk_size = step;
+    }
+    q->t.base.tx_buffer = p;
+    q->t.base.length = chunk_size * 16;
+    len -= chunk_size;
+    if (!wrap) p += chunk_size;
+    if (len == 0 && close) {
+      q->flags |= LCD_TRANS_CS_END;
+      if (notify) {
+        q->flags |= LCD_TRANS_NOTIFY;
+        q->user = user;
+      }
+    }
+    lcd_trans_submit(q);
+  } while (len > 0);
+}
+#endif
+
+void lcd_PushColorsAsync(uint16_t x,
+                         uint16_t y,
+                         uint16_t width,
+                         uint16_t high,
+                         uint16_t *data,
+                         void *user) {
+#if LCD_USB_QSPI_DREVER == 1
+  lcd_te_frame_begin();
+  if (lcd_scroll_on) {
+    uint16_t fit;
+    x = lcd_scroll_map(x, width, &fit);
+    if (fit < width) {
+      lcd_push_wrapped(x, y, width, fit, high, data, true, user);
+      return;
+    }
+  }
+  lcd_queue_window(x, y, width, high);
+  lcd_queue_pixels(data, (size_t)width * high, 0, true, user);
+#else
+  lcd_PushColors(x, y, width, high, data);
+  if (lcd_flush_done_cb) lcd_flush_done_cb(user);
+#endif
+}
+
+// Stream the first `rows` rows of lcd_tile (already expanded to `width`
+// columns) over and over until the window is full.
+static void lcd_stream_tile(uint16_t x, uint16_t y, uint16_t width, uint16_t high, uint32_t rows) {
+#if LCD_USB_QSPI_DREVER == 1
+  lcd_queue_window(x, y, width, high);
+  lcd_queue_pixels(lcd_tile, (size_t)width * high, (size_t)width * rows, false, NULL);
+#else
+  lcd_push_stats.windows++;
+  lcd_push_stats.bytes += (uint32_t)width * high * 2;
+  lcd_address_set(x, y, x + width - 1, y + high - 1);
+  TFT_CS_L;
+  SPI.beginTransaction(SPISettings(SPI_FREQUENCY, MSBFIRST, TFT_SPI_MODE));
+  TFT_DC_H;
+  for (uint32_t r = 0; r < high; r += rows) {
+    uint32_t n = (high - r < rows) ? high - r : rows;
+    SPI.writeBytes((uint8_t *)lcd_tile, n * width * 2);
+  }
+  SPI.endTransaction();
+  TFT_CS_H;
+#endif
+}
+
+// Push the width x high block at `src` (row pitch `stride`) by copying it
+// into lcd_tile a batch of rows at a time. The last batch may notify.
+static void lcd_push_strided(uint16_t x, uint16_t y, uint16_t width, uint16_t high,
+                             const uint16_t *src, uint32_t stride, bool notify, void *user) {
+  uint32_t rows = LCD_TILE_PX / width;
+  lcd_tile_solid = -1;
+#if LCD_USB_QSPI_DREVER == 1
+  lcd_queue_window(x, y, width, high);
+#else
+  lcd_push_stats.windows++;
+  lcd_push_stats.bytes += (uint32_t)width * high * 2;
+  lcd_address_set(x, y, x + width - 1, y + high - 1);
+  TFT_CS_L;
+  SPI.beginTransaction(SPISettings(SPI_FREQUENCY, MSBFIRST, TFT_SPI_MODE));
+  TFT_DC_H;
+#endif
+  for (uint32_t r = 0; r < high; r += rows) {
+    uint32_t n = (high - r < rows) ? high - r : rows;
+    // The previous batch has to leave the tile before it is refilled
+    lcd_wait_idle();
+    for (uint32_t i = 0; i < n; i++)
+      memcpy(lcd_tile + i * width, src + (r + i) * stride, width * 2);
+#if LCD_USB_QSPI_DREVER == 1
+    bool close = (r + n == high);
+    lcd_queue_pixels(lcd_tile, n * width, 0, notify && close, user, r == 0, close);
+#else
+    SPI.writeBytes((uint8_t *)lcd_tile, n * width * 2);
+#endif
+  }
+#if LCD_USB_QSPI_DREVER != 1
+  SPI.endTransaction();
+  TFT_CS_H;
+  if (notify && lcd_flush_done_cb) lcd_flush_done_cb(user);
+#endif
+}
+
+// A window that crosses the end of the scroll area: the first `fit` columns
+// go to frame-memory column x onwards, the rest to column 0 onwards.
+static void lcd_push_wrapped(uint16_t x, uint16_t y, uint16_t width, uint16_t fit, uint16_t high,
+                             const uint16_t *data, bool notify, void *user) {
+  lcd_push_strided(x, y, fit, high, data, width, false, NULL);
+  lcd_push_strided(0, y, width - fit, high, data + fit, width, notify, user);
+}
+
+void lcd_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t high, uint16_t color) {
+  if (!width || !high || width > LCD_TILE_PX) return;
+  if (lcd_tile_solid != (int32_t)color) {
+    // The tile may still be on the bus from an earlier fill
+    lcd_wait_idle();
+    for (uint32_t i = 0; i < LCD_TILE_PX; i++) lcd_tile[i] = color;
+    lcd_tile_solid = color;
+  }
+  uint16_t fit = width;
+  if (lcd_scroll_on) x = lcd_scroll_map(x, width, &fit);
+  lcd_stream_tile(x, y, fit, high, LCD_TILE_PX / fit);
+  if (fit < width)
+    lcd_stream_tile(0, y, width - fit, high, LCD_TILE_PX / (width - fit));
+}
+
+void lcd_clear_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t high) {
+  lcd_fill_rect(x, y, width, high, 0x0000);
+}
+
+// Expand the pattern into the tile, starting `phase` columns into it, and
+// stream it over the window
+static void lcd_stream_pattern(uint16_t x, uint16_t y, uint16_t width, uint16_t high,
+                               const uint16_t *pattern, uint16_t pw, uint16_t ph, uint16_t phase) {
+  // Whole pattern periods only, so every chunk starts in phase
+  uint32_t rows = (LCD_TILE_PX / width) / ph * ph;
+
+  lcd_wait_idle();
+  for (uint32_t r = 0; r < rows; r++) {
+    const uint16_t *src = pattern + (r % ph) * pw;
+    uint16_t *dst = lcd_tile + r * width;
+    for (uint32_t c = 0; c < width; c++) dst[c] = src[(c + phase) % pw];
+  }
+  lcd_tile_solid = -1;
+  lcd_stream_tile(x, y, width, high, rows);
+}
+
+bool lcd_blit_pattern(uint16_t x,
+                      uint16_t y,
+                      uint16_t width,
+                      uint16_t high,
+                      const uint16_t *pattern,
+                      uint16_t pw,
+                      uint16_t ph) {
+  if (!width || !high || !pattern || !pw || !ph) return false;
+  if ((LCD_TILE_PX / width) / ph == 0) return false;
+
+  uint16_t fit = width;
+  if (lcd_scroll_on) x = lcd_scroll_map(x, width, &fit);
+  lcd_stream_pattern(x, y, fit, high, pattern, pw, ph, 0);
+  if (fit < width)
+    lcd_stream_pattern(0, y, width - fit, high, pattern, pw, ph, fit % pw);
+  return true;
+}
+
+bool lcd_is_solid(const uint16_t *data, uint32_t len) {
+  uint16_t c = data[0];
+  for (uint32_t i = 1; i < len; i++) {
+    if (data[i] != c) return false;
+  }
+  return true;
+}
+
+void lcd_te_set_divider(uint8_t divider, bool auto_pace) {
+  if (divider > LCD_TE_MAX_DIVIDER) divider = LCD_TE_MAX_DIVIDER;
+  lcd_te_divider = divider;
+  lcd_te_auto = auto_pace && divider;
+  lcd_te_armed = true;
+  lcd_te_attach(divider > 0);
+}
+
+void lcd_te_frame_done(void) {
+  if (!lcd_te_divider) return;
+  lcd_te_armed = true;
+  if (!lcd_te_auto || !lcd_te_period_us || !lcd_te_frame_start_us) return;
+
+  // Pace so that rendering a frame fits in the window between presents:
+  // slow down when a frame overruns, speed up again with 25% headroom.
+  uint32_t took = (uint32_t)(esp_timer_get_time() - lcd_te_frame_start_us);
+  uint32_t window = lcd_te_period_us * lcd_te_divider;
+  if (took > window && lcd_te_divider < LCD_TE_MAX_DIVIDER) {
+    lcd_te_divider++;
+  } else if (lcd_te_divider > 1 && took * 4 < lcd_te_period_us * (lcd_te_divider - 1) * 3) {
+    lcd_te_divider--;
+  }
+}
+
+void lcd_te_get_stats(lcd_te_stats_t *out) {
+  out->pulses = lcd_te_count;
+  out->frames = lcd_te_frames;
+  out->timeouts = lcd_te_timeouts;
+  out->period_us = lcd_te_period_us;
+  out->divider = lcd_te_divider;
+}
+
+void lcd_get_push_stats(lcd_push_stats_t *out) {
+  *out = lcd_push_stats;
+}
+
+void lcd_scroll_enable(bool on) {
+  if (on == lcd_scroll_on) return;
+  if (on) {
+    // Whole panel is one scroll area: no fixed top/bottom lines
+    uint8_t area[6] = { 0, 0, (uint8_t)(LCD_SCROLL_LINES >> 8), (uint8_t)LCD_SCROLL_LINES, 0, 0 };
+    lcd_send_cmd(0x33, area, 6);
+  }
+  lcd_scroll_on = on;
+  lcd_scroll_to(0);
+  if (!on) lcd_send_cmd(0x13, NULL, 0);  // Normal display mode
+}
+
+void lcd_scroll_prepare(uint16_t offset) {
+  lcd_scroll_pos = lcd_scroll_on ? offset % LCD_SCROLL_LINES : 0;
+}
+
+void lcd_scroll_to(uint16_t offset) {
+  lcd_scroll_prepare(offset);
+  offset = lcd_scroll_pos;
+  uint8_t start[2] = { (uint8_t)(offset >> 8), (uint8_t)offset };
+  lcd_send_cmd(0x37, start, 2);
+}
+
+uint16_t lcd_scroll_offset(void) {
+  return lcd_scroll_pos;
+}
+
+bool lcd_scroll_active(void) {
+  return lcd_scroll_on;
+}
+
 void lcd_sleep() {
   lcd_send_cmd(0x10, NULL, 0);
 }
\ No newline at end of file
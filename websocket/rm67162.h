@@ -34,21 +34,100 @@ typedef struct
   uint8_t len;
 } lcd_cmd_t;
 
-void rm67162_init(void);
+// Reset and initialise the panel, then read its power mode back and retry
+// only if it did not come up. False if it never reported ready.
+bool rm67162_init(void);
 
 // Set the display window size
 void lcd_address_set(uint16_t x1, uint16_t y1, uint16_t x2, uint16_t y2);
 void lcd_setRotation(uint8_t r);
 void lcd_DrawPoint(uint16_t x, uint16_t y, uint16_t color);
+// Fills stream a small DMA tile; nothing is allocated per call. Colours
+// are in the same byte order as the pixel buffers handed to lcd_PushColors.
 void lcd_fill(uint16_t xsta,
               uint16_t ysta,
               uint16_t xend,
               uint16_t yend,
               uint16_t color);
+void lcd_fill_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t high, uint16_t color);
+void lcd_clear_rect(uint16_t x, uint16_t y, uint16_t width, uint16_t high);
+// Tile a pw x ph pattern over the window; false if width * ph does not fit
+// in the tile (LCD_TILE_PX)
+bool lcd_blit_pattern(uint16_t x,
+                      uint16_t y,
+                      uint16_t width,
+                      uint16_t high,
+                      const uint16_t *pattern,
+                      uint16_t pw,
+                      uint16_t ph);
+// True if all `len` pixels have the same value
+bool lcd_is_solid(const uint16_t *data, uint32_t len);
 void lcd_PushColors(uint16_t x,
                     uint16_t y,
                     uint16_t width,
                     uint16_t high,
                     uint16_t *data);
 void lcd_PushColors(uint16_t *data, uint32_t len);
+
+// Counters for everything pushed through lcd_PushColors*(x, y, ...)
+typedef struct {
+  uint32_t windows;       // address windows opened
+  uint32_t transactions;  // queued SPI transactions (commands + pixel chunks)
+  uint64_t bytes;         // pixel bytes sent
+} lcd_push_stats_t;
+void lcd_get_push_stats(lcd_push_stats_t *out);
+
+// Asynchronous (queued DMA) pushes. The address window goes out in the same
+// queued batch as the pixels. The buffer must be DMA-capable internal RAM
+// and stay untouched until the done callback fires with `user`; the
+// callback runs in the SPI interrupt.
+typedef void (*lcd_flush_done_cb_t)(void *user);
+void lcd_set_flush_done_cb(lcd_flush_done_cb_t cb);
+void lcd_PushColorsAsync(uint16_t x,
+                         uint16_t y,
+                         uint16_t width,
+                         uint16_t high,
+                         uint16_t *data,
+                         void *user);
+// Block until every queued transfer has left the bus
+void lcd_wait_idle();
+
+// Tearing-effect synchronised presentation. With a divider n > 0 the first
+// push of every frame waits for the n-th TE pulse after the previous frame
+// start; auto_pace raises/lowers n so rendering fits the refresh window.
+// Flush callbacks report the end of a frame with lcd_te_frame_done().
+// lcd_te_pulse() is the pulse source, called from the TE pin interrupt or
+// by anything simulating one; the interrupt is attached only while the
+// divider is non-zero. Windowed pushes start frames themselves. Fills and
+// pattern blits do not (scripts call them between frames); a flush that
+// draws through them calls lcd_te_frame_begin() first.
+typedef struct {
+  uint32_t pulses;
+  uint32_t frames;
+  uint32_t timeouts;
+  uint32_t period_us;
+  uint8_t divider;
+} lcd_te_stats_t;
+
+void lcd_te_set_divider(uint8_t divider, bool auto_pace);
+void lcd_te_frame_begin(void);
+void lcd_te_frame_done(void);
+void lcd_te_pulse(void);
+void lcd_te_get_stats(lcd_te_stats_t *out);
+
+// Hardware scrolling. The panel scrolls along its native rows (TFT_HEIGHT
+// lines), which is the x axis in landscape (rotation 1). While enabled, all
+// windowed pushes, fills and blits take logical coordinates: logical column
+// x is stored in frame-memory column (x + offset) % TFT_HEIGHT, and windows
+// crossing the wrap point are split. Moving content left by n columns is then
+// lcd_scroll_prepare(offset + n), a push of the n newly exposed columns and
+// lcd_scroll_to(offset + n): the new columns are in frame memory before the
+// panel shows them. lcd_address_set() and lcd_PushColors(data, len) stay
+// unmapped.
+void lcd_scroll_enable(bool on);
+// Map pushes as if the panel were at `offset`, without moving it yet
+void lcd_scroll_prepare(uint16_t offset);
+void lcd_scroll_to(uint16_t offset);
+uint16_t lcd_scroll_offset(void);
+bool lcd_scroll_active(void);
 void lcd_sleep();
\ No newline at end of file
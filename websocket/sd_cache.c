@@ -0,0 +1,200 @@
+#include "sd_cache.h"
+#include <string.h>
+
+/******************************************************************************
+ * Shared block cache
+ ******************************************************************************/
+static int bucket_of(uint32_t file, uint32_t block) {
+  return (int)(((file ^ (block * 2654435761u)) >> 7) % SDC_BUCKETS);
+}
+
+static void lru_unlink(sdc_cache_t *c, int i) {
+  sdc_slot_t *s = &c->slots[i];
+  if (s->prev >= 0) c->slots[s->prev].next = s->next;
+  else c->mru = s->next;
+  if (s->next >= 0) c->slots[s->next].prev = s->prev;
+  else c->lru = s->prev;
+}
+
+static void lru_push_front(sdc_cache_t *c, int i) {
+  sdc_slot_t *s = &c->slots[i];
+  s->prev = -1;
+  s->next = c->mru;
+  if (c->mru >= 0) c->slots[c->mru].prev = (int16_t)i;
+  c->mru = (int16_t)i;
+  if (c->lru < 0) c->lru = (int16_t)i;
+}
+
+static void lru_push_back(sdc_cache_t *c, int i) {
+  sdc_slot_t *s = &c->slots[i];
+  s->next = -1;
+  s->prev = c->lru;
+  if (c->lru >= 0) c->slots[c->lru].next = (int16_t)i;
+  c->lru = (int16_t)i;
+  if (c->mru < 0) c->mru = (int16_t)i;
+}
+
+static void chain_remove(sdc_cache_t *c, int i) {
+  sdc_slot_t *s = &c->slots[i];
+  int16_t *p = &c->bucket[bucket_of(s->file, s->block)];
+  while (*p != i) p = &c->slots[*p].chain;
+  *p = s->chain;
+  s->used = 0;
+}
+
+uint32_t sdc_cache_init(sdc_cache_t *c, void *mem, size_t size) {
+  memset(c, 0, sizeof(*c));
+  size_t n = size / (SDC_BLOCK + sizeof(sdc_slot_t));
+  if (n > 0x7FFF) n = 0x7FFF;
+  c->data = (uint8_t *)mem;
+  c->slots = (sdc_slot_t *)(c->data + n * SDC_BLOCK);  // SDC_BLOCK keeps them aligned
+  c->nslots = (int16_t)n;
+  c->mru = c->lru = -1;
+  for (int b = 0; b < SDC_BUCKETS; b++) c->bucket[b] = -1;
+  for (int i = 0; i < c->nslots; i++) {
+    c->slots[i].used = 0;
+    lru_push_back(c, i);
+  }
+  return (uint32_t)n;
+}
+
+static int cache_find(sdc_cache_t *c, uint32_t file, uint32_t ver, uint32_t block) {
+  for (int i = c->bucket[bucket_of(file, block)]; i >= 0; i = c->slots[i].chain) {
+    sdc_slot_t *s = &c->slots[i];
+    if (s->block == block && s->file == file && s->ver == ver) return i;
+  }
+  return -1;
+}
+
+static void cache_put(sdc_cache_t *c, uint32_t file, uint32_t ver, uint32_t block, const uint8_t *src,
+                      uint32_t n) {
+  if (c->nslots == 0 || cache_find(c, file, ver, block) >= 0) return;
+  int i = c->lru;
+  sdc_slot_t *s = &c->slots[i];
+  if (s->used) chain_remove(c, i);
+  s->file = file;
+  s->ver = ver;
+  s->block = block;
+  s->used = 1;
+  int16_t *head = &c->bucket[bucket_of(file, block)];
+  s->chain = *head;
+  *head = (int16_t)i;
+  memcpy(c->data + (size_t)i * SDC_BLOCK, src, n);
+  lru_unlink(c, i);
+  lru_push_front(c, i);
+}
+
+void sdc_invalidate(sdc_cache_t *c, uint32_t file) {
+  for (int i = 0; i < c->nslots; i++) {
+    if (!c->slots[i].used || c->slots[i].file != file) continue;
+    chain_remove(c, i);
+    lru_unlink(c, i);
+    lru_push_back(c, i);  // reused first
+  }
+}
+
+uint32_t sdc_path_hash(const char *path) {
+  uint32_t h = 2166136261u;
+  while (*path) h = (h ^ (uint8_t)*path++) * 16777619u;
+  return h;
+}
+
+/******************************************************************************
+ * Files
+ ******************************************************************************/
+void sdc_open(sdc_file_t *f, sdc_cache_t *c, uint32_t file, uint32_t ver, uint32_t size,
+              uint8_t *buf, uint32_t cap, sdc_read_fn read, void *handle) {
+  memset(f, 0, sizeof(*f));
+  f->cache = c;
+  f->read = read;
+  f->handle = handle;
+  f->file = file;
+  f->ver = ver;
+  f->size = size;
+  f->buf = buf;
+  f->cap = cap;
+}
+
+void sdc_seek(sdc_file_t *f, uint32_t pos) {
+  f->pos = pos < f->size ? pos : f->size;
+}
+
+// Fill the read-ahead buffer with the span holding `pos`, at least up to
+// `want` bytes past it if the buffer allows
+static int fetch(sdc_file_t *f, uint32_t pos, uint32_t want) {
+  sdc_cache_t *c = f->cache;
+  uint32_t start = pos / SDC_BLOCK * SDC_BLOCK;
+  int seq = pos == f->next || (f->buf_len && pos == f->buf_off + f->buf_len);
+  uint32_t ra = seq && f->ra ? f->ra * 2 : SDC_BLOCK;
+  uint32_t need = (pos - start + want + SDC_BLOCK - 1) / SDC_BLOCK * SDC_BLOCK;
+  uint32_t len = ra > need ? ra : need;
+  if (len > f->cap) len = f->cap;
+  if (len > f->size - start) len = f->size - start;
+  f->ra = ra < f->cap ? ra : f->cap;
+
+  uint32_t got = f->read(f->handle, start, f->buf, len);
+  c->stats.sd_reads++;
+  c->stats.sd_bytes += got;
+  f->buf_off = start;
+  f->buf_len = got;
+  if (got <= pos - start) return 0;
+  if (len <= SDC_BLOCK) cache_put(c, f->file, f->ver, start / SDC_BLOCK, f->buf, got);
+  return 1;
+}
+
+int sdc_read(sdc_file_t *f, void *dst, uint32_t n, uint32_t *got) {
+  sdc_cache_t *c = f->cache;
+  uint8_t *out = (uint8_t *)dst;
+  uint32_t pos = f->pos;
+  if (n > f->size - pos) n = f->size - pos;
+  uint32_t sd_before = c->stats.sd_reads, saved = 0;
+  int ok = 1, fresh = 0;  // fresh: the read-ahead buffer was filled by this call
+
+  while (n) {
+    uint32_t k;
+    int slot;
+    if (pos >= f->buf_off && pos < f->buf_off + f->buf_len) {
+      k = f->buf_off + f->buf_len - pos;
+      if (k > n) k = n;
+      memcpy(out, f->buf + (pos - f->buf_off), k);
+      if (!fresh) saved += k;
+    } else if ((slot = cache_find(c, f->file, f->ver, pos / SDC_BLOCK)) >= 0) {
+      k = SDC_BLOCK - pos % SDC_BLOCK;
+      if (k > n) k = n;
+      memcpy(out, c->data + (size_t)slot * SDC_BLOCK + pos % SDC_BLOCK, k);
+      lru_unlink(c, slot);
+      lru_push_front(c, slot);
+      c->stats.block_hits++;
+      saved += k;
+    } else if (n >= f->cap) {
+      // Large read: straight into the caller's memory
+      k = f->read(f->handle, pos, out, n);
+      c->stats.sd_reads++;
+      c->stats.sd_bytes += k;
+      f->ra = f->cap;
+      if (k == 0) {
+        ok = 0;
+        break;
+      }
+    } else {
+      if (!fetch(f, pos, n)) {
+        ok = 0;
+        break;
+      }
+      fresh = 1;
+      continue;
+    }
+    out += k;
+    pos += k;
+    n -= k;
+  }
+
+  uint32_t done = (uint32_t)(out - (uint8_t *)dst);
+  c->stats.reads++;
+  c->stats.bytes += done;
+  c->stats.saved += saved;
+  if (c->stats.sd_reads == sd_before) c->stats.hits++;
+  f->pos = f->next = pos;
+  *got = done;
+  return ok;
+}
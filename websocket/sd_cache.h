@@ -0,0 +1,91 @@
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Read caching for the 'S' LVGL driver. The card runs in 1-bit mode at
+// 1 MHz, where every transaction has a fixed cost, and the image and font
+// decoders read a few bytes at a time. Two levels stand between them:
+//  - a read-ahead buffer per open file, holding the last span fetched.
+//    Fetches start on a SDC_BLOCK boundary; they are one block after a
+//    seek and double on every sequential miss, up to the buffer size, so
+//    random access does not pay for bytes it never uses. Reads at least as
+//    long as the buffer go straight to the caller's memory.
+//  - a block cache shared by all files (LRU, SDC_BLOCK-sized blocks), fed
+//    by the single-block fetches: headers read on every open and the
+//    scattered lookups of font and image decoders.
+// Blocks are keyed by path hash, file version (the caller's choice, such
+// as its size) and block number. Plain C and no allocation: the caller
+// provides the memory and a read callback, so the same file builds into
+// the firmware and into the host test (tools/sdcache).
+
+#define SDC_BLOCK 512   // SD sector
+#define SDC_BUCKETS 64
+#define SDC_CACHE_DEFAULT (64 * 1024)     // shared blocks, PSRAM
+#define SDC_READAHEAD_DEFAULT (8 * 1024)  // per open file, PSRAM
+
+// Reads `n` bytes at `off` of the file behind `handle`; returns the bytes read
+typedef uint32_t (*sdc_read_fn)(void *handle, uint32_t off, void *buf, uint32_t n);
+
+typedef struct {
+  uint32_t reads;        // sdc_read() calls
+  uint32_t hits;         // of which served without touching the card
+  uint32_t block_hits;   // blocks found in the shared cache
+  uint32_t sd_reads;     // card transactions
+  uint64_t bytes;        // requested
+  uint64_t saved;        // of which served from memory
+  uint64_t sd_bytes;     // read from the card, read-ahead included
+} sdc_stats_t;
+
+typedef struct {
+  uint32_t file, ver, block;
+  int16_t prev, next;    // LRU list, most recent first
+  int16_t chain;         // bucket chain, -1 = end
+  uint8_t used;
+} sdc_slot_t;
+
+typedef struct {
+  uint8_t *data;         // nslots * SDC_BLOCK
+  sdc_slot_t *slots;
+  int16_t nslots;
+  int16_t mru, lru;
+  int16_t bucket[SDC_BUCKETS];
+  sdc_stats_t stats;
+} sdc_cache_t;
+
+typedef struct {
+  sdc_cache_t *cache;
+  sdc_read_fn read;
+  void *handle;
+  uint32_t file, ver, size;
+  uint32_t pos;
+  uint32_t next;         // where a sequential read would start
+  uint32_t ra;           // size of the last fetch
+  uint8_t *buf;          // read-ahead buffer
+  uint32_t cap;
+  uint32_t buf_off, buf_len;
+} sdc_file_t;
+
+// Lay the cache out in `mem`; `size` may be 0 (read-ahead only). Returns
+// the number of blocks.
+uint32_t sdc_cache_init(sdc_cache_t *c, void *mem, size_t size);
+// Drop every block of `file` (a sdc_path_hash()), whatever its version
+void sdc_invalidate(sdc_cache_t *c, uint32_t file);
+
+uint32_t sdc_path_hash(const char *path);
+
+// `buf` holds `cap` bytes, a multiple of SDC_BLOCK
+void sdc_open(sdc_file_t *f, sdc_cache_t *c, uint32_t file, uint32_t ver, uint32_t size,
+              uint8_t *buf, uint32_t cap, sdc_read_fn read, void *handle);
+// Up to `n` bytes from the current position; false on a card error
+int sdc_read(sdc_file_t *f, void *dst, uint32_t n, uint32_t *got);
+// Positions past the end are clamped to it
+void sdc_seek(sdc_file_t *f, uint32_t pos);
+
+#ifdef __cplusplus
+}
+#endif
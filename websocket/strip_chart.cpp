@@ -0,0 +1,163 @@
+#include <Arduino.h>
+#include <string.h>
+#include "esp_heap_caps.h"
+#include "strip_chart.h"
+
+#define STRIP_CHART_MAGIC 0x53545250  // "STRP"
+
+typedef struct {
+  uint32_t magic;
+  lv_color_t *buf;     // w * h bitmap shown by the canvas
+  lv_color_t *bg_col;  // cached background column: fill + horizontal grid
+  lv_coord_t w, h;
+  int32_t min, max;
+  lv_color_t bg, grid;
+  uint8_t h_div;
+  uint16_t v_every;
+  uint8_t step;
+  uint32_t samples;
+  uint8_t nser;
+  lv_color_t color[STRIP_CHART_MAX_SERIES];
+  lv_coord_t last_y[STRIP_CHART_MAX_SERIES];  // -1 after a gap
+} strip_chart_t;
+
+static strip_chart_t *strip_get(lv_obj_t *obj) {
+  if (!obj || !lv_obj_check_type(obj, &lv_canvas_class)) return NULL;
+  strip_chart_t *s = (strip_chart_t *)lv_obj_get_user_data(obj);
+  return (s && s->magic == STRIP_CHART_MAGIC) ? s : NULL;
+}
+
+bool strip_chart_check(lv_obj_t *obj) {
+  return strip_get(obj) != NULL;
+}
+
+static void strip_build_bg(strip_chart_t *s) {
+  for (lv_coord_t y = 0; y < s->h; y++) s->bg_col[y] = s->bg;
+  for (int k = 0; s->h_div && k <= s->h_div; k++) s->bg_col[(s->h - 1) * k / s->h_div] = s->grid;
+}
+
+// Clear to background and grid; series restart at the next sample
+static void strip_repaint(lv_obj_t *obj, strip_chart_t *s) {
+  strip_build_bg(s);
+  for (lv_coord_t y = 0; y < s->h; y++) {
+    lv_color_t *row = s->buf + (size_t)y * s->w;
+    for (lv_coord_t x = 0; x < s->w; x++) row[x] = s->bg_col[y];
+  }
+  for (int i = 0; i < s->nser; i++) s->last_y[i] = -1;
+  s->samples = 0;
+  lv_obj_invalidate(obj);
+}
+
+static void strip_deleted(lv_event_t *e) {
+  strip_chart_t *s = (strip_chart_t *)lv_event_get_user_data(e);
+  s->magic = 0;
+  free(s->buf);
+  free(s->bg_col);
+  free(s);
+}
+
+lv_obj_t *strip_chart_create(lv_obj_t *parent, lv_coord_t w, lv_coord_t h) {
+  if (w < 2 || h < 2) return NULL;
+  strip_chart_t *s = (strip_chart_t *)calloc(1, sizeof(strip_chart_t));
+  if (!s) return NULL;
+  s->buf = (lv_color_t *)heap_caps_malloc((size_t)w * h * sizeof(lv_color_t), MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  s->bg_col = (lv_color_t *)malloc(h * sizeof(lv_color_t));
+  if (!s->buf || !s->bg_col) {
+    Serial.printf("strip_chart: no memory for a %dx%d bitmap\n", w, h);
+    free(s->buf);
+    free(s->bg_col);
+    free(s);
+    return NULL;
+  }
+  s->magic = STRIP_CHART_MAGIC;
+  s->w = w;
+  s->h = h;
+  s->min = 0;
+  s->max = 100;
+  s->bg = lv_color_black();
+  s->grid = lv_color_hex(0x303030);
+  s->h_div = 4;
+  s->step = 1;
+
+  lv_obj_t *obj = lv_canvas_create(parent);
+  lv_canvas_set_buffer(obj, s->buf, w, h, LV_IMG_CF_TRUE_COLOR);
+  lv_obj_set_user_data(obj, s);
+  lv_obj_add_event_cb(obj, strip_deleted, LV_EVENT_DELETE, s);
+  strip_repaint(obj, s);
+  return obj;
+}
+
+int strip_chart_add_series(lv_obj_t *obj, lv_color_t color) {
+  strip_chart_t *s = strip_get(obj);
+  if (!s || s->nser >= STRIP_CHART_MAX_SERIES) return -1;
+  s->color[s->nser] = color;
+  s->last_y[s->nser] = -1;
+  return s->nser++;
+}
+
+void strip_chart_set_range(lv_obj_t *obj, int32_t min, int32_t max) {
+  strip_chart_t *s = strip_get(obj);
+  if (!s || min == max) return;
+  s->min = min;
+  s->max = max;
+}
+
+void strip_chart_set_grid(lv_obj_t *obj, lv_color_t bg, lv_color_t grid, uint8_t h_div, uint16_t v_every) {
+  strip_chart_t *s = strip_get(obj);
+  if (!s) return;
+  s->bg = bg;
+  s->grid = grid;
+  s->h_div = h_div;
+  s->v_every = v_every;
+  strip_repaint(obj, s);
+}
+
+void strip_chart_set_step(lv_obj_t *obj, uint8_t px) {
+  strip_chart_t *s = strip_get(obj);
+  if (s && px > 0) s->step = px < s->w ? px : s->w - 1;
+}
+
+static lv_coord_t strip_map(const strip_chart_t *s, int32_t v) {
+  int32_t y = (int32_t)((int64_t)(s->max - v) * (s->h - 1) / (s->max - s->min));
+  return y < 0 ? 0 : (y >= s->h ? s->h - 1 : y);
+}
+
+void strip_chart_push(lv_obj_t *obj, const int32_t *values, int n) {
+  strip_chart_t *s = strip_get(obj);
+  if (!s) return;
+  const lv_coord_t w = s->w, h = s->h, st = s->step;
+
+  // Shift every row left by `st` pixels in one go: the first pixels of each
+  // row land at the end of the row above, where the new columns go anyway
+  memmove(s->buf, s->buf + st, ((size_t)w * h - st) * sizeof(lv_color_t));
+
+  bool vline = s->v_every && s->samples % s->v_every == 0;
+  for (lv_coord_t y = 0; y < h; y++) {
+    lv_color_t *row = s->buf + (size_t)y * w;
+    for (lv_coord_t x = w - st; x < w; x++) row[x] = s->bg_col[y];
+    if (vline) row[w - 1] = s->grid;
+  }
+
+  // Each series is a line from its previous sample to this one across the
+  // new columns, drawn as one vertical span per column
+  for (int i = 0; i < s->nser; i++) {
+    if (i >= n || values[i] == LV_CHART_POINT_NONE) {
+      s->last_y[i] = -1;
+      continue;
+    }
+    lv_coord_t y1 = strip_map(s, values[i]);
+    lv_coord_t y0 = s->last_y[i] >= 0 ? s->last_y[i] : y1;
+    lv_coord_t prev = y0;
+    for (lv_coord_t k = 1; k <= st; k++) {
+      lv_coord_t yk = y0 + (y1 - y0) * k / st;
+      lv_coord_t lo = prev < yk ? prev : yk, hi = prev < yk ? yk : prev;
+      lv_color_t *px = s->buf + (size_t)lo * w + (w - st - 1 + k);
+      for (lv_coord_t y = lo; y <= hi; y++, px += w) *px = s->color[i];
+      prev = yk;
+    }
+    s->last_y[i] = y1;
+  }
+
+  s->samples++;
+  lv_obj_invalidate(obj);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <lvgl.h>
+
+// Scrolling strip chart: a canvas with its own PSRAM bitmap. Each sample
+// shifts the bitmap left by `step` pixels (one memmove over the whole
+// buffer) and rasterizes only the new rightmost columns, taken from a
+// cached background column (fill + horizontal grid lines) plus one
+// vertical span per series. Nothing that is already on screen is ever
+// re-rasterized; LVGL only blits the bitmap. lv_chart in shift mode instead
+// redraws grid, ticks and every series line on each new value.
+#define STRIP_CHART_MAX_SERIES 8
+
+// Create a w x h strip chart on `parent`; NULL if the bitmap does not fit
+lv_obj_t *strip_chart_create(lv_obj_t *parent, lv_coord_t w, lv_coord_t h);
+// True for objects made by strip_chart_create()
+bool strip_chart_check(lv_obj_t *obj);
+
+// Returns the series id (0, 1, ...) or -1 when full
+int strip_chart_add_series(lv_obj_t *obj, lv_color_t color);
+// Value range mapped onto the height (default 0..100)
+void strip_chart_set_range(lv_obj_t *obj, int32_t min, int32_t max);
+// Background, grid colour, number of horizontal grid divisions and a
+// vertical grid line every `v_every` samples (0 = none). Repaints the chart.
+void strip_chart_set_grid(lv_obj_t *obj, lv_color_t bg, lv_color_t grid, uint8_t h_div, uint16_t v_every);
+// Pixels scrolled per sample (default 1)
+void strip_chart_set_step(lv_obj_t *obj, uint8_t px);
+// One sample per series (values[i] for series i, missing ones and
+// LV_CHART_POINT_NONE leave a gap); scrolls by one step
+void strip_chart_push(lv_obj_t *obj, const int32_t *values, int n);
@@ -0,0 +1,440 @@
+#include "ui_queue.h"
+#include <lvgl.h>
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "esp_heap_caps.h"
+#if CONFIG_PM_ENABLE
+#include "esp_pm.h"
+#include "esp_idf_version.h"
+#endif
+
+typedef struct {
+  jsval_t val;  // numbers, booleans, null: self-contained, copied as is
+  char *str;    // strings: heap copy, freed once applied
+  size_t len;
+} ui_arg_t;
+
+typedef struct {
+  ui_bridge_fn_t fn;
+  uint8_t kind;
+  uint8_t nargs;
+  int32_t handle;  // reserved id of a UI_CREATE command
+  ui_arg_t *args;  // inline_args, or a heap block for longer calls
+  ui_arg_t inline_args[UI_INLINE_ARGS];
+} ui_cmd_t;
+static_assert(UI_MAX_ARGS <= 255, "nargs is a uint8_t");
+
+// Result of a UI_SYNC command, handed back to the waiting Elk task
+typedef struct {
+  int type;
+  jsval_t val;
+  char *str;
+  size_t len;
+} ui_result_t;
+
+static ui_cmd_t g_ui_ring[UI_QUEUE_LEN];
+static volatile uint32_t g_ui_head = 0;  // written by the producer only
+static volatile uint32_t g_ui_tail = 0;  // written by the consumer only
+
+static TaskHandle_t g_ui_task = NULL;
+static TaskHandle_t g_ui_sleeper = NULL;  // task sleeping in ui_run_once()
+static SemaphoreHandle_t g_ui_sync_done = NULL;
+static ui_result_t g_ui_result;
+static ui_stats_t g_ui_stats;
+
+// Scratch Elk instance the render task rebuilds arguments in
+#define UI_ARENA_SIZE 8192
+static uint8_t g_ui_arena[UI_ARENA_SIZE];
+
+static int g_ui_pending_handle = -1;
+
+/******************************************************************************
+ * Handles
+ ******************************************************************************/
+// Slots live in slabs of UI_HANDLE_SLAB, allocated in PSRAM as the table
+// grows and never moved or freed, so a slot pointer stays valid without the
+// lock. Free slots form a LIFO list threaded through `next`. A handle is
+// (generation << UI_HANDLE_INDEX_BITS) | index; releasing a slot bumps its
+// generation, so a handle kept after its object was deleted never resolves
+// to whatever reuses the slot.
+#define UI_HANDLE_INDEX_MASK ((1 << UI_HANDLE_INDEX_BITS) - 1)
+#define UI_HANDLE_GEN_MASK 0xFFFF
+#define UI_HANDLE_SLABS (UI_HANDLE_MAX / UI_HANDLE_SLAB)
+static_assert(UI_HANDLE_MAX <= (1 << UI_HANDLE_INDEX_BITS) && UI_HANDLE_MAX % UI_HANDLE_SLAB == 0,
+              "UI_HANDLE_MAX must be a multiple of UI_HANDLE_SLAB within the index bits");
+
+enum { UI_SLOT_FREE, UI_SLOT_RESERVED, UI_SLOT_LIVE };
+
+typedef struct {
+  void *ptr;
+  uint16_t gen;   // never 0, so neither 0 nor -1 is ever a valid handle
+  uint8_t state;
+  int16_t next;   // next free slot, -1 at the end of the list
+} ui_slot_t;
+
+static ui_slot_t *g_ui_slabs[UI_HANDLE_SLABS];
+static int g_ui_nslabs = 0;
+static int g_ui_free = -1;
+static ui_handle_stats_t g_ui_hstats;
+static portMUX_TYPE g_ui_handle_lock = portMUX_INITIALIZER_UNLOCKED;
+
+static inline ui_slot_t *ui_slot(int index) {
+  return &g_ui_slabs[index / UI_HANDLE_SLAB][index % UI_HANDLE_SLAB];
+}
+
+// Add one slab to the free list; false once UI_HANDLE_MAX is reached or
+// memory is out. Allocates outside the lock; a slab that lost the race
+// against another task growing the table is dropped again.
+static bool ui_handle_grow() {
+  int n = __atomic_load_n(&g_ui_nslabs, __ATOMIC_ACQUIRE);
+  if (n >= UI_HANDLE_SLABS) return false;
+  size_t bytes = UI_HANDLE_SLAB * sizeof(ui_slot_t);
+  ui_slot_t *slab = (ui_slot_t *)heap_caps_malloc(bytes, MALLOC_CAP_SPIRAM | MALLOC_CAP_8BIT);
+  if (!slab) slab = (ui_slot_t *)malloc(bytes);
+  if (!slab) return false;
+
+  bool added = false;
+  portENTER_CRITICAL(&g_ui_handle_lock);
+  if (g_ui_nslabs == n) {
+    int base = n * UI_HANDLE_SLAB;
+    for (int i = 0; i < UI_HANDLE_SLAB; i++) {
+      slab[i].ptr = NULL;
+      slab[i].gen = 1;
+      slab[i].state = UI_SLOT_FREE;
+      slab[i].next = (i + 1 < UI_HANDLE_SLAB) ? base + i + 1 : g_ui_free;
+    }
+    g_ui_slabs[n] = slab;
+    g_ui_free = base;
+    __atomic_store_n(&g_ui_nslabs, n + 1, __ATOMIC_RELEASE);
+    g_ui_hstats.capacity += UI_HANDLE_SLAB;
+    added = true;
+  }
+  portEXIT_CRITICAL(&g_ui_handle_lock);
+  if (!added) free(slab);
+  return true;
+}
+
+static int ui_handle_reserve() {
+  for (;;) {
+    int handle = -1;
+    portENTER_CRITICAL(&g_ui_handle_lock);
+    if (g_ui_free >= 0) {
+      int index = g_ui_free;
+      ui_slot_t *s = ui_slot(index);
+      g_ui_free = s->next;
+      s->state = UI_SLOT_RESERVED;
+      s->ptr = NULL;
+      handle = ((int)s->gen << UI_HANDLE_INDEX_BITS) | index;
+      g_ui_hstats.allocs++;
+      if (++g_ui_hstats.used > g_ui_hstats.peak) g_ui_hstats.peak = g_ui_hstats.used;
+    }
+    portEXIT_CRITICAL(&g_ui_handle_lock);
+    if (handle >= 0) return handle;
+    if (!ui_handle_grow()) return -1;
+  }
+}
+
+// Slot of a handle whose generation still matches, NULL otherwise
+static ui_slot_t *ui_handle_slot(int id) {
+  if (id <= 0) return NULL;
+  int index = id & UI_HANDLE_INDEX_MASK;
+  if (index >= __atomic_load_n(&g_ui_nslabs, __ATOMIC_ACQUIRE) * UI_HANDLE_SLAB) return NULL;
+  ui_slot_t *s = ui_slot(index);
+  if (s->gen != ((unsigned)id >> UI_HANDLE_INDEX_BITS) || s->state == UI_SLOT_FREE) {
+    __atomic_fetch_add(&g_ui_hstats.stale, 1, __ATOMIC_RELAXED);  // lookups run on both tasks
+    return NULL;
+  }
+  return s;
+}
+
+int ui_handle_claim() {
+  if (g_ui_pending_handle >= 0) {
+    int id = g_ui_pending_handle;
+    g_ui_pending_handle = -1;
+    return id;
+  }
+  return ui_handle_reserve();
+}
+
+void ui_handle_set(int id, void *ptr) {
+  ui_slot_t *s = ui_handle_slot(id);
+  if (!s) return;
+  s->ptr = ptr;
+  s->state = UI_SLOT_LIVE;
+}
+
+void *ui_handle_get(int id) {
+  ui_slot_t *s = ui_handle_slot(id);
+  return (s && s->state == UI_SLOT_LIVE) ? s->ptr : NULL;
+}
+
+void ui_handle_release(int id) {
+  if (id <= 0) return;
+  portENTER_CRITICAL(&g_ui_handle_lock);
+  int index = id & UI_HANDLE_INDEX_MASK;
+  if (index < g_ui_nslabs * UI_HANDLE_SLAB) {
+    ui_slot_t *s = ui_slot(index);
+    if (s->gen == ((unsigned)id >> UI_HANDLE_INDEX_BITS) && s->state != UI_SLOT_FREE) {
+      s->gen = s->gen == UI_HANDLE_GEN_MASK ? 1 : s->gen + 1;
+      s->state = UI_SLOT_FREE;
+      s->ptr = NULL;
+      s->next = g_ui_free;
+      g_ui_free = index;
+      g_ui_hstats.used--;
+      g_ui_hstats.frees++;
+    }
+  }
+  portEXIT_CRITICAL(&g_ui_handle_lock);
+}
+
+void ui_handle_get_stats(ui_handle_stats_t *out) {
+  portENTER_CRITICAL(&g_ui_handle_lock);
+  *out = g_ui_hstats;
+  portEXIT_CRITICAL(&g_ui_handle_lock);
+  out->bytes = out->capacity * sizeof(ui_slot_t);
+}
+
+/******************************************************************************
+ * Producer (Elk task)
+ ******************************************************************************/
+// What a call that could not be queued returns
+static jsval_t ui_rejected(uint8_t kind) {
+  return kind == UI_CMD_CREATE ? js_mknum(-1) : js_mknull();
+}
+
+static void ui_free_args(ui_cmd_t *c, int n) {
+  for (int i = 0; i < n; i++) {
+    free(c->args[i].str);
+    c->args[i].str = NULL;
+  }
+  if (c->args != c->inline_args) free(c->args);
+  c->args = c->inline_args;
+}
+
+jsval_t ui_forward(struct js *js, ui_bridge_fn_t fn, uint8_t kind, jsval_t *args, int nargs) {
+  if (!g_ui_task) return fn(js, args, nargs);  // no render task: run inline
+
+  if (nargs > UI_MAX_ARGS) {
+    Serial.printf("ui: call with %d arguments rejected, at most %d\n", nargs, UI_MAX_ARGS);
+    return ui_rejected(kind);
+  }
+  for (int i = 0; i < nargs; i++) {
+    switch (js_type(args[i])) {
+      case JS_UNDEF: case JS_NULL: case JS_TRUE: case JS_FALSE: case JS_NUM: case JS_STR:
+        break;
+      default:  // objects and functions live in the Elk heap
+        Serial.printf("ui: call rejected, argument %d is an object or function\n", i + 1);
+        return ui_rejected(kind);
+    }
+  }
+
+  int handle = -1;
+  if (kind == UI_CMD_CREATE) {
+    handle = ui_handle_reserve();
+    if (handle < 0) {
+      Serial.println("ui: no free object handle");
+      return js_mknum(-1);
+    }
+  }
+
+  uint32_t head = g_ui_head;
+  while (head - __atomic_load_n(&g_ui_tail, __ATOMIC_ACQUIRE) >= UI_QUEUE_LEN) {
+    g_ui_stats.full++;
+    ui_wake();
+    vTaskDelay(1);
+  }
+
+  ui_cmd_t *c = &g_ui_ring[head % UI_QUEUE_LEN];
+  c->fn = fn;
+  c->kind = kind;
+  c->handle = handle;
+  c->nargs = (uint8_t)nargs;
+  c->args = c->inline_args;
+  if (nargs > UI_INLINE_ARGS) c->args = (ui_arg_t *)malloc(nargs * sizeof(ui_arg_t));
+  bool ok = c->args != NULL;
+  for (int i = 0; ok && i < nargs; i++) {
+    ui_arg_t *a = &c->args[i];
+    a->str = NULL;
+    a->val = args[i];
+    if (js_type(args[i]) == JS_STR) {
+      const char *s = js_getstr(js, args[i], &a->len);
+      a->str = (char *)malloc(a->len + 1);
+      if (a->str) {
+        memcpy(a->str, s, a->len);
+        a->str[a->len] = 0;
+      } else {
+        ui_free_args(c, i);
+        ok = false;
+      }
+    }
+  }
+  if (!ok) {
+    c->args = c->inline_args;
+    Serial.println("ui: out of memory for call arguments");
+    ui_handle_release(handle);
+    return ui_rejected(kind);
+  }
+
+  __atomic_store_n(&g_ui_head, head + 1, __ATOMIC_RELEASE);
+  g_ui_stats.posted++;
+  ui_wake();
+
+  if (kind == UI_CMD_CREATE) return js_mknum(handle);
+  if (kind != UI_CMD_SYNC) return js_mknull();
+
+  g_ui_stats.sync++;
+  xSemaphoreTake(g_ui_sync_done, portMAX_DELAY);
+  jsval_t res = g_ui_result.val;
+  if (g_ui_result.type == JS_STR) {
+    res = g_ui_result.str ? js_mkstr(js, g_ui_result.str, g_ui_result.len) : js_mknull();
+    free(g_ui_result.str);
+  }
+  return res;
+}
+
+/******************************************************************************
+ * Consumer (render task)
+ ******************************************************************************/
+static void ui_apply(ui_cmd_t *c) {
+  struct js *rjs = js_create(g_ui_arena, sizeof(g_ui_arena));
+  jsval_t args[UI_MAX_ARGS];
+  for (int i = 0; i < c->nargs; i++) {
+    ui_arg_t *a = &c->args[i];
+    args[i] = a->val;
+    if (a->str) {
+      args[i] = js_mkstr(rjs, a->str, a->len);
+      if (js_type(args[i]) != JS_STR) {
+        Serial.printf("ui: %u byte string argument does not fit\n", (unsigned)a->len);
+        args[i] = js_mknull();
+      }
+    }
+  }
+  ui_free_args(c, c->nargs);
+
+  g_ui_pending_handle = c->handle;
+  jsval_t res = c->fn(rjs, args, c->nargs);
+  if (g_ui_pending_handle >= 0) {
+    // The bridge failed before storing an object: give the id back
+    ui_handle_release(g_ui_pending_handle);
+    g_ui_pending_handle = -1;
+  }
+
+  if (c->kind == UI_CMD_SYNC) {
+    g_ui_result.type = js_type(res);
+    g_ui_result.val = res;
+    g_ui_result.str = NULL;
+    if (g_ui_result.type == JS_STR) {
+      const char *s = js_getstr(rjs, res, &g_ui_result.len);
+      g_ui_result.str = (char *)malloc(g_ui_result.len + 1);
+      if (g_ui_result.str) memcpy(g_ui_result.str, s, g_ui_result.len);
+    } else if (g_ui_result.type != JS_NUM && g_ui_result.type != JS_TRUE &&
+               g_ui_result.type != JS_FALSE) {
+      g_ui_result.val = js_mknull();
+    }
+    xSemaphoreGive(g_ui_sync_done);
+  }
+}
+
+// Apply everything queued so far
+static void ui_drain() {
+  uint32_t tail = g_ui_tail;
+  uint32_t head = __atomic_load_n(&g_ui_head, __ATOMIC_ACQUIRE);
+  if (head == tail) return;
+
+  uint32_t n = head - tail;
+  for (; tail != head; tail++) {
+    ui_apply(&g_ui_ring[tail % UI_QUEUE_LEN]);
+    __atomic_store_n(&g_ui_tail, tail + 1, __ATOMIC_RELEASE);
+  }
+  g_ui_stats.applied += n;
+  g_ui_stats.batches++;
+  if (n > g_ui_stats.max_batch) g_ui_stats.max_batch = n;
+}
+
+/******************************************************************************
+ * Scheduler
+ ******************************************************************************/
+#if CONFIG_PM_ENABLE
+// Held while frames are due soon; released when the screen is static. Only
+// created once light sleep is actually configured, which needs tickless
+// idle: releasing it would not let the chip sleep otherwise.
+static esp_pm_lock_handle_t g_ui_pm_lock = NULL;
+static bool g_ui_pm_held = false;
+static bool g_ui_pm_ready = false;
+
+static void ui_pm_init() {
+  if (g_ui_pm_ready) return;
+  g_ui_pm_ready = true;
+#if CONFIG_FREERTOS_USE_TICKLESS_IDLE
+#if ESP_IDF_VERSION_MAJOR >= 5
+  esp_pm_config_t cfg = {
+#else
+  esp_pm_config_esp32s3_t cfg = {
+#endif
+    .max_freq_mhz = CONFIG_ESP32S3_DEFAULT_CPU_FREQ_MHZ,
+    .min_freq_mhz = 40,
+    .light_sleep_enable = true,
+  };
+  if (esp_pm_configure(&cfg) != ESP_OK) {
+    Serial.println("ui: light sleep not available");
+    return;
+  }
+  esp_pm_lock_create(ESP_PM_NO_LIGHT_SLEEP, 0, "ui", &g_ui_pm_lock);
+#endif
+}
+
+// Returns whether light sleep is now allowed
+static bool ui_pm_hold(bool hold) {
+  if (!g_ui_pm_lock) return false;
+  if (hold != g_ui_pm_held) {
+    if (hold) esp_pm_lock_acquire(g_ui_pm_lock);
+    else esp_pm_lock_release(g_ui_pm_lock);
+    g_ui_pm_held = hold;
+  }
+  return !g_ui_pm_held;
+}
+#endif
+
+void ui_run_once(uint32_t max_ms) {
+  g_ui_sleeper = xTaskGetCurrentTaskHandle();
+#if CONFIG_PM_ENABLE
+  ui_pm_init();
+#endif
+  ui_drain();
+  uint32_t next = lv_timer_handler();  // ms until the next LVGL timer is due
+  if (next > max_ms) next = max_ms;
+
+  bool light_sleep = false;
+#if CONFIG_PM_ENABLE
+  light_sleep = ui_pm_hold(next < UI_LIGHT_SLEEP_MIN_MS);
+#endif
+
+  g_ui_stats.wakeups++;
+  if (next == 0) return;
+  uint32_t t0 = millis();
+  if (ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(next)) > 0) g_ui_stats.woken++;
+  uint32_t slept = millis() - t0;
+  g_ui_stats.idle_ms += slept;
+  if (light_sleep) g_ui_stats.light_sleep_ms += slept;
+}
+
+static void ui_render_task(void *pvParam) {
+  for (;;) {
+    ui_run_once(UI_IDLE_MAX_MS);
+  }
+}
+
+void ui_start() {
+  if (g_ui_task) return;
+  g_ui_sync_done = xSemaphoreCreateBinary();
+  xTaskCreatePinnedToCore(ui_render_task, "RenderTask", UI_RENDER_STACK, NULL, 2,
+                          &g_ui_task, UI_RENDER_CORE);
+}
+
+void ui_wake() {
+  if (g_ui_sleeper) xTaskNotifyGive(g_ui_sleeper);
+}
+
+void ui_get_stats(ui_stats_t *out) {
+  *out = g_ui_stats;
+}
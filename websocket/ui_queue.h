@@ -0,0 +1,106 @@
+#pragma once
+
+#include <Arduino.h>
+extern "C" {
+  #include "elk.h"
+}
+
+// UI command queue between the Elk task (producer) and the render task
+// (consumer, sole owner of LVGL and the panel). Bridges that touch LVGL are
+// registered through one of the wrappers below instead of directly:
+//   UI_ASYNC(fn)  - queued, the script continues at once (returns null)
+//   UI_CREATE(fn) - queued; the object handle is reserved up front and
+//                   returned immediately, later commands can use it
+//   UI_SYNC(fn)   - queued, the script waits for the bridge's return value
+// Arguments are copied into the command (strings included); on the render
+// task the bridge runs unchanged against a scratch Elk instance holding
+// those copies. Commands are applied in order, in one batch per frame.
+// Objects and functions live in the script's heap and cannot be copied: a
+// call passing one, or more than UI_MAX_ARGS arguments, is rejected with a
+// message on Serial and returns null (-1 from UI_CREATE).
+#ifndef UI_QUEUE_LEN
+#define UI_QUEUE_LEN 64        // commands in flight, single producer/consumer
+#endif
+#define UI_INLINE_ARGS 10      // arguments held in the queue slot itself
+#define UI_MAX_ARGS 64         // longer calls (polylines, chart rows) take a heap block
+#ifndef UI_HANDLE_SLAB
+#define UI_HANDLE_SLAB 64      // object handles added per table growth step
+#endif
+#define UI_HANDLE_INDEX_BITS 12
+#ifndef UI_HANDLE_MAX
+#define UI_HANDLE_MAX (1 << UI_HANDLE_INDEX_BITS)  // live object handles at most
+#endif
+#ifndef UI_RENDER_CORE
+#define UI_RENDER_CORE 0       // the Elk task runs on core 1
+#endif
+#define UI_RENDER_STACK 8192
+#ifndef UI_IDLE_MAX_MS
+#define UI_IDLE_MAX_MS 1000    // longest sleep with no LVGL timer pending
+#endif
+#ifndef UI_LIGHT_SLEEP_MIN_MS
+#define UI_LIGHT_SLEEP_MIN_MS 50  // allow light sleep for idle gaps this long
+#endif
+
+typedef jsval_t (*ui_bridge_fn_t)(struct js *, jsval_t *, int);
+enum { UI_CMD_ASYNC, UI_CMD_CREATE, UI_CMD_SYNC };
+
+jsval_t ui_forward(struct js *js, ui_bridge_fn_t fn, uint8_t kind, jsval_t *args, int nargs);
+
+template <ui_bridge_fn_t F, uint8_t K>
+static jsval_t ui_bridge(struct js *js, jsval_t *args, int nargs) {
+  return ui_forward(js, F, K, args, nargs);
+}
+
+#define UI_ASYNC(fn) (ui_bridge<fn, UI_CMD_ASYNC>)
+#define UI_CREATE(fn) (ui_bridge<fn, UI_CMD_CREATE>)
+#define UI_SYNC(fn) (ui_bridge<fn, UI_CMD_SYNC>)
+
+// Start the render task: it drains the queue and runs lv_timer_handler()
+void ui_start();
+// One scheduler pass for whoever owns LVGL: apply queued commands, run
+// lv_timer_handler(), then sleep until its next timer is due, ui_wake() is
+// called, or max_ms passes. With CONFIG_PM_ENABLE (and tickless idle) the
+// chip may drop into light sleep while nothing is due for a while; the
+// stock Arduino-ESP32 core is built without it, so there only the task
+// sleeps.
+void ui_run_once(uint32_t max_ms);
+// Wake the LVGL owner early: UI command, input, network completion, ...
+// Safe from tasks only.
+void ui_wake();
+
+// Object handles. The Elk side reserves one per UI_CREATE command; on the
+// render task ui_handle_claim() hands that reserved id to the bridge's
+// store_lv_obj() call (or any free id outside a UI_CREATE command), which
+// binds it with ui_handle_set(). Handles carry a generation: once released,
+// ui_handle_get() returns NULL for them even after the slot is reused.
+// Allocation and release are O(1); the table grows in PSRAM slabs up to
+// UI_HANDLE_MAX.
+int ui_handle_claim();
+void ui_handle_set(int id, void *ptr);
+void *ui_handle_get(int id);
+void ui_handle_release(int id);
+
+typedef struct {
+  uint32_t capacity;  // slots allocated so far
+  uint32_t used;      // reserved or bound right now
+  uint32_t peak;      // most used at once
+  uint32_t allocs;
+  uint32_t frees;
+  uint32_t stale;     // lookups rejected for a released handle
+  uint32_t bytes;     // table memory
+} ui_handle_stats_t;
+void ui_handle_get_stats(ui_handle_stats_t *out);
+
+typedef struct {
+  uint32_t posted;     // commands queued by the Elk task
+  uint32_t applied;    // commands run by the render task
+  uint32_t sync;       // of which the script waited for
+  uint32_t batches;    // render passes that applied at least one command
+  uint32_t max_batch;  // most commands applied in one pass
+  uint32_t full;       // times the Elk task had to wait for a free slot
+  uint32_t wakeups;    // scheduler passes
+  uint32_t woken;      // of which ended early by ui_wake()
+  uint32_t idle_ms;    // time spent sleeping between passes
+  uint32_t light_sleep_ms;  // of which with light sleep allowed (0 without CONFIG_PM_ENABLE)
+} ui_stats_t;
+void ui_get_stats(ui_stats_t *out);
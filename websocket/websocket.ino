@@ -6,6 +6,7 @@
 #include "pins_config.h"     // For PIN_SD_CMD, etc.
 #include "fallback.h"        // Fallback header
 #include "dynamic_js.h"      // Dynamic (Elk + JS) header
+#include "display.h"         // Shared panel + LVGL bring-up
 
 #include <ArduinoJson.h>
 
@@ -58,6 +59,9 @@ static bool readWiFiConfigJSON(const char* path, String &outSSID, String &outPAS
 
 void setup() {
   Serial.begin(115200);
+
+  // Panel first: both modes share it, so bring it up before anything slow
+  display_init();
   delay(2000);
 
   // Attempt to mount SD
@@ -95,11 +99,12 @@ void setup() {
   }
   Serial.println("Wi-Fi connected => " + WiFi.localIP().toString());
 
-  // Check if /script.js exists
+  // Check if /script.js or an app bundle exists
   {
     File checkF = SD_MMC.open("/script.js");
+    if(!checkF) checkF = SD_MMC.open("/app.wsb");
     if(!checkF) {
-      Serial.println("No script.js => fallback");
+      Serial.println("No script.js or app.wsb => fallback");
       useFallback = true;
       fallback_setup();
       return;
@@ -107,7 +112,7 @@ void setup() {
     checkF.close();
   }
 
-  // We have script.js => run dynamic
+  // We have a script => run dynamic
   useFallback = false;
   dynamic_js_setup();
 }